@@ -33,10 +33,15 @@ enum gsm0503_egprs_mcs {
 int gsm0503_xcch_encode(ubit_t *bursts, const uint8_t *l2_data);
 int gsm0503_xcch_decode(uint8_t *l2_data, const sbit_t *bursts,
 	int *n_errors, int *n_bits_total);
+int gsm0503_xcch_decode_batch(unsigned int n, uint8_t * const *l2_data,
+	const sbit_t * const *bursts, int *n_errors, int *n_bits_total, int *rc);
 
 int gsm0503_pdtch_encode(ubit_t *bursts, const uint8_t *l2_data, uint8_t l2_len);
 int gsm0503_pdtch_decode(uint8_t *l2_data, const sbit_t *bursts, uint8_t *usf_p,
 	int *n_errors, int *n_bits_total);
+int gsm0503_pdtch_decode_batch(unsigned int n, uint8_t * const *l2_data,
+	const sbit_t * const *bursts, uint8_t *usf, int *n_errors,
+	int *n_bits_total, int *rc);
 
 int gsm0503_pdtch_egprs_encode(ubit_t *bursts, const uint8_t *l2_data,
 	uint8_t l2_len);
@@ -47,6 +52,9 @@ int gsm0503_tch_fr_encode(ubit_t *bursts, const uint8_t *tch_data, int len,
 	int net_order);
 int gsm0503_tch_fr_decode(uint8_t *tch_data, const sbit_t *bursts, int net_order,
 	int efr, int *n_errors, int *n_bits_total);
+int gsm0503_tch_fr_decode_batch(unsigned int n, uint8_t * const *tch_data,
+	const sbit_t * const *bursts, int net_order, int efr, int *n_errors,
+	int *n_bits_total, int *rc);
 
 int gsm0503_tch_hr_encode(ubit_t *bursts, const uint8_t *tch_data, int len);
 int gsm0503_tch_hr_decode(uint8_t *tch_data, const sbit_t *bursts, int odd,
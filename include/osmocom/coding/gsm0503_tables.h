@@ -48,6 +48,16 @@ extern const uint8_t gsm0503_puncture_mcs9_p1[1836];
 extern const uint8_t gsm0503_puncture_mcs9_p2[1836];
 extern const uint8_t gsm0503_puncture_mcs9_p3[1836];
 extern const uint16_t gsm0503_interleave_mcs5[1248];
+extern const uint16_t gsm0503_interleave_xcch[456];
+extern const uint16_t gsm0503_interleave_xcch_burst[456];
+extern const uint16_t gsm0503_interleave_tch_fr[456];
+extern const uint16_t gsm0503_interleave_tch_fr_burst[456];
+extern const uint16_t gsm0503_interleave_mcs5_ul_hdr[136];
+extern const uint16_t gsm0503_interleave_mcs5_dl_hdr[100];
+extern const uint16_t gsm0503_interleave_mcs7_dl_hdr[124];
+extern const uint16_t gsm0503_interleave_mcs7_ul_hdr[160];
+extern const uint16_t gsm0503_interleave_mcs7[1224];
+extern const uint16_t gsm0503_interleave_mcs8[1224];
 extern const uint8_t gsm0503_gsm_fr_map[76];
 extern const uint8_t gsm0503_gsm_efr_protected_bits[65];
 extern const ubit_t gsm0503_afs_ic_ubit[4][8];
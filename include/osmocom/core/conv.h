@@ -134,6 +134,31 @@ int osmo_conv_decode_get_output(struct osmo_conv_decoder *decoder,
 	/* All-in-one */
 int osmo_conv_decode(const struct osmo_conv_code *code,
                      const sbit_t *input, ubit_t *output);
+int osmo_conv_decode_ber(const struct osmo_conv_code *code,
+                         const sbit_t *input, ubit_t *output,
+                         int *n_errors, int *n_bits_total);
+int osmo_conv_decode_ber_punctured(const struct osmo_conv_code *code,
+                                   const sbit_t *input, ubit_t *output,
+                                   int *n_errors, int *n_bits_total,
+                                   const uint8_t *data_punc);
+
+	/* Accelerated decoder, reusable (K=5 and K=7 codes with N<=7 only) */
+
+struct osmo_conv_acc_decoder;
+
+struct osmo_conv_acc_decoder *osmo_conv_acc_decoder_alloc(const struct osmo_conv_code *code);
+void osmo_conv_acc_decoder_free(struct osmo_conv_acc_decoder *dec);
+int osmo_conv_acc_decoder_decode(struct osmo_conv_acc_decoder *dec,
+                                 const sbit_t *input, ubit_t *output);
+void osmo_conv_acc_cache_flush(void);
+
+	/* Batch decoding of several sequences of the same code */
+int osmo_conv_decode_batch(const struct osmo_conv_code *code,
+                           const sbit_t * const *input, ubit_t * const *output,
+                           unsigned int n);
+int osmo_conv_decode_batch_ber(const struct osmo_conv_code *code,
+                               const sbit_t * const *input, ubit_t * const *output,
+                               unsigned int n, int *n_errors, int *n_bits_total);
 
 
 /*! @} */
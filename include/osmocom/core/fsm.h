@@ -118,6 +118,11 @@ struct osmo_fsm_inst {
 		/*! Indicator whether osmo_fsm_inst_term() was already invoked on this instance. */
 		bool terminating;
 	} proc;
+
+	/*! \ref hlist_node in the table of instances by id, see osmo_fsm_inst_find_by_id() */
+	struct hlist_node id_node;
+	/*! \ref hlist_node in the table of instances by name, see osmo_fsm_inst_find_by_name() */
+	struct hlist_node name_node;
 };
 
 void osmo_fsm_log_addr(bool log_addr);
@@ -202,13 +207,29 @@ void osmo_fsm_set_dealloc_ctx(void *ctx);
 #define OSMO_T_FMT "%c%u"
 #define OSMO_T_FMT_ARGS(T) ((T) >= 0 ? 'T' : 'X'), ((T) >= 0 ? T : -T)
 
+/*! Position in the instances of all registered FSMs which stays valid
+ *  while instances are freed, for walking them piecewise */
+struct osmo_fsm_inst_cursor {
+	/*! entry in the list of started cursors */
+	struct llist_head list;
+	/*! list entry of the current FSM; the list head at the end */
+	struct llist_head *fsm;
+	/*! list entry of the instance returned next; the list head at the
+	 *  end of the instances of the current FSM */
+	struct llist_head *next;
+};
+
 int osmo_fsm_register(struct osmo_fsm *fsm);
 void osmo_fsm_unregister(struct osmo_fsm *fsm);
+int osmo_fsm_set_inst_pool(struct osmo_fsm *fsm, unsigned int max_free);
 struct osmo_fsm *osmo_fsm_find_by_name(const char *name);
 struct osmo_fsm_inst *osmo_fsm_inst_find_by_name(const struct osmo_fsm *fsm,
 						 const char *name);
 struct osmo_fsm_inst *osmo_fsm_inst_find_by_id(const struct osmo_fsm *fsm,
 						const char *id);
+void osmo_fsm_inst_cursor_start(struct osmo_fsm_inst_cursor *cur);
+struct osmo_fsm_inst *osmo_fsm_inst_cursor_next(struct osmo_fsm_inst_cursor *cur);
+void osmo_fsm_inst_cursor_stop(struct osmo_fsm_inst_cursor *cur);
 struct osmo_fsm_inst *osmo_fsm_inst_alloc(struct osmo_fsm *fsm, void *ctx, void *priv,
 					  int log_level, const char *id);
 struct osmo_fsm_inst *osmo_fsm_inst_alloc_child(struct osmo_fsm *fsm,
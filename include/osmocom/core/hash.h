@@ -0,0 +1,80 @@
+/*! \file hash.h
+ * Fast hashing of integer values, adapted from the Linux kernel, and of
+ * strings. */
+/*
+ * Based on include/linux/hash.h of the Linux kernel:
+ * (C) 2002 Nadia Yvette Chambers, IBM
+ *
+ * This source code is licensed under the GNU General Public License,
+ * Version 2. See the file COPYING for more details.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#pragma once
+
+/*! \defgroup hash Hashing of integer values and strings
+ *  @{
+ * \file hash.h */
+
+#include <stdint.h>
+
+/*
+ * The "golden ratio" multipliers of the kernel's multiplicative
+ * hashing: the top bits of the product are well mixed, so the hash is
+ * taken from the top, never the bottom, bits.
+ */
+#define GOLDEN_RATIO_32 0x61C88647
+#define GOLDEN_RATIO_64 0x61C8864680B583EBull
+
+static inline uint32_t __hash_32(uint32_t val)
+{
+	return val * GOLDEN_RATIO_32;
+}
+
+/*! Hash a 32 bit value.
+ *  \param[in] val value to hash.
+ *  \param[in] bits number of bits of the result, 1..32.
+ *  \returns hash of \a val in the range 0 .. (1 << bits) - 1. */
+static inline uint32_t hash_32(uint32_t val, unsigned int bits)
+{
+	/* High bits are more random, so use them. */
+	return __hash_32(val) >> (32 - bits);
+}
+
+/*! Hash a 64 bit value.
+ *  \param[in] val value to hash.
+ *  \param[in] bits number of bits of the result, 1..32.
+ *  \returns hash of \a val in the range 0 .. (1 << bits) - 1. */
+static inline uint32_t hash_64(uint64_t val, unsigned int bits)
+{
+	/* 64x64-bit multiply is efficient on all 64-bit processors */
+	return val * GOLDEN_RATIO_64 >> (64 - bits);
+}
+
+/*! Hash a value of type long; see hash_32() and hash_64(). */
+#define hash_long(val, bits) \
+	(sizeof(long) == 8 ? hash_64(val, bits) : hash_32(val, bits))
+
+/*! Hash a pointer value; see hash_32() and hash_64(). */
+static inline uint32_t hash_ptr(const void *ptr, unsigned int bits)
+{
+	return hash_long((unsigned long)ptr, bits);
+}
+
+/*! FNV-1a hash of a NUL-terminated string.  Unlike hash_32(), all 32
+ *  bits of the result are mixed, so it may be masked to a table size
+ *  directly; it is a 32 bit key for hash_32() as well.
+ *  \param[in] str string to hash
+ *  \returns 32 bit hash of \a str */
+static inline uint32_t osmo_fnv1a(const char *str)
+{
+	uint32_t h = 2166136261u;
+
+	while (*str) {
+		h ^= (uint8_t)*str++;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+/*! @} */
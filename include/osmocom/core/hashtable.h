@@ -0,0 +1,137 @@
+/*! \file hashtable.h
+ * Statically sized hash tables of hlists, adapted from the Linux kernel. */
+/*
+ * Based on include/linux/hashtable.h of the Linux kernel:
+ * (C) 2012  Sasha Levin <levinsasha928@gmail.com>
+ *
+ * This source code is licensed under the GNU General Public License,
+ * Version 2. See the file COPYING for more details.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#pragma once
+
+/*! \defgroup hashtable Hash tables
+ *  @{
+ * \file hashtable.h
+ *
+ * A hash table is an array of 2^bits \ref hlist_head buckets.  The
+ * objects are linked into the buckets by an embedded \ref hlist_node;
+ * the key is an integer (e.g. an ID, a pointer or a hash of a string),
+ * objects with colliding keys share a bucket.  The table does not own
+ * nor compare the objects: lookups iterate over the bucket of a key
+ * with hash_for_each_possible() and compare the full key themselves. */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <osmocom/core/linuxlist.h>
+#include <osmocom/core/hash.h>
+
+/*! Define a hash table of 2^bits buckets. */
+#define DEFINE_HASHTABLE(name, bits)						\
+	struct hlist_head name[1 << (bits)] =					\
+			{ [0 ... ((1 << (bits)) - 1)] = HLIST_HEAD_INIT }
+
+/*! Declare a hash table of 2^bits buckets, e.g. as a struct member. */
+#define DECLARE_HASHTABLE(name, bits)						\
+	struct hlist_head name[1 << (bits)]
+
+/*! Number of buckets of a hash table. */
+#define HASH_SIZE(name) (sizeof(name) / sizeof((name)[0]))
+/*! Number of bits of a hash table. */
+#define HASH_BITS(name) ((unsigned int)__builtin_ctz(HASH_SIZE(name)))
+
+/* Use hash_32 when possible to allow for fast 32bit hashing in 64bit kernels. */
+#define hash_min(val, bits)							\
+	(sizeof(val) <= 4 ? hash_32(val, bits) : hash_long(val, bits))
+
+static inline void __hash_init(struct hlist_head *ht, unsigned int sz)
+{
+	unsigned int i;
+
+	for (i = 0; i < sz; i++)
+		INIT_HLIST_HEAD(&ht[i]);
+}
+
+/*! Initialize a hash table.
+ *  \param[in] hashtable hash table to be initialized. */
+#define hash_init(hashtable) __hash_init(hashtable, HASH_SIZE(hashtable))
+
+/*! Add an object to a hash table.
+ *  \param[in] hashtable hash table to add to.
+ *  \param[in] node the &struct hlist_node of the object to be added.
+ *  \param[in] key the key of the object to be added. */
+#define hash_add(hashtable, node, key)						\
+	hlist_add_head(node, &hashtable[hash_min(key, HASH_BITS(hashtable))])
+
+/*! Check whether an object is in any hash table.
+ *  \param[in] node the &struct hlist_node of the object to be checked. */
+static inline bool hash_hashed(struct hlist_node *node)
+{
+	return !hlist_unhashed(node);
+}
+
+static inline bool __hash_empty(struct hlist_head *ht, unsigned int sz)
+{
+	unsigned int i;
+
+	for (i = 0; i < sz; i++)
+		if (!hlist_empty(&ht[i]))
+			return false;
+
+	return true;
+}
+
+/*! Check whether a hash table is empty.
+ *  \param[in] hashtable hash table to check. */
+#define hash_empty(hashtable) __hash_empty(hashtable, HASH_SIZE(hashtable))
+
+/*! Remove an object from a hash table.
+ *  \param[in] node &struct hlist_node of the object to remove. */
+static inline void hash_del(struct hlist_node *node)
+{
+	hlist_del_init(node);
+}
+
+/*! Iterate over a hash table.
+ *  \param[in] name hash table to iterate.
+ *  \param[in] bkt integer to use as bucket loop cursor.
+ *  \param[out] obj the type * to use as a loop cursor for each entry.
+ *  \param[in] member the name of the hlist_node within the struct. */
+#define hash_for_each(name, bkt, obj, member)					\
+	for ((bkt) = 0, obj = NULL; obj == NULL && (bkt) < HASH_SIZE(name);	\
+			(bkt)++)						\
+		hlist_for_each_entry(obj, &name[bkt], member)
+
+/*! Iterate over a hash table, safe against removal of a hash entry.
+ *  \param[in] name hash table to iterate.
+ *  \param[in] bkt integer to use as bucket loop cursor.
+ *  \param[out] tmp a &struct hlist_node used for temporary storage.
+ *  \param[out] obj the type * to use as a loop cursor for each entry.
+ *  \param[in] member the name of the hlist_node within the struct. */
+#define hash_for_each_safe(name, bkt, tmp, obj, member)				\
+	for ((bkt) = 0, obj = NULL; obj == NULL && (bkt) < HASH_SIZE(name);	\
+			(bkt)++)						\
+		hlist_for_each_entry_safe(obj, tmp, &name[bkt], member)
+
+/*! Iterate over all possible objects hashing to the same bucket as a key.
+ *  \param[in] name hash table to iterate.
+ *  \param[out] obj the type * to use as a loop cursor for each entry.
+ *  \param[in] member the name of the hlist_node within the struct.
+ *  \param[in] key the key of the objects to iterate over. */
+#define hash_for_each_possible(name, obj, member, key)				\
+	hlist_for_each_entry(obj, &name[hash_min(key, HASH_BITS(name))], member)
+
+/*! Iterate over all possible objects hashing to the same bucket as a key,
+ *  safe against removal of a hash entry.
+ *  \param[in] name hash table to iterate.
+ *  \param[out] obj the type * to use as a loop cursor for each entry.
+ *  \param[out] tmp a &struct hlist_node used for temporary storage.
+ *  \param[in] member the name of the hlist_node within the struct.
+ *  \param[in] key the key of the objects to iterate over. */
+#define hash_for_each_possible_safe(name, obj, tmp, member, key)		\
+	hlist_for_each_entry_safe(obj, tmp,					\
+		&name[hash_min(key, HASH_BITS(name))], member)
+
+/*! @} */
@@ -0,0 +1,64 @@
+/*! \file it_msgq.h
+ * Inter-thread msgb queue on top of a lock-free ring buffer. */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+#pragma once
+
+/*! \defgroup osmo_it_msgq Osmocom inter-thread msgb queues
+ *  @{
+ * \file it_msgq.h */
+
+#include <osmocom/core/msgb.h>
+#include <osmocom/core/ring.h>
+#include <osmocom/core/select.h>
+
+struct osmo_it_msgq;
+
+/*! call-back for each msgb dequeued in the consumer's select loop.
+ *  Ownership of \a msg is transferred to the call-back. */
+typedef void osmo_it_msgq_read_cb(struct osmo_it_msgq *q, struct msgb *msg);
+
+/*! Inter-thread msgb queue: producer thread(s) enqueue msgbs, which are
+ *  handed to \ref read_cb from the osmo_select_main() loop of the thread
+ *  which allocated the queue. */
+struct osmo_it_msgq {
+	/*! human-readable name, used for logging */
+	const char *name;
+	/*! lock-free ring buffer holding the msgb pointers */
+	struct osmo_ring *ring;
+	/*! eventfd registered with the consumer thread's select loop */
+	struct osmo_fd event_ofd;
+	/*! non-zero while a wake-up is signalled but not yet handled */
+	int wakeup_pending;
+	/*! maximum number of msgbs handed to \ref read_cb per wake-up (0 = all) */
+	unsigned int batch_max;
+	/*! call-back for each dequeued msgb */
+	osmo_it_msgq_read_cb *read_cb;
+	/*! opaque data pointer for the user */
+	void *data;
+};
+
+struct osmo_it_msgq *osmo_it_msgq_alloc(void *ctx, const char *name, enum osmo_ring_type type,
+					unsigned int max_length, osmo_it_msgq_read_cb *read_cb,
+					void *data);
+void osmo_it_msgq_destroy(struct osmo_it_msgq *q);
+int osmo_it_msgq_enqueue(struct osmo_it_msgq *q, struct msgb *msg);
+struct msgb *osmo_it_msgq_dequeue(struct osmo_it_msgq *q);
+void osmo_it_msgq_flush(struct osmo_it_msgq *q);
+
+/*! @} */
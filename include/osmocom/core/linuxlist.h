@@ -393,6 +393,122 @@ static inline unsigned int llist_count(const struct llist_head *head)
 	return i;
 }
 
+/*
+ * Double linked lists with a single pointer list head.
+ * Mostly useful for hash tables where the two pointer list head is
+ * too wasteful.  You lose the ability to access the tail in O(1).
+ */
+
+/*! hlist head: a single pointer to the first node */
+struct hlist_head {
+	struct hlist_node *first;
+};
+
+/*! hlist node: next pointer and pointer to the previous next pointer */
+struct hlist_node {
+	struct hlist_node *next, **pprev;
+};
+
+#define HLIST_HEAD_INIT { .first = NULL }
+#define HLIST_HEAD(name) struct hlist_head name = {  .first = NULL }
+#define INIT_HLIST_HEAD(ptr) ((ptr)->first = NULL)
+
+/*! Initialize an hlist node, so that hlist_unhashed() is true for it. */
+static inline void INIT_HLIST_NODE(struct hlist_node *h)
+{
+	h->next = NULL;
+	h->pprev = NULL;
+}
+
+/*! Has the node been removed from its list (or never been added)?
+ *  \param[in] h the node to check. */
+static inline int hlist_unhashed(const struct hlist_node *h)
+{
+	return !h->pprev;
+}
+
+/*! Is the specified hlist_head structure an empty hlist?
+ *  \param[in] h the hlist to check. */
+static inline int hlist_empty(const struct hlist_head *h)
+{
+	return !h->first;
+}
+
+static inline void __hlist_del(struct hlist_node *n)
+{
+	struct hlist_node *next = n->next;
+	struct hlist_node **pprev = n->pprev;
+
+	*pprev = next;
+	if (next)
+		next->pprev = pprev;
+}
+
+/*! Delete the specified hlist_node from its list.
+ *  \param[in] n the node to delete.
+ *  Note: hlist_unhashed() on the node does not return true after this. */
+static inline void hlist_del(struct hlist_node *n)
+{
+	__hlist_del(n);
+	n->next = (struct hlist_node *)LLIST_POISON1;
+	n->pprev = (struct hlist_node **)LLIST_POISON2;
+}
+
+/*! Delete the specified hlist_node from its list and reinitialize it,
+ *  if it is on a list at all.
+ *  \param[in] n the node to delete. */
+static inline void hlist_del_init(struct hlist_node *n)
+{
+	if (!hlist_unhashed(n)) {
+		__hlist_del(n);
+		INIT_HLIST_NODE(n);
+	}
+}
+
+/*! Add a new entry at the beginning of the hlist.
+ *  \param[in] n new entry to be added.
+ *  \param[in] h hlist head to add it after. */
+static inline void hlist_add_head(struct hlist_node *n, struct hlist_head *h)
+{
+	struct hlist_node *first = h->first;
+	n->next = first;
+	if (first)
+		first->pprev = &n->next;
+	h->first = n;
+	n->pprev = &h->first;
+}
+
+/*! Get the struct for this hlist entry.
+ *  \param[in] ptr    the &struct hlist_node pointer.
+ *  \param[in] type   the type of the struct this is embedded in.
+ *  \param[in] member the name of the hlist_node within the struct. */
+#define hlist_entry(ptr, type, member) container_of(ptr,type,member)
+
+/*! Get the struct for this hlist entry, or NULL if ptr is NULL. */
+#define hlist_entry_safe(ptr, type, member) \
+	({ typeof(ptr) ____ptr = (ptr); \
+	   ____ptr ? hlist_entry(____ptr, type, member) : NULL; \
+	})
+
+/*! Iterate over an hlist of given type.
+ *  \param[out] pos    the type * to use as a loop cursor.
+ *  \param[in]  head   the head for your hlist.
+ *  \param[in]  member the name of the hlist_node within the struct. */
+#define hlist_for_each_entry(pos, head, member)				\
+	for (pos = hlist_entry_safe((head)->first, typeof(*(pos)), member);\
+	     pos;							\
+	     pos = hlist_entry_safe((pos)->member.next, typeof(*(pos)), member))
+
+/*! Iterate over an hlist of given type, safe against removal of hlist entry.
+ *  \param[out] pos    the type * to use as a loop cursor.
+ *  \param[out] n      a &struct hlist_node to use as temporary storage.
+ *  \param[in]  head   the head for your hlist.
+ *  \param[in]  member the name of the hlist_node within the struct. */
+#define hlist_for_each_entry_safe(pos, n, head, member) 		\
+	for (pos = hlist_entry_safe((head)->first, typeof(*pos), member);\
+	     pos && ({ n = pos->member.next; 1; });			\
+	     pos = hlist_entry_safe(n, typeof(*pos), member))
+
 /*!
  *  @}
  */
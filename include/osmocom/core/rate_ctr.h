@@ -25,12 +25,18 @@ struct rate_ctr_per_intv {
 	uint64_t rate;		/*!< counter rate */
 };
 
+struct rate_ctr_group;
+
 /*! data we keep for each actual value */
 struct rate_ctr {
 	uint64_t current;	/*!< current value */
 	uint64_t previous;	/*!< previous value, used for delta */
-	/*! per-interval data */
+	/*! per-interval data.  The rates of a group are computed lazily:
+	 *  call rate_ctr_group_aggregate() on the group before reading them,
+	 *  they may be out of date otherwise. */
 	struct rate_ctr_per_intv intv[RATE_CTR_INTV_NUM];
+	/*! back-reference to the group, to track changes; NULL for stand-alone counters */
+	struct rate_ctr_group *group;
 };
 
 /*! rate counter description */
@@ -53,6 +59,9 @@ struct rate_ctr_group_desc {
 	const struct rate_ctr_desc *ctr_desc;
 };
 
+struct rate_ctr_group_shards;
+struct osmo_name_index;
+
 /*! One instance of a counter group class */
 struct rate_ctr_group {
 	/*! Linked list of all counter groups in the system */
@@ -61,6 +70,18 @@ struct rate_ctr_group {
 	const struct rate_ctr_group_desc *desc;
 	/*! The index of this ctr_group within its class */
 	unsigned int idx;
+	/*! Per-thread increments not yet folded into \ref rate_ctr.current,
+	 *  NULL unless rate_ctr_group_enable_shards() was called */
+	struct rate_ctr_group_shards *shards;
+	/*! Second up to which the \ref rate_ctr.intv rates were computed */
+	uint64_t intv_tick;
+	/*! Entry in the list of groups changed since they were last reported;
+	 *  empty while the group is unchanged */
+	struct llist_head dirty_list;
+	/*! Entry in the hash table of groups by name and index */
+	struct hlist_node name_idx_node;
+	/*! Index of the counter names of \ref desc, shared by all its groups */
+	struct osmo_name_index *desc_index;
 	/*! Actual counter structures below */
 	struct rate_ctr ctr[0];
 };
@@ -69,10 +90,7 @@ struct rate_ctr_group *rate_ctr_group_alloc(void *ctx,
 					    const struct rate_ctr_group_desc *desc,
 					    unsigned int idx);
 
-static inline void rate_ctr_group_upd_idx(struct rate_ctr_group *grp, unsigned int idx)
-{
-	grp->idx = idx;
-}
+void rate_ctr_group_upd_idx(struct rate_ctr_group *grp, unsigned int idx);
 
 void rate_ctr_group_free(struct rate_ctr_group *grp);
 
@@ -88,12 +106,28 @@ static inline void rate_ctr_inc(struct rate_ctr *ctr)
 	rate_ctr_add(ctr, 1);
 }
 
+int rate_ctr_group_enable_shards(struct rate_ctr_group *ctrg, unsigned int num_shards);
+void rate_ctr_group_shard_add(struct rate_ctr_group *ctrg, unsigned int idx, int inc);
+void rate_ctr_group_aggregate(struct rate_ctr_group *ctrg);
+
+/*! Increment the counter by \a inc; thread-safe for groups with shards
+ *  \param ctrg \ref rate_ctr_group of counter
+ *  \param idx index into \a ctrg counter group
+ *  \param inc quantity to increment the counter by */
+static inline void rate_ctr_add2(struct rate_ctr_group *ctrg, unsigned int idx, int inc)
+{
+	if (ctrg->shards)
+		rate_ctr_group_shard_add(ctrg, idx, inc);
+	else
+		rate_ctr_add(&ctrg->ctr[idx], inc);
+}
+
 /*! Increment the counter by 1
  *  \param ctrg \ref rate_ctr_group of counter
  *  \param idx index into \a ctrg counter group */
 static inline void rate_ctr_inc2(struct rate_ctr_group *ctrg, unsigned int idx)
 {
-	rate_ctr_inc(&ctrg->ctr[idx]);
+	rate_ctr_add2(ctrg, idx, 1);
 }
 
 
@@ -116,6 +150,22 @@ int rate_ctr_for_each_counter(struct rate_ctr_group *ctrg,
 
 int rate_ctr_for_each_group(rate_ctr_group_handler_t handle_group, void *data);
 
+/*! Position in the list of all counter groups which stays valid while
+ *  groups are freed, for walking the list piecewise */
+struct rate_ctr_group_cursor {
+	/*! entry in the list of started cursors */
+	struct llist_head list;
+	/*! list entry of the group returned next; the list head at the end */
+	struct llist_head *next;
+};
+
+void rate_ctr_group_cursor_start(struct rate_ctr_group_cursor *cur);
+struct rate_ctr_group *rate_ctr_group_cursor_next(struct rate_ctr_group_cursor *cur);
+void rate_ctr_group_cursor_stop(struct rate_ctr_group_cursor *cur);
+int rate_ctr_for_each_dirty_group(rate_ctr_group_handler_t handle_group, void *data,
+				  unsigned int max_groups);
+void rate_ctr_mark_all_dirty(void);
+
 void rate_ctr_reset(struct rate_ctr *ctr);
 void rate_ctr_group_reset(struct rate_ctr_group *ctrg);
 
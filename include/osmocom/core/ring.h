@@ -0,0 +1,74 @@
+/*! \file ring.h
+ * Lock-free bounded ring buffers for passing data between threads. */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+#pragma once
+
+/*! \defgroup osmo_ring Osmocom lock-free ring buffers
+ *  @{
+ * \file ring.h */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*! Size of a CPU cache line, used to keep producer and consumer state apart */
+#define OSMO_CACHELINE_SIZE	64
+
+/*! Concurrency model of a \ref osmo_ring */
+enum osmo_ring_type {
+	/*! exactly one producer thread and one consumer thread */
+	OSMO_RING_SPSC,
+	/*! any number of producer threads and one consumer thread */
+	OSMO_RING_MPSC,
+};
+
+struct osmo_ring;
+
+struct osmo_ring *osmo_ring_alloc(void *ctx, enum osmo_ring_type type,
+				  unsigned int num_elem, size_t elem_size);
+void osmo_ring_free(struct osmo_ring *ring);
+
+int osmo_ring_enqueue(struct osmo_ring *ring, const void *elem);
+bool osmo_ring_dequeue(struct osmo_ring *ring, void *elem);
+
+unsigned int osmo_ring_count(const struct osmo_ring *ring);
+unsigned int osmo_ring_size(const struct osmo_ring *ring);
+size_t osmo_ring_elem_size(const struct osmo_ring *ring);
+enum osmo_ring_type osmo_ring_get_type(const struct osmo_ring *ring);
+
+/*! Enqueue a single pointer into a ring allocated with elem_size == sizeof(void *)
+ *  \param[in] ring ring buffer to which to append
+ *  \param[in] ptr pointer value to append
+ *  \returns 0 on success; -ENOSPC if the ring is full */
+static inline int osmo_ring_enqueue_ptr(struct osmo_ring *ring, void *ptr)
+{
+	return osmo_ring_enqueue(ring, &ptr);
+}
+
+/*! Dequeue a single pointer from a ring allocated with elem_size == sizeof(void *)
+ *  \param[in] ring ring buffer from which to dequeue
+ *  \returns dequeued pointer; NULL if the ring is empty */
+static inline void *osmo_ring_dequeue_ptr(struct osmo_ring *ring)
+{
+	void *ptr;
+	if (!osmo_ring_dequeue(ring, &ptr))
+		return NULL;
+	return ptr;
+}
+
+/*! @} */
@@ -85,5 +85,17 @@ struct osmo_signalfd {
 struct osmo_signalfd *
 osmo_signalfd_setup(void *ctx, sigset_t set, osmo_signalfd_cb *cb, void *data);
 
+/* cross-thread task posting */
+struct osmo_loop;
+
+/*! closure executed in the select loop to which it was posted */
+typedef void osmo_loop_task_cb(void *data);
+
+int osmo_loop_init(void *ctx, unsigned int max_tasks);
+void osmo_loop_exit(void);
+struct osmo_loop *osmo_loop_self(void);
+int osmo_loop_post(struct osmo_loop *loop, osmo_loop_task_cb *cb, void *data);
+int osmo_loop_run_tasks(void);
+
 
 /*! @} */
@@ -0,0 +1,36 @@
+#pragma once
+
+/*! \defgroup simd_internal Selection of the SIMD kernels
+ *  @{
+ *  For tests and benchmarks only: the kernels are selected once when
+ *  libosmocore is loaded, these functions override that selection.  They
+ *  are not thread-safe, no other thread may use the kernels meanwhile.
+ * \file simd_internal.h */
+
+#include <osmocom/core/utils.h>
+
+/* only in builds with HAVE_PCLMUL */
+int osmo_crc_clmul_enable(int enable);
+/* only in builds with HAVE_AVX2 */
+int osmo_bits_avx2_enable(int enable);
+
+/*! SIMD instruction sets of the accelerated decoder, the x86 ones in
+ *  increasing order */
+enum osmo_conv_simd {
+	OSMO_CONV_SIMD_GEN,	/*!< portable C only */
+	OSMO_CONV_SIMD_SSSE3,	/*!< SSSE3, and SSE4.1 if supported */
+	OSMO_CONV_SIMD_AVX2,	/*!< AVX2 */
+	OSMO_CONV_SIMD_AVX512,	/*!< AVX-512BW/VL, on top of AVX2 */
+	OSMO_CONV_SIMD_NEON,	/*!< ARM NEON */
+};
+
+extern const struct value_string osmo_conv_simd_names[];
+static inline const char *osmo_conv_simd_name(enum osmo_conv_simd simd)
+{
+	return get_value_string(osmo_conv_simd_names, simd);
+}
+
+int osmo_conv_simd_limit(enum osmo_conv_simd max);
+enum osmo_conv_simd osmo_conv_simd_get(void);
+
+/*! @} */
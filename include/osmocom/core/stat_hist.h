@@ -0,0 +1,125 @@
+#pragma once
+
+/*! \defgroup osmo_stat_hist Statistics histogram
+ *  @{
+ * \file stat_hist.h */
+
+#include <stdint.h>
+
+#include <osmocom/core/linuxlist.h>
+
+/*! Number of bits of each value kept in addition to its magnitude.
+ *  Values are recorded with a relative error of at most 1/2^OSMO_STAT_HIST_SUB_BITS. */
+#define OSMO_STAT_HIST_SUB_BITS		3
+/*! Number of buckets per power of two */
+#define OSMO_STAT_HIST_SUB_BUCKETS	(1 << OSMO_STAT_HIST_SUB_BITS)
+/*! Number of buckets covering all uint32_t values */
+#define OSMO_STAT_HIST_NUM_BUCKETS	((32 - OSMO_STAT_HIST_SUB_BITS + 1) * OSMO_STAT_HIST_SUB_BUCKETS)
+
+/*! Histogram description */
+struct osmo_stat_hist_desc {
+	const char *name;	/*!< name of the histogram */
+	const char *description;/*!< description of the histogram */
+	const char *unit;	/*!< unit of a value */
+};
+
+/*! data we keep for each actual histogram */
+struct osmo_stat_hist {
+	/*! back-reference to the histogram description */
+	const struct osmo_stat_hist_desc *desc;
+	/*! number of recorded values */
+	uint64_t count;
+	/*! sum of all recorded values */
+	uint64_t sum;
+	/*! smallest recorded value, UINT32_MAX if none */
+	uint32_t min;
+	/*! largest recorded value */
+	uint32_t max;
+	/*! bucket contents as of the last stats report, NULL until the first report */
+	uint32_t *reported;
+	/*! number of recorded values per bucket */
+	uint32_t buckets[OSMO_STAT_HIST_NUM_BUCKETS];
+};
+
+/*! Description of a histogram group */
+struct osmo_stat_hist_group_desc {
+	/*! The prefix to the name of all histograms in this group */
+	const char *group_name_prefix;
+	/*! The human-readable description of the group */
+	const char *group_description;
+	/*! The class to which this group belongs */
+	int class_id;
+	/*! The number of histograms in this group (size of hist_desc) */
+	unsigned int num_hists;
+	/*! Pointer to array of histogram descriptions, length as per num_hists */
+	const struct osmo_stat_hist_desc *hist_desc;
+};
+
+/*! One instance of a histogram group class */
+struct osmo_stat_hist_group {
+	/*! Linked list of all histogram groups in the system */
+	struct llist_head list;
+	/*! Pointer to the histogram group class */
+	const struct osmo_stat_hist_group_desc *desc;
+	/*! The index of this histogram group within its class */
+	unsigned int idx;
+	/*! Actual histograms below */
+	struct osmo_stat_hist hist[0];
+};
+
+/*! Summary of the values recorded in a histogram */
+struct osmo_stat_hist_summary {
+	uint64_t count;		/*!< number of values */
+	uint32_t min;		/*!< smallest value (0 if count is 0) */
+	uint32_t max;		/*!< largest value */
+	uint32_t p50;		/*!< median */
+	uint32_t p90;		/*!< 90th percentile */
+	uint32_t p99;		/*!< 99th percentile */
+	uint32_t p999;		/*!< 99.9th percentile */
+};
+
+struct osmo_stat_hist_group *osmo_stat_hist_group_alloc(void *ctx,
+							 const struct osmo_stat_hist_group_desc *desc,
+							 unsigned int idx);
+void osmo_stat_hist_group_free(struct osmo_stat_hist_group *histg);
+
+void osmo_stat_hist_record(struct osmo_stat_hist *hist, uint32_t value);
+
+/*! Record a value in a histogram of a group
+ *  \param histg \ref osmo_stat_hist_group of the histogram
+ *  \param idx index into \a histg histogram group
+ *  \param value value to record */
+static inline void osmo_stat_hist_record2(struct osmo_stat_hist_group *histg, unsigned int idx,
+					  uint32_t value)
+{
+	osmo_stat_hist_record(&histg->hist[idx], value);
+}
+
+unsigned int osmo_stat_hist_bucket(uint32_t value);
+uint32_t osmo_stat_hist_bucket_max(unsigned int bucket);
+
+uint32_t osmo_stat_hist_get_percentile(const struct osmo_stat_hist *hist, double percentile);
+void osmo_stat_hist_get_summary(const struct osmo_stat_hist *hist, struct osmo_stat_hist_summary *sum);
+void osmo_stat_hist_summarize_buckets(const uint32_t *buckets, uint32_t min, uint32_t max,
+				      struct osmo_stat_hist_summary *sum);
+
+int osmo_stat_hist_init(void *tall_ctx);
+
+struct osmo_stat_hist_group *osmo_stat_hist_get_group_by_name_idx(const char *name,
+								  const unsigned int idx);
+const struct osmo_stat_hist *osmo_stat_hist_get_by_name(const struct osmo_stat_hist_group *histg,
+							const char *name);
+
+typedef int (*osmo_stat_hist_handler_t)(struct osmo_stat_hist_group *, struct osmo_stat_hist *, void *);
+
+typedef int (*osmo_stat_hist_group_handler_t)(struct osmo_stat_hist_group *, void *);
+
+int osmo_stat_hist_for_each_hist(struct osmo_stat_hist_group *histg,
+				 osmo_stat_hist_handler_t handle_hist, void *data);
+
+int osmo_stat_hist_for_each_group(osmo_stat_hist_group_handler_t handle_group, void *data);
+
+void osmo_stat_hist_reset(struct osmo_stat_hist *hist);
+void osmo_stat_hist_group_reset(struct osmo_stat_hist_group *histg);
+
+/*! @} */
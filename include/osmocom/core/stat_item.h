@@ -9,6 +9,8 @@
 #include <osmocom/core/linuxlist.h>
 
 struct osmo_stat_item_desc;
+struct osmo_stat_item_group;
+struct osmo_name_index;
 
 #define OSMO_STAT_ITEM_NOVALUE_ID 0
 #define OSMO_STAT_ITEM_NO_UNIT NULL
@@ -27,6 +29,8 @@ struct osmo_stat_item {
 	int32_t last_value_index;
 	/*! offset to the freshest value in the value FIFO */
 	int16_t last_offs;
+	/*! back-reference to the group, to track changes */
+	struct osmo_stat_item_group *group;
 	/*! value FIFO */
 	struct osmo_stat_item_value values[0];
 };
@@ -62,6 +66,13 @@ struct osmo_stat_item_group {
 	const struct osmo_stat_item_group_desc *desc;
 	/*! The index of this value group within its class */
 	unsigned int idx;
+	/*! Entry in the list of groups changed since they were last reported;
+	 *  empty while the group is unchanged */
+	struct llist_head dirty_list;
+	/*! Entry in the hash table of groups by name and index */
+	struct hlist_node name_idx_node;
+	/*! Index of the item names of \ref desc, shared by all its groups */
+	struct osmo_name_index *desc_index;
 	/*! Actual counter structures below */
 	struct osmo_stat_item *items[0];
 };
@@ -71,11 +82,7 @@ struct osmo_stat_item_group *osmo_stat_item_group_alloc(
 	const struct osmo_stat_item_group_desc *desc,
 	unsigned int idx);
 
-static inline void osmo_stat_item_group_udp_idx(
-	struct osmo_stat_item_group *grp, unsigned int idx)
-{
-	grp->idx = idx;
-}
+void osmo_stat_item_group_udp_idx(struct osmo_stat_item_group *grp, unsigned int idx);
 
 void osmo_stat_item_group_free(struct osmo_stat_item_group *statg);
 
@@ -109,6 +116,10 @@ int osmo_stat_item_for_each_item(struct osmo_stat_item_group *statg,
 	osmo_stat_item_handler_t handle_item, void *data);
 
 int osmo_stat_item_for_each_group(osmo_stat_item_group_handler_t handle_group, void *data);
+int osmo_stat_item_for_each_dirty_group(osmo_stat_item_group_handler_t handle_group, void *data,
+					unsigned int max_groups);
+void osmo_stat_item_group_mark_dirty(struct osmo_stat_item_group *statg);
+void osmo_stat_item_mark_all_dirty(void);
 
 static inline int32_t osmo_stat_item_get_last(const struct osmo_stat_item *item)
 {
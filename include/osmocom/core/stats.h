@@ -42,6 +42,9 @@ struct osmo_stat_item_group;
 struct osmo_stat_item_desc;
 struct rate_ctr_group;
 struct rate_ctr_desc;
+struct osmo_stat_hist_group;
+struct osmo_stat_hist_desc;
+struct osmo_stat_hist_summary;
 
 /*! Statistics Class definitions */
 enum osmo_stats_class {
@@ -55,6 +58,7 @@ enum osmo_stats_class {
 enum osmo_stats_reporter_type {
 	OSMO_STATS_REPORTER_LOG,	/*!< libosmocore logging */
 	OSMO_STATS_REPORTER_STATSD,	/*!< statsd backend */
+	OSMO_STATS_REPORTER_PROMETHEUS,	/*!< Prometheus/OpenMetrics HTTP endpoint */
 };
 
 /*! One statistics reporter instance. */
@@ -102,10 +106,20 @@ struct osmo_stats_reporter {
 		const struct osmo_stat_item_group *statg,
 		const struct osmo_stat_item_desc *desc,
 		int64_t value);
+	/*! report the values recorded in a histogram during the last interval */
+	int (*send_hist)(struct osmo_stats_reporter *srep,
+		const struct osmo_stat_hist_group *histg,
+		const struct osmo_stat_hist_desc *desc,
+		const struct osmo_stat_hist_summary *sum);
+
+	int bind_port;		/*!< local (TCP) port of reporters accepting connections */
+	void *priv;		/*!< private state of the reporter implementation */
 };
 
 struct osmo_stats_config {
 	int interval;
+	/*! number of changed groups to report per main loop iteration, 0 for all */
+	unsigned int batch_size;
 };
 
 extern struct osmo_stats_config *osmo_stats_config;
@@ -114,6 +128,7 @@ void osmo_stats_init(void *ctx);
 int osmo_stats_report();
 
 int osmo_stats_set_interval(int interval);
+int osmo_stats_set_batch_size(unsigned int batch_size);
 
 struct osmo_stats_reporter *osmo_stats_reporter_alloc(enum osmo_stats_reporter_type type,
 	const char *name);
@@ -125,6 +140,7 @@ struct osmo_stats_reporter *osmo_stats_reporter_find(enum osmo_stats_reporter_ty
 int osmo_stats_reporter_set_remote_addr(struct osmo_stats_reporter *srep, const char *addr);
 int osmo_stats_reporter_set_remote_port(struct osmo_stats_reporter *srep, int port);
 int osmo_stats_reporter_set_local_addr(struct osmo_stats_reporter *srep, const char *addr);
+int osmo_stats_reporter_set_local_port(struct osmo_stats_reporter *srep, int port);
 int osmo_stats_reporter_set_mtu(struct osmo_stats_reporter *srep, int mtu);
 int osmo_stats_reporter_set_max_class(struct osmo_stats_reporter *srep,
 	enum osmo_stats_class class_id);
@@ -136,6 +152,7 @@ int osmo_stats_reporter_set_flush_period(struct osmo_stats_reporter *srep, unsig
 /* reporter creation */
 struct osmo_stats_reporter *osmo_stats_reporter_create_log(const char *name);
 struct osmo_stats_reporter *osmo_stats_reporter_create_statsd(const char *name);
+struct osmo_stats_reporter *osmo_stats_reporter_create_prometheus(const char *name);
 
 /* helper functions for reporter implementations */
 int osmo_stats_reporter_send(struct osmo_stats_reporter *srep, const char *data,
@@ -0,0 +1,111 @@
+/*! \file stats_shm.h
+ * Export of all statistics to a memory-mapped file. */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+#pragma once
+
+/*! \defgroup stats_shm Shared-memory statistics export
+ *  @{
+ * \file stats_shm.h */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*! Magic at the start of a stats segment */
+#define OSMO_STATS_SHM_MAGIC	"OSMOSTAT"
+/*! Version of the segment layout described below */
+#define OSMO_STATS_SHM_VERSION	1
+
+/*! Kind of statistics object an entry was exported from */
+enum osmo_stats_shm_type {
+	OSMO_STATS_SHM_T_COUNTER,	/*!< \ref osmo_counter */
+	OSMO_STATS_SHM_T_RATE_CTR,	/*!< \ref rate_ctr, current value */
+	OSMO_STATS_SHM_T_STAT_ITEM,	/*!< \ref osmo_stat_item, last value */
+	OSMO_STATS_SHM_T_STAT_HIST,	/*!< \ref osmo_stat_hist, one entry per count/percentile */
+};
+
+/*! Header at offset 0 of a stats segment.  All offsets are relative to
+ *  the start of the segment; all fields are in host byte order. */
+struct osmo_stats_shm_hdr {
+	/*! OSMO_STATS_SHM_MAGIC, not NUL-terminated */
+	char magic[8];
+	/*! OSMO_STATS_SHM_VERSION */
+	uint32_t version;
+	/*! sizeof(struct osmo_stats_shm_hdr) */
+	uint32_t hdr_len;
+	/*! sizeof(struct osmo_stats_shm_entry) */
+	uint32_t entry_len;
+	/*! process ID of the writer */
+	uint32_t pid;
+	/*! sequence lock: odd while the writer updates the segment */
+	uint64_t seq;
+	/*! size of the file; readers remap if it exceeds their mapping */
+	uint64_t size;
+	/*! number of bytes from the start of the segment holding valid data */
+	uint64_t used;
+	/*! incremented whenever entries were added, removed or renamed */
+	uint64_t generation;
+	/*! CLOCK_REALTIME of the last update, in nanoseconds */
+	uint64_t timestamp_ns;
+	/*! number of entries */
+	uint32_t num_entries;
+	/*! offset of the array of num_entries struct osmo_stats_shm_entry */
+	uint32_t entries_offs;
+};
+
+/*! One exported value */
+struct osmo_stats_shm_entry {
+	/*! the value */
+	int64_t value;
+	/*! offset of the NUL-terminated name, e.g. "bsc.0.chreq:total" */
+	uint32_t name_offs;
+	/*! index of the group the value belongs to */
+	uint32_t group_idx;
+	/*! enum osmo_stats_shm_type */
+	uint16_t type;
+	uint16_t reserved[3];
+};
+
+struct osmo_stats_shm;
+
+struct osmo_stats_shm *osmo_stats_shm_open(void *ctx, const char *path, size_t size,
+					   unsigned int interval_ms);
+int osmo_stats_shm_update(struct osmo_stats_shm *shm);
+void osmo_stats_shm_close(struct osmo_stats_shm *shm);
+
+int osmo_stats_shm_snapshot(const void *segment, size_t segment_len, void *buf, size_t buf_len);
+
+/*! Get the array of entries of a segment snapshot
+ *  \param[in] hdr start of a snapshot taken by osmo_stats_shm_snapshot()
+ *  \returns array of hdr->num_entries entries */
+static inline const struct osmo_stats_shm_entry *osmo_stats_shm_entries(const struct osmo_stats_shm_hdr *hdr)
+{
+	return (const struct osmo_stats_shm_entry *)((const char *)hdr + hdr->entries_offs);
+}
+
+/*! Get the name of an entry of a segment snapshot
+ *  \param[in] hdr start of a snapshot taken by osmo_stats_shm_snapshot()
+ *  \param[in] entry entry of the same snapshot
+ *  \returns NUL-terminated name of the entry */
+static inline const char *osmo_stats_shm_entry_name(const struct osmo_stats_shm_hdr *hdr,
+						    const struct osmo_stats_shm_entry *entry)
+{
+	return (const char *)hdr + entry->name_offs;
+}
+
+/*! @} */
@@ -21,6 +21,9 @@ struct osmo_talloc_contexts {
 
 extern __thread struct osmo_talloc_contexts *osmo_ctx;
 
+/* initialize osmo_ctx for the calling thread; done automatically for the main thread */
+int osmo_ctx_init(const char *id);
+
 /* short-hand #defines for the osmo talloc contexts (OTC) that can be used to pass
  * to the various _c functions like msgb_alloc_c() */
 #define OTC_GLOBAL (osmo_ctx->global)
@@ -35,7 +35,9 @@ enum ctrl_type {
 	CTRL_TYPE_GET_REPLY,
 	CTRL_TYPE_SET_REPLY,
 	CTRL_TYPE_TRAP,
-	CTRL_TYPE_ERROR
+	CTRL_TYPE_ERROR,
+	CTRL_TYPE_GET_BULK,
+	CTRL_TYPE_GET_BULK_REPLY
 };
 
 /*! human-readable string names for \ref ctrl_type */
@@ -72,7 +74,8 @@ struct ctrl_cmd {
 	char *id;
 	/*! node of the specified variable */
 	void *node;
-	/*! name of the variable */
+	/*! name of the variable; for GET_BULK the space-separated list of variables,
+	 *  for GET_BULK_REPLY "more" or "last" */
 	char *variable;
 	/*! value of the specified CTRL variable */
 	char *value;
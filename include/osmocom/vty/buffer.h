@@ -53,6 +53,9 @@ char *buffer_getstr(struct buffer *);
 /* Returns 1 if there is no pending data in the buffer.  Otherwise returns 0. */
 int buffer_empty(struct buffer *);
 
+/* Returns the number of bytes of pending data in the buffer. */
+size_t buffer_len(struct buffer *);
+
 typedef enum {
 	/* An I/O error occurred.  The buffer should be destroyed and the
 	   file descriptor should be closed. */
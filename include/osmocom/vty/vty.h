@@ -159,6 +159,9 @@ struct vty {
 	/*! When reading from a config file, these are the indenting characters expected for children of
 	 * the current VTY node. */
 	char *indent;
+
+	/*! Output of a command still being produced, see \ref vty_out_stream */
+	struct vty_out_stream *stream;
 };
 
 /* Small macro to determine newline is newline only or linefeed needed. */
@@ -209,6 +212,15 @@ bool vty_is_active(struct vty *vty);
 int vty_out (struct vty *, const char *, ...) VTY_PRINTF_ATTRIBUTE(2, 3);
 int vty_out_va(struct vty *vty, const char *format, va_list ap);
 int vty_out_newline(struct vty *);
+
+/*! Call-back producing the next part of the output of a command.
+ *  \param[in] vty VTY to which to print
+ *  \param[in] data as passed to \ref vty_out_stream
+ *  \returns > 0 if there is more output to produce; 0 if done; negative on error */
+typedef int (*vty_out_stream_cb_t)(struct vty *vty, void *data);
+int vty_out_stream(struct vty *vty, vty_out_stream_cb_t cb, void *data);
+bool vty_out_stream_more(struct vty *vty);
+void vty_out_stream_resume(struct vty *vty);
 int vty_read(struct vty *vty);
 //void vty_time_print (struct vty *, int);
 void vty_close (struct vty *);
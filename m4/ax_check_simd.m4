@@ -19,7 +19,7 @@
 #
 #   And defines:
 #
-#      HAVE_AVX3 / HAVE_SSSE3 / HAVE_SSE4.1
+#      HAVE_AVX3 / HAVE_SSSE3 / HAVE_SSE4.1 / HAVE_AVX512BW / HAVE_PCLMUL
 #
 # LICENSE
 #
@@ -44,6 +44,8 @@ AC_DEFUN([AX_CHECK_SIMD],
   AM_CONDITIONAL(HAVE_AVX2, false)
   AM_CONDITIONAL(HAVE_SSSE3, false)
   AM_CONDITIONAL(HAVE_SSE4_1, false)
+  AM_CONDITIONAL(HAVE_AVX512BW, false)
+  AM_CONDITIONAL(HAVE_PCLMUL, false)
 
   case $host_cpu in
     i[[3456]]86*|x86_64*|amd64*)
@@ -76,6 +78,26 @@ AC_DEFUN([AX_CHECK_SIMD],
       else
         AC_MSG_WARN([Your compiler does not support SSE4.1 instructions])
       fi
+
+      AX_CHECK_COMPILE_FLAG([-mavx512bw -mavx512vl], ax_cv_support_avx512bw_ext=yes, [])
+      if test x"$ax_cv_support_avx512bw_ext" = x"yes"; then
+        SIMD_FLAGS="$SIMD_FLAGS -mavx512bw -mavx512vl"
+        AC_DEFINE(HAVE_AVX512BW,,
+          [Support AVX-512BW (Advanced Vector Extensions 512 Byte and Word) instructions])
+        AM_CONDITIONAL(HAVE_AVX512BW, true)
+      else
+        AC_MSG_WARN([Your compiler does not support AVX-512BW instructions])
+      fi
+
+      AX_CHECK_COMPILE_FLAG([-mpclmul -mssse3], ax_cv_support_pclmul_ext=yes, [])
+      if test x"$ax_cv_support_pclmul_ext" = x"yes"; then
+        SIMD_FLAGS="$SIMD_FLAGS -mpclmul"
+        AC_DEFINE(HAVE_PCLMUL,,
+          [Support PCLMULQDQ (carry-less multiplication) instructions])
+        AM_CONDITIONAL(HAVE_PCLMUL, true)
+      else
+        AC_MSG_WARN([Your compiler does not support PCLMULQDQ instructions])
+      fi
   ;;
   esac
 
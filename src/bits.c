@@ -23,8 +23,14 @@
  */
 
 #include <stdint.h>
+#include "config.h"
 
 #include <osmocom/core/bits.h>
+#include <osmocom/core/simd_internal.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 /*! \addtogroup bits
  *  @{
@@ -37,6 +43,66 @@
  *
  * \file bits.c */
 
+#ifdef HAVE_AVX2
+/* The conversions below handle 32 bits per step with the AVX2 kernels of
+ * bits_avx2.c if the CPU supports them (detected when libosmocore is
+ * loaded), like the accelerated Viterbi decoder of conv_acc.c. */
+unsigned int osmo_ubit2pbit_avx2(pbit_t *out, const ubit_t *in, unsigned int num_bits);
+unsigned int osmo_pbit2ubit_avx2(ubit_t *out, const pbit_t *in, unsigned int num_bits);
+unsigned int osmo_ubit2sbit_avx2(sbit_t *out, const ubit_t *in, unsigned int num_bits);
+unsigned int osmo_sbit2ubit_avx2(ubit_t *out, const sbit_t *in, unsigned int num_bits);
+
+static int avx2_cpu_supported = 0;
+static int avx2_supported = 0;
+
+static __attribute__((constructor)) void on_dso_load_bits(void)
+{
+#ifdef HAVE___BUILTIN_CPU_SUPPORTS
+	avx2_cpu_supported = __builtin_cpu_supports("avx2");
+#endif
+	avx2_supported = avx2_cpu_supported;
+}
+
+/* Use the AVX2 kernels if the CPU supports them, or the SSE2 and scalar
+ * code only, e.g. to test that code on such CPUs.  Not thread-safe.
+ * Returns whether the kernels are used from now on. */
+int osmo_bits_avx2_enable(int enable)
+{
+	avx2_supported = enable && avx2_cpu_supported;
+	return avx2_supported;
+}
+#endif
+
+#ifdef __SSE2__
+/* The conversions below handle 16 bits per step with SSE2, which every
+ * x86-64 CPU has, and the remaining bits one by one as before. */
+
+/* Reverse the order of the bytes in both 64 bit halves */
+static inline __m128i sse_rev8(__m128i v)
+{
+	v = _mm_shufflelo_epi16(v, 0x1b);
+	v = _mm_shufflehi_epi16(v, 0x1b);
+	return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+/* Bytes 0..7 of v all set to in[0], bytes 8..15 to in[1] */
+static inline __m128i sse_bcast2(const pbit_t *in)
+{
+	__m128i v = _mm_cvtsi32_si128(in[0] | in[1] << 8);
+
+	v = _mm_unpacklo_epi8(v, v);
+	v = _mm_unpacklo_epi16(v, v);
+	return _mm_unpacklo_epi32(v, v);
+}
+
+/* 0xff in every byte of v that has any bit of the same byte of mask set */
+static inline __m128i sse_test8(__m128i v, __m128i mask)
+{
+	return _mm_cmpeq_epi8(_mm_and_si128(v, mask), mask);
+}
+#endif
+
+
 /*! convert unpacked bits to packed bits, return length in bytes
  *  \param[out] out output buffer of packed bits
  *  \param[in] in input buffer of unpacked bits
@@ -44,11 +110,35 @@
  */
 int osmo_ubit2pbit(pbit_t *out, const ubit_t *in, unsigned int num_bits)
 {
-	unsigned int i;
+	unsigned int i = 0;
 	uint8_t curbyte = 0;
 	pbit_t *outptr = out;
 
-	for (i = 0; i < num_bits; i++) {
+#ifdef HAVE_AVX2
+	if (avx2_supported) {
+		i = osmo_ubit2pbit_avx2(out, in, num_bits);
+		outptr += i / 8;
+	}
+#endif
+
+#ifdef __SSE2__
+	/* Any other value than 0 and 1 also sets or clears the previous bits
+	 * below, so leave those to the loop below */
+	for (; i + 16 <= num_bits; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *) &in[i]);
+		int m;
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8(~1)),
+						     _mm_setzero_si128())) != 0xffff)
+			break;
+
+		m = _mm_movemask_epi8(_mm_slli_epi16(sse_rev8(v), 7));
+		*outptr++ = m;
+		*outptr++ = m >> 8;
+	}
+#endif
+
+	for (; i < num_bits; i++) {
 		uint8_t bitnum = 7 - (i % 8);
 
 		curbyte |= (in[i] << bitnum);
@@ -120,8 +210,24 @@ void osmo_nibble_shift_left_unal(uint8_t *out, const uint8_t *in,
  */
 void osmo_ubit2sbit(sbit_t *out, const ubit_t *in, unsigned int num_bits)
 {
-	unsigned int i;
-	for (i = 0; i < num_bits; i++)
+	unsigned int i = 0;
+
+#ifdef HAVE_AVX2
+	if (avx2_supported)
+		i = osmo_ubit2sbit_avx2(out, in, num_bits);
+#endif
+
+#ifdef __SSE2__
+	for (; i + 16 <= num_bits; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *) &in[i]);
+
+		/* 127 ^ 0xfe is -127 */
+		v = _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_setzero_si128()), _mm_set1_epi8(0xfe));
+		_mm_storeu_si128((__m128i *) &out[i], _mm_xor_si128(v, _mm_set1_epi8(127)));
+	}
+#endif
+
+	for (; i < num_bits; i++)
 		out[i] = in[i] ? -127 : 127;
 }
 
@@ -132,8 +238,23 @@ void osmo_ubit2sbit(sbit_t *out, const ubit_t *in, unsigned int num_bits)
  */
 void osmo_sbit2ubit(ubit_t *out, const sbit_t *in, unsigned int num_bits)
 {
-	unsigned int i;
-	for (i = 0; i < num_bits; i++)
+	unsigned int i = 0;
+
+#ifdef HAVE_AVX2
+	if (avx2_supported)
+		i = osmo_sbit2ubit_avx2(out, in, num_bits);
+#endif
+
+#ifdef __SSE2__
+	for (; i + 16 <= num_bits; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *) &in[i]);
+
+		v = _mm_cmplt_epi8(v, _mm_setzero_si128());
+		_mm_storeu_si128((__m128i *) &out[i], _mm_and_si128(v, _mm_set1_epi8(1)));
+	}
+#endif
+
+	for (; i < num_bits; i++)
 		out[i] = in[i] < 0;
 }
 
@@ -145,11 +266,32 @@ void osmo_sbit2ubit(ubit_t *out, const sbit_t *in, unsigned int num_bits)
  */
 int osmo_pbit2ubit(ubit_t *out, const pbit_t *in, unsigned int num_bits)
 {
-	unsigned int i;
+	unsigned int i = 0;
 	ubit_t *cur = out;
 	ubit_t *limit = out + num_bits;
 
-	for (i = 0; i < (num_bits/8)+1; i++) {
+#ifdef HAVE_AVX2
+	if (avx2_supported) {
+		unsigned int n = osmo_pbit2ubit_avx2(out, in, num_bits);
+
+		i = n / 8;
+		cur += n;
+	}
+#endif
+
+#ifdef __SSE2__
+	/* Leave at least one bit to the loop below, which handles the
+	 * end of the output */
+	const __m128i mask = _mm_set_epi8(1, 2, 4, 8, 16, 32, 64, -128,
+					  1, 2, 4, 8, 16, 32, 64, -128);
+
+	for (; limit - cur > 16; i += 2, cur += 16) {
+		__m128i v = sse_test8(sse_bcast2(&in[i]), mask);
+		_mm_storeu_si128((__m128i *) cur, _mm_and_si128(v, _mm_set1_epi8(1)));
+	}
+#endif
+
+	for (; i < (num_bits/8)+1; i++) {
 		pbit_t byte = in[i];
 		*cur++ = (byte >> 7) & 1;
 		if (cur >= limit)
@@ -195,6 +337,23 @@ int osmo_ubit2pbit_ext(pbit_t *out, unsigned int out_ofs,
 	int i, op, bn;
 	for (i=0; i<num_bits; i++) {
 		op = out_ofs + i;
+#ifdef __SSE2__
+		/* whole output bytes at once, as soon as they are aligned */
+		if (!(op & 7)) {
+			for (; i + 16 <= num_bits; i += 16, op += 16) {
+				__m128i v = _mm_loadu_si128((const __m128i *) &in[in_ofs + i]);
+				int m;
+
+				if (!lsb_mode)
+					v = sse_rev8(v);
+				m = ~_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128()));
+				out[op >> 3] = m;
+				out[(op >> 3) + 1] = m >> 8;
+			}
+			if (i >= num_bits)
+				break;
+		}
+#endif
 		bn = lsb_mode ? (op&7) : (7-(op&7));
 		if (in[in_ofs+i])
 			out[op>>3] |= 1 << bn;
@@ -218,8 +377,25 @@ int osmo_pbit2ubit_ext(ubit_t *out, unsigned int out_ofs,
                        unsigned int num_bits, int lsb_mode)
 {
 	int i, ip, bn;
+#ifdef __SSE2__
+	const __m128i mask = lsb_mode ?
+		_mm_set_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1) :
+		_mm_set_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+#endif
 	for (i=0; i<num_bits; i++) {
 		ip = in_ofs + i;
+#ifdef __SSE2__
+		/* whole input bytes at once, as soon as they are aligned */
+		if (!(ip & 7)) {
+			for (; i + 16 <= num_bits; i += 16, ip += 16) {
+				__m128i v = sse_test8(sse_bcast2(&in[ip >> 3]), mask);
+				_mm_storeu_si128((__m128i *) &out[out_ofs + i],
+						 _mm_and_si128(v, _mm_set1_epi8(1)));
+			}
+			if (i >= num_bits)
+				break;
+		}
+#endif
 		bn = lsb_mode ? (ip&7) : (7-(ip&7));
 		out[out_ofs+i] = !!(in[ip>>3] & (1<<bn));
 	}
@@ -0,0 +1,112 @@
+/*! \file bits_avx2.c
+ * AVX2 kernels of the conversions between unpacked, packed and soft bits
+ * of bits.c, 32 bits per step. */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+#include <osmocom/core/bits.h>
+
+/* Each kernel converts whole steps of 32 bits and returns the number of
+ * bits converted, bits.c converts the rest. */
+
+/* Stops before the first step with unpacked bits other than 0 and 1 */
+__attribute__ ((visibility("hidden")))
+unsigned int osmo_ubit2pbit_avx2(pbit_t *out, const ubit_t *in, unsigned int num_bits)
+{
+	/* reverse the order of the bytes within each 8 byte group */
+	const __m256i rev = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15,
+					    0, 1, 2, 3, 4, 5, 6, 7,
+					    8, 9, 10, 11, 12, 13, 14, 15,
+					    0, 1, 2, 3, 4, 5, 6, 7);
+	unsigned int i;
+
+	for (i = 0; i + 32 <= num_bits; i += 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *) &in[i]);
+		uint32_t m;
+
+		if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(v, _mm256_set1_epi8(~1)),
+							   _mm256_setzero_si256())) != -1)
+			break;
+
+		m = _mm256_movemask_epi8(_mm256_slli_epi16(_mm256_shuffle_epi8(v, rev), 7));
+		memcpy(&out[i / 8], &m, sizeof(m));
+	}
+
+	return i;
+}
+
+/* Leaves at least one bit to the caller */
+__attribute__ ((visibility("hidden")))
+unsigned int osmo_pbit2ubit_avx2(ubit_t *out, const pbit_t *in, unsigned int num_bits)
+{
+	/* in each 128 bit lane, 8 copies of the first and of the second
+	 * byte of that lane */
+	const __m256i bcast = _mm256_set_epi8(3, 3, 3, 3, 3, 3, 3, 3,
+					      2, 2, 2, 2, 2, 2, 2, 2,
+					      1, 1, 1, 1, 1, 1, 1, 1,
+					      0, 0, 0, 0, 0, 0, 0, 0);
+	const __m256i mask = _mm256_set1_epi64x(0x0102040810204080ULL);
+	unsigned int i;
+
+	for (i = 0; num_bits - i > 32; i += 32) {
+		uint32_t b;
+		__m256i v;
+
+		memcpy(&b, &in[i / 8], sizeof(b));
+		v = _mm256_shuffle_epi8(_mm256_set1_epi32(b), bcast);
+		v = _mm256_cmpeq_epi8(_mm256_and_si256(v, mask), mask);
+		_mm256_storeu_si256((__m256i *) &out[i], _mm256_and_si256(v, _mm256_set1_epi8(1)));
+	}
+
+	return i;
+}
+
+__attribute__ ((visibility("hidden")))
+unsigned int osmo_ubit2sbit_avx2(sbit_t *out, const ubit_t *in, unsigned int num_bits)
+{
+	unsigned int i;
+
+	for (i = 0; i + 32 <= num_bits; i += 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *) &in[i]);
+
+		/* 127 ^ 0xfe is -127 */
+		v = _mm256_andnot_si256(_mm256_cmpeq_epi8(v, _mm256_setzero_si256()), _mm256_set1_epi8(0xfe));
+		_mm256_storeu_si256((__m256i *) &out[i], _mm256_xor_si256(v, _mm256_set1_epi8(127)));
+	}
+
+	return i;
+}
+
+__attribute__ ((visibility("hidden")))
+unsigned int osmo_sbit2ubit_avx2(ubit_t *out, const sbit_t *in, unsigned int num_bits)
+{
+	unsigned int i;
+
+	for (i = 0; i + 32 <= num_bits; i += 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *) &in[i]);
+
+		v = _mm256_cmpgt_epi8(_mm256_setzero_si256(), v);
+		_mm256_storeu_si256((__m256i *) &out[i], _mm256_and_si256(v, _mm256_set1_epi8(1)));
+	}
+
+	return i;
+}
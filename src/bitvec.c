@@ -44,6 +44,7 @@
 
 #include <osmocom/core/bits.h>
 #include <osmocom/core/bitvec.h>
+#include <osmocom/core/endian.h>
 #include <osmocom/core/panic.h>
 #include <osmocom/core/utils.h>
 
@@ -56,6 +57,107 @@ static inline unsigned int bytenum_from_bitnum(unsigned int bitnum)
 	return bytenum;
 }
 
+/* L and H are the bits of the padding pattern 0x2b and their inverse */
+#define LH_PADDING	0x2b2b2b2b2b2b2b2bULL
+
+/* unaligned big endian 64 bit load and store, unlike osmo_load64be() and
+ * osmo_store64be() a single instruction each on common targets */
+static inline uint64_t load64be(const uint8_t *p)
+{
+	uint64_t w;
+
+	memcpy(&w, p, sizeof(w));
+#if OSMO_IS_LITTLE_ENDIAN
+	w = __builtin_bswap64(w);
+#endif
+	return w;
+}
+
+static inline void store64be(uint64_t w, uint8_t *p)
+{
+#if OSMO_IS_LITTLE_ENDIAN
+	w = __builtin_bswap64(w);
+#endif
+	memcpy(p, &w, sizeof(w));
+}
+
+/* check if the num_bits bits from bit number bitnr on are inside the vector */
+static inline bool bits_inside(const struct bitvec *bv, unsigned int bitnr,
+			       unsigned int num_bits)
+{
+	unsigned int total = bv->data_len * 8;
+
+	return bitnr <= total && num_bits <= total - bitnr;
+}
+
+/* read 1 to 57 bits from bit number bitnr on, which the caller has checked
+ * to be inside the vector, through a 64 bit word starting at the first byte */
+static inline uint64_t get_bits(const struct bitvec *bv, unsigned int bitnr,
+				unsigned int num_bits)
+{
+	unsigned int bytenum = bytenum_from_bitnum(bitnr);
+	unsigned int shift = bitnr % 8;
+	uint64_t w;
+
+	if (bytenum + 8 <= bv->data_len)
+		w = load64be(bv->data + bytenum);
+	else
+		w = osmo_load64be_ext(bv->data + bytenum, (shift + num_bits + 7) / 8);
+
+	return (w << shift) >> (64 - num_bits);
+}
+
+/* write 1 to 57 bits from bit number bitnr on, see get_bits(); the bits
+ * are XORed with the given padding pattern, as L/H are encoded */
+static inline void set_bits(struct bitvec *bv, unsigned int bitnr, uint64_t val,
+			    unsigned int num_bits, uint64_t padding)
+{
+	unsigned int bytenum = bytenum_from_bitnum(bitnr);
+	unsigned int shift = 64 - bitnr % 8 - num_bits;
+	uint64_t mask = (~(uint64_t) 0 >> (64 - num_bits)) << shift;
+	unsigned int n;
+	uint64_t w;
+
+	if (bytenum + 8 <= bv->data_len) {
+		w = load64be(bv->data + bytenum);
+		w = (w & ~mask) | (((val << shift) ^ padding) & mask);
+		store64be(w, bv->data + bytenum);
+	} else {
+		n = (64 - shift + 7) / 8;
+		w = osmo_load64be_ext(bv->data + bytenum, n);
+		w = (w & ~mask) | (((val << shift) ^ padding) & mask);
+		osmo_store64be_ext(w >> (64 - 8 * n), bv->data + bytenum, n);
+	}
+}
+
+/* read up to 64 bits, see get_bits() */
+static inline uint64_t read_bits(const struct bitvec *bv, unsigned int bitnr,
+				 unsigned int num_bits)
+{
+	if (num_bits == 0)
+		return 0;
+	if (num_bits > 57)
+		return (get_bits(bv, bitnr, num_bits - 32) << 32) |
+			get_bits(bv, bitnr + num_bits - 32, 32);
+
+	return get_bits(bv, bitnr, num_bits);
+}
+
+/* write up to 64 bits, see set_bits() */
+static inline void write_bits(struct bitvec *bv, unsigned int bitnr, uint64_t val,
+			      unsigned int num_bits, uint64_t padding)
+{
+	if (num_bits == 0)
+		return;
+	if (num_bits > 57) {
+		set_bits(bv, bitnr, val >> 32, num_bits - 32, padding);
+		bitnr += num_bits - 32;
+		num_bits = 32;
+	}
+
+	set_bits(bv, bitnr, val, num_bits, padding);
+}
+
 /* convert ZERO/ONE/L/H to a bitmask at given pos in a byte */
 static uint8_t bitval2mask(enum bit_value bit, uint8_t bitnum)
 {
@@ -225,6 +327,13 @@ int bitvec_set_u64(struct bitvec *bv, uint64_t v, uint8_t num_bits, bool use_lh)
 	if (num_bits > 64)
 		return -E2BIG;
 
+	if (bits_inside(bv, bv->cur_bit, num_bits)) {
+		write_bits(bv, bv->cur_bit, v, num_bits, use_lh ? LH_PADDING : 0);
+		bv->cur_bit += num_bits;
+		return 0;
+	}
+
+	/* bit by bit up to the end of the vector */
 	for (i = 0; i < num_bits; i++) {
 		int rc;
 		enum bit_value bit = use_lh ? L : 0;
@@ -267,6 +376,12 @@ int bitvec_get_uint(struct bitvec *bv, unsigned int num_bits)
 	int i;
 	unsigned int ui = 0;
 
+	if (num_bits <= 32 && bits_inside(bv, bv->cur_bit, num_bits)) {
+		ui = read_bits(bv, bv->cur_bit, num_bits);
+		bv->cur_bit += num_bits;
+		return ui;
+	}
+
 	for (i = 0; i < num_bits; i++) {
 		int bit = bitvec_get_bit_pos(bv, bv->cur_bit);
 		if (bit < 0)
@@ -285,6 +400,19 @@ int bitvec_get_uint(struct bitvec *bv, unsigned int num_bits)
 int bitvec_fill(struct bitvec *bv, unsigned int num_bits, enum bit_value fill)
 {
 	unsigned i, stop = bv->cur_bit + num_bits;
+	uint64_t val = (fill == ONE || fill == H) ? ~(uint64_t) 0 : 0;
+	uint64_t padding = (fill == L || fill == H) ? LH_PADDING : 0;
+
+	if (bits_inside(bv, bv->cur_bit, num_bits)) {
+		while (num_bits > 0) {
+			i = OSMO_MIN(num_bits, 64);
+			write_bits(bv, bv->cur_bit, val, i, padding);
+			bv->cur_bit += i;
+			num_bits -= i;
+		}
+		return 0;
+	}
+
 	for (i = bv->cur_bit; i < stop; i++)
 		if (bitvec_set_bit(bv, fill) < 0)
 			return -EINVAL;
@@ -340,8 +468,16 @@ int bitvec_get_bytes(struct bitvec *bv, uint8_t *bytes, unsigned int count)
 		memcpy(bytes, bv->data + byte_offs, count);
 	} else {
 		src = bv->data + byte_offs;
+		/* eight bytes at a time from the nine they span, which are
+		 * inside the vector as checked above */
+		for (i = count; i >= 8; i -= 8) {
+			store64be((load64be(src) << bit_offs) |
+				       (src[8] >> (8 - bit_offs)), bytes);
+			src += 8;
+			bytes += 8;
+		}
 		last_c = *(src++);
-		for (i = count; i > 0; i--) {
+		for (; i > 0; i--) {
 			c = *(src++);
 			*(bytes++) =
 				(last_c << bit_offs) |
@@ -366,6 +502,7 @@ int bitvec_set_bytes(struct bitvec *bv, const uint8_t *bytes, unsigned int count
 	int byte_offs = bytenum_from_bitnum(bv->cur_bit);
 	int bit_offs = bv->cur_bit % 8;
 	uint8_t c, last_c;
+	uint64_t w;
 	int i;
 	uint8_t *dst;
 
@@ -378,7 +515,16 @@ int bitvec_set_bytes(struct bitvec *bv, const uint8_t *bytes, unsigned int count
 		dst = bv->data + byte_offs;
 		/* Get lower bits of first dst byte */
 		last_c = *dst >> (8 - bit_offs);
-		for (i = count; i > 0; i--) {
+		/* eight bytes at a time */
+		for (i = count; i >= 8; i -= 8) {
+			w = load64be(bytes);
+			store64be(((uint64_t) last_c << (64 - bit_offs)) |
+				       (w >> bit_offs), dst);
+			last_c = w;
+			bytes += 8;
+			dst += 8;
+		}
+		for (; i > 0; i--) {
 			c = *(bytes++);
 			*(dst++) =
 				(last_c << (8 - bit_offs)) |
@@ -480,6 +626,13 @@ uint64_t bitvec_read_field(struct bitvec *bv, unsigned int *read_index, unsigned
 	uint64_t ui = 0;
 	bv->cur_bit = *read_index;
 
+	if (len <= 64 && bits_inside(bv, bv->cur_bit, len)) {
+		ui = read_bits(bv, bv->cur_bit, len);
+		bv->cur_bit += len;
+		*read_index += len;
+		return ui;
+	}
+
 	for (i = 0; i < len; i++) {
 		int bit = bitvec_get_bit_pos((const struct bitvec *)bv, bv->cur_bit);
 		if (bit < 0)
@@ -60,215 +60,141 @@ const struct value_string gsm0503_amr_dtx_frame_names[] = {
 	{ 0, NULL }
 };
 
-static bool detect_afs_id_marker(int *n_errors, int *n_bits_total, const ubit_t * ubits, uint8_t offset, uint8_t count,
-				 const ubit_t * id_marker, uint8_t id_marker_len)
-{
-	unsigned int i, k;
-	unsigned int id_bit_nr = 0;
-	int errors = 0;
-	int bits = 0;
-
-	/* Override coded in-band data */
-	ubits += offset;
+/* Hard bits of a deinterleaved 456 bit frame, packed as by osmo_ubit2pbit()
+ * and read as 64 bit words, so that 64 bits are compared at once */
+#define DTX_FRAME_WORDS	8
+
+/*! Where a DTX frame type carries which repeated pattern: n_bits bits,
+ *  taken in runs of run bits every step bits from offset on */
+struct dtx_pattern_desc {
+	enum gsm0503_amr_dtx_frames type;
+	uint16_t offset;
+	uint16_t n_bits;
+	uint8_t run;
+	uint8_t step;
+	const ubit_t *pattern;
+	uint8_t pattern_len;
+};
 
-	/* Check for identification marker bits */
-	for (i = 0; i < count; i++) {
-		for (k = 0; k < 4; k++) {
-			if (id_marker[id_bit_nr % id_marker_len] != *ubits)
-				errors++;
-			id_bit_nr++;
-			ubits++;
-			bits++;
-		}
+/*! A DTX frame type as the expected value of the checked bits of a frame */
+struct dtx_pattern {
+	enum gsm0503_amr_dtx_frames type;
+	int n_bits;
+	uint64_t bits[DTX_FRAME_WORDS];
+	uint64_t mask[DTX_FRAME_WORDS];
+};
 
-		/* Jump to the next block of 4 bits */
-		ubits += 4;
-	}
+/* In the order they are tried in */
+static const struct dtx_pattern_desc afs_pattern_desc[] = {
+	/* SID_FIRST by its identification marker, next to the coded in-band
+	 * data every 4 bits */
+	{ AFS_SID_FIRST, 32, 53 * 4, 4, 8, id_marker_0, 9 },
+	/* SID_UPDATE by its identification marker */
+	{ AFS_SID_UPDATE, 36, 53 * 4, 4, 8, id_marker_0, 9 },
+	/* ONSET by its repeated coded in-band data, for all four ids */
+	{ AFS_ONSET, 4, 57 * 4, 4, 8, codec_mode_1_sid, 16 },
+	{ AFS_ONSET, 4, 57 * 4, 4, 8, codec_mode_2_sid, 16 },
+	{ AFS_ONSET, 4, 57 * 4, 4, 8, codec_mode_3_sid, 16 },
+	{ AFS_ONSET, 4, 57 * 4, 4, 8, codec_mode_4_sid, 16 },
+};
 
-	*n_errors = errors;
-	*n_bits_total = bits;
+static const struct dtx_pattern_desc ahs_pattern_desc[] = {
+	/* SID_UPDATE by its identification marker after the in-band data */
+	{ AHS_SID_UPDATE, 16, 212, 1, 1, id_marker_1, 9 },
+	/* SID_FIRST_INH and SID_UPDATE_INH by their identification markers
+	 * on the odd bits */
+	{ AHS_SID_FIRST_INH, 33, 212, 1, 2, id_marker_1, 9 },
+	{ AHS_SID_UPDATE_INH, 33, 212, 1, 2, id_marker_0, 9 },
+	/* SID_FIRST_P1 by its identification marker */
+	{ AHS_SID_FIRST_P1, 16, 212, 1, 1, id_marker_0, 9 },
+	/* SID_FIRST_P2 by its repeated coded in-band data on the even bits */
+	{ AHS_SID_FIRST_P2, 0, 114, 1, 2, codec_mode_1_sid, 16 },
+	{ AHS_SID_FIRST_P2, 0, 114, 1, 2, codec_mode_2_sid, 16 },
+	{ AHS_SID_FIRST_P2, 0, 114, 1, 2, codec_mode_3_sid, 16 },
+	{ AHS_SID_FIRST_P2, 0, 114, 1, 2, codec_mode_4_sid, 16 },
+	/* ONSET by its repeated coded in-band data on the odd bits */
+	{ AHS_ONSET, 1, 114, 1, 2, codec_mode_1_sid, 16 },
+	{ AHS_ONSET, 1, 114, 1, 2, codec_mode_2_sid, 16 },
+	{ AHS_ONSET, 1, 114, 1, 2, codec_mode_3_sid, 16 },
+	{ AHS_ONSET, 1, 114, 1, 2, codec_mode_4_sid, 16 },
+};
 
-	/* Tolerate up to 1/8 errornous bits */
-	return *n_errors < *n_bits_total / 8;
-}
+static struct dtx_pattern afs_patterns[ARRAY_SIZE(afs_pattern_desc)];
+static struct dtx_pattern ahs_patterns[ARRAY_SIZE(ahs_pattern_desc)];
 
-static bool detect_ahs_id_marker(int *n_errors, int *n_bits_total, const ubit_t * ubits, const ubit_t * id_marker)
+static void dtx_frame_pack(uint64_t *words, const ubit_t *ubits)
 {
-	unsigned int i, k;
-	int errors = 0;
-	int bits = 0;
+	pbit_t pbits[DTX_FRAME_WORDS * 8] = { 0 };
 
-	/* Override coded in-band data */
-	ubits += 16;
-
-	/* Check first identification marker bits (23*9 bits) */
-	for (i = 0; i < 23; i++) {
-		for (k = 0; k < 9; k++) {
-			if (id_marker[k] != *ubits)
-				errors++;
-			ubits++;
-			bits++;
-		}
-	}
-
-	/* Check remaining identification marker bits (5 bits) */
-	for (k = 0; k < 5; k++) {
-		if (id_marker[k] != *ubits)
-			errors++;
-		ubits++;
-		bits++;
-	}
-
-	*n_errors = errors;
-	*n_bits_total = bits;
-
-	/* Tolerate up to 1/8 errornous bits */
-	return *n_errors < *n_bits_total / 8;
+	osmo_ubit2pbit(pbits, ubits, 456);
+	memcpy(words, pbits, sizeof(pbits));
 }
 
-static bool detect_interleaved_ahs_id_marker(int *n_errors, int *n_bits_total, const ubit_t * ubits, uint8_t offset,
-					     uint8_t n_bits, const ubit_t * id_marker, uint8_t id_marker_len)
+static void dtx_pattern_build(struct dtx_pattern *p, const struct dtx_pattern_desc *desc)
 {
-	unsigned int i, k;
-	int errors = 0;
-	int bits = 0;
-	uint8_t full_rounds = n_bits / id_marker_len;
-	uint8_t remainder = n_bits % id_marker_len;
+	ubit_t bits[456] = { 0 }, mask[456] = { 0 };
+	unsigned int i, pos;
 
-	/* Override coded in-band data */
-	ubits += offset;
-
-	/* Check first identification marker bits (23*9 bits) */
-	for (i = 0; i < full_rounds; i++) {
-		for (k = 0; k < id_marker_len; k++) {
-			if (id_marker[k] != *ubits)
-				errors++;
-			ubits += 2;
-			bits++;
-		}
+	for (i = 0; i < desc->n_bits; i++) {
+		pos = desc->offset + i / desc->run * desc->step + i % desc->run;
+		bits[pos] = desc->pattern[i % desc->pattern_len];
+		mask[pos] = 1;
 	}
 
-	/* Check remaining identification marker bits (5 bits) */
-	for (k = 0; k < remainder; k++) {
-		if (id_marker[k] != *ubits)
-			errors++;
-		ubits += 2;
-		bits++;
-	}
-
-	*n_errors = errors;
-	*n_bits_total = bits;
-
-	/* Tolerate up to 1/8 errornous bits */
-	return *n_errors < *n_bits_total / 8;
-}
-
-/* Detect a an FR AMR SID_FIRST frame by its identifcation marker */
-static bool detect_afs_sid_first(int *n_errors, int *n_bits_total, const ubit_t * ubits)
-{
-	return detect_afs_id_marker(n_errors, n_bits_total, ubits, 32, 53, id_marker_0, 9);
-}
-
-/* Detect an FR AMR SID_FIRST frame by its identification marker */
-static bool detect_afs_sid_update(int *n_errors, int *n_bits_total, const ubit_t * ubits)
-{
-	return detect_afs_id_marker(n_errors, n_bits_total, ubits, 36, 53, id_marker_0, 9);
-}
-
-/* Detect an FR AMR SID_FIRST frame by its repeating coded inband data */
-static bool detect_afs_onset(int *n_errors, int *n_bits_total, const ubit_t * ubits)
-{
-	bool rc;
-
-	rc = detect_afs_id_marker(n_errors, n_bits_total, ubits, 4, 57, codec_mode_1_sid, 16);
-	if (rc)
-		return true;
-
-	rc = detect_afs_id_marker(n_errors, n_bits_total, ubits, 4, 57, codec_mode_2_sid, 16);
-	if (rc)
-		return true;
-
-	rc = detect_afs_id_marker(n_errors, n_bits_total, ubits, 4, 57, codec_mode_3_sid, 16);
-	if (rc)
-		return true;
-
-	rc = detect_afs_id_marker(n_errors, n_bits_total, ubits, 4, 57, codec_mode_4_sid, 16);
-	if (rc)
-		return true;
-
-	return false;
+	p->type = desc->type;
+	p->n_bits = desc->n_bits;
+	dtx_frame_pack(p->bits, bits);
+	dtx_frame_pack(p->mask, mask);
 }
 
-/* Detect an HR AMR SID UPDATE frame by its identification marker */
-static bool detect_ahs_sid_update(int *n_errors, int *n_bits_total, const ubit_t * ubits)
+static __attribute__ ((constructor)) void dtx_patterns_build(void)
 {
-	return detect_ahs_id_marker(n_errors, n_bits_total, ubits, id_marker_1);
-}
+	unsigned int i;
 
-/* Detect an HR AMR SID FIRST (part 1) frame by its identification marker */
-static bool detect_ahs_sid_first_p1(int *n_errors, int *n_bits_total, const ubit_t * ubits)
-{
-	return detect_ahs_id_marker(n_errors, n_bits_total, ubits, id_marker_0);
+	for (i = 0; i < ARRAY_SIZE(afs_pattern_desc); i++)
+		dtx_pattern_build(&afs_patterns[i], &afs_pattern_desc[i]);
+	for (i = 0; i < ARRAY_SIZE(ahs_pattern_desc); i++)
+		dtx_pattern_build(&ahs_patterns[i], &ahs_pattern_desc[i]);
 }
 
-/* Detect an HR AMR SID FIRST (part 2) frame by its repeating coded inband data */
-static bool detect_ahs_sid_first_p2(int *n_errors, int *n_bits_total, const ubit_t * ubits)
+/* Count the bits of the frame that differ from the pattern, giving up as
+ * soon as there are too many of them: speech frames, which match none of
+ * the patterns, are rejected after a word or two */
+static bool dtx_pattern_match(int *n_errors, int *n_bits_total, const uint64_t *frame,
+			      const struct dtx_pattern *p)
 {
-	bool rc;
-
-	rc = detect_interleaved_ahs_id_marker(n_errors, n_bits_total, ubits, 0, 114, codec_mode_1_sid, 16);
-	if (rc)
-		return true;
-
-	rc = detect_interleaved_ahs_id_marker(n_errors, n_bits_total, ubits, 0, 114, codec_mode_2_sid, 16);
-	if (rc)
-		return true;
-
-	rc = detect_interleaved_ahs_id_marker(n_errors, n_bits_total, ubits, 0, 114, codec_mode_3_sid, 16);
-	if (rc)
-		return true;
+	/* Tolerate up to 1/8 errornous bits */
+	int max_errors = p->n_bits / 8;
+	int errors = 0;
+	unsigned int i;
 
-	rc = detect_interleaved_ahs_id_marker(n_errors, n_bits_total, ubits, 0, 114, codec_mode_4_sid, 16);
-	if (rc)
-		return true;
+	for (i = 0; i < DTX_FRAME_WORDS; i++) {
+		errors += __builtin_popcountll((frame[i] ^ p->bits[i]) & p->mask[i]);
+		if (errors >= max_errors)
+			return false;
+	}
 
-	return false;
+	*n_errors = errors;
+	*n_bits_total = p->n_bits;
+	return true;
 }
 
-/* Detect an HR AMR ONSET frame by its repeating coded inband data */
-static bool detect_ahs_onset(int *n_errors, int *n_bits_total, const ubit_t * ubits)
+static enum gsm0503_amr_dtx_frames detect_dtx_frame(int *n_errors, int *n_bits_total, const ubit_t *ubits,
+						    const struct dtx_pattern *patterns, unsigned int num_patterns)
 {
-	bool rc;
-
-	rc = detect_interleaved_ahs_id_marker(n_errors, n_bits_total, ubits, 1, 114, codec_mode_1_sid, 16);
-	if (rc)
-		return true;
-
-	rc = detect_interleaved_ahs_id_marker(n_errors, n_bits_total, ubits, 1, 114, codec_mode_2_sid, 16);
-	if (rc)
-		return true;
-
-	rc = detect_interleaved_ahs_id_marker(n_errors, n_bits_total, ubits, 1, 114, codec_mode_3_sid, 16);
-	if (rc)
-		return true;
+	uint64_t frame[DTX_FRAME_WORDS];
+	unsigned int i;
 
-	rc = detect_interleaved_ahs_id_marker(n_errors, n_bits_total, ubits, 1, 114, codec_mode_4_sid, 16);
-	if (rc)
-		return true;
+	dtx_frame_pack(frame, ubits);
 
-	return false;
-}
-
-/* Detect an HR AMR SID FIRST INHIBIT frame by its identification marker */
-static bool detect_ahs_sid_first_inh(int *n_errors, int *n_bits_total, const ubit_t * ubits)
-{
-	return detect_interleaved_ahs_id_marker(n_errors, n_bits_total, ubits, 33, 212, id_marker_1, 9);
-}
+	for (i = 0; i < num_patterns; i++) {
+		if (dtx_pattern_match(n_errors, n_bits_total, frame, &patterns[i]))
+			return patterns[i].type;
+	}
 
-/* Detect an HR AMR SID UPDATE INHIBIT frame by its identification marker */
-static bool detect_ahs_sid_update_inh(int *n_errors, int *n_bits_total, const ubit_t * ubits)
-{
-	return detect_interleaved_ahs_id_marker(n_errors, n_bits_total, ubits, 33, 212, id_marker_0, 9);
+	*n_errors = 0;
+	*n_bits_total = 0;
+	return AMR_OTHER;
 }
 
 /*! Detect FR AMR DTX frame in unmapped, deinterleaved frame bits.
@@ -278,16 +204,7 @@ static bool detect_ahs_sid_update_inh(int *n_errors, int *n_bits_total, const ub
  *  \returns dtx frame type. */
 enum gsm0503_amr_dtx_frames gsm0503_detect_afs_dtx_frame(int *n_errors, int *n_bits_total, const ubit_t * ubits)
 {
-	if (detect_afs_sid_first(n_errors, n_bits_total, ubits))
-		return AFS_SID_FIRST;
-	if (detect_afs_sid_update(n_errors, n_bits_total, ubits))
-		return AFS_SID_UPDATE;
-	if (detect_afs_onset(n_errors, n_bits_total, ubits))
-		return AFS_ONSET;
-
-	*n_errors = 0;
-	*n_bits_total = 0;
-	return AMR_OTHER;
+	return detect_dtx_frame(n_errors, n_bits_total, ubits, afs_patterns, ARRAY_SIZE(afs_patterns));
 }
 
 /*! Detect HR AMR DTX frame in unmapped, deinterleaved frame bits.
@@ -297,20 +214,5 @@ enum gsm0503_amr_dtx_frames gsm0503_detect_afs_dtx_frame(int *n_errors, int *n_b
  *  \returns dtx frame type, */
 enum gsm0503_amr_dtx_frames gsm0503_detect_ahs_dtx_frame(int *n_errors, int *n_bits_total, const ubit_t * ubits)
 {
-	if (detect_ahs_sid_update(n_errors, n_bits_total, ubits))
-		return AHS_SID_UPDATE;
-	if (detect_ahs_sid_first_inh(n_errors, n_bits_total, ubits))
-		return AHS_SID_FIRST_INH;
-	if (detect_ahs_sid_update_inh(n_errors, n_bits_total, ubits))
-		return AHS_SID_UPDATE_INH;
-	if (detect_ahs_sid_first_p1(n_errors, n_bits_total, ubits))
-		return AHS_SID_FIRST_P1;
-	if (detect_ahs_sid_first_p2(n_errors, n_bits_total, ubits))
-		return AHS_SID_FIRST_P2;
-	if (detect_ahs_onset(n_errors, n_bits_total, ubits))
-		return AHS_ONSET;
-
-	*n_errors = 0;
-	*n_bits_total = 0;
-	return AMR_OTHER;
+	return detect_dtx_frame(n_errors, n_bits_total, ubits, ahs_patterns, ARRAY_SIZE(ahs_patterns));
 }
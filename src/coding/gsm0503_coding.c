@@ -25,6 +25,7 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <stdlib.h>
 #include <errno.h>
@@ -529,59 +530,22 @@ const struct gsm0503_mcs_code gsm0503_mcs_dl_codes[EGPRS_NUM_MCS] = {
 	},
 };
 
-/*! Convolutional Decode + compute BER for punctured codes
- *  \param[in] code Description of Convolutional Code
- *  \param[in] input Input soft-bits (-127...127)
- *  \param[out] output bits
- *  \param[out] n_errors Number of bit-errors
- *  \param[out] n_bits_total Number of bits
- *  \param[in] data_punc Puncturing mask array. Can be NULL.
- */
-static int osmo_conv_decode_ber_punctured(const struct osmo_conv_code *code,
-	const sbit_t *input, ubit_t *output,
-	int *n_errors, int *n_bits_total,
-	const uint8_t *data_punc)
+/*! check CRC of decoded xCCH bits and pack them
+ *  \param[out] l2_data caller-allocated buffer for L2 Frame
+ *  \param[in] conv 224 decoded bits
+ *  \returns 0 on success; -1 on CRC error */
+static int _xcch_decode_conv(uint8_t *l2_data, const ubit_t *conv)
 {
-	int res, i, coded_len;
-	ubit_t recoded[EGPRS_DATA_C_MAX];
-
-	res = osmo_conv_decode(code, input, output);
-
-	if (n_bits_total || n_errors) {
-		coded_len = osmo_conv_encode(code, output, recoded);
-		OSMO_ASSERT(sizeof(recoded) / sizeof(recoded[0]) >= coded_len);
-	}
-
-	/* Count bit errors */
-	if (n_errors) {
-		*n_errors = 0;
-		for (i = 0; i < coded_len; i++) {
-			if (((!data_punc) || (data_punc && !data_punc[i])) &&
-				!((recoded[i] && input[i] < 0) ||
-					(!recoded[i] && input[i] > 0)) )
-						*n_errors += 1;
-		}
-	}
+	int rv;
 
-	if (n_bits_total)
-		*n_bits_total = coded_len;
+	rv = osmo_crc64gen_check_bits(&gsm0503_fire_crc40,
+		conv, 184, conv + 184);
+	if (rv)
+		return -1;
 
-	return res;
-}
+	osmo_ubit2pbit_ext(l2_data, 0, conv, 0, 184, 1);
 
-/*! Convolutional Decode + compute BER for non-punctured codes
- *  \param[in] code Description of Convolutional Code
- *  \param[in] input Input soft-bits (-127...127)
- *  \param[out] output bits
- *  \param[out] n_errors Number of bit-errors
- *  \param[out] n_bits_total Number of bits
- */
-static int osmo_conv_decode_ber(const struct osmo_conv_code *code,
-	const sbit_t *input, ubit_t *output,
-	int *n_errors, int *n_bits_total)
-{
-	return osmo_conv_decode_ber_punctured(code, input, output,
-		n_errors, n_bits_total, NULL);
+	return 0;
 }
 
 /*! convenience wrapper for decoding coded bits
@@ -594,19 +558,11 @@ static int _xcch_decode_cB(uint8_t *l2_data, const sbit_t *cB,
 	int *n_errors, int *n_bits_total)
 {
 	ubit_t conv[224];
-	int rv;
 
 	osmo_conv_decode_ber(&gsm0503_xcch, cB,
 		conv, n_errors, n_bits_total);
 
-	rv = osmo_crc64gen_check_bits(&gsm0503_fire_crc40,
-		conv, 184, conv + 184);
-	if (rv)
-		return -1;
-
-	osmo_ubit2pbit_ext(l2_data, 0, conv, 0, 184, 1);
-
-	return 0;
+	return _xcch_decode_conv(l2_data, conv);
 }
 
 /*! convenience wrapper for encoding to coded bits
@@ -626,10 +582,90 @@ static int _xcch_encode_cB(ubit_t *cB, const uint8_t *l2_data)
 	return 0;
 }
 
+/*
+ * Batch decoding
+ */
+
+/* Number of blocks decoded at once; no less than the number of codewords
+ * osmo_conv_decode_batch() decodes in parallel */
+#define BATCH_MAX	16
+
+/* Decoding state of one block of a batch */
+struct batch_block {
+	/* Code of the block; NULL if it isn't convolutionally coded */
+	const struct osmo_conv_code *code;
+	/* Coded (soft) bits, depunctured */
+	sbit_t cB[676];
+	/* Decoded bits */
+	ubit_t conv[456];
+	int n_errors;
+	int n_bits_total;
+};
+
+/*! Convolutional decode + compute BER of several blocks
+ *  Blocks using the same code are decoded together.
+ *  \param[inout] blk blocks to decode
+ *  \param[in] n Number of blocks, up to BATCH_MAX
+ */
+static void batch_decode_conv(struct batch_block *blk, unsigned int n)
+{
+	const sbit_t *in[BATCH_MAX];
+	ubit_t *out[BATCH_MAX];
+	int n_errors[BATCH_MAX], n_bits_total[BATCH_MAX];
+	unsigned int idx[BATCH_MAX];
+	bool done[BATCH_MAX] = { false };
+	unsigned int i, j, cnt;
+
+	for (i = 0; i < n; i++) {
+		if (!blk[i].code || done[i])
+			continue;
+
+		for (j = i, cnt = 0; j < n; j++) {
+			if (blk[j].code != blk[i].code)
+				continue;
+			in[cnt] = blk[j].cB;
+			out[cnt] = blk[j].conv;
+			idx[cnt++] = j;
+			done[j] = true;
+		}
+
+		osmo_conv_decode_batch_ber(blk[i].code, in, out, cnt,
+			n_errors, n_bits_total);
+
+		for (j = 0; j < cnt; j++) {
+			blk[idx[j]].n_errors = n_errors[j];
+			blk[idx[j]].n_bits_total = n_bits_total[j];
+		}
+	}
+}
+
+/* Store the BER of a block in the optional output arrays of a batch */
+static void batch_block_result(const struct batch_block *blk, unsigned int i,
+	int *n_errors, int *n_bits_total)
+{
+	if (n_errors)
+		n_errors[i] = blk->n_errors;
+	if (n_bits_total)
+		n_bits_total[i] = blk->n_bits_total;
+}
+
 /*
  * GSM xCCH block transcoding
  */
 
+/*! unmap and deinterleave four xCCH bursts
+ *  \param[out] cB 456 coded (soft) bits
+ *  \param[in] bursts four GSM bursts in soft-bits */
+static void _xcch_decode_bursts(sbit_t *cB, const sbit_t *bursts)
+{
+	int k;
+
+	/* gsm0503_xcch_burst_unmap() and gsm0503_xcch_deinterleave() in one
+	 * pass, without the intermediate interleaved bits */
+	for (k = 0; k < 456; k++)
+		cB[k] = bursts[gsm0503_interleave_xcch_burst[k]];
+}
+
 /*! Decoding of xCCH data from bursts to L2 frame
  *  \param[out] l2_data caller-allocated output data buffer
  *  \param[in] bursts four GSM bursts in soft-bits
@@ -639,17 +675,53 @@ static int _xcch_encode_cB(ubit_t *cB, const uint8_t *l2_data)
 int gsm0503_xcch_decode(uint8_t *l2_data, const sbit_t *bursts,
 	int *n_errors, int *n_bits_total)
 {
-	sbit_t iB[456], cB[456];
-	int i;
+	sbit_t cB[456];
 
-	for (i = 0; i < 4; i++)
-		gsm0503_xcch_burst_unmap(&iB[i * 114], &bursts[i * 116], NULL, NULL);
-
-	gsm0503_xcch_deinterleave(cB, iB);
+	_xcch_decode_bursts(cB, bursts);
 
 	return _xcch_decode_cB(l2_data, cB, n_errors, n_bits_total);
 }
 
+/*! Decoding of several xCCH blocks at once
+ *  Blocks of several timeslots or channels are decoded in parallel, see
+ *  osmo_conv_decode_batch().  The results are the same as those of
+ *  gsm0503_xcch_decode() for each block.
+ *  \param[in] n Number of blocks
+ *  \param[out] l2_data n caller-allocated output data buffers
+ *  \param[in] bursts n sets of four GSM bursts in soft-bits
+ *  \param[out] n_errors n numbers of detected errors; can be NULL
+ *  \param[out] n_bits_total n numbers of total coded bits; can be NULL
+ *  \param[out] rc n return values of gsm0503_xcch_decode()
+ *  \returns number of blocks decoded successfully
+ */
+int gsm0503_xcch_decode_batch(unsigned int n, uint8_t * const *l2_data,
+	const sbit_t * const *bursts, int *n_errors, int *n_bits_total, int *rc)
+{
+	struct batch_block blk[BATCH_MAX];
+	unsigned int i, j, cnt;
+	int ok = 0;
+
+	for (i = 0; i < n; i += cnt) {
+		cnt = OSMO_MIN(n - i, BATCH_MAX);
+
+		for (j = 0; j < cnt; j++) {
+			_xcch_decode_bursts(blk[j].cB, bursts[i + j]);
+			blk[j].code = &gsm0503_xcch;
+		}
+
+		batch_decode_conv(blk, cnt);
+
+		for (j = 0; j < cnt; j++) {
+			rc[i + j] = _xcch_decode_conv(l2_data[i + j], blk[j].conv);
+			batch_block_result(&blk[j], i + j, n_errors, n_bits_total);
+			if (rc[i + j] >= 0)
+				ok++;
+		}
+	}
+
+	return ok;
+}
+
 /*! Encoding of xCCH data from L2 frame to bursts
  *  \param[out] bursts caller-allocated burst data (unpacked bits)
  *  \param[in] l2_data L2 input data (MAC block)
@@ -1012,23 +1084,19 @@ int gsm0503_pdtch_egprs_decode(uint8_t *l2_data, const sbit_t *bursts, uint16_t
  * GSM PDTCH block transcoding
  */
 
-/*! Decode GPRS PDTCH
- *  \param[out] l2_data caller-allocated buffer for L2 Frame
+/*! unmap and deinterleave four PDTCH bursts and detect the coding scheme
+ *  \param[out] cB 676 coded (soft) bits, depunctured for CS-2 and CS-3
  *  \param[in] bursts burst input data as soft unpacked bits
- *  \param[out] usf_p uplink stealing flag
- *  \param[out] n_errors number of detected bit-errors
- *  \param[out] n_bits_total total number of dcoded bits
- *  \returns 0 on success; negative on error */
-int gsm0503_pdtch_decode(uint8_t *l2_data, const sbit_t *bursts, uint8_t *usf_p,
-	int *n_errors, int *n_bits_total)
+ *  \returns coding scheme (1..4) */
+static int _pdtch_decode_bursts(sbit_t *cB, const sbit_t *bursts)
 {
-	sbit_t iB[456], cB[676], hl_hn[8];
-	ubit_t conv[456];
-	int i, j, k, rv, best = 0, cs = 0, usf = 0; /* make GCC happy */
+	sbit_t hl_hn[8];
+	int i, j, k, best = 0, cs = 0; /* make GCC happy */
 
-	for (i = 0; i < 4; i++)
-		gsm0503_xcch_burst_unmap(&iB[i * 114], &bursts[i * 116],
-			hl_hn + i * 2, hl_hn + i * 2 + 1);
+	for (i = 0; i < 4; i++) {
+		hl_hn[i * 2] = bursts[i * 116 + 57];
+		hl_hn[i * 2 + 1] = bursts[i * 116 + 58];
+	}
 
 	for (i = 0; i < 4; i++) {
 		for (j = 0, k = 0; j < 8; j++)
@@ -1040,21 +1108,9 @@ int gsm0503_pdtch_decode(uint8_t *l2_data, const sbit_t *bursts, uint8_t *usf_p,
 		}
 	}
 
-	gsm0503_xcch_deinterleave(cB, iB);
+	_xcch_decode_bursts(cB, bursts);
 
 	switch (cs) {
-	case 1:
-		osmo_conv_decode_ber(&gsm0503_xcch, cB,
-			conv, n_errors, n_bits_total);
-
-		rv = osmo_crc64gen_check_bits(&gsm0503_fire_crc40,
-			conv, 184, conv + 184);
-		if (rv)
-			return -1;
-
-		osmo_ubit2pbit_ext(l2_data, 0, conv, 0, 184, 1);
-
-		return 23;
 	case 2:
 		for (i = 587, j = 455; i >= 0; i--) {
 			if (!gsm0503_puncture_cs2[i])
@@ -1062,10 +1118,59 @@ int gsm0503_pdtch_decode(uint8_t *l2_data, const sbit_t *bursts, uint8_t *usf_p,
 			else
 				cB[i] = 0;
 		}
+		break;
+	case 3:
+		for (i = 675, j = 455; i >= 0; i--) {
+			if (!gsm0503_puncture_cs3[i])
+				cB[i] = cB[j--];
+			else
+				cB[i] = 0;
+		}
+		break;
+	}
 
-		osmo_conv_decode_ber(&gsm0503_cs2_np, cB,
-			conv, n_errors, n_bits_total);
+	return cs;
+}
+
+/*! convolutional code of a PDTCH coding scheme
+ *  \param[in] cs coding scheme (1..4)
+ *  \returns code; NULL for CS-4, which isn't convolutionally coded */
+static const struct osmo_conv_code *_pdtch_conv_code(int cs)
+{
+	switch (cs) {
+	case 1:
+		return &gsm0503_xcch;
+	case 2:
+		return &gsm0503_cs2_np;
+	case 3:
+		return &gsm0503_cs3_np;
+	default:
+		return NULL;
+	}
+}
 
+/*! decode the USF, check CRC of decoded PDTCH bits and pack them
+ *  \param[out] l2_data caller-allocated buffer for L2 Frame
+ *  \param[in] cB coded (soft) bits as from _pdtch_decode_bursts()
+ *  \param[inout] conv decoded bits; unused for CS-4
+ *  \param[in] cs coding scheme (1..4)
+ *  \param[out] usf_p uplink stealing flag
+ *  \param[out] n_errors number of detected bit-errors, CS-4 only
+ *  \param[out] n_bits_total total number of dcoded bits, CS-4 only
+ *  \returns number of bytes in l2_data; negative on error */
+static int _pdtch_decode_conv(uint8_t *l2_data, const sbit_t *cB, ubit_t *conv,
+	int cs, uint8_t *usf_p, int *n_errors, int *n_bits_total)
+{
+	int i, j, k, rv, best = 0, usf = 0; /* make GCC happy */
+
+	switch (cs) {
+	case 1:
+		rv = _xcch_decode_conv(l2_data, conv);
+		if (rv)
+			return -1;
+
+		return 23;
+	case 2:
 		for (i = 0; i < 8; i++) {
 			for (j = 0, k = 0; j < 6; j++)
 				k += abs(((int)gsm0503_usf2six[i][j]) - ((int)conv[j]));
@@ -1091,16 +1196,6 @@ int gsm0503_pdtch_decode(uint8_t *l2_data, const sbit_t *bursts, uint8_t *usf_p,
 
 		return 34;
 	case 3:
-		for (i = 675, j = 455; i >= 0; i--) {
-			if (!gsm0503_puncture_cs3[i])
-				cB[i] = cB[j--];
-			else
-				cB[i] = 0;
-		}
-
-		osmo_conv_decode_ber(&gsm0503_cs3_np, cB,
-			conv, n_errors, n_bits_total);
-
 		for (i = 0; i < 8; i++) {
 			for (j = 0, k = 0; j < 6; j++)
 				k += abs(((int)gsm0503_usf2six[i][j]) - ((int)conv[j]));
@@ -1168,6 +1263,75 @@ int gsm0503_pdtch_decode(uint8_t *l2_data, const sbit_t *bursts, uint8_t *usf_p,
 	return -1;
 }
 
+/*! Decode GPRS PDTCH
+ *  \param[out] l2_data caller-allocated buffer for L2 Frame
+ *  \param[in] bursts burst input data as soft unpacked bits
+ *  \param[out] usf_p uplink stealing flag
+ *  \param[out] n_errors number of detected bit-errors
+ *  \param[out] n_bits_total total number of dcoded bits
+ *  \returns 0 on success; negative on error */
+int gsm0503_pdtch_decode(uint8_t *l2_data, const sbit_t *bursts, uint8_t *usf_p,
+	int *n_errors, int *n_bits_total)
+{
+	const struct osmo_conv_code *code;
+	sbit_t cB[676];
+	ubit_t conv[456];
+	int cs;
+
+	cs = _pdtch_decode_bursts(cB, bursts);
+
+	code = _pdtch_conv_code(cs);
+	if (code)
+		osmo_conv_decode_ber(code, cB, conv, n_errors, n_bits_total);
+
+	return _pdtch_decode_conv(l2_data, cB, conv, cs, usf_p,
+		n_errors, n_bits_total);
+}
+
+/*! Decode several GPRS PDTCH blocks at once
+ *  Blocks of several timeslots or channels are decoded in parallel, see
+ *  osmo_conv_decode_batch().  The results are the same as those of
+ *  gsm0503_pdtch_decode() for each block.
+ *  \param[in] n Number of blocks
+ *  \param[out] l2_data n caller-allocated buffers for L2 Frames
+ *  \param[in] bursts n sets of burst input data as soft unpacked bits
+ *  \param[out] usf n uplink stealing flags; can be NULL
+ *  \param[out] n_errors n numbers of detected bit-errors; can be NULL
+ *  \param[out] n_bits_total n total numbers of dcoded bits; can be NULL
+ *  \param[out] rc n return values of gsm0503_pdtch_decode()
+ *  \returns number of blocks decoded successfully */
+int gsm0503_pdtch_decode_batch(unsigned int n, uint8_t * const *l2_data,
+	const sbit_t * const *bursts, uint8_t *usf, int *n_errors,
+	int *n_bits_total, int *rc)
+{
+	struct batch_block blk[BATCH_MAX];
+	int cs[BATCH_MAX];
+	unsigned int i, j, cnt;
+	int ok = 0;
+
+	for (i = 0; i < n; i += cnt) {
+		cnt = OSMO_MIN(n - i, BATCH_MAX);
+
+		for (j = 0; j < cnt; j++) {
+			cs[j] = _pdtch_decode_bursts(blk[j].cB, bursts[i + j]);
+			blk[j].code = _pdtch_conv_code(cs[j]);
+		}
+
+		batch_decode_conv(blk, cnt);
+
+		for (j = 0; j < cnt; j++) {
+			rc[i + j] = _pdtch_decode_conv(l2_data[i + j], blk[j].cB,
+				blk[j].conv, cs[j], usf ? &usf[i + j] : NULL,
+				&blk[j].n_errors, &blk[j].n_bits_total);
+			batch_block_result(&blk[j], i + j, n_errors, n_bits_total);
+			if (rc[i + j] >= 0)
+				ok++;
+		}
+	}
+
+	return ok;
+}
+
 /*
  * EGPRS PDTCH DL block encoding
  */
@@ -1831,35 +1995,48 @@ static void tch_amr_unmerge(ubit_t *d, ubit_t *p, const ubit_t *u, int len, int
 	memcpy(d + prot, u + prot + 6, len - prot);
 }
 
-/*! Perform channel decoding of a FR/EFR channel according TS 05.03
- *  \param[out] tch_data Codec frame in RTP payload format
+/*! unmap and deinterleave eight TCH/FS bursts
+ *  \param[out] cB 456 coded (soft) bits
  *  \param[in] bursts buffer containing the symbols of 8 bursts
- *  \param[in] net_order FIXME
- *  \param[in] efr Is this channel using EFR (1) or FR (0)
- *  \param[out] n_errors Number of detected bit errors
- *  \param[out] n_bits_total Total number of bits
- *  \returns length of bytes used in \a tch_data output buffer; negative on error */
-int gsm0503_tch_fr_decode(uint8_t *tch_data, const sbit_t *bursts,
-	int net_order, int efr, int *n_errors, int *n_bits_total)
+ *  \returns 1 if the block is stolen for FACCH; 0 otherwise */
+static int _tch_fr_decode_bursts(sbit_t *cB, const sbit_t *bursts)
 {
-	sbit_t iB[912], cB[456], h;
-	ubit_t conv[185], s[244], w[260], b[65], d[260], p[8];
-	int i, rv, len, steal = 0;
+	sbit_t h;
+	int i, k, steal = 0;
 
-	/* map from 8 bursts to interleaved data bits (iB) */
+	/* stealing flags of the 8 bursts: the first 4 bursts only carry
+	 * the even bits of this block, the last 4 the odd bits */
 	for (i = 0; i < 8; i++) {
-		gsm0503_tch_burst_unmap(&iB[i * 114],
-			&bursts[i * 116], &h, i >> 2);
+		gsm0503_tch_burst_unmap(NULL, &bursts[i * 116], &h, i >> 2);
 		steal -= h;
 	}
-	/* we now have the bits of the four bursts (interface 4 in
-	 * Figure 1a of TS 05.03 */
 
-	gsm0503_tch_fr_deinterleave(cB, iB);
-	/* we now have the coded bits c(B): interface 3 in Fig. 1a */
+	/* gsm0503_tch_burst_unmap() and gsm0503_tch_fr_deinterleave() in
+	 * one pass: we get the coded bits c(B), interface 3 in Fig. 1a of
+	 * TS 05.03, without going through the bits of the bursts at
+	 * interface 4 */
+	for (k = 0; k < 456; k++)
+		cB[k] = bursts[gsm0503_interleave_tch_fr_burst[k]];
 
-	if (steal > 0) {
-		rv = _xcch_decode_cB(tch_data, cB, n_errors, n_bits_total);
+	return steal > 0;
+}
+
+/*! check CRC of decoded FR/EFR bits and reassemble the codec frame
+ *  \param[out] tch_data Codec frame in RTP payload format
+ *  \param[in] cB 456 coded (soft) bits
+ *  \param[in] conv decoded bits, 185 of TCH/FS or 224 of FACCH if stolen
+ *  \param[in] steal Is the block stolen for FACCH
+ *  \param[in] net_order FIXME
+ *  \param[in] efr Is this channel using EFR (1) or FR (0)
+ *  \returns length of bytes used in \a tch_data output buffer; negative on error */
+static int _tch_fr_decode_conv(uint8_t *tch_data, const sbit_t *cB,
+	const ubit_t *conv, int steal, int net_order, int efr)
+{
+	ubit_t s[244], w[260], b[65], d[260], p[8];
+	int i, rv, len;
+
+	if (steal) {
+		rv = _xcch_decode_conv(tch_data, conv);
 		if (rv) {
 			/* Error decoding FACCH frame */
 			return -1;
@@ -1868,9 +2045,6 @@ int gsm0503_tch_fr_decode(uint8_t *tch_data, const sbit_t *bursts,
 		return 23;
 	}
 
-	osmo_conv_decode_ber(&gsm0503_tch_fr, cB, conv, n_errors, n_bits_total);
-	/* we now have the data bits 'u': interface 2 in Fig. 1a */
-
 	/* input: 'conv', output: d[ata] + p[arity] */
 	tch_fr_unreorder(d, p, conv);
 
@@ -1917,6 +2091,75 @@ int gsm0503_tch_fr_decode(uint8_t *tch_data, const sbit_t *bursts,
 	return len;
 }
 
+
+/*! Perform channel decoding of a FR/EFR channel according TS 05.03
+ *  \param[out] tch_data Codec frame in RTP payload format
+ *  \param[in] bursts buffer containing the symbols of 8 bursts
+ *  \param[in] net_order FIXME
+ *  \param[in] efr Is this channel using EFR (1) or FR (0)
+ *  \param[out] n_errors Number of detected bit errors
+ *  \param[out] n_bits_total Total number of bits
+ *  \returns length of bytes used in \a tch_data output buffer; negative on error */
+int gsm0503_tch_fr_decode(uint8_t *tch_data, const sbit_t *bursts,
+	int net_order, int efr, int *n_errors, int *n_bits_total)
+{
+	sbit_t cB[456];
+	ubit_t conv[224];
+	int steal;
+
+	steal = _tch_fr_decode_bursts(cB, bursts);
+
+	osmo_conv_decode_ber(steal ? &gsm0503_xcch : &gsm0503_tch_fr, cB,
+		conv, n_errors, n_bits_total);
+	/* we now have the data bits 'u': interface 2 in Fig. 1a */
+
+	return _tch_fr_decode_conv(tch_data, cB, conv, steal, net_order, efr);
+}
+
+/*! Perform channel decoding of several FR/EFR blocks at once
+ *  Blocks of several timeslots or channels are decoded in parallel, see
+ *  osmo_conv_decode_batch().  The results are the same as those of
+ *  gsm0503_tch_fr_decode() for each block.
+ *  \param[in] n Number of blocks
+ *  \param[out] tch_data n Codec frames in RTP payload format
+ *  \param[in] bursts n buffers containing the symbols of 8 bursts
+ *  \param[in] net_order FIXME
+ *  \param[in] efr Is this channel using EFR (1) or FR (0)
+ *  \param[out] n_errors n Numbers of detected bit errors; can be NULL
+ *  \param[out] n_bits_total n Total numbers of bits; can be NULL
+ *  \param[out] rc n return values of gsm0503_tch_fr_decode()
+ *  \returns number of blocks decoded successfully */
+int gsm0503_tch_fr_decode_batch(unsigned int n, uint8_t * const *tch_data,
+	const sbit_t * const *bursts, int net_order, int efr, int *n_errors,
+	int *n_bits_total, int *rc)
+{
+	struct batch_block blk[BATCH_MAX];
+	int steal[BATCH_MAX];
+	unsigned int i, j, cnt;
+	int ok = 0;
+
+	for (i = 0; i < n; i += cnt) {
+		cnt = OSMO_MIN(n - i, BATCH_MAX);
+
+		for (j = 0; j < cnt; j++) {
+			steal[j] = _tch_fr_decode_bursts(blk[j].cB, bursts[i + j]);
+			blk[j].code = steal[j] ? &gsm0503_xcch : &gsm0503_tch_fr;
+		}
+
+		batch_decode_conv(blk, cnt);
+
+		for (j = 0; j < cnt; j++) {
+			rc[i + j] = _tch_fr_decode_conv(tch_data[i + j], blk[j].cB,
+				blk[j].conv, steal[j], net_order, efr);
+			batch_block_result(&blk[j], i + j, n_errors, n_bits_total);
+			if (rc[i + j] >= 0)
+				ok++;
+		}
+	}
+
+	return ok;
+}
+
 /*! Perform channel encoding on a TCH/FS channel according to TS 05.03
  *  \param[out] bursts caller-allocated output buffer for bursts bits
  *  \param[in] tch_data Codec input data in RTP payload format
@@ -2158,7 +2401,7 @@ int gsm0503_tch_afs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts,
 	int codec_mode_req, uint8_t *codec, int codecs, uint8_t *ft,
 	uint8_t *cmr, int *n_errors, int *n_bits_total, uint8_t *dtx)
 {
-	sbit_t iB[912], cB[456], h;
+	sbit_t cB[456];
 	ubit_t d[244], p[6], conv[250];
 	int i, j, k, best = 0, rv, len, steal = 0, id = 0;
 	ubit_t cBd[456];
@@ -2167,12 +2410,7 @@ int gsm0503_tch_afs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts,
 	sbit_t sid_update_enc[256];
 	uint8_t dtx_prev;
 
-	for (i=0; i<8; i++) {
-		gsm0503_tch_burst_unmap(&iB[i * 114], &bursts[i * 116], &h, i >> 2);
-		steal -= h;
-	}
-
-	gsm0503_tch_fr_deinterleave(cB, iB);
+	steal = _tch_fr_decode_bursts(cB, bursts);
 
 	if (steal > 0) {
 		rv = _xcch_decode_cB(tch_data, cB, n_errors, n_bits_total);
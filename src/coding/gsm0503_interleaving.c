@@ -85,13 +85,10 @@
  *  \param[in] iB 456 soft input bits */
 void gsm0503_xcch_deinterleave(sbit_t *cB, const sbit_t *iB)
 {
-	int j, k, B;
+	int k;
 
-	for (k = 0; k < 456; k++) {
-		B = k & 3;
-		j = 2 * ((49 * k) % 57) + ((k & 7) >> 2);
-		cB[k] = iB[B * 114 + j];
-	}
+	for (k = 0; k < 456; k++)
+		cB[k] = iB[gsm0503_interleave_xcch[k]];
 }
 
 /*! Interleave burst bits according to TS 05.03 4.1.4
@@ -99,13 +96,10 @@ void gsm0503_xcch_deinterleave(sbit_t *cB, const sbit_t *iB)
  *  \param[in] cB 456 soft input coded bits */
 void gsm0503_xcch_interleave(const ubit_t *cB, ubit_t *iB)
 {
-	int j, k, B;
+	int k;
 
-	for (k = 0; k < 456; k++) {
-		B = k & 3;
-		j = 2 * ((49 * k) % 57) + ((k & 7) >> 2);
-		iB[B * 114 + j] = cB[k];
-	}
+	for (k = 0; k < 456; k++)
+		iB[gsm0503_interleave_xcch[k]] = cB[k];
 }
 
 /*! De-Interleave MCS1 DL burst bits according to TS 05.03 5.1.5.1.5
@@ -267,7 +261,7 @@ void gsm0503_mcs5_ul_interleave(const ubit_t *hc, const ubit_t *dc,
 
 	/* Header */
 	for (k = 0; k < 136; k++) {
-		j = 34 * (k % 4) + 2 * (11 * k % 17) + k % 8 / 4;
+		j = gsm0503_interleave_mcs5_ul_hdr[k];
 		hi[j] = hc[k];
 	}
 
@@ -290,7 +284,7 @@ void gsm0503_mcs5_ul_deinterleave(sbit_t *hc, sbit_t *dc,
 	/* Header */
 	if (hc) {
 		for (k = 0; k < 136; k++) {
-			j = 34 * (k % 4) + 2 * (11 * k % 17) + k % 8 / 4;
+			j = gsm0503_interleave_mcs5_ul_hdr[k];
 			hc[k] = hi[j];
 		}
 	}
@@ -316,7 +310,7 @@ void gsm0503_mcs5_dl_interleave(const ubit_t *hc, const ubit_t *dc,
 
 	/* Header */
 	for (k = 0; k < 100; k++) {
-		j = 25 * (k % 4) + ((17 * k) % 25);
+		j = gsm0503_interleave_mcs5_dl_hdr[k];
 		hi[j] = hc[k];
 	}
 
@@ -339,7 +333,7 @@ void gsm0503_mcs5_dl_deinterleave(sbit_t *hc, sbit_t *dc,
 	/* Header */
 	if (hc) {
 		for (k = 0; k < 100; k++) {
-			j = 25 * (k % 4) + ((17 * k) % 25);
+			j = gsm0503_interleave_mcs5_dl_hdr[k];
 			hc[k] = hi[j];
 		}
 	}
@@ -363,22 +357,17 @@ void gsm0503_mcs7_dl_interleave(const ubit_t *hc, const ubit_t *c1,
 	const ubit_t *c2, ubit_t *hi, ubit_t *di)
 {
 	int j, k;
-	ubit_t dc[1224];
 
 	/* Header */
 	for (k = 0; k < 124; k++) {
-		j = 31 * (k % 4) + ((17 * k) % 31);
+		j = gsm0503_interleave_mcs7_dl_hdr[k];
 		hi[j] = hc[k];
 	}
 
-	memcpy(&dc[0], c1, 612);
-	memcpy(&dc[612], c2, 612);
-
 	/* Data */
-	for (k = 0; k < 1224; k++) {
-		j = 306 * (k % 4) + 3 * (44 * k % 102 + k / 4 % 2) +
-			(k + 2 - k / 408) % 3;
-		di[j] = dc[k];
+	for (k = 0; k < 612; k++) {
+		di[gsm0503_interleave_mcs7[k]] = c1[k];
+		di[gsm0503_interleave_mcs7[k + 612]] = c2[k];
 	}
 }
 
@@ -392,26 +381,21 @@ void gsm0503_mcs7_dl_deinterleave(sbit_t *hc, sbit_t *c1, sbit_t *c2,
 	const sbit_t *hi, const sbit_t *di)
 {
 	int j, k;
-	ubit_t dc[1224];
 
 	/* Header */
 	if (hc) {
 		for (k = 0; k < 124; k++) {
-			j = 31 * (k % 4) + ((17 * k) % 31);
+			j = gsm0503_interleave_mcs7_dl_hdr[k];
 			hc[k] = hi[j];
 		}
 	}
 
 	/* Data */
 	if (c1 && c2) {
-		for (k = 0; k < 1224; k++) {
-			j = 306 * (k % 4) + 3 * (44 * k % 102 + k / 4 % 2) +
-	(k + 2 - k / 408) % 3;
-			dc[k] = di[j];
+		for (k = 0; k < 612; k++) {
+			c1[k] = di[gsm0503_interleave_mcs7[k]];
+			c2[k] = di[gsm0503_interleave_mcs7[k + 612]];
 		}
-
-		memcpy(c1, &dc[0], 612);
-		memcpy(c2, &dc[612], 612);
 	}
 }
 
@@ -425,22 +409,17 @@ void gsm0503_mcs7_ul_interleave(const ubit_t *hc, const ubit_t *c1,
 	const ubit_t *c2, ubit_t *hi, ubit_t *di)
 {
 	int j, k;
-	ubit_t dc[1224];
 
 	/* Header */
 	for (k = 0; k < 160; k++) {
-		j = 40 * (k % 4) + 2 * (13 * (k / 8) % 20) + k % 8 / 4;
+		j = gsm0503_interleave_mcs7_ul_hdr[k];
 		hi[j] = hc[k];
 	}
 
-	memcpy(&dc[0], c1, 612);
-	memcpy(&dc[612], c2, 612);
-
 	/* Data */
-	for (k = 0; k < 1224; k++) {
-		j = 306 * (k % 4) + 3 * (44 * k % 102 + k / 4 % 2) +
-			(k + 2 - k / 408) % 3;
-		di[j] = dc[k];
+	for (k = 0; k < 612; k++) {
+		di[gsm0503_interleave_mcs7[k]] = c1[k];
+		di[gsm0503_interleave_mcs7[k + 612]] = c2[k];
 	}
 }
 
@@ -454,26 +433,21 @@ void gsm0503_mcs7_ul_deinterleave(sbit_t *hc, sbit_t *c1, sbit_t *c2,
 	const sbit_t *hi, const sbit_t *di)
 {
 	int j, k;
-	ubit_t dc[1224];
 
 	/* Header */
 	if (hc) {
 		for (k = 0; k < 160; k++) {
-			j = 40 * (k % 4) + 2 * (13 * (k / 8) % 20) + k % 8 / 4;
+			j = gsm0503_interleave_mcs7_ul_hdr[k];
 			hc[k] = hi[j];
 		}
 	}
 
 	/* Data */
 	if (c1 && c2) {
-		for (k = 0; k < 1224; k++) {
-			j = 306 * (k % 4) + 3 * (44 * k % 102 + k / 4 % 2) +
-	(k + 2 - k / 408) % 3;
-			dc[k] = di[j];
+		for (k = 0; k < 612; k++) {
+			c1[k] = di[gsm0503_interleave_mcs7[k]];
+			c2[k] = di[gsm0503_interleave_mcs7[k + 612]];
 		}
-
-		memcpy(c1, &dc[0], 612);
-		memcpy(c2, &dc[612], 612);
 	}
 }
 
@@ -487,22 +461,17 @@ void gsm0503_mcs8_ul_interleave(const ubit_t *hc, const ubit_t *c1,
 	const ubit_t *c2, ubit_t *hi, ubit_t *di)
 {
 	int j, k;
-	ubit_t dc[1224];
 
 	/* Header */
 	for (k = 0; k < 160; k++) {
-		j = 40 * (k % 4) + 2 * (13 * (k / 8) % 20) + k % 8 / 4;
+		j = gsm0503_interleave_mcs7_ul_hdr[k];
 		hi[j] = hc[k];
 	}
 
-	memcpy(&dc[0], c1, 612);
-	memcpy(&dc[612], c2, 612);
-
 	/* Data */
-	for (k = 0; k < 1224; k++) {
-		j = 306 * (2 * (k / 612) + (k % 2)) +
-			3 * (74 * k % 102 + k / 2 % 2) + (k + 2 - k / 204) % 3;
-		di[j] = dc[k];
+	for (k = 0; k < 612; k++) {
+		di[gsm0503_interleave_mcs8[k]] = c1[k];
+		di[gsm0503_interleave_mcs8[k + 612]] = c2[k];
 	}
 }
 
@@ -517,26 +486,21 @@ void gsm0503_mcs8_ul_deinterleave(sbit_t *hc, sbit_t *c1, sbit_t *c2,
 	const sbit_t *hi, const sbit_t *di)
 {
 	int j, k;
-	ubit_t dc[1224];
 
 	/* Header */
 	if (hc) {
 		for (k = 0; k < 160; k++) {
-			j = 40 * (k % 4) + 2 * (13 * (k / 8) % 20) + k % 8 / 4;
+			j = gsm0503_interleave_mcs7_ul_hdr[k];
 			hc[k] = hi[j];
 		}
 	}
 
 	/* Data */
 	if (c1 && c2) {
-		for (k = 0; k < 1224; k++) {
-			j = 306 * (2 * (k / 612) + (k % 2)) +
-	3 * (74 * k % 102 + k / 2 % 2) + (k + 2 - k / 204) % 3;
-			dc[k] = di[j];
+		for (k = 0; k < 612; k++) {
+			c1[k] = di[gsm0503_interleave_mcs8[k]];
+			c2[k] = di[gsm0503_interleave_mcs8[k + 612]];
 		}
-
-		memcpy(c1, &dc[0], 612);
-		memcpy(c2, &dc[612], 612);
 	}
 }
 
@@ -550,22 +514,17 @@ void gsm0503_mcs8_dl_interleave(const ubit_t *hc, const ubit_t *c1,
 	const ubit_t *c2, ubit_t *hi, ubit_t *di)
 {
 	int j, k;
-	ubit_t dc[1224];
 
 	/* Header */
 	for (k = 0; k < 124; k++) {
-		j = 31 * (k % 4) + ((17 * k) % 31);
+		j = gsm0503_interleave_mcs7_dl_hdr[k];
 		hi[j] = hc[k];
 	}
 
-	memcpy(&dc[0], c1, 612);
-	memcpy(&dc[612], c2, 612);
-
 	/* Data */
-	for (k = 0; k < 1224; k++) {
-		j = 306 * (2 * (k / 612) + (k % 2)) +
-			3 * (74 * k % 102 + k / 2 % 2) + (k + 2 - k / 204) % 3;
-		di[j] = dc[k];
+	for (k = 0; k < 612; k++) {
+		di[gsm0503_interleave_mcs8[k]] = c1[k];
+		di[gsm0503_interleave_mcs8[k + 612]] = c2[k];
 	}
 }
 
@@ -579,26 +538,21 @@ void gsm0503_mcs8_dl_deinterleave(sbit_t *hc, sbit_t *c1, sbit_t *c2,
 	const sbit_t *hi, const sbit_t *di)
 {
 	int j, k;
-	ubit_t dc[1224];
 
 	/* Header */
 	if (hc) {
 		for (k = 0; k < 124; k++) {
-			j = 31 * (k % 4) + ((17 * k) % 31);
+			j = gsm0503_interleave_mcs7_dl_hdr[k];
 			hc[k] = hi[j];
 		}
 	}
 
 	/* Data */
 	if (c1 && c2) {
-		for (k = 0; k < 1224; k++) {
-			j = 306 * (2 * (k / 612) + (k % 2)) +
-	3 * (74 * k % 102 + k / 2 % 2) + (k + 2 - k / 204) % 3;
-			dc[k] = di[j];
+		for (k = 0; k < 612; k++) {
+			c1[k] = di[gsm0503_interleave_mcs8[k]];
+			c2[k] = di[gsm0503_interleave_mcs8[k + 612]];
 		}
-
-		memcpy(c1, &dc[0], 612);
-		memcpy(c2, &dc[612], 612);
 	}
 }
 
@@ -631,13 +585,10 @@ void gsm0503_mcs8_dl_deinterleave(sbit_t *hc, sbit_t *c1, sbit_t *c2,
  *  \param[in] iB 456 unpacked interleaved input bits */
 void gsm0503_tch_fr_deinterleave(sbit_t *cB, const sbit_t *iB)
 {
-	int j, k, B;
+	int k;
 
-	for (k = 0; k < 456; k++) {
-		B = k & 7;
-		j = 2 * ((49 * k) % 57) + ((k & 7) >> 2);
-		cB[k] = iB[B * 114 + j];
-	}
+	for (k = 0; k < 456; k++)
+		cB[k] = iB[gsm0503_interleave_tch_fr[k]];
 }
 
 /*! GSM TCH FR/EFR/AFS Interleaving and burst mapping
@@ -645,13 +596,10 @@ void gsm0503_tch_fr_deinterleave(sbit_t *cB, const sbit_t *iB)
  *  \param[out] iB 456 unpacked interleaved output bits */
 void gsm0503_tch_fr_interleave(const ubit_t *cB, ubit_t *iB)
 {
-	int j, k, B;
+	int k;
 
-	for (k = 0; k < 456; k++) {
-		B = k & 7;
-		j = 2 * ((49 * k) % 57) + ((k & 7) >> 2);
-		iB[B * 114 + j] = cB[k];
-	}
+	for (k = 0; k < 456; k++)
+		iB[gsm0503_interleave_tch_fr[k]] = cB[k];
 }
 
 /*! GSM TCH HR/AHS De-Interleaving and burst mapping
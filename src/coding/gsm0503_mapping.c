@@ -103,40 +103,26 @@ void gsm0503_mcs5_dl_burst_map(const ubit_t *di, ubit_t *eB,
 	int j;
 	int q[8] = { 0, 0, 0, 0, 0, 0, 0, 0, };
 
-	for (j = 0; j < 156; j++)
-		eB[j] = di[312 * B + j];
-	for (j = 156; j < 168; j++)
-		eB[j] = hi[25 * B + j - 156];
-	for (j = 168; j < 174; j++)
-		eB[j] = up[9 * B + j - 168];
+	memcpy(eB, &di[312 * B], 156);
+	memcpy(eB + 156, &hi[25 * B], 12);
+	memcpy(eB + 168, &up[9 * B], 6);
 	for (j = 174; j < 176; j++)
 		eB[j] = q[2 * B + j - 174];
-	for (j = 176; j < 179; j++)
-		eB[j] = up[9 * B + j - 170];
-	for (j = 179; j < 192; j++)
-		eB[j] = hi[25 * B + j - 167];
-	for (j = 192; j < 348; j++)
-		eB[j] = di[312 * B + j - 36];
+	memcpy(eB + 176, &up[9 * B + 6], 3);
+	memcpy(eB + 179, &hi[25 * B + 12], 13);
+	memcpy(eB + 192, &di[312 * B + 156], 156);
 }
 
 void gsm0503_mcs5_dl_burst_unmap(sbit_t *di, const sbit_t *eB,
 	sbit_t *hi, sbit_t *up, int B)
 {
-	int j;
+	memcpy(&di[312 * B], eB, 156);
+	memcpy(&hi[25 * B], eB + 156, 12);
+	memcpy(&up[9 * B], eB + 168, 6);
 
-	for (j = 0; j < 156; j++)
-		di[312 * B + j] = eB[j];
-	for (j = 156; j < 168; j++)
-		hi[25 * B + j - 156] = eB[j];
-	for (j = 168; j < 174; j++)
-		up[9 * B + j - 168] = eB[j];
-
-	for (j = 176; j < 179; j++)
-		up[9 * B + j - 170] = eB[j];
-	for (j = 179; j < 192; j++)
-		hi[25 * B + j - 167] = eB[j];
-	for (j = 192; j < 348; j++)
-		di[312 * B + j - 36] = eB[j];
+	memcpy(&up[9 * B + 6], eB + 176, 3);
+	memcpy(&hi[25 * B + 12], eB + 179, 13);
+	memcpy(&di[312 * B + 156], eB + 192, 156);
 }
 
 void gsm0503_mcs5_ul_burst_map(const ubit_t *di, ubit_t *eB,
@@ -144,31 +130,21 @@ void gsm0503_mcs5_ul_burst_map(const ubit_t *di, ubit_t *eB,
 {
 	int j;
 
-	for (j = 0; j < 156; j++)
-		eB[j] = di[312 * B + j];
-	for (j = 156; j < 174; j++)
-		eB[j] = hi[34 * B + j - 156];
+	memcpy(eB, &di[312 * B], 156);
+	memcpy(eB + 156, &hi[34 * B], 18);
 	for (j = 174; j < 176; j++)
 		eB[j] = 0;
-	for (j = 176; j < 192; j++)
-		eB[j] = hi[34 * B + j - 158];
-	for (j = 192; j < 348; j++)
-		eB[j] = di[312 * B + j - 36];
+	memcpy(eB + 176, &hi[34 * B + 18], 16);
+	memcpy(eB + 192, &di[312 * B + 156], 156);
 }
 
 void gsm0503_mcs5_ul_burst_unmap(sbit_t *di, const sbit_t *eB,
 	sbit_t *hi, int B)
 {
-	int j;
-
-	for (j = 0; j < 156; j++)
-		di[312 * B + j] = eB[j];
-	for (j = 156; j < 174; j++)
-		hi[34 * B + j - 156] = eB[j];
-	for (j = 176; j < 192; j++)
-		hi[34 * B + j - 158] = eB[j];
-	for (j = 192; j < 348; j++)
-		di[312 * B + j - 36] = eB[j];
+	memcpy(&di[312 * B], eB, 156);
+	memcpy(&hi[34 * B], eB + 156, 18);
+	memcpy(&hi[34 * B + 18], eB + 176, 16);
+	memcpy(&di[312 * B + 156], eB + 192, 156);
 }
 
 void gsm0503_mcs7_dl_burst_map(const ubit_t *di, ubit_t *eB,
@@ -177,40 +153,26 @@ void gsm0503_mcs7_dl_burst_map(const ubit_t *di, ubit_t *eB,
 	int j;
 	int q[8] = { 1, 1, 1, 0, 0, 1, 1, 1, };
 
-	for (j = 0; j < 153; j++)
-		eB[j] = di[306 * B + j];
-	for (j = 153; j < 168; j++)
-		eB[j] = hi[31 * B + j - 153];
-	for (j = 168; j < 174; j++)
-		eB[j] = up[9 * B + j - 168];
+	memcpy(eB, &di[306 * B], 153);
+	memcpy(eB + 153, &hi[31 * B], 15);
+	memcpy(eB + 168, &up[9 * B], 6);
 	for (j = 174; j < 176; j++)
 		eB[j] = q[2 * B + j - 174];
-	for (j = 176; j < 179; j++)
-		eB[j] = up[9 * B + j - 170];
-	for (j = 179; j < 195; j++)
-		eB[j] = hi[31 * B + j - 164];
-	for (j = 195; j < 348; j++)
-		eB[j] = di[306 * B + j - 42];
+	memcpy(eB + 176, &up[9 * B + 6], 3);
+	memcpy(eB + 179, &hi[31 * B + 15], 16);
+	memcpy(eB + 195, &di[306 * B + 153], 153);
 }
 
 void gsm0503_mcs7_dl_burst_unmap(sbit_t *di, const sbit_t *eB,
 	sbit_t *hi, sbit_t *up, int B)
 {
-	int j;
+	memcpy(&di[306 * B], eB, 153);
+	memcpy(&hi[31 * B], eB + 153, 15);
+	memcpy(&up[9 * B], eB + 168, 6);
 
-	for (j = 0; j < 153; j++)
-		di[306 * B + j] = eB[j];
-	for (j = 153; j < 168; j++)
-		hi[31 * B + j - 153] = eB[j];
-	for (j = 168; j < 174; j++)
-		up[9 * B + j - 168] = eB[j];
-
-	for (j = 176; j < 179; j++)
-		up[9 * B + j - 170] = eB[j];
-	for (j = 179; j < 195; j++)
-		hi[31 * B + j - 164] = eB[j];
-	for (j = 195; j < 348; j++)
-		di[306 * B + j - 42] = eB[j];
+	memcpy(&up[9 * B + 6], eB + 176, 3);
+	memcpy(&hi[31 * B + 15], eB + 179, 16);
+	memcpy(&di[306 * B + 153], eB + 195, 153);
 }
 
 void gsm0503_mcs7_ul_burst_map(const ubit_t *di, ubit_t *eB,
@@ -219,32 +181,22 @@ void gsm0503_mcs7_ul_burst_map(const ubit_t *di, ubit_t *eB,
 	int j;
 	int q[8] = { 1, 1, 1, 0, 0, 1, 1, 1, };
 
-	for (j = 0; j < 153; j++)
-		eB[j] = di[306 * B + j];
-	for (j = 153; j < 174; j++)
-		eB[j] = hi[40 * B + j - 153];
+	memcpy(eB, &di[306 * B], 153);
+	memcpy(eB + 153, &hi[40 * B], 21);
 	for (j = 174; j < 176; j++)
 		eB[j] = q[2 * B + j - 174];
-	for (j = 176; j < 195; j++)
-		eB[j] = hi[40 * B + j - 155];
-	for (j = 195; j < 348; j++)
-		eB[j] = di[306 * B + j - 42];
+	memcpy(eB + 176, &hi[40 * B + 21], 19);
+	memcpy(eB + 195, &di[306 * B + 153], 153);
 }
 
 void gsm0503_mcs7_ul_burst_unmap(sbit_t *di, const sbit_t *eB,
 	sbit_t *hi, int B)
 {
-	int j;
-
-	for (j = 0; j < 153; j++)
-		di[306 * B + j] = eB[j];
-	for (j = 153; j < 174; j++)
-		hi[40 * B + j - 153] = eB[j];
+	memcpy(&di[306 * B], eB, 153);
+	memcpy(&hi[40 * B], eB + 153, 21);
 
-	for (j = 176; j < 195; j++)
-		hi[40 * B + j - 155] = eB[j];
-	for (j = 195; j < 348; j++)
-		di[306 * B + j - 42] = eB[j];
+	memcpy(&hi[40 * B + 21], eB + 176, 19);
+	memcpy(&di[306 * B + 153], eB + 195, 153);
 }
 
 void gsm0503_mcs5_burst_swap(sbit_t *eB)
@@ -1645,6 +1645,354 @@ const uint16_t gsm0503_interleave_mcs5[1248] = {
 	1132,   44,  931, 1070,  261,  400,  839,  975,  163,  614,  774, 1189,  107,  519, 682, 1097,
 };
 
+/* TS 05.03 4.1.4: B = k mod 4, j = 2(49k mod 57) + ((k mod 8) div 4),
+ * index B * 114 + j */
+const uint16_t gsm0503_interleave_xcch[456] = {
+	   0,  212,  310,  408,   51,  149,  247,  345,  100,  198,  296,  394,   37,  135,  233,  445,
+	  86,  184,  282,  380,   23,  121,  333,  431,   72,  170,  268,  366,    9,  221,  319,  417,
+	  58,  156,  254,  352,  109,  207,  305,  403,   44,  142,  240,  452,   95,  193,  291,  389,
+	  30,  128,  340,  438,   81,  179,  277,  375,   16,  114,  326,  424,   67,  165,  263,  361,
+	   2,  214,  312,  410,   53,  151,  249,  347,  102,  200,  298,  396,   39,  137,  235,  447,
+	  88,  186,  284,  382,   25,  123,  335,  433,   74,  172,  270,  368,   11,  223,  321,  419,
+	  60,  158,  256,  354,  111,  209,  307,  405,   46,  144,  242,  454,   97,  195,  293,  391,
+	  32,  130,  228,  440,   83,  181,  279,  377,   18,  116,  328,  426,   69,  167,  265,  363,
+	   4,  216,  314,  412,   55,  153,  251,  349,  104,  202,  300,  398,   41,  139,  237,  449,
+	  90,  188,  286,  384,   27,  125,  337,  435,   76,  174,  272,  370,   13,  225,  323,  421,
+	  62,  160,  258,  356,  113,  211,  309,  407,   48,  146,  244,  342,   99,  197,  295,  393,
+	  34,  132,  230,  442,   85,  183,  281,  379,   20,  118,  330,  428,   71,  169,  267,  365,
+	   6,  218,  316,  414,   57,  155,  253,  351,  106,  204,  302,  400,   43,  141,  239,  451,
+	  92,  190,  288,  386,   29,  127,  339,  437,   78,  176,  274,  372,   15,  227,  325,  423,
+	  64,  162,  260,  358,    1,  213,  311,  409,   50,  148,  246,  344,  101,  199,  297,  395,
+	  36,  134,  232,  444,   87,  185,  283,  381,   22,  120,  332,  430,   73,  171,  269,  367,
+	   8,  220,  318,  416,   59,  157,  255,  353,  108,  206,  304,  402,   45,  143,  241,  453,
+	  94,  192,  290,  388,   31,  129,  341,  439,   80,  178,  276,  374,   17,  115,  327,  425,
+	  66,  164,  262,  360,    3,  215,  313,  411,   52,  150,  248,  346,  103,  201,  299,  397,
+	  38,  136,  234,  446,   89,  187,  285,  383,   24,  122,  334,  432,   75,  173,  271,  369,
+	  10,  222,  320,  418,   61,  159,  257,  355,  110,  208,  306,  404,   47,  145,  243,  455,
+	  96,  194,  292,  390,   33,  131,  229,  441,   82,  180,  278,  376,   19,  117,  329,  427,
+	  68,  166,  264,  362,    5,  217,  315,  413,   54,  152,  250,  348,  105,  203,  301,  399,
+	  40,  138,  236,  448,   91,  189,  287,  385,   26,  124,  336,  434,   77,  175,  273,  371,
+	  12,  224,  322,  420,   63,  161,  259,  357,  112,  210,  308,  406,   49,  147,  245,  343,
+	  98,  196,  294,  392,   35,  133,  231,  443,   84,  182,  280,  378,   21,  119,  331,  429,
+	  70,  168,  266,  364,    7,  219,  317,  415,   56,  154,  252,  350,  107,  205,  303,  401,
+	  42,  140,  238,  450,   93,  191,  289,  387,   28,  126,  338,  436,   79,  177,  275,  373,
+	  14,  226,  324,  422,   65,  163,  261,  359,
+};
+
+/* The same as gsm0503_interleave_xcch, index into four 116 bit bursts */
+const uint16_t gsm0503_interleave_xcch_burst[456] = {
+	   0,  216,  316,  416,   51,  151,  251,  351,  102,  202,  302,  400,   37,  137,  237,  453,
+	  88,  188,  286,  386,   23,  123,  339,  439,   74,  172,  272,  372,    9,  225,  325,  425,
+	  60,  158,  258,  358,  111,  211,  311,  411,   44,  144,  244,  460,   97,  197,  297,  395,
+	  30,  130,  346,  446,   83,  183,  281,  381,   16,  116,  332,  432,   69,  167,  267,  367,
+	   2,  218,  318,  418,   53,  153,  253,  353,  104,  204,  304,  402,   39,  139,  239,  455,
+	  90,  190,  288,  388,   25,  125,  341,  441,   76,  176,  274,  374,   11,  227,  327,  427,
+	  62,  160,  260,  360,  113,  213,  313,  413,   46,  146,  246,  462,   99,  199,  299,  397,
+	  32,  132,  232,  448,   85,  185,  283,  383,   18,  118,  334,  434,   71,  169,  269,  369,
+	   4,  220,  320,  420,   55,  155,  255,  355,  106,  206,  306,  404,   41,  141,  241,  457,
+	  92,  192,  292,  390,   27,  127,  343,  443,   78,  178,  276,  376,   13,  229,  329,  429,
+	  64,  162,  262,  362,  115,  215,  315,  415,   48,  148,  248,  348,  101,  201,  301,  399,
+	  34,  134,  234,  450,   87,  187,  285,  385,   20,  120,  336,  436,   73,  171,  271,  371,
+	   6,  222,  322,  422,   59,  157,  257,  357,  108,  208,  308,  408,   43,  143,  243,  459,
+	  94,  194,  294,  392,   29,  129,  345,  445,   80,  180,  278,  378,   15,  231,  331,  431,
+	  66,  164,  264,  364,    1,  217,  317,  417,   50,  150,  250,  350,  103,  203,  303,  401,
+	  36,  136,  236,  452,   89,  189,  287,  387,   22,  122,  338,  438,   75,  175,  273,  373,
+	   8,  224,  324,  424,   61,  159,  259,  359,  110,  210,  310,  410,   45,  145,  245,  461,
+	  96,  196,  296,  394,   31,  131,  347,  447,   82,  182,  280,  380,   17,  117,  333,  433,
+	  68,  166,  266,  366,    3,  219,  319,  419,   52,  152,  252,  352,  105,  205,  305,  403,
+	  38,  138,  238,  454,   91,  191,  291,  389,   24,  124,  340,  440,   77,  177,  275,  375,
+	  10,  226,  326,  426,   63,  161,  261,  361,  112,  212,  312,  412,   47,  147,  247,  463,
+	  98,  198,  298,  396,   33,  133,  233,  449,   84,  184,  282,  382,   19,  119,  335,  435,
+	  70,  168,  268,  368,    5,  221,  321,  421,   54,  154,  254,  354,  107,  207,  307,  407,
+	  40,  140,  240,  456,   93,  193,  293,  391,   26,  126,  342,  442,   79,  179,  277,  377,
+	  12,  228,  328,  428,   65,  163,  263,  363,  114,  214,  314,  414,   49,  149,  249,  349,
+	 100,  200,  300,  398,   35,  135,  235,  451,   86,  186,  284,  384,   21,  121,  337,  437,
+	  72,  170,  270,  370,    7,  223,  323,  423,   56,  156,  256,  356,  109,  209,  309,  409,
+	  42,  142,  242,  458,   95,  195,  295,  393,   28,  128,  344,  444,   81,  181,  279,  379,
+	  14,  230,  330,  430,   67,  165,  265,  365,
+};
+
+/* TS 05.03 3.1.3: B = k mod 8, j = 2(49k mod 57) + ((k mod 8) div 4),
+ * index B * 114 + j */
+const uint16_t gsm0503_interleave_tch_fr[456] = {
+	   0,  212,  310,  408,  507,  605,  703,  801,  100,  198,  296,  394,  493,  591,  689,  901,
+	  86,  184,  282,  380,  479,  577,  789,  887,   72,  170,  268,  366,  465,  677,  775,  873,
+	  58,  156,  254,  352,  565,  663,  761,  859,   44,  142,  240,  452,  551,  649,  747,  845,
+	  30,  128,  340,  438,  537,  635,  733,  831,   16,  114,  326,  424,  523,  621,  719,  817,
+	   2,  214,  312,  410,  509,  607,  705,  803,  102,  200,  298,  396,  495,  593,  691,  903,
+	  88,  186,  284,  382,  481,  579,  791,  889,   74,  172,  270,  368,  467,  679,  777,  875,
+	  60,  158,  256,  354,  567,  665,  763,  861,   46,  144,  242,  454,  553,  651,  749,  847,
+	  32,  130,  228,  440,  539,  637,  735,  833,   18,  116,  328,  426,  525,  623,  721,  819,
+	   4,  216,  314,  412,  511,  609,  707,  805,  104,  202,  300,  398,  497,  595,  693,  905,
+	  90,  188,  286,  384,  483,  581,  793,  891,   76,  174,  272,  370,  469,  681,  779,  877,
+	  62,  160,  258,  356,  569,  667,  765,  863,   48,  146,  244,  342,  555,  653,  751,  849,
+	  34,  132,  230,  442,  541,  639,  737,  835,   20,  118,  330,  428,  527,  625,  723,  821,
+	   6,  218,  316,  414,  513,  611,  709,  807,  106,  204,  302,  400,  499,  597,  695,  907,
+	  92,  190,  288,  386,  485,  583,  795,  893,   78,  176,  274,  372,  471,  683,  781,  879,
+	  64,  162,  260,  358,  457,  669,  767,  865,   50,  148,  246,  344,  557,  655,  753,  851,
+	  36,  134,  232,  444,  543,  641,  739,  837,   22,  120,  332,  430,  529,  627,  725,  823,
+	   8,  220,  318,  416,  515,  613,  711,  809,  108,  206,  304,  402,  501,  599,  697,  909,
+	  94,  192,  290,  388,  487,  585,  797,  895,   80,  178,  276,  374,  473,  571,  783,  881,
+	  66,  164,  262,  360,  459,  671,  769,  867,   52,  150,  248,  346,  559,  657,  755,  853,
+	  38,  136,  234,  446,  545,  643,  741,  839,   24,  122,  334,  432,  531,  629,  727,  825,
+	  10,  222,  320,  418,  517,  615,  713,  811,  110,  208,  306,  404,  503,  601,  699,  911,
+	  96,  194,  292,  390,  489,  587,  685,  897,   82,  180,  278,  376,  475,  573,  785,  883,
+	  68,  166,  264,  362,  461,  673,  771,  869,   54,  152,  250,  348,  561,  659,  757,  855,
+	  40,  138,  236,  448,  547,  645,  743,  841,   26,  124,  336,  434,  533,  631,  729,  827,
+	  12,  224,  322,  420,  519,  617,  715,  813,  112,  210,  308,  406,  505,  603,  701,  799,
+	  98,  196,  294,  392,  491,  589,  687,  899,   84,  182,  280,  378,  477,  575,  787,  885,
+	  70,  168,  266,  364,  463,  675,  773,  871,   56,  154,  252,  350,  563,  661,  759,  857,
+	  42,  140,  238,  450,  549,  647,  745,  843,   28,  126,  338,  436,  535,  633,  731,  829,
+	  14,  226,  324,  422,  521,  619,  717,  815,
+};
+
+/* The same as gsm0503_interleave_tch_fr, index into eight 116 bit bursts */
+const uint16_t gsm0503_interleave_tch_fr_burst[456] = {
+	   0,  216,  316,  416,  515,  615,  715,  815,  102,  202,  302,  400,  501,  601,  701,  917,
+	  88,  188,  286,  386,  487,  587,  803,  903,   74,  172,  272,  372,  473,  689,  789,  889,
+	  60,  158,  258,  358,  575,  675,  775,  875,   44,  144,  244,  460,  561,  661,  761,  859,
+	  30,  130,  346,  446,  547,  647,  745,  845,   16,  116,  332,  432,  533,  631,  731,  831,
+	   2,  218,  318,  418,  517,  617,  717,  817,  104,  204,  304,  402,  503,  603,  703,  919,
+	  90,  190,  288,  388,  489,  589,  805,  905,   76,  176,  274,  374,  475,  691,  791,  891,
+	  62,  160,  260,  360,  577,  677,  777,  877,   46,  146,  246,  462,  563,  663,  763,  861,
+	  32,  132,  232,  448,  549,  649,  747,  847,   18,  118,  334,  434,  535,  633,  733,  833,
+	   4,  220,  320,  420,  519,  619,  719,  819,  106,  206,  306,  404,  505,  605,  705,  921,
+	  92,  192,  292,  390,  491,  591,  807,  907,   78,  178,  276,  376,  477,  693,  793,  893,
+	  64,  162,  262,  362,  579,  679,  779,  879,   48,  148,  248,  348,  565,  665,  765,  863,
+	  34,  134,  234,  450,  551,  651,  749,  849,   20,  120,  336,  436,  537,  635,  735,  835,
+	   6,  222,  322,  422,  523,  621,  721,  821,  108,  208,  308,  408,  507,  607,  707,  923,
+	  94,  194,  294,  392,  493,  593,  809,  909,   80,  180,  278,  378,  479,  695,  795,  895,
+	  66,  164,  264,  364,  465,  681,  781,  881,   50,  150,  250,  350,  567,  667,  767,  865,
+	  36,  136,  236,  452,  553,  653,  751,  851,   22,  122,  338,  438,  539,  639,  737,  837,
+	   8,  224,  324,  424,  525,  623,  723,  823,  110,  210,  310,  410,  509,  609,  709,  925,
+	  96,  196,  296,  394,  495,  595,  811,  911,   82,  182,  280,  380,  481,  581,  797,  897,
+	  68,  166,  266,  366,  467,  683,  783,  883,   52,  152,  252,  352,  569,  669,  769,  867,
+	  38,  138,  238,  454,  555,  655,  755,  853,   24,  124,  340,  440,  541,  641,  739,  839,
+	  10,  226,  326,  426,  527,  625,  725,  825,  112,  212,  312,  412,  511,  611,  711,  927,
+	  98,  198,  298,  396,  497,  597,  697,  913,   84,  184,  282,  382,  483,  583,  799,  899,
+	  70,  168,  268,  368,  469,  685,  785,  885,   54,  154,  254,  354,  571,  671,  771,  871,
+	  40,  140,  240,  456,  557,  657,  757,  855,   26,  126,  342,  442,  543,  643,  741,  841,
+	  12,  228,  328,  428,  529,  627,  727,  827,  114,  214,  314,  414,  513,  613,  713,  813,
+	 100,  200,  300,  398,  499,  599,  699,  915,   86,  186,  284,  384,  485,  585,  801,  901,
+	  72,  170,  270,  370,  471,  687,  787,  887,   56,  156,  256,  356,  573,  673,  773,  873,
+	  42,  142,  242,  458,  559,  659,  759,  857,   28,  128,  344,  444,  545,  645,  743,  843,
+	  14,  230,  330,  430,  531,  629,  729,  829,
+};
+
+/* TS 05.03 5.1.9.2.4: j = 34(k mod 4) + 2(11k mod 17) + ((k mod 8) div 4) */
+const uint16_t gsm0503_interleave_mcs5_ul_hdr[136] = {
+	   0,   56,   78,  134,   21,   43,   99,  121,    6,   62,   84,  106,   27,   49,   71,  127,
+	  12,   34,   90,  112,   33,   55,   77,  133,   18,   40,   96,  118,    5,   61,   83,  105,
+	  24,   46,   68,  124,   11,   67,   89,  111,   30,   52,   74,  130,   17,   39,   95,  117,
+	   2,   58,   80,  102,   23,   45,  101,  123,    8,   64,   86,  108,   29,   51,   73,  129,
+	  14,   36,   92,  114,    1,   57,   79,  135,   20,   42,   98,  120,    7,   63,   85,  107,
+	  26,   48,   70,  126,   13,   35,   91,  113,   32,   54,   76,  132,   19,   41,   97,  119,
+	   4,   60,   82,  104,   25,   47,   69,  125,   10,   66,   88,  110,   31,   53,   75,  131,
+	  16,   38,   94,  116,    3,   59,   81,  103,   22,   44,  100,  122,    9,   65,   87,  109,
+	  28,   50,   72,  128,   15,   37,   93,  115,
+};
+
+/* TS 05.03 5.1.9.1.5: j = 25(k mod 4) + (17k mod 25) */
+const uint16_t gsm0503_interleave_mcs5_dl_hdr[100] = {
+	   0,   42,   59,   76,   18,   35,   52,   94,   11,   28,   70,   87,    4,   46,   63,   80,
+	  22,   39,   56,   98,   15,   32,   74,   91,    8,   25,   67,   84,    1,   43,   60,   77,
+	  19,   36,   53,   95,   12,   29,   71,   88,    5,   47,   64,   81,   23,   40,   57,   99,
+	  16,   33,   50,   92,    9,   26,   68,   85,    2,   44,   61,   78,   20,   37,   54,   96,
+	  13,   30,   72,   89,    6,   48,   65,   82,   24,   41,   58,   75,   17,   34,   51,   93,
+	  10,   27,   69,   86,    3,   45,   62,   79,   21,   38,   55,   97,   14,   31,   73,   90,
+	   7,   49,   66,   83,
+};
+
+/* TS 05.03 5.1.11.1.5: j = 31(k mod 4) + (17k mod 31) */
+const uint16_t gsm0503_interleave_mcs7_dl_hdr[124] = {
+	   0,   48,   65,  113,    6,   54,   71,  119,   12,   60,   77,   94,   18,   35,   83,  100,
+	  24,   41,   89,  106,   30,   47,   64,  112,    5,   53,   70,  118,   11,   59,   76,   93,
+	  17,   34,   82,   99,   23,   40,   88,  105,   29,   46,   63,  111,    4,   52,   69,  117,
+	  10,   58,   75,  123,   16,   33,   81,   98,   22,   39,   87,  104,   28,   45,   62,  110,
+	   3,   51,   68,  116,    9,   57,   74,  122,   15,   32,   80,   97,   21,   38,   86,  103,
+	  27,   44,   92,  109,    2,   50,   67,  115,    8,   56,   73,  121,   14,   31,   79,   96,
+	  20,   37,   85,  102,   26,   43,   91,  108,    1,   49,   66,  114,    7,   55,   72,  120,
+	  13,   61,   78,   95,   19,   36,   84,  101,   25,   42,   90,  107,
+};
+
+/* TS 05.03 5.1.11.2.4: j = 40(k mod 4) + 2(13(k div 8) mod 20) + ((k mod 8) div 4) */
+const uint16_t gsm0503_interleave_mcs7_ul_hdr[160] = {
+	   0,   40,   80,  120,    1,   41,   81,  121,   26,   66,  106,  146,   27,   67,  107,  147,
+	  12,   52,   92,  132,   13,   53,   93,  133,   38,   78,  118,  158,   39,   79,  119,  159,
+	  24,   64,  104,  144,   25,   65,  105,  145,   10,   50,   90,  130,   11,   51,   91,  131,
+	  36,   76,  116,  156,   37,   77,  117,  157,   22,   62,  102,  142,   23,   63,  103,  143,
+	   8,   48,   88,  128,    9,   49,   89,  129,   34,   74,  114,  154,   35,   75,  115,  155,
+	  20,   60,  100,  140,   21,   61,  101,  141,    6,   46,   86,  126,    7,   47,   87,  127,
+	  32,   72,  112,  152,   33,   73,  113,  153,   18,   58,   98,  138,   19,   59,   99,  139,
+	   4,   44,   84,  124,    5,   45,   85,  125,   30,   70,  110,  150,   31,   71,  111,  151,
+	  16,   56,   96,  136,   17,   57,   97,  137,    2,   42,   82,  122,    3,   43,   83,  123,
+	  28,   68,  108,  148,   29,   69,  109,  149,   14,   54,   94,  134,   15,   55,   95,  135,
+};
+
+/* TS 05.03 5.1.11.1.5: j = 306(k mod 4) + 3(44k mod 102 + (k div 4) mod 2)
+ *                          + (k + 2 - k div 408) mod 3 */
+const uint16_t gsm0503_interleave_mcs7[1224] = {
+	   2,  438,  877, 1010,  225,  358,  797,  927,  139,  578,  708, 1147,   59,  495,  628, 1067,
+	 276,  409,  848,  978,  196,  329,  765, 1204,  110,  546,  679, 1118,   27,  466,  905, 1035,
+	 247,  380,  816,  949,  167,  603,  736, 1175,   78,  517,  650, 1086,  304,  437,  873, 1006,
+	 218,  348,  787,  920,  135,  574,  707, 1143,   49,  488,  618, 1057,  275,  405,  844,  977,
+	 186,  319,  758, 1194,  106,  545,  675, 1114,   20,  456,  895, 1028,  243,  376,  815,  945,
+	 157,  596,  726, 1165,   77,  513,  646, 1085,  294,  427,  866,  996,  214,  347,  783, 1222,
+	 128,  564,  697, 1136,   45,  484,  617, 1053,  265,  398,  834,  967,  185,  315,  754, 1193,
+	  96,  535,  668, 1104,   16,  455,  891, 1024,  236,  366,  805,  938,  153,  592,  725, 1161,
+	  67,  506,  636, 1075,  293,  423,  862,  995,  204,  337,  776, 1212,  124,  563,  693, 1132,
+	  38,  474,  913, 1046,  261,  394,  833,  963,  175,  308,  744, 1183,   95,  531,  664, 1103,
+	   6,  445,  884, 1014,  232,  365,  801,  934,  146,  582,  715, 1154,   63,  502,  635, 1071,
+	 283,  416,  852,  985,  203,  333,  772, 1211,  114,  553,  686, 1122,   34,  473,  909, 1042,
+	 254,  384,  823,  956,  171,  610,  743, 1179,   85,  524,  654, 1093,    5,  441,  880, 1013,
+	 222,  355,  794,  924,  142,  581,  711, 1150,   56,  492,  625, 1064,  279,  412,  851,  981,
+	 193,  326,  762, 1201,  113,  549,  682, 1121,   24,  463,  902, 1032,  250,  383,  819,  952,
+	 164,  600,  733, 1172,   81,  520,  653, 1089,  301,  434,  870, 1003,  221,  351,  790,  923,
+	 132,  571,  704, 1140,   52,  491,  621, 1060,  272,  402,  841,  974,  189,  322,  761, 1197,
+	 103,  542,  672, 1111,   23,  459,  898, 1031,  240,  373,  812,  942,  160,  599,  729, 1168,
+	  74,  510,  643, 1082,  297,  430,  869,  999,  211,  344,  780, 1219,  131,  567,  700, 1139,
+	  42,  481,  614, 1050,  268,  401,  837,  970,  182,  312,  751, 1190,   99,  538,  671, 1107,
+	  13,  452,  888, 1021,  239,  369,  808,  941,  150,  589,  722, 1158,   70,  509,  639, 1078,
+	 290,  420,  859,  992,  207,  340,  779, 1215,  121,  560,  690, 1129,   41,  477,  916, 1049,
+	 258,  391,  830,  960,  178,  311,  747, 1186,   92,  528,  661, 1100,    9,  448,  887, 1017,
+	 229,  362,  798,  931,  149,  585,  718, 1157,   60,  499,  632, 1068,  286,  419,  855,  988,
+	 200,  330,  769, 1208,  117,  556,  689, 1125,   31,  470,  906, 1039,  257,  387,  826,  959,
+	 168,  607,  740, 1176,   88,  527,  657, 1096,    1,  440,  876, 1009,  227,  357,  796,  929,
+	 138,  577,  710, 1146,   58,  497,  627, 1066,  278,  408,  847,  980,  195,  328,  767, 1203,
+	 109,  548,  678, 1117,   29,  465,  904, 1037,  246,  379,  818,  948,  166,  605,  735, 1174,
+	  80,  516,  649, 1088,  303,  436,  875, 1005,  217,  350,  786,  919,  137,  573,  706, 1145,
+	  48,  487,  620, 1056,  274,  407,  843,  976,  188,  318,  757, 1196,  105,  544,  677, 1113,
+	  19,  458,  894, 1027,  245,  375,  814,  947,  156,  595,  728, 1164,   76,  515,  645, 1084,
+	 296,  426,  865,  998,  213,  346,  785, 1221,  127,  566,  696, 1135,   47,  483,  616, 1055,
+	 264,  397,  836,  966,  184,  317,  753, 1192,   98,  534,  667, 1106,   15,  454,  893, 1023,
+	 235,  368,  804,  937,  155,  591,  724, 1163,   66,  505,  638, 1074,  292,  425,  861,  994,
+	 206,  336,  775, 1214,  123,  562,  695, 1131,   37,  476,  912, 1045,  263,  393,  832,  965,
+	 174,  307,  746, 1182,   94,  533,  663, 1102,    8,  444,  883, 1016,  231,  364,  803,  933,
+	 145,  584,  714, 1153,   65,  501,  634, 1073,  282,  415,  854,  984,  202,  335,  771, 1210,
+	 116,  552,  685, 1124,   33,  472,  911, 1041,  253,  386,  822,  955,  173,  609,  742, 1181,
+	  84,  523,  656, 1092,    4,  443,  879, 1012,  224,  354,  793,  926,  141,  580,  713, 1149,
+	  55,  494,  624, 1063,  281,  411,  850,  983,  192,  325,  764, 1200,  112,  551,  681, 1120,
+	  26,  462,  901, 1034,  249,  382,  821,  951,  163,  602,  732, 1171,   83,  519,  652, 1091,
+	 300,  433,  872, 1002,  220,  353,  789,  922,  134,  570,  703, 1142,   51,  490,  623, 1059,
+	 271,  404,  840,  973,  191,  321,  760, 1199,  102,  541,  674, 1110,   22,  461,  897, 1030,
+	 242,  372,  811,  944,  159,  598,  731, 1167,   73,  512,  642, 1081,  299,  429,  868, 1001,
+	 210,  343,  782, 1218,  130,  569,  699, 1138,   44,  480,  613, 1052,  267,  400,  839,  969,
+	 181,  314,  750, 1189,  101,  537,  670, 1109,   12,  451,  890, 1020,  238,  371,  807,  940,
+	 152,  588,  721, 1160,   69,  508,  641, 1077,  289,  422,  858,  991,  209,  339,  778, 1217,
+	 120,  559,  692, 1128,   40,  479,  915, 1048,  260,  390,  829,  962,  177,  310,  749, 1185,
+	  91,  530,  660, 1099,   11,  447,  886, 1019,  228,  361,  800,  930,  148,  587,  717, 1156,
+	  62,  498,  631, 1070,  285,  418,  857,  987,  199,  332,  768, 1207,  119,  555,  688, 1127,
+	  30,  469,  908, 1038,  256,  389,  825,  958,  170,  606,  739, 1178,   87,  526,  659, 1095,
+	   0,  439,  878, 1008,  226,  359,  795,  928,  140,  576,  709, 1148,   57,  496,  629, 1065,
+	 277,  410,  846,  979,  197,  327,  766, 1205,  108,  547,  680, 1116,   28,  467,  903, 1036,
+	 248,  378,  817,  950,  165,  604,  737, 1173,   79,  518,  648, 1087,  305,  435,  874, 1007,
+	 216,  349,  788,  918,  136,  575,  705, 1144,   50,  486,  619, 1058,  273,  406,  845,  975,
+	 187,  320,  756, 1195,  107,  543,  676, 1115,   18,  457,  896, 1026,  244,  377,  813,  946,
+	 158,  594,  727, 1166,   75,  514,  647, 1083,  295,  428,  864,  997,  215,  345,  784, 1223,
+	 126,  565,  698, 1134,   46,  485,  615, 1054,  266,  396,  835,  968,  183,  316,  755, 1191,
+	  97,  536,  666, 1105,   17,  453,  892, 1025,  234,  367,  806,  936,  154,  593,  723, 1162,
+	  68,  504,  637, 1076,  291,  424,  863,  993,  205,  338,  774, 1213,  125,  561,  694, 1133,
+	  36,  475,  914, 1044,  262,  395,  831,  964,  176,  306,  745, 1184,   93,  532,  665, 1101,
+	   7,  446,  882, 1015,  233,  363,  802,  935,  144,  583,  716, 1152,   64,  503,  633, 1072,
+	 284,  414,  853,  986,  201,  334,  773, 1209,  115,  554,  684, 1123,   35,  471,  910, 1043,
+	 252,  385,  824,  954,  172,  611,  741, 1180,   86,  522,  655, 1094,    3,  442,  881, 1011,
+	 223,  356,  792,  925,  143,  579,  712, 1151,   54,  493,  626, 1062,  280,  413,  849,  982,
+	 194,  324,  763, 1202,  111,  550,  683, 1119,   25,  464,  900, 1033,  251,  381,  820,  953,
+	 162,  601,  734, 1170,   82,  521,  651, 1090,  302,  432,  871, 1004,  219,  352,  791,  921,
+	 133,  572,  702, 1141,   53,  489,  622, 1061,  270,  403,  842,  972,  190,  323,  759, 1198,
+	 104,  540,  673, 1112,   21,  460,  899, 1029,  241,  374,  810,  943,  161,  597,  730, 1169,
+	  72,  511,  644, 1080,  298,  431,  867, 1000,  212,  342,  781, 1220,  129,  568,  701, 1137,
+	  43,  482,  612, 1051,  269,  399,  838,  971,  180,  313,  752, 1188,  100,  539,  669, 1108,
+	  14,  450,  889, 1022,  237,  370,  809,  939,  151,  590,  720, 1159,   71,  507,  640, 1079,
+	 288,  421,  860,  990,  208,  341,  777, 1216,  122,  558,  691, 1130,   39,  478,  917, 1047,
+	 259,  392,  828,  961,  179,  309,  748, 1187,   90,  529,  662, 1098,   10,  449,  885, 1018,
+	 230,  360,  799,  932,  147,  586,  719, 1155,   61,  500,  630, 1069,  287,  417,  856,  989,
+	 198,  331,  770, 1206,  118,  557,  687, 1126,   32,  468,  907, 1040,  255,  388,  827,  957,
+	 169,  608,  738, 1177,   89,  525,  658, 1097,
+};
+
+/* TS 05.03 5.1.12.1.5: j = 306(2(k div 612) + (k mod 2)) + 3(74k mod 102 + (k div 2) mod 2)
+ *                          + (k + 2 - k div 204) mod 3 */
+const uint16_t gsm0503_interleave_mcs8[1224] = {
+	   2,  528,  142,  365,  276,  499,  113,  333,  247,  470,   81,  610,  218,  438,   52,  581,
+	 186,  409,   23,  549,  157,  380,  297,  520,  128,  348,  268,  491,   96,  319,  239,  459,
+	  67,  596,  207,  430,   38,  564,  178,  401,    6,  535,  149,  369,  283,  506,  117,  340,
+	 254,  474,   88,  311,  222,  445,   59,  585,  193,  416,   27,  556,  164,  384,  304,  527,
+	 132,  355,  275,  495,  103,  326,  243,  466,   74,  600,  214,  437,   42,  571,  185,  405,
+	  13,  542,  153,  376,  290,  510,  124,  347,  258,  481,   95,  315,  229,  452,   63,  592,
+	 200,  420,   34,  563,  168,  391,    5,  531,  139,  362,  279,  502,  110,  330,  250,  473,
+	  78,  607,  221,  441,   49,  578,  189,  412,   20,  546,  160,  383,  294,  517,  131,  351,
+	 265,  488,   99,  322,  236,  456,   70,  599,  204,  427,   41,  567,  175,  398,    9,  538,
+	 146,  366,  286,  509,  114,  337,  257,  477,   85,  308,  225,  448,   56,  582,  196,  419,
+	  24,  553,  167,  387,  301,  524,  135,  358,  272,  492,  106,  329,  240,  463,   77,  603,
+	 211,  434,   45,  574,  182,  402,   16,  545,  150,  373,  293,  513,  121,  344,  261,  484,
+	  92,  312,  232,  455,   60,  589,  203,  423,   31,  560,  171,  394,    1,  530,  141,  364,
+	 278,  498,  112,  335,  246,  469,   83,  609,  217,  440,   51,  580,  188,  408,   22,  551,
+	 156,  379,  299,  519,  127,  350,  267,  490,   98,  318,  238,  461,   66,  595,  209,  429,
+	  37,  566,  177,  400,    8,  534,  148,  371,  282,  505,  119,  339,  253,  476,   87,  310,
+	 224,  444,   58,  587,  192,  415,   29,  555,  163,  386,  303,  526,  134,  354,  274,  497,
+	 102,  325,  245,  465,   73,  602,  213,  436,   44,  570,  184,  407,   12,  541,  155,  375,
+	 289,  512,  123,  346,  260,  480,   94,  317,  228,  451,   65,  591,  199,  422,   33,  562,
+	 170,  390,    4,  533,  138,  361,  281,  501,  109,  332,  249,  472,   80,  606,  220,  443,
+	  48,  577,  191,  411,   19,  548,  159,  382,  296,  516,  130,  353,  264,  487,  101,  321,
+	 235,  458,   69,  598,  206,  426,   40,  569,  174,  397,   11,  537,  145,  368,  285,  508,
+	 116,  336,  256,  479,   84,  307,  227,  447,   55,  584,  195,  418,   26,  552,  166,  389,
+	 300,  523,  137,  357,  271,  494,  105,  328,  242,  462,   76,  605,  210,  433,   47,  573,
+	 181,  404,   15,  544,  152,  372,  292,  515,  120,  343,  263,  483,   91,  314,  231,  454,
+	  62,  588,  202,  425,   30,  559,  173,  393,    0,  529,  143,  363,  277,  500,  111,  334,
+	 248,  468,   82,  611,  216,  439,   53,  579,  187,  410,   21,  550,  158,  378,  298,  521,
+	 126,  349,  269,  489,   97,  320,  237,  460,   68,  594,  208,  431,   36,  565,  179,  399,
+	   7,  536,  147,  370,  284,  504,  118,  341,  252,  475,   89,  309,  223,  446,   57,  586,
+	 194,  414,   28,  557,  162,  385,  305,  525,  133,  356,  273,  496,  104,  324,  244,  467,
+	  72,  601,  215,  435,   43,  572,  183,  406,   14,  540,  154,  377,  288,  511,  125,  345,
+	 259,  482,   93,  316,  230,  450,   64,  593,  198,  421,   35,  561,  169,  392,    3,  532,
+	 140,  360,  280,  503,  108,  331,  251,  471,   79,  608,  219,  442,   50,  576,  190,  413,
+	  18,  547,  161,  381,  295,  518,  129,  352,  266,  486,  100,  323,  234,  457,   71,  597,
+	 205,  428,   39,  568,  176,  396,   10,  539,  144,  367,  287,  507,  115,  338,  255,  478,
+	  86,  306,  226,  449,   54,  583,  197,  417,   25,  554,  165,  388,  302,  522,  136,  359,
+	 270,  493,  107,  327,  241,  464,   75,  604,  212,  432,   46,  575,  180,  403,   17,  543,
+	 151,  374,  291,  514,  122,  342,  262,  485,   90,  313,  233,  453,   61,  590,  201,  424,
+	  32,  558,  172,  395,  614, 1140,  754,  977,  888, 1111,  725,  945,  859, 1082,  693, 1222,
+	 830, 1050,  664, 1193,  798, 1021,  635, 1161,  769,  992,  909, 1132,  740,  960,  880, 1103,
+	 708,  931,  851, 1071,  679, 1208,  819, 1042,  650, 1176,  790, 1013,  618, 1147,  761,  981,
+	 895, 1118,  729,  952,  866, 1086,  700,  923,  834, 1057,  671, 1197,  805, 1028,  639, 1168,
+	 776,  996,  916, 1139,  744,  967,  887, 1107,  715,  938,  855, 1078,  686, 1212,  826, 1049,
+	 654, 1183,  797, 1017,  625, 1154,  765,  988,  902, 1122,  736,  959,  870, 1093,  707,  927,
+	 841, 1064,  675, 1204,  812, 1032,  646, 1175,  780, 1003,  617, 1143,  751,  974,  891, 1114,
+	 722,  942,  862, 1085,  690, 1219,  833, 1053,  661, 1190,  801, 1024,  632, 1158,  772,  995,
+	 906, 1129,  743,  963,  877, 1100,  711,  934,  848, 1068,  682, 1211,  816, 1039,  653, 1179,
+	 787, 1010,  621, 1150,  758,  978,  898, 1121,  726,  949,  869, 1089,  697,  920,  837, 1060,
+	 668, 1194,  808, 1031,  636, 1165,  779,  999,  913, 1136,  747,  970,  884, 1104,  718,  941,
+	 852, 1075,  689, 1215,  823, 1046,  657, 1186,  794, 1014,  628, 1157,  762,  985,  905, 1125,
+	 733,  956,  873, 1096,  704,  924,  844, 1067,  672, 1201,  815, 1035,  643, 1172,  783, 1006,
+	 613, 1142,  753,  976,  890, 1110,  724,  947,  858, 1081,  695, 1221,  829, 1052,  663, 1192,
+	 800, 1020,  634, 1163,  768,  991,  911, 1131,  739,  962,  879, 1102,  710,  930,  850, 1073,
+	 678, 1207,  821, 1041,  649, 1178,  789, 1012,  620, 1146,  760,  983,  894, 1117,  731,  951,
+	 865, 1088,  699,  922,  836, 1056,  670, 1199,  804, 1027,  641, 1167,  775,  998,  915, 1138,
+	 746,  966,  886, 1109,  714,  937,  857, 1077,  685, 1214,  825, 1048,  656, 1182,  796, 1019,
+	 624, 1153,  767,  987,  901, 1124,  735,  958,  872, 1092,  706,  929,  840, 1063,  677, 1203,
+	 811, 1034,  645, 1174,  782, 1002,  616, 1145,  750,  973,  893, 1113,  721,  944,  861, 1084,
+	 692, 1218,  832, 1055,  660, 1189,  803, 1023,  631, 1160,  771,  994,  908, 1128,  742,  965,
+	 876, 1099,  713,  933,  847, 1070,  681, 1210,  818, 1038,  652, 1181,  786, 1009,  623, 1149,
+	 757,  980,  897, 1120,  728,  948,  868, 1091,  696,  919,  839, 1059,  667, 1196,  807, 1030,
+	 638, 1164,  778, 1001,  912, 1135,  749,  969,  883, 1106,  717,  940,  854, 1074,  688, 1217,
+	 822, 1045,  659, 1185,  793, 1016,  627, 1156,  764,  984,  904, 1127,  732,  955,  875, 1095,
+	 703,  926,  843, 1066,  674, 1200,  814, 1037,  642, 1171,  785, 1005,  612, 1141,  755,  975,
+	 889, 1112,  723,  946,  860, 1080,  694, 1223,  828, 1051,  665, 1191,  799, 1022,  633, 1162,
+	 770,  990,  910, 1133,  738,  961,  881, 1101,  709,  932,  849, 1072,  680, 1206,  820, 1043,
+	 648, 1177,  791, 1011,  619, 1148,  759,  982,  896, 1116,  730,  953,  864, 1087,  701,  921,
+	 835, 1058,  669, 1198,  806, 1026,  640, 1169,  774,  997,  917, 1137,  745,  968,  885, 1108,
+	 716,  936,  856, 1079,  684, 1213,  827, 1047,  655, 1184,  795, 1018,  626, 1152,  766,  989,
+	 900, 1123,  737,  957,  871, 1094,  705,  928,  842, 1062,  676, 1205,  810, 1033,  647, 1173,
+	 781, 1004,  615, 1144,  752,  972,  892, 1115,  720,  943,  863, 1083,  691, 1220,  831, 1054,
+	 662, 1188,  802, 1025,  630, 1159,  773,  993,  907, 1130,  741,  964,  878, 1098,  712,  935,
+	 846, 1069,  683, 1209,  817, 1040,  651, 1180,  788, 1008,  622, 1151,  756,  979,  899, 1119,
+	 727,  950,  867, 1090,  698,  918,  838, 1061,  666, 1195,  809, 1029,  637, 1166,  777, 1000,
+	 914, 1134,  748,  971,  882, 1105,  719,  939,  853, 1076,  687, 1216,  824, 1044,  658, 1187,
+	 792, 1015,  629, 1155,  763,  986,  903, 1126,  734,  954,  874, 1097,  702,  925,  845, 1065,
+	 673, 1202,  813, 1036,  644, 1170,  784, 1007,
+};
+
 /* this corresponds to the bit-lengths of the individual codec
  * parameters as indicated in Table 1.1 of TS 06.10 */
 const uint8_t gsm0503_gsm_fr_map[76] = {
@@ -243,6 +243,11 @@ osmo_conv_encode(const struct osmo_conv_code *code,
 int
 osmo_conv_decode_acc(const struct osmo_conv_code *code,
                      const sbit_t *input, ubit_t *output);
+int
+osmo_conv_decode_acc_ber(const struct osmo_conv_code *code,
+                         const sbit_t *input, ubit_t *output,
+                         int *n_errors, int *n_bits_total,
+                         const uint8_t *data_punc);
 
 void
 osmo_conv_decode_init(struct osmo_conv_decoder *decoder,
@@ -604,6 +609,11 @@ osmo_conv_decode_get_output(struct osmo_conv_decoder *decoder,
  * \ref osmo_conv_decode_init, \ref osmo_conv_decode_scan,
  * \ref osmo_conv_decode_flush, \ref osmo_conv_decode_get_output and
  * \ref osmo_conv_decode_deinit.
+ *
+ * For K=5 and K=7 codes, the accelerated decoder set up for \a code is
+ * cached per thread by the address of \a code.  The tables \a code points
+ * to must not change while cached, they are expected to be static; see
+ * \ref osmo_conv_acc_cache_flush.
  */
 int
 osmo_conv_decode(const struct osmo_conv_code *code,
@@ -613,7 +623,7 @@ osmo_conv_decode(const struct osmo_conv_code *code,
 	int rv, l;
 
 	/* Use accelerated implementation for supported codes */
-	if ((code->N <= 4) && ((code->K == 5) || (code->K == 7)))
+	if ((code->N <= 7) && ((code->K == 5) || (code->K == 7)))
 		return osmo_conv_decode_acc(code, input, output);
 
 	osmo_conv_decode_init(&decoder, code, 0, 0);
@@ -638,4 +648,89 @@ osmo_conv_decode(const struct osmo_conv_code *code,
 	return rv;
 }
 
+/* Count the bit errors of the input by re-encoding the decoded bits, for
+ * codes not supported by the accelerated decoder */
+__attribute__ ((visibility("hidden")))
+void
+osmo_conv_count_ber(const struct osmo_conv_code *code,
+                    const sbit_t *input, const ubit_t *output,
+                    int *n_errors, int *n_bits_total,
+                    const uint8_t *data_punc)
+{
+	int i, errors = 0, coded_len = osmo_conv_get_output_length(code, 0);
+	ubit_t recoded[coded_len];
+
+	if (n_bits_total)
+		*n_bits_total = coded_len;
+	if (!n_errors)
+		return;
+
+	osmo_conv_encode(code, output, recoded);
+
+	/* A soft bit is an error unless it has the sign of the re-encoded
+	 * bit, zero soft bits included */
+	for (i = 0; i < coded_len; i++) {
+		if (data_punc && data_punc[i])
+			continue;
+		errors += recoded[i] ? input[i] >= 0 : input[i] <= 0;
+	}
+
+	*n_errors = errors;
+}
+
+/*! Convolutional decode and count the bit errors of the input
+ *
+ *  The bit errors are the coded bits whose soft bit doesn't have the sign
+ *  of the corresponding bit of re-encoding the decoded bits, erased (zero)
+ *  soft bits included.  The accelerated decoder finds them along the
+ *  decoded path, without re-encoding.
+ *
+ *  \param[in] code The convolutional code
+ *  \param[in] input Input soft-bits (-127...127)
+ *  \param[out] output Output bits
+ *  \param[out] n_errors Number of bit errors; may be NULL
+ *  \param[out] n_bits_total Number of coded bits; may be NULL
+ *  \param[in] data_punc Mask of coded bits not to count, e.g. inserted
+ *             by depuncturing the input before decoding; may be NULL
+ *  \returns as osmo_conv_decode()
+ */
+int
+osmo_conv_decode_ber_punctured(const struct osmo_conv_code *code,
+                               const sbit_t *input, ubit_t *output,
+                               int *n_errors, int *n_bits_total,
+                               const uint8_t *data_punc)
+{
+	int rv;
+
+	/* Use accelerated implementation for supported codes */
+	if ((code->N <= 7) && ((code->K == 5) || (code->K == 7)))
+		return osmo_conv_decode_acc_ber(code, input, output,
+			n_errors, n_bits_total, data_punc);
+
+	rv = osmo_conv_decode(code, input, output);
+	osmo_conv_count_ber(code, input, output, n_errors, n_bits_total, data_punc);
+
+	return rv;
+}
+
+/*! Convolutional decode and count the bit errors of the input
+ *
+ *  Same as osmo_conv_decode_ber_punctured() without mask.
+ *
+ *  \param[in] code The convolutional code
+ *  \param[in] input Input soft-bits (-127...127)
+ *  \param[out] output Output bits
+ *  \param[out] n_errors Number of bit errors; may be NULL
+ *  \param[out] n_bits_total Number of coded bits; may be NULL
+ *  \returns as osmo_conv_decode()
+ */
+int
+osmo_conv_decode_ber(const struct osmo_conv_code *code,
+                     const sbit_t *input, ubit_t *output,
+                     int *n_errors, int *n_bits_total)
+{
+	return osmo_conv_decode_ber_punctured(code, input, output,
+		n_errors, n_bits_total, NULL);
+}
+
 /*! @} */
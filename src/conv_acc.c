@@ -25,13 +25,18 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <pthread.h>
 
 #include "config.h"
 
 #include <osmocom/core/conv.h>
+#include <osmocom/core/hashtable.h>
+#include <osmocom/core/simd_internal.h>
 
 #define BIT2NRZ(REG,N)	(((REG >> N) & 0x01) * 2 - 1) * -1
 #define NUM_STATES(K)	(K == 7 ? 64 : 16)
+/* Trellis outputs per state, padded for the vector units */
+#define NUM_OUTPUTS(N)	(N == 2 ? 2 : (N <= 4 ? 4 : 8))
 
 #define INIT_POINTERS(simd) \
 { \
@@ -45,11 +50,40 @@
 	vdec_free = &osmo_conv_##simd##_vdec_free; \
 }
 
+#define INIT_POINTERS_N8(simd) \
+{ \
+	osmo_conv_metrics_k5_n5 = osmo_conv_##simd##_metrics_k5_n5; \
+	osmo_conv_metrics_k5_n6 = osmo_conv_##simd##_metrics_k5_n6; \
+	osmo_conv_metrics_k5_n7 = osmo_conv_##simd##_metrics_k5_n7; \
+	osmo_conv_metrics_k7_n5 = osmo_conv_##simd##_metrics_k7_n5; \
+	osmo_conv_metrics_k7_n6 = osmo_conv_##simd##_metrics_k7_n6; \
+	osmo_conv_metrics_k7_n7 = osmo_conv_##simd##_metrics_k7_n7; \
+}
+
 static int init_complete = 0;
 
+/* Set by osmo_conv_simd_limit(), the instruction set used by osmo_conv_init() */
+static enum osmo_conv_simd simd_max = OSMO_CONV_SIMD_NEON;
+static enum osmo_conv_simd simd_used = OSMO_CONV_SIMD_GEN;
+
+const struct value_string osmo_conv_simd_names[] = {
+	{ OSMO_CONV_SIMD_GEN,		"gen" },
+	{ OSMO_CONV_SIMD_SSSE3,		"ssse3" },
+	{ OSMO_CONV_SIMD_AVX2,		"avx2" },
+	{ OSMO_CONV_SIMD_AVX512,	"avx512" },
+	{ OSMO_CONV_SIMD_NEON,		"neon" },
+	{ 0, NULL }
+};
+
+/* Bit error count by re-encoding, in conv.c */
+void osmo_conv_count_ber(const struct osmo_conv_code *code,
+	const sbit_t *input, const ubit_t *output,
+	int *n_errors, int *n_bits_total, const uint8_t *data_punc);
+
 __attribute__ ((visibility("hidden"))) int avx2_supported = 0;
 __attribute__ ((visibility("hidden"))) int ssse3_supported = 0;
 __attribute__ ((visibility("hidden"))) int sse41_supported = 0;
+__attribute__ ((visibility("hidden"))) int avx512bw_supported = 0;
 
 /**
  * These pointers are being initialized at runtime by the
@@ -71,6 +105,20 @@ void (*osmo_conv_metrics_k7_n3)(const int8_t *seq,
 void (*osmo_conv_metrics_k7_n4)(const int8_t *seq,
 	const int16_t *out, int16_t *sums, int16_t *paths, int norm);
 
+/* N=5 to N=7, with trellis outputs padded to 8 per state */
+static void (*osmo_conv_metrics_k5_n5)(const int8_t *seq,
+	const int16_t *out, int16_t *sums, int16_t *paths, int norm);
+static void (*osmo_conv_metrics_k5_n6)(const int8_t *seq,
+	const int16_t *out, int16_t *sums, int16_t *paths, int norm);
+static void (*osmo_conv_metrics_k5_n7)(const int8_t *seq,
+	const int16_t *out, int16_t *sums, int16_t *paths, int norm);
+static void (*osmo_conv_metrics_k7_n5)(const int8_t *seq,
+	const int16_t *out, int16_t *sums, int16_t *paths, int norm);
+static void (*osmo_conv_metrics_k7_n6)(const int8_t *seq,
+	const int16_t *out, int16_t *sums, int16_t *paths, int norm);
+static void (*osmo_conv_metrics_k7_n7)(const int8_t *seq,
+	const int16_t *out, int16_t *sums, int16_t *paths, int norm);
+
 /* Forward malloc wrappers */
 int16_t *osmo_conv_gen_vdec_malloc(size_t n);
 void osmo_conv_gen_vdec_free(int16_t *ptr);
@@ -90,6 +138,18 @@ int16_t *osmo_conv_neon_vdec_malloc(size_t n);
 void osmo_conv_neon_vdec_free(int16_t *ptr);
 #endif
 
+/* Forward recursion of several codewords, one per vector lane */
+void osmo_conv_gen_batch_forward(int ns, int n, int len, int intrvl,
+	const int16_t *out, const int16_t *seq, int16_t *sums, int16_t *paths);
+#if defined(HAVE_AVX2)
+void osmo_conv_avx_batch_forward(int ns, int n, int len, int intrvl,
+	const int16_t *out, const int16_t *seq, int16_t *sums, int16_t *paths);
+#endif
+
+static void (*batch_forward)(int ns, int n, int len, int intrvl,
+	const int16_t *out, const int16_t *seq, int16_t *sums, int16_t *paths);
+static int batch_lanes;
+
 /* Forward Metric Units */
 void osmo_conv_gen_metrics_k5_n2(const int8_t *seq, const int16_t *out,
 	int16_t *sums, int16_t *paths, int norm);
@@ -103,6 +163,18 @@ void osmo_conv_gen_metrics_k7_n3(const int8_t *seq, const int16_t *out,
 	int16_t *sums, int16_t *paths, int norm);
 void osmo_conv_gen_metrics_k7_n4(const int8_t *seq, const int16_t *out,
 	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_gen_metrics_k5_n5(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_gen_metrics_k5_n6(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_gen_metrics_k5_n7(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_gen_metrics_k7_n5(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_gen_metrics_k7_n6(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_gen_metrics_k7_n7(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
 
 #if defined(HAVE_SSSE3)
 void osmo_conv_sse_metrics_k5_n2(const int8_t *seq, const int16_t *out,
@@ -117,6 +189,18 @@ void osmo_conv_sse_metrics_k7_n3(const int8_t *seq, const int16_t *out,
 	int16_t *sums, int16_t *paths, int norm);
 void osmo_conv_sse_metrics_k7_n4(const int8_t *seq, const int16_t *out,
 	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_sse_metrics_k5_n5(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_sse_metrics_k5_n6(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_sse_metrics_k5_n7(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_sse_metrics_k7_n5(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_sse_metrics_k7_n6(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_sse_metrics_k7_n7(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
 #endif
 
 #if defined(HAVE_SSSE3) && defined(HAVE_AVX2)
@@ -132,6 +216,45 @@ void osmo_conv_sse_avx_metrics_k7_n3(const int8_t *seq, const int16_t *out,
 	int16_t *sums, int16_t *paths, int norm);
 void osmo_conv_sse_avx_metrics_k7_n4(const int8_t *seq, const int16_t *out,
 	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_sse_avx_metrics_k5_n5(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_sse_avx_metrics_k5_n6(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_sse_avx_metrics_k5_n7(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_sse_avx_metrics_k7_n5(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_sse_avx_metrics_k7_n6(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_sse_avx_metrics_k7_n7(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+#endif
+
+#if defined(HAVE_AVX512BW)
+void osmo_conv_avx512_metrics_k5_n2(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_avx512_metrics_k5_n3(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_avx512_metrics_k5_n4(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_avx512_metrics_k5_n5(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_avx512_metrics_k5_n6(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_avx512_metrics_k5_n7(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_avx512_metrics_k7_n2(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_avx512_metrics_k7_n3(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_avx512_metrics_k7_n4(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_avx512_metrics_k7_n5(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_avx512_metrics_k7_n6(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
+void osmo_conv_avx512_metrics_k7_n7(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm);
 #endif
 
 #if defined(HAVE_NEON)
@@ -179,6 +302,7 @@ struct vtrellis {
  * intrvl    - Normalization interval
  * trellis   - Trellis object
  * paths     - Trellis paths
+ * depunc    - Depunctured input sequence, NULL if the code is not punctured
  */
 struct vdecoder {
 	int n;
@@ -188,6 +312,7 @@ struct vdecoder {
 	int intrvl;
 	struct vtrellis trellis;
 	int16_t **paths;
+	int8_t *depunc;
 
 	void (*metric_func)(const int8_t *, const int16_t *,
 		int16_t *, int16_t *, int);
@@ -244,6 +369,13 @@ static inline unsigned bitswap6(unsigned v)
 		((v & 0x04) << 1) | ((v & 0x02) << 3) | ((v & 0x01) << 5);
 }
 
+static inline unsigned bitswap7(unsigned v)
+{
+	return ((v & 0x40) >> 6) | ((v & 0x20) >> 4) | ((v & 0x10) >> 2) |
+		((v & 0x08) >> 0) | ((v & 0x04) << 2) | ((v & 0x02) << 4) |
+		((v & 0x01) << 6);
+}
+
 static unsigned bitswap(unsigned v, unsigned n)
 {
 	switch (n) {
@@ -259,6 +391,8 @@ static unsigned bitswap(unsigned v, unsigned n)
 		return bitswap5(v);
 	case 6:
 		return bitswap6(v);
+	case 7:
+		return bitswap7(v);
 	default:
 		return 0;
 	}
@@ -410,7 +544,7 @@ static int generate_trellis(struct vdecoder *dec,
 	int i, rc;
 
 	int ns = NUM_STATES(code->K);
-	int olen = (code->N == 2) ? 2 : 4;
+	int olen = NUM_OUTPUTS(code->N);
 
 	trellis->num_states = ns;
 	trellis->sums =	vdec_malloc(ns);
@@ -422,6 +556,9 @@ static int generate_trellis(struct vdecoder *dec,
 		goto fail;
 	}
 
+	/* Padding outputs are zero, so that they don't add to the metrics */
+	memset(trellis->outputs, 0, sizeof(int16_t) * ns * olen);
+
 	/* Populate the trellis state objects */
 	for (i = 0; i < ns; i++) {
 		outputs = &trellis->outputs[olen * i];
@@ -481,28 +618,39 @@ static void _traceback_rec(struct vdecoder *dec,
 	}
 }
 
-/* Traceback and generate decoded output
- * Find the largest accumulated path metric at the final state except for
- * the zero terminated case, where we assume the final state is always zero.
+/* Find the final state to start the traceback from: the one with the
+ * largest accumulated path metric except for the zero terminated case,
+ * where we assume the final state is always zero.
  */
-static int traceback(struct vdecoder *dec, uint8_t *out, int term, int len)
+static int traceback_state(struct vdecoder *dec, int term, unsigned *state)
 {
 	int i, sum, max = -1;
-	unsigned path, state = 0;
 
-	if (term != CONV_TERM_FLUSH) {
-		for (i = 0; i < dec->trellis.num_states; i++) {
-			sum = dec->trellis.sums[i];
-			if (sum > max) {
-				max = sum;
-				state = i;
-			}
-		}
+	*state = 0;
+	if (term == CONV_TERM_FLUSH)
+		return 0;
 
-		if (max < 0)
-			return -EPROTO;
+	for (i = 0; i < dec->trellis.num_states; i++) {
+		sum = dec->trellis.sums[i];
+		if (sum > max) {
+			max = sum;
+			*state = i;
+		}
 	}
 
+	return max < 0 ? -EPROTO : 0;
+}
+
+/* Traceback and generate decoded output */
+static int traceback(struct vdecoder *dec, uint8_t *out, int term, int len)
+{
+	int i, rc;
+	unsigned path, state;
+
+	rc = traceback_state(dec, term, &state);
+	if (rc)
+		return rc;
+
 	for (i = dec->len - 1; i >= len; i--) {
 		path = dec->paths[i][state] + 1;
 		state = vstate_lshift(state, dec->k, path);
@@ -516,6 +664,83 @@ static int traceback(struct vdecoder *dec, uint8_t *out, int term, int len)
 	return 0;
 }
 
+/* Traceback and generate decoded output like traceback(), and count the
+ * bit errors of the input along the decoded path on the way: compare the
+ * soft bits of each step with the outputs of the transition taken, which
+ * are the trellis outputs of the butterfly or their negation.  A soft bit
+ * is an error unless it has the sign of its output, so zero soft bits are
+ * errors, including the 'num_punc' zeros inserted by depuncturing, which
+ * are subtracted again.  Soft bits set in the optional 'data_punc' mask are
+ * not counted.
+ *
+ * This is the count of re-encoding the decoded bits and comparing them with
+ * the input, as long as the path starts in the encoder starting state.  If
+ * it doesn't, the count is set to -EAGAIN.
+ */
+static inline __attribute__((always_inline)) int _traceback_ber(
+	struct vdecoder *dec, int n, const int8_t *seq, uint8_t *out,
+	int term, int len, const uint8_t *data_punc, int num_punc, int *errors)
+{
+	/* copies, as the stores to 'out' may alias the decoder */
+	int16_t * const *paths = dec->paths;
+	const uint8_t *vals = dec->trellis.vals;
+	const int16_t *outputs = dec->trellis.outputs;
+	const int16_t *o;
+	int ns = dec->trellis.num_states;
+	int olen = NUM_OUTPUTS(n);
+	/* as vstate_lshift() */
+	unsigned mask = (ns - 1) & ~1;
+	unsigned recursive = dec->recursive ? 1 : 0;
+	unsigned path, state, end;
+	int i, k, sign, err, rc, cnt = 0;
+
+	rc = traceback_state(dec, term, &end);
+	if (rc)
+		return rc;
+
+	for (i = dec->len - 1, state = end; i >= 0; i--) {
+		path = paths[i][state] + 1;
+		if (i < len)
+			out[i] = (path & recursive) ^ vals[state];
+
+		o = &outputs[olen * (state & (ns / 2 - 1))];
+		/* branchless, the path decisions are unpredictable */
+		sign = 1 - 2 * (int) (path ^ (state >= ns / 2));
+
+		for (k = 0; k < n; k++) {
+			err = seq[n * i + k] * o[k] * sign <= 0;
+			if (data_punc)
+				err &= !data_punc[n * i + k];
+			cnt += err;
+		}
+
+		state = ((state << 1) & mask) | path;
+	}
+
+	if (state != (term == CONV_TERM_TAIL_BITING ? end : 0))
+		*errors = -EAGAIN;
+	else
+		*errors = cnt - num_punc;
+
+	return 0;
+}
+
+/* Specialize for the most common code orders, so that the comparisons of
+ * a step are unrolled */
+static int traceback_ber(struct vdecoder *dec, const int8_t *seq,
+	uint8_t *out, int term, int len,
+	const uint8_t *data_punc, int num_punc, int *errors)
+{
+	switch (dec->n) {
+	case 2:
+		return _traceback_ber(dec, 2, seq, out, term, len, data_punc, num_punc, errors);
+	case 3:
+		return _traceback_ber(dec, 3, seq, out, term, len, data_punc, num_punc, errors);
+	default:
+		return _traceback_ber(dec, dec->n, seq, out, term, len, data_punc, num_punc, errors);
+	}
+}
+
 /* Release decoder object */
 static void vdec_deinit(struct vdecoder *dec)
 {
@@ -528,11 +753,16 @@ static void vdec_deinit(struct vdecoder *dec)
 		vdec_free(dec->paths[0]);
 		free(dec->paths);
 	}
+
+	free(dec->depunc);
 }
 
 /* Initialize decoder object with code specific params
- * Subtract the constraint length K on the normalization interval to
- * accommodate the initialization path metric at state zero.
+ * Right after normalization, the path metrics of any two states differ by
+ * at most 2 * (K - 1) branch metrics, as every state can be reached from
+ * the best one in K - 1 steps.  Subtract those from the normalization
+ * interval, so that the path metrics don't overflow 16 bits; this also
+ * covers the initialization path metric at state zero.
  */
 static int vdec_init(struct vdecoder *dec, const struct osmo_conv_code *code)
 {
@@ -540,10 +770,11 @@ static int vdec_init(struct vdecoder *dec, const struct osmo_conv_code *code)
 
 	ns = NUM_STATES(code->K);
 
+	memset(dec, 0, sizeof(*dec));
 	dec->n = code->N;
 	dec->k = code->K;
 	dec->recursive = conv_code_recursive(code);
-	dec->intrvl = INT16_MAX / (dec->n * INT8_MAX) - dec->k;
+	dec->intrvl = INT16_MAX / (dec->n * INT8_MAX) - 2 * (dec->k - 1);
 
 	if (dec->k == 5) {
 		switch (dec->n) {
@@ -562,6 +793,15 @@ static int vdec_init(struct vdecoder *dec, const struct osmo_conv_code *code)
 		case 4:
 			dec->metric_func = osmo_conv_metrics_k5_n4;
 			break;
+		case 5:
+			dec->metric_func = osmo_conv_metrics_k5_n5;
+			break;
+		case 6:
+			dec->metric_func = osmo_conv_metrics_k5_n6;
+			break;
+		case 7:
+			dec->metric_func = osmo_conv_metrics_k5_n7;
+			break;
 		default:
 			return -EINVAL;
 		}
@@ -576,6 +816,15 @@ static int vdec_init(struct vdecoder *dec, const struct osmo_conv_code *code)
 		case 4:
 			dec->metric_func = osmo_conv_metrics_k7_n4;
 			break;
+		case 5:
+			dec->metric_func = osmo_conv_metrics_k7_n5;
+			break;
+		case 6:
+			dec->metric_func = osmo_conv_metrics_k7_n6;
+			break;
+		case 7:
+			dec->metric_func = osmo_conv_metrics_k7_n7;
+			break;
 		default:
 			return -EINVAL;
 		}
@@ -603,6 +852,12 @@ static int vdec_init(struct vdecoder *dec, const struct osmo_conv_code *code)
 	for (i = 1; i < dec->len; i++)
 		dec->paths[i] = &dec->paths[0][i * ns];
 
+	if (code->puncture) {
+		dec->depunc = (int8_t *) malloc(dec->len * dec->n);
+		if (!dec->depunc)
+			goto enomem;
+	}
+
 	return 0;
 
 enomem:
@@ -610,6 +865,17 @@ enomem:
 	return -ENOMEM;
 }
 
+/* Reset the accumulated path metrics before decoding another sequence,
+ * like generate_trellis() initialized them.
+ */
+static void vdec_reset(struct vdecoder *dec, const struct osmo_conv_code *code)
+{
+	memset(dec->trellis.sums, 0, sizeof(int16_t) * dec->trellis.num_states);
+
+	if (code->term != CONV_TERM_TAIL_BITING)
+		dec->trellis.sums[0] = INT8_MAX * code->N * code->K;
+}
+
 /* Depuncture sequence with nagative value terminated puncturing matrix */
 static int depuncture(const int8_t *in, const int *punc, int8_t *out, int len)
 {
@@ -646,19 +912,16 @@ static void forward_traverse(struct vdecoder *dec, const int8_t *seq)
 	}
 }
 
-/* Convolutional decode with a decoder object
+/* Forward part of decoding with a decoder object
  * Initial puncturing run if necessary followed by the forward recursion.
- * For tail-biting perform a second pass before running the backward
- * traceback operation.
+ * For tail-biting perform a second pass.  Returns the depunctured sequence.
  */
-static int conv_decode(struct vdecoder *dec, const int8_t *seq,
-	const int *punc, uint8_t *out, int len, int term)
+static const int8_t *conv_forward(struct vdecoder *dec, const int8_t *seq,
+	const int *punc, int term)
 {
-	int8_t depunc[dec->len * dec->n];
-
 	if (punc) {
-		depuncture(seq, punc, depunc, dec->len * dec->n);
-		seq = depunc;
+		depuncture(seq, punc, dec->depunc, dec->len * dec->n);
+		seq = dec->depunc;
 	}
 
 	/* Propagate through the trellis with interval normalization */
@@ -667,6 +930,17 @@ static int conv_decode(struct vdecoder *dec, const int8_t *seq,
 	if (term == CONV_TERM_TAIL_BITING)
 		forward_traverse(dec, seq);
 
+	return seq;
+}
+
+/* Convolutional decode with a decoder object
+ * Forward recursion followed by the backward traceback operation.
+ */
+static int conv_decode(struct vdecoder *dec, const int8_t *seq,
+	const int *punc, uint8_t *out, int len, int term)
+{
+	conv_forward(dec, seq, punc, term);
+
 	return traceback(dec, out, term, len);
 }
 
@@ -687,8 +961,24 @@ static void osmo_conv_init(void)
 	#ifdef HAVE_SSE4_1
 		sse41_supported = __builtin_cpu_supports("sse4.1");
 	#endif
+
+	#ifdef HAVE_AVX512BW
+		avx512bw_supported = __builtin_cpu_supports("avx512bw") &&
+			__builtin_cpu_supports("avx512vl");
+	#endif
 #endif
 
+	/* Limited by osmo_conv_simd_limit() */
+	if (simd_max < OSMO_CONV_SIMD_AVX512)
+		avx512bw_supported = 0;
+	if (simd_max < OSMO_CONV_SIMD_AVX2)
+		avx2_supported = 0;
+	if (simd_max < OSMO_CONV_SIMD_SSSE3) {
+		ssse3_supported = 0;
+		sse41_supported = 0;
+	}
+	simd_used = OSMO_CONV_SIMD_GEN;
+
 /**
  * Usage of curly braces is mandatory,
  * because we use multi-line define.
@@ -696,22 +986,659 @@ static void osmo_conv_init(void)
 #if defined(HAVE_SSSE3) && defined(HAVE_AVX2)
 	if (ssse3_supported && avx2_supported) {
 		INIT_POINTERS(sse_avx);
+		INIT_POINTERS_N8(sse_avx);
+		simd_used = OSMO_CONV_SIMD_AVX2;
 	} else if (ssse3_supported) {
 		INIT_POINTERS(sse);
+		INIT_POINTERS_N8(sse);
+		simd_used = OSMO_CONV_SIMD_SSSE3;
 	} else {
 		INIT_POINTERS(gen);
+		INIT_POINTERS_N8(gen);
 	}
 #elif defined(HAVE_SSSE3)
 	if (ssse3_supported) {
 		INIT_POINTERS(sse);
+		INIT_POINTERS_N8(sse);
+		simd_used = OSMO_CONV_SIMD_SSSE3;
 	} else {
 		INIT_POINTERS(gen);
+		INIT_POINTERS_N8(gen);
 	}
 #elif defined(HAVE_NEON)
-	INIT_POINTERS(neon);
+	if (simd_max > OSMO_CONV_SIMD_GEN) {
+		INIT_POINTERS(neon);
+		simd_used = OSMO_CONV_SIMD_NEON;
+	} else {
+		INIT_POINTERS(gen);
+	}
+	/* no NEON kernels for N > 4 */
+	INIT_POINTERS_N8(gen);
 #else
 	INIT_POINTERS(gen);
+	INIT_POINTERS_N8(gen);
+#endif
+
+/**
+ * The AVX-512 kernels use unaligned loads and stores, so they share the
+ * memory allocator selected above.
+ */
+#if defined(HAVE_AVX512BW)
+	if (avx512bw_supported) {
+		osmo_conv_metrics_k5_n2 = osmo_conv_avx512_metrics_k5_n2;
+		osmo_conv_metrics_k5_n3 = osmo_conv_avx512_metrics_k5_n3;
+		osmo_conv_metrics_k5_n4 = osmo_conv_avx512_metrics_k5_n4;
+		osmo_conv_metrics_k7_n2 = osmo_conv_avx512_metrics_k7_n2;
+		osmo_conv_metrics_k7_n3 = osmo_conv_avx512_metrics_k7_n3;
+		osmo_conv_metrics_k7_n4 = osmo_conv_avx512_metrics_k7_n4;
+		INIT_POINTERS_N8(avx512);
+		simd_used = OSMO_CONV_SIMD_AVX512;
+	}
 #endif
+
+#if defined(HAVE_AVX2)
+	if (avx2_supported) {
+		batch_forward = osmo_conv_avx_batch_forward;
+		batch_lanes = 16;
+	} else
+#endif
+	{
+		batch_forward = osmo_conv_gen_batch_forward;
+		batch_lanes = 8;
+	}
+}
+
+/*! Viterbi decoder for one convolutional code, set up once and reused
+ *  for any number of sequences */
+struct osmo_conv_acc_decoder {
+	/*! the code passed on allocation, key in the per-thread cache */
+	const struct osmo_conv_code *code_ptr;
+	/*! copy of the code the decoder was set up for */
+	struct osmo_conv_code code;
+	/*! entry in the per-thread cache of osmo_conv_decode_acc() */
+	struct hlist_node node;
+	struct vdecoder vdec;
+	/*! number of coded bits, after puncturing */
+	int coded_len;
+	/*! state for decoding batch_lanes codewords at once, see batch_init() */
+	struct {
+		void *mem;
+		int16_t *sums;
+		int16_t *paths;
+		int16_t *seq;
+	} batch;
+};
+
+/* Maximum number of decoders cached per thread.  Beyond that, e.g. for
+ * codes built on the stack, decoders are set up for each call. */
+#define VDEC_CACHE_MAX	64
+
+/* Decoders by the address of their code.  A cached decoder is reused as
+ * long as the code has the same parameters and table pointers; the tables
+ * themselves are not compared, so they must not change (i.e. be static). */
+static __thread DEFINE_HASHTABLE(vdec_cache, 5);
+static __thread unsigned int vdec_cache_len;
+
+/* set for threads with cached decoders, whose destructor flushes them */
+static pthread_key_t vdec_cache_key;
+static pthread_once_t vdec_cache_key_once = PTHREAD_ONCE_INIT;
+static int vdec_cache_key_valid;
+
+static int conv_code_check(const struct osmo_conv_code *code)
+{
+	if ((code->N < 2) || (code->N > 7) || (code->len < 1) ||
+		((code->K != 5) && (code->K != 7)))
+		return -EINVAL;
+	return 0;
+}
+
+static int conv_code_equal(const struct osmo_conv_code *a, const struct osmo_conv_code *b)
+{
+	return a->N == b->N && a->K == b->K && a->len == b->len && a->term == b->term &&
+	       a->next_output == b->next_output && a->next_state == b->next_state &&
+	       a->next_term_output == b->next_term_output && a->next_term_state == b->next_term_state &&
+	       a->puncture == b->puncture;
+}
+
+static int acc_decoder_init(struct osmo_conv_acc_decoder *dec, const struct osmo_conv_code *code)
+{
+	dec->code_ptr = code;
+	dec->code = *code;
+	dec->coded_len = osmo_conv_get_output_length(code, 0);
+	return vdec_init(&dec->vdec, code);
+}
+
+static int acc_decoder_decode(struct osmo_conv_acc_decoder *dec,
+	const sbit_t *input, ubit_t *output)
+{
+	vdec_reset(&dec->vdec, &dec->code);
+	return conv_decode(&dec->vdec, input, dec->code.puncture,
+		output, dec->code.len, dec->code.term);
+}
+
+/* Decode and count the bit errors of the input, see traceback_ber().  Falls
+ * back to re-encoding the decoded bits where that doesn't apply. */
+static int acc_decoder_decode_ber(struct osmo_conv_acc_decoder *dec,
+	const sbit_t *input, ubit_t *output,
+	int *n_errors, int *n_bits_total, const uint8_t *data_punc)
+{
+	struct vdecoder *vdec = &dec->vdec;
+	const int8_t *seq;
+	int rc, errors = -EAGAIN;
+
+	if (n_bits_total)
+		*n_bits_total = dec->coded_len;
+
+	/* data_punc applies to the punctured input */
+	if (!n_errors || (dec->code.puncture && data_punc)) {
+		rc = acc_decoder_decode(dec, input, output);
+	} else {
+		vdec_reset(vdec, &dec->code);
+		seq = conv_forward(vdec, input, dec->code.puncture, dec->code.term);
+		rc = traceback_ber(vdec, seq, output, dec->code.term, dec->code.len,
+			data_punc, vdec->len * vdec->n - dec->coded_len, &errors);
+	}
+
+	if (!n_errors)
+		return rc;
+
+	if (errors >= 0)
+		*n_errors = errors;
+	else
+		osmo_conv_count_ber(&dec->code, input, output, n_errors, NULL, data_punc);
+
+	return rc;
+}
+
+/*! Allocate a Viterbi decoder for a convolutional code
+ *
+ *  The decoder holds all state needed for decoding, so that \ref
+ *  osmo_conv_acc_decoder_decode doesn't allocate any memory.  The arrays
+ *  referenced by the code must stay valid while the decoder is in use.
+ *  Only K=5 and K=7 codes with N from 2 to 7 are supported.
+ *
+ *  \param[in] code convolutional code to decode
+ *  \returns decoder; NULL if the code is not supported or on allocation failure */
+struct osmo_conv_acc_decoder *osmo_conv_acc_decoder_alloc(const struct osmo_conv_code *code)
+{
+	struct osmo_conv_acc_decoder *dec;
+
+	if (!init_complete)
+		osmo_conv_init();
+
+	if (conv_code_check(code))
+		return NULL;
+
+	dec = calloc(1, sizeof(*dec));
+	if (!dec)
+		return NULL;
+
+	if (acc_decoder_init(dec, code)) {
+		free(dec);
+		return NULL;
+	}
+	return dec;
+}
+
+/*! Release a decoder allocated by \ref osmo_conv_acc_decoder_alloc
+ *  \param[in] dec decoder to release; may be NULL */
+void osmo_conv_acc_decoder_free(struct osmo_conv_acc_decoder *dec)
+{
+	if (!dec)
+		return;
+
+	vdec_deinit(&dec->vdec);
+	free(dec->batch.mem);
+	free(dec);
+}
+
+/*! Decode a sequence with a preallocated Viterbi decoder
+ *  \param[in] dec decoder allocated by \ref osmo_conv_acc_decoder_alloc
+ *  \param[in] input soft bits of the encoded (and punctured) sequence
+ *  \param[out] output decoded bits, code->len of them
+ *  \returns 0 on success; negative on error */
+int osmo_conv_acc_decoder_decode(struct osmo_conv_acc_decoder *dec,
+	const sbit_t *input, ubit_t *output)
+{
+	return acc_decoder_decode(dec, input, output);
+}
+
+#define BATCH_LANES_MAX	16
+/* batch_forward() finds all 2^N branch metrics of a step */
+#define BATCH_N_MAX	4
+#define BATCH_ALIGN	64
+#define BATCH_SIZE(n)	(((n) * sizeof(int16_t) + BATCH_ALIGN - 1) & ~(BATCH_ALIGN - 1))
+
+/* Allocate the lane-interleaved path metrics, path decisions and input
+ * sequence of a decoder on first use, aligned for the vector units */
+static int batch_init(struct osmo_conv_acc_decoder *dec)
+{
+	struct vdecoder *vdec = &dec->vdec;
+	size_t sums_len = vdec->trellis.num_states * batch_lanes;
+	size_t paths_len = vdec->trellis.num_states / 16 * vdec->len * batch_lanes;
+	size_t seq_len = vdec->n * vdec->len * batch_lanes;
+	uintptr_t base;
+
+	if (dec->batch.mem)
+		return 0;
+
+	dec->batch.mem = malloc(BATCH_SIZE(sums_len) + BATCH_SIZE(paths_len) +
+				BATCH_SIZE(seq_len) + BATCH_ALIGN);
+	if (!dec->batch.mem)
+		return -ENOMEM;
+
+	base = ((uintptr_t) dec->batch.mem + BATCH_ALIGN - 1) & ~(uintptr_t) (BATCH_ALIGN - 1);
+	dec->batch.sums = (int16_t *) base;
+	dec->batch.paths = (int16_t *) (base + BATCH_SIZE(sums_len));
+	dec->batch.seq = (int16_t *) (base + BATCH_SIZE(sums_len) + BATCH_SIZE(paths_len));
+	return 0;
+}
+
+/* Depuncture the inputs into the lane-interleaved sequence; lanes without
+ * input are zeroed.  All lanes share the puncturing pattern of the code. */
+static void batch_load(struct osmo_conv_acc_decoder *dec,
+	const sbit_t * const *input, int n)
+{
+	const int *punc = dec->code.puncture;
+	int16_t *seq = dec->batch.seq;
+	int i, j, m = 0, seq_len = dec->vdec.n * dec->vdec.len;
+
+	for (i = 0; i < seq_len; i++, seq += batch_lanes) {
+		if (punc && i == *punc) {
+			memset(seq, 0, batch_lanes * sizeof(*seq));
+			punc++;
+			continue;
+		}
+		for (j = 0; j < n; j++)
+			seq[j] = input[j][m];
+		for (; j < batch_lanes; j++)
+			seq[j] = 0;
+		m++;
+	}
+}
+
+/* Find the final state of each lane, like traceback_state() for a single
+ * codeword.  Returns a mask of the lanes where that failed. */
+static unsigned batch_traceback_state(struct osmo_conv_acc_decoder *dec,
+	unsigned *state, int n)
+{
+	int ns = dec->vdec.trellis.num_states;
+	const int16_t *sums = dec->batch.sums;
+	unsigned failed = 0;
+	int i, j, sum, max;
+
+	for (j = 0; j < n; j++) {
+		state[j] = 0;
+		if (dec->code.term == CONV_TERM_FLUSH)
+			continue;
+
+		for (i = 0, max = -1; i < ns; i++) {
+			sum = sums[i * batch_lanes + j];
+			if (sum > max) {
+				max = sum;
+				state[j] = i;
+			}
+		}
+
+		if (max < 0)
+			failed |= 1 << j;
+	}
+
+	return failed;
+}
+
+/* Traceback of all lanes, like traceback() for a single codeword.  The
+ * lanes are traced back together, so that their dependency chains of path
+ * decision lookups overlap. */
+static int batch_traceback(struct osmo_conv_acc_decoder *dec,
+	ubit_t * const *output, int n)
+{
+	struct vdecoder *vdec = &dec->vdec;
+	int ns = vdec->trellis.num_states;
+	int nw = ns / 16;
+	const uint16_t *paths = (const uint16_t *) dec->batch.paths;
+	const uint8_t *vals = vdec->trellis.vals;
+	/* as vstate_lshift() */
+	unsigned mask = (ns - 1) & ~1;
+	unsigned recursive = vdec->recursive ? 1 : 0;
+	unsigned state[BATCH_LANES_MAX], path;
+	int i, j, len = dec->code.len;
+	int rc = 0;
+
+	if (batch_traceback_state(dec, state, n))
+		rc = -EPROTO;
+
+	for (i = vdec->len - 1; i >= len; i--) {
+		for (j = 0; j < n; j++) {
+			path = paths[(i * nw + state[j] / 16) * batch_lanes + j];
+			path = (path >> (state[j] % 16)) & 1;
+			state[j] = ((state[j] << 1) & mask) | path;
+		}
+	}
+
+	for (i = len - 1; i >= 0; i--) {
+		for (j = 0; j < n; j++) {
+			path = paths[(i * nw + state[j] / 16) * batch_lanes + j];
+			path = (path >> (state[j] % 16)) & 1;
+			output[j][i] = (path & recursive) ^ vals[state[j]];
+			state[j] = ((state[j] << 1) & mask) | path;
+		}
+	}
+
+	return rc;
+}
+
+static inline __attribute__((always_inline)) int _batch_traceback_ber(
+	struct osmo_conv_acc_decoder *dec, int n, const sbit_t * const *input,
+	ubit_t * const *output, int cnt, int *n_errors)
+{
+	struct vdecoder *vdec = &dec->vdec;
+	int ns = vdec->trellis.num_states;
+	int nw = ns / 16;
+	int olen = NUM_OUTPUTS(n);
+	int lanes = batch_lanes;
+	const uint16_t *paths = (const uint16_t *) dec->batch.paths;
+	const uint8_t *vals = vdec->trellis.vals;
+	const int16_t *outputs = vdec->trellis.outputs;
+	const int16_t *seq, *o;
+	/* as vstate_lshift() */
+	unsigned mask = (ns - 1) & ~1;
+	unsigned recursive = vdec->recursive ? 1 : 0;
+	unsigned end[BATCH_LANES_MAX], state[BATCH_LANES_MAX], path, failed;
+	int errors[BATCH_LANES_MAX] = { 0 };
+	int num_punc = vdec->len * n - dec->coded_len;
+	int i, j, k, sign, len = dec->code.len;
+	int rc = 0;
+
+	failed = batch_traceback_state(dec, end, cnt);
+	if (failed)
+		rc = -EPROTO;
+	memcpy(state, end, sizeof(state));
+
+	for (i = vdec->len - 1; i >= 0; i--) {
+		seq = &dec->batch.seq[n * i * lanes];
+		for (j = 0; j < cnt; j++) {
+			path = paths[(i * nw + state[j] / 16) * lanes + j];
+			path = (path >> (state[j] % 16)) & 1;
+			if (i < len)
+				output[j][i] = (path & recursive) ^ vals[state[j]];
+
+			o = &outputs[olen * (state[j] & (ns / 2 - 1))];
+			sign = 1 - 2 * (int) (path ^ (state[j] >= ns / 2));
+			for (k = 0; k < n; k++)
+				errors[j] += seq[k * lanes + j] * o[k] * sign <= 0;
+
+			state[j] = ((state[j] << 1) & mask) | path;
+		}
+	}
+
+	for (j = 0; j < cnt; j++) {
+		if (state[j] != (dec->code.term == CONV_TERM_TAIL_BITING ? end[j] : 0))
+			failed |= 1 << j;
+		if (failed & (1 << j))
+			osmo_conv_count_ber(&dec->code, input[j], output[j], &n_errors[j], NULL, NULL);
+		else
+			n_errors[j] = errors[j] - num_punc;
+	}
+
+	return rc;
+}
+
+/* Traceback of all lanes, counting the bit errors of their inputs on the
+ * way, like traceback_ber() for a single codeword.  Lanes where that doesn't
+ * apply fall back to re-encoding the decoded bits. */
+static int batch_traceback_ber(struct osmo_conv_acc_decoder *dec,
+	const sbit_t * const *input, ubit_t * const *output, int cnt, int *n_errors)
+{
+	switch (dec->vdec.n) {
+	case 2:
+		return _batch_traceback_ber(dec, 2, input, output, cnt, n_errors);
+	case 3:
+		return _batch_traceback_ber(dec, 3, input, output, cnt, n_errors);
+	default:
+		return _batch_traceback_ber(dec, 4, input, output, cnt, n_errors);
+	}
+}
+
+/* Decode up to batch_lanes codewords at once, counting the bit errors of
+ * their inputs if 'n_errors' is given */
+static int batch_decode(struct osmo_conv_acc_decoder *dec,
+	const sbit_t * const *input, ubit_t * const *output, int n, int *n_errors)
+{
+	struct vdecoder *vdec = &dec->vdec;
+	int ns = vdec->trellis.num_states;
+	int i, rc;
+
+	rc = batch_init(dec);
+	if (rc)
+		return rc;
+
+	batch_load(dec, input, n);
+
+	/* same initial path metrics as a single codeword in every lane */
+	vdec_reset(vdec, &dec->code);
+	for (i = 0; i < ns * batch_lanes; i++)
+		dec->batch.sums[i] = vdec->trellis.sums[i / batch_lanes];
+
+	batch_forward(ns, vdec->n, vdec->len, vdec->intrvl, vdec->trellis.outputs,
+		      dec->batch.seq, dec->batch.sums, dec->batch.paths);
+	if (dec->code.term == CONV_TERM_TAIL_BITING)
+		batch_forward(ns, vdec->n, vdec->len, vdec->intrvl, vdec->trellis.outputs,
+			      dec->batch.seq, dec->batch.sums, dec->batch.paths);
+
+	if (n_errors)
+		return batch_traceback_ber(dec, input, output, n, n_errors);
+	return batch_traceback(dec, output, n);
+}
+
+static void vdec_cache_thread_exit(void *arg)
+{
+	osmo_conv_acc_cache_flush();
+}
+
+static void vdec_cache_key_create(void)
+{
+	vdec_cache_key_valid = !pthread_key_create(&vdec_cache_key, vdec_cache_thread_exit);
+}
+
+static __attribute__((destructor)) void on_dso_unload_conv_acc(void)
+{
+	if (vdec_cache_key_valid)
+		pthread_key_delete(vdec_cache_key);
+}
+
+/* Find the decoder for a code in the cache of the calling thread, and set it
+ * up if there is none yet.  Returns NULL if the cache is full. */
+static struct osmo_conv_acc_decoder *vdec_cache_get(const struct osmo_conv_code *code, int *rc)
+{
+	struct osmo_conv_acc_decoder *dec;
+
+	*rc = 0;
+	hash_for_each_possible(vdec_cache, dec, node, (unsigned long)code) {
+		if (dec->code_ptr != code)
+			continue;
+		if (conv_code_equal(&dec->code, code))
+			return dec;
+
+		/* same address, different code: set up again */
+		vdec_deinit(&dec->vdec);
+		free(dec->batch.mem);
+		memset(&dec->batch, 0, sizeof(dec->batch));
+		*rc = acc_decoder_init(dec, code);
+		if (*rc) {
+			hash_del(&dec->node);
+			vdec_cache_len--;
+			free(dec);
+			return NULL;
+		}
+		return dec;
+	}
+
+	if (vdec_cache_len >= VDEC_CACHE_MAX)
+		return NULL;
+
+	/* flush the cache when the thread exits */
+	if (!vdec_cache_len) {
+		pthread_once(&vdec_cache_key_once, vdec_cache_key_create);
+		if (vdec_cache_key_valid)
+			pthread_setspecific(vdec_cache_key, &vdec_cache);
+	}
+
+	dec = calloc(1, sizeof(*dec));
+	if (!dec)
+		return NULL;
+
+	*rc = acc_decoder_init(dec, code);
+	if (*rc) {
+		free(dec);
+		return NULL;
+	}
+
+	hash_add(vdec_cache, &dec->node, (unsigned long)code);
+	vdec_cache_len++;
+	return dec;
+}
+
+/*! Release the decoders cached by \ref osmo_conv_decode for the calling thread
+ *
+ *  osmo_conv_decode() keeps one decoder per code and thread, so decoding
+ *  doesn't allocate memory once each code was used.  The decoders of a
+ *  thread are released when it exits; call this before to release them
+ *  earlier, or after changing the tables of a code in place. */
+void osmo_conv_acc_cache_flush(void)
+{
+	struct osmo_conv_acc_decoder *dec;
+	struct hlist_node *tmp;
+	int bkt;
+
+	hash_for_each_safe(vdec_cache, bkt, tmp, dec, node) {
+		hash_del(&dec->node);
+		osmo_conv_acc_decoder_free(dec);
+	}
+	vdec_cache_len = 0;
+}
+
+/*! Limit the SIMD instruction set used by the accelerated decoder
+ *
+ *  By default, the decoder uses the best instruction set supported by
+ *  both the build and the CPU.  This limits it to the given one or a
+ *  lower one, for instance to compare the kernels.  On ARM, NEON is used
+ *  for any limit but OSMO_CONV_SIMD_GEN.
+ *
+ *  The decoders cached by the calling thread are released, see
+ *  \ref osmo_conv_acc_cache_flush.  Those of other threads and those
+ *  allocated by \ref osmo_conv_acc_decoder_alloc must be released before.
+ *
+ *  \param[in] max highest instruction set to use
+ *  \returns 0 on success; negative on error */
+int osmo_conv_simd_limit(enum osmo_conv_simd max)
+{
+	if (max < OSMO_CONV_SIMD_GEN || max > OSMO_CONV_SIMD_NEON)
+		return -EINVAL;
+
+	osmo_conv_acc_cache_flush();
+	simd_max = max;
+	osmo_conv_init();
+
+	return 0;
+}
+
+/*! Get the SIMD instruction set used by the accelerated decoder
+ *  \returns instruction set in use */
+enum osmo_conv_simd osmo_conv_simd_get(void)
+{
+	if (!init_complete)
+		osmo_conv_init();
+
+	return simd_used;
+}
+
+/*! Decode several sequences of the same convolutional code at once
+ *
+ *  For the codes accelerated by \ref osmo_conv_decode with N up to 4,
+ *  the sequences are decoded in parallel, one per vector lane: 16 at a
+ *  time with AVX2, otherwise 8.  This is faster than decoding them one by
+ *  one, in particular for K=5 codes, whose 16 states don't fill the
+ *  vector units when decoding one sequence.  Other codes are decoded one
+ *  by one.  The output is the same as that of
+ *  osmo_conv_decode() for each sequence.
+ *
+ *  \param[in] code convolutional code of all sequences
+ *  \param[in] input n pointers to the soft bits of each encoded sequence
+ *  \param[out] output n pointers to buffers for code->len decoded bits each
+ *  \param[in] n number of sequences
+ *  \returns 0 on success; negative if decoding any of the sequences failed */
+int osmo_conv_decode_batch(const struct osmo_conv_code *code,
+	const sbit_t * const *input, ubit_t * const *output, unsigned int n)
+{
+	return osmo_conv_decode_batch_ber(code, input, output, n, NULL, NULL);
+}
+
+/*! Decode several sequences of the same code at once and count bit errors
+ *
+ *  Like \ref osmo_conv_decode_batch, with the bit errors of each sequence
+ *  as counted by \ref osmo_conv_decode_ber.
+ *
+ *  \param[in] code convolutional code of all sequences
+ *  \param[in] input n pointers to the soft bits of each encoded sequence
+ *  \param[out] output n pointers to buffers for code->len decoded bits each
+ *  \param[in] n number of sequences
+ *  \param[out] n_errors n numbers of bit errors; may be NULL
+ *  \param[out] n_bits_total n numbers of coded bits; may be NULL
+ *  \returns 0 on success; negative if decoding any of the sequences failed */
+int osmo_conv_decode_batch_ber(const struct osmo_conv_code *code,
+	const sbit_t * const *input, ubit_t * const *output, unsigned int n,
+	int *n_errors, int *n_bits_total)
+{
+	struct osmo_conv_acc_decoder *dec, *tmp = NULL;
+	unsigned int i, j, cnt;
+	int rc, rv = 0;
+
+	if (!init_complete)
+		osmo_conv_init();
+
+	if (!conv_code_check(code)) {
+		dec = vdec_cache_get(code, &rc);
+		/* cache full */
+		if (!dec && !rc)
+			dec = tmp = osmo_conv_acc_decoder_alloc(code);
+	} else
+		dec = NULL;
+
+	/* code not supported by the accelerated decoder */
+	if (!dec) {
+		for (i = 0; i < n; i++) {
+			rc = osmo_conv_decode_ber(code, input[i], output[i],
+				n_errors ? &n_errors[i] : NULL,
+				n_bits_total ? &n_bits_total[i] : NULL);
+			if (rc < 0 && !rv)
+				rv = rc;
+		}
+		return rv;
+	}
+
+	for (i = 0; i < n; i += cnt) {
+		cnt = n - i < batch_lanes ? n - i : batch_lanes;
+		if (code->N > BATCH_N_MAX)
+			cnt = 1;
+		if (cnt == 1) {
+			rc = acc_decoder_decode_ber(dec, input[i], output[i],
+				n_errors ? &n_errors[i] : NULL,
+				n_bits_total ? &n_bits_total[i] : NULL, NULL);
+		} else {
+			rc = batch_decode(dec, &input[i], &output[i], cnt,
+				n_errors ? &n_errors[i] : NULL);
+			if (n_bits_total) {
+				for (j = 0; j < cnt; j++)
+					n_bits_total[i + j] = dec->coded_len;
+			}
+		}
+		if (rc && !rv)
+			rv = rc;
+	}
+
+	osmo_conv_acc_decoder_free(tmp);
+	return rv;
 }
 
 /* All-in-one Viterbi decoding  */
@@ -719,23 +1646,61 @@ int osmo_conv_decode_acc(const struct osmo_conv_code *code,
 	const sbit_t *input, ubit_t *output)
 {
 	int rc;
-	struct vdecoder dec;
+	struct osmo_conv_acc_decoder *dec;
 
 	if (!init_complete)
 		osmo_conv_init();
 
-	if ((code->N < 2) || (code->N > 4) || (code->len < 1) ||
-		((code->K != 5) && (code->K != 7)))
-		return -EINVAL;
+	rc = conv_code_check(code);
+	if (rc)
+		return rc;
 
-	rc = vdec_init(&dec, code);
+	dec = vdec_cache_get(code, &rc);
+	if (dec)
+		return acc_decoder_decode(dec, input, output);
 	if (rc)
 		return rc;
 
-	rc = conv_decode(&dec, input, code->puncture,
-		output, code->len, code->term);
+	/* cache full */
+	dec = osmo_conv_acc_decoder_alloc(code);
+	if (!dec)
+		return -ENOMEM;
+
+	rc = acc_decoder_decode(dec, input, output);
+	osmo_conv_acc_decoder_free(dec);
+
+	return rc;
+}
+
+/* All-in-one Viterbi decoding, counting the bit errors of the input */
+__attribute__ ((visibility("hidden")))
+int osmo_conv_decode_acc_ber(const struct osmo_conv_code *code,
+	const sbit_t *input, ubit_t *output,
+	int *n_errors, int *n_bits_total, const uint8_t *data_punc)
+{
+	int rc;
+	struct osmo_conv_acc_decoder *dec;
+
+	if (!init_complete)
+		osmo_conv_init();
+
+	rc = conv_code_check(code);
+	if (rc)
+		return rc;
+
+	dec = vdec_cache_get(code, &rc);
+	if (dec)
+		return acc_decoder_decode_ber(dec, input, output, n_errors, n_bits_total, data_punc);
+	if (rc)
+		return rc;
+
+	/* cache full */
+	dec = osmo_conv_acc_decoder_alloc(code);
+	if (!dec)
+		return -ENOMEM;
 
-	vdec_deinit(&dec);
+	rc = acc_decoder_decode_ber(dec, input, output, n_errors, n_bits_total, data_punc);
+	osmo_conv_acc_decoder_free(dec);
 
 	return rc;
 }
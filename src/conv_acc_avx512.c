@@ -0,0 +1,329 @@
+/*! \file conv_acc_avx512.c
+ * Accelerated Viterbi decoder implementation:
+ * AVX-512BW kernels, for K=7 the 64 path metrics fit in two registers. */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdint.h>
+#include "config.h"
+
+#include <immintrin.h>
+
+/* Some distributions (notably Alpine Linux) for some strange reason
+ * don't have this #define */
+#ifndef __always_inline
+#define __always_inline         inline __attribute__((always_inline))
+#endif
+
+/* Path metrics are deinterleaved like in the SSE kernels: the byte
+ * shuffle moves the even elements of each 128-bit lane to its low and the
+ * odd ones to its high 64 bits, then the 64-bit permutations gather them.
+ * Permuting 16-bit elements across lanes directly is much slower. */
+#define _I8_SHUFFLE_MASK 15, 14, 11, 10, 7, 6, 3, 2, 13, 12, 9, 8, 5, 4, 1, 0
+
+static const uint64_t _k7_even[8] = { 0, 2, 4, 6, 8, 10, 12, 14 };
+static const uint64_t _k7_odd[8] = { 1, 3, 5, 7, 9, 11, 13, 15 };
+
+/* Branch metric order after packing, which interleaves the 128-bit lanes
+ * of its operands, for 2, 4 and 8 trellis outputs per state. The K=5
+ * tables also place the negated branch metrics in the upper half. */
+static const uint16_t _k7_bm_order[3][32] = {
+	{
+		 0,  1,  2,  3,  8,  9, 10, 11, 16, 17, 18, 19, 24, 25, 26, 27,
+		 4,  5,  6,  7, 12, 13, 14, 15, 20, 21, 22, 23, 28, 29, 30, 31,
+	},
+	{
+		 0,  1,  8,  9, 16, 17, 24, 25,  2,  3, 10, 11, 18, 19, 26, 27,
+		 4,  5, 12, 13, 20, 21, 28, 29,  6,  7, 14, 15, 22, 23, 30, 31,
+	},
+	{
+		 0,  8, 16, 24,  1,  9, 17, 25,  2, 10, 18, 26,  3, 11, 19, 27,
+		 4, 12, 20, 28,  5, 13, 21, 29,  6, 14, 22, 30,  7, 15, 23, 31,
+	},
+};
+
+static const uint16_t _k5_bm_order[3][16] = {
+	{ 0, 1, 2, 3, 8, 9, 10, 11, 4, 5, 6, 7, 12, 13, 14, 15 },
+	{ 0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15 },
+	{ 0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15 },
+};
+
+#define BM_ORDER(OLEN)	((OLEN) == 2 ? 0 : (OLEN) == 4 ? 1 : 2)
+
+/* Horizontal minimum
+ * Compute the minimum of 8 signed 16-bit integers and place it in the low
+ * 16-bit element. The other elements are undefined.
+ */
+static __always_inline __m128i _avx512_hmin(__m128i m0)
+{
+	m0 = _mm_min_epi16(m0, _mm_shuffle_epi32(m0, _MM_SHUFFLE(1, 0, 3, 2)));
+	m0 = _mm_min_epi16(m0, _mm_shuffle_epi32(m0, _MM_SHUFFLE(2, 3, 0, 1)));
+	m0 = _mm_min_epi16(m0, _mm_srli_epi32(m0, 16));
+
+	return m0;
+}
+
+/* Load input sequence
+ * Sign extend the n soft bits of a step to 16-bit and repeat them for 2
+ * and 4 trellis outputs per state, so that each 128-bit lane holds the
+ * values for its trellis outputs. The masked load doesn't read beyond the
+ * end of the sequence, and building the vector in registers avoids the
+ * store forwarding stall of loading it from the stack.
+ */
+static __always_inline __m128i _avx512_load_seq(const int8_t *seq, int n)
+{
+	__m128i m0;
+
+	m0 = _mm_cvtepi8_epi16(_mm_maskz_loadu_epi8((1 << n) - 1, seq));
+
+	if (n == 2)
+		m0 = _mm_broadcastd_epi32(m0);
+	else if (n <= 4)
+		m0 = _mm_broadcastq_epi64(m0);
+
+	return m0;
+}
+
+/* Generate branch metrics K = 7:
+ * Compute 32 branch metrics from olen (2, 4 or 8) trellis outputs per
+ * state and the input values repeated in each 128-bit lane. Multiply-add
+ * sums pairs of products into 32-bit integers, then pack and sum pairs
+ * again until one sum per butterfly is left.
+ */
+static __always_inline __m512i _avx512_branch_metrics_k7(const int16_t *out,
+	__m512i val, int olen)
+{
+	__m512i m[8], one = _mm512_set1_epi16(1);
+	int i, n;
+
+	for (i = 0; i < olen; i++)
+		m[i] = _mm512_madd_epi16(_mm512_loadu_si512(&out[32 * i]), val);
+
+	for (n = olen; n > 2; n /= 2) {
+		for (i = 0; i < n / 2; i++)
+			m[i] = _mm512_madd_epi16(_mm512_packs_epi32(m[2 * i], m[2 * i + 1]), one);
+	}
+
+	m[0] = _mm512_packs_epi32(m[0], m[1]);
+
+	return _mm512_permutexvar_epi16(
+		_mm512_loadu_si512(_k7_bm_order[BM_ORDER(olen)]), m[0]);
+}
+
+/* Generate branch metrics K = 5:
+ * As for K = 7, compute the 8 branch metrics of the 16-state trellis in
+ * the lower half, and their negation in the upper half.
+ */
+static __always_inline __m256i _avx512_branch_metrics_k5(const int16_t *out,
+	__m256i val, int olen)
+{
+	__m256i m[4], one = _mm256_set1_epi16(1);
+	int i, n;
+
+	for (i = 0; i < olen / 2; i++)
+		m[i] = _mm256_madd_epi16(_mm256_loadu_si256((__m256i *) &out[16 * i]), val);
+
+	for (n = olen / 2; n > 1; n /= 2) {
+		for (i = 0; i < n / 2; i++)
+			m[i] = _mm256_madd_epi16(_mm256_packs_epi32(m[2 * i], m[2 * i + 1]), one);
+	}
+
+	m[0] = _mm256_packs_epi32(m[0], _mm256_sub_epi32(_mm256_setzero_si256(), m[0]));
+
+	return _mm256_permutexvar_epi16(
+		_mm256_loadu_si256((__m256i *) _k5_bm_order[BM_ORDER(olen)]), m[0]);
+}
+
+/* Combined BMU/PMU (K=7)
+ * Compute branch metrics followed by path metrics for the 64-state
+ * trellis. The 32 butterflies are computed at once, with the even and odd
+ * path metrics in one register each. Path selections come from mask
+ * compares, where ties select the '0' path as in the other kernels.
+ */
+static __always_inline void _avx512_metrics_k7(const int8_t *seq,
+	const int16_t *out, int16_t *sums, int16_t *paths, int norm, int n)
+{
+	int olen = n == 2 ? 2 : (n <= 4 ? 4 : 8);
+	__m512i m0, m1, m2, m3, m4, m5;
+	__m256i m6;
+	__m128i m7;
+
+	/* (BMU) Load input sequence and compute branch metrics */
+	m0 = _mm512_broadcast_i32x4(_avx512_load_seq(seq, n));
+	m0 = _avx512_branch_metrics_k7(out, m0, olen);
+
+	/* (PMU) Load and deinterleave accumulated path metrics */
+	m1 = _mm512_loadu_si512(&sums[0]);
+	m2 = _mm512_loadu_si512(&sums[32]);
+	m3 = _mm512_broadcast_i32x4(_mm_set_epi8(_I8_SHUFFLE_MASK));
+	m1 = _mm512_shuffle_epi8(m1, m3);
+	m2 = _mm512_shuffle_epi8(m2, m3);
+	m3 = _mm512_permutex2var_epi64(m1, _mm512_loadu_si512(_k7_even), m2);
+	m4 = _mm512_permutex2var_epi64(m1, _mm512_loadu_si512(_k7_odd), m2);
+
+	/* (PMU) Butterflies: 0-31 */
+	m1 = _mm512_adds_epi16(m3, m0);
+	m2 = _mm512_subs_epi16(m4, m0);
+	m5 = _mm512_movm_epi16(_mm512_cmpge_epi16_mask(m1, m2));
+	_mm512_storeu_si512(&paths[0], m5);
+	m1 = _mm512_max_epi16(m1, m2);
+
+	m3 = _mm512_subs_epi16(m3, m0);
+	m4 = _mm512_adds_epi16(m4, m0);
+	m5 = _mm512_movm_epi16(_mm512_cmpge_epi16_mask(m3, m4));
+	_mm512_storeu_si512(&paths[32], m5);
+	m2 = _mm512_max_epi16(m3, m4);
+
+	if (norm) {
+		m0 = _mm512_min_epi16(m1, m2);
+		m6 = _mm256_min_epi16(_mm512_castsi512_si256(m0),
+				      _mm512_extracti64x4_epi64(m0, 1));
+		m7 = _mm_min_epi16(_mm256_castsi256_si128(m6),
+				   _mm256_extracti128_si256(m6, 1));
+		m0 = _mm512_broadcastw_epi16(_avx512_hmin(m7));
+		m1 = _mm512_subs_epi16(m1, m0);
+		m2 = _mm512_subs_epi16(m2, m0);
+	}
+
+	_mm512_storeu_si512(&sums[0], m1);
+	_mm512_storeu_si512(&sums[32], m2);
+}
+
+/* Combined BMU/PMU (K=5)
+ * Compute branch metrics followed by path metrics for the 16-state
+ * trellis. Both halves of the 8 butterflies are computed at once in a
+ * 256-bit register, with the even and odd path metrics repeated.
+ */
+static __always_inline void _avx512_metrics_k5(const int8_t *seq,
+	const int16_t *out, int16_t *sums, int16_t *paths, int norm, int n)
+{
+	int olen = n == 2 ? 2 : (n <= 4 ? 4 : 8);
+	__m256i m0, m1, m2, m3;
+	__m128i m4;
+
+	/* (BMU) Load input sequence and compute branch metrics */
+	m0 = _mm256_broadcastsi128_si256(_avx512_load_seq(seq, n));
+	m0 = _avx512_branch_metrics_k5(out, m0, olen);
+
+	/* (PMU) Load and deinterleave accumulated path metrics */
+	m1 = _mm256_loadu_si256((__m256i *) &sums[0]);
+	m1 = _mm256_shuffle_epi8(m1, _mm256_broadcastsi128_si256(
+		_mm_set_epi8(_I8_SHUFFLE_MASK)));
+	m2 = _mm256_permute4x64_epi64(m1, _MM_SHUFFLE(2, 0, 2, 0));
+	m3 = _mm256_permute4x64_epi64(m1, _MM_SHUFFLE(3, 1, 3, 1));
+
+	/* (PMU) Butterflies: 0-7 */
+	m2 = _mm256_adds_epi16(m2, m0);
+	m3 = _mm256_subs_epi16(m3, m0);
+	m1 = _mm256_movm_epi16(_mm256_cmpge_epi16_mask(m2, m3));
+	_mm256_storeu_si256((__m256i *) &paths[0], m1);
+	m1 = _mm256_max_epi16(m2, m3);
+
+	if (norm) {
+		m4 = _mm_min_epi16(_mm256_castsi256_si128(m1),
+				   _mm256_extracti128_si256(m1, 1));
+		m0 = _mm256_broadcastw_epi16(_avx512_hmin(m4));
+		m1 = _mm256_subs_epi16(m1, m0);
+	}
+
+	_mm256_storeu_si256((__m256i *) &sums[0], m1);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_avx512_metrics_k5_n2(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	_avx512_metrics_k5(seq, out, sums, paths, norm, 2);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_avx512_metrics_k5_n3(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	_avx512_metrics_k5(seq, out, sums, paths, norm, 3);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_avx512_metrics_k5_n4(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	_avx512_metrics_k5(seq, out, sums, paths, norm, 4);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_avx512_metrics_k5_n5(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	_avx512_metrics_k5(seq, out, sums, paths, norm, 5);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_avx512_metrics_k5_n6(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	_avx512_metrics_k5(seq, out, sums, paths, norm, 6);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_avx512_metrics_k5_n7(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	_avx512_metrics_k5(seq, out, sums, paths, norm, 7);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_avx512_metrics_k7_n2(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	_avx512_metrics_k7(seq, out, sums, paths, norm, 2);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_avx512_metrics_k7_n3(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	_avx512_metrics_k7(seq, out, sums, paths, norm, 3);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_avx512_metrics_k7_n4(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	_avx512_metrics_k7(seq, out, sums, paths, norm, 4);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_avx512_metrics_k7_n5(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	_avx512_metrics_k7(seq, out, sums, paths, norm, 5);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_avx512_metrics_k7_n6(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	_avx512_metrics_k7(seq, out, sums, paths, norm, 6);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_avx512_metrics_k7_n7(const int8_t *seq, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	_avx512_metrics_k7(seq, out, sums, paths, norm, 7);
+}
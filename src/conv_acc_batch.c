@@ -0,0 +1,34 @@
+/*! \file conv_acc_batch.c
+ * Accelerated Viterbi decoder implementation:
+ * Forward recursion over 8 codewords at once, for any architecture. */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdint.h>
+
+/* 128-bit vectors, as in SSE2 or NEON registers */
+#define BATCH_LANES	8
+
+#include "conv_acc_batch_impl.h"
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_gen_batch_forward(int ns, int n, int len, int intrvl,
+	const int16_t *out, const int16_t *seq, int16_t *sums, int16_t *paths)
+{
+	batch_forward(ns, n, len, intrvl, out, seq, sums, paths);
+}
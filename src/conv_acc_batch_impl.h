@@ -0,0 +1,157 @@
+/*! \file conv_acc_batch_impl.h
+ * Accelerated Viterbi decoder implementation:
+ * Forward recursion over several codewords at once, one codeword per
+ * vector lane.  Included from conv_acc_batch.c and conv_acc_batch_avx.c,
+ * which set BATCH_LANES to the number of 16-bit lanes of their vectors. */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/* Some distributions (notably Alpine Linux) for some strange reason
+ * don't have this #define */
+#ifndef __always_inline
+#define __always_inline         inline __attribute__((always_inline))
+#endif
+
+/* One accumulated path metric, branch metric or path decision per lane */
+typedef int16_t vbatch_t __attribute__((vector_size(BATCH_LANES * sizeof(int16_t))));
+
+/* Forward recursion of all lanes
+ * The same computation as the generic metric units in conv_acc_generic.c,
+ * in particular ties select the '0' path, so that every lane decodes
+ * exactly like a single codeword.
+ *
+ * Input:
+ * ns      - Number of trellis states (16 or 64)
+ * n       - Code order (2 to 4)
+ * len     - Number of trellis steps
+ * intrvl  - Normalization interval
+ * out     - Trellis outputs, 2 (N=2) or 4 (N=3,4) per state as for the
+ *           single codeword decoder
+ * seq     - Depunctured input, len * n vectors
+ *
+ * Output:
+ * sums    - Accumulated path metrics, ns vectors, also input
+ * paths   - Path decisions, len * ns / 16 vectors, one bit per state,
+ *           set where the path from the second predecessor survived
+ */
+static __always_inline void _batch_forward(int ns, int n, int len, int intrvl,
+	const int16_t *out, const vbatch_t *seq, vbatch_t *sums, vbatch_t *paths)
+{
+	vbatch_t buf[2][64], bm[16], dec[4];
+	vbatch_t *cur = buf[0], *nxt = buf[1], *tmp;
+	vbatch_t m, a, b, c, d, sel, min;
+	uint8_t idx[32];
+	int olen = (n == 2) ? 2 : 4;
+	int i, j, k, norm = 0;
+
+	/* The trellis outputs are +1 or -1, so that every branch metric is
+	 * one of the 2^n sums of the soft bits of a step with either sign.
+	 * Find the sum of each butterfly once, instead of multiplying. */
+	for (j = 0; j < ns / 2; j++) {
+		idx[j] = 0;
+		for (k = 0; k < n; k++)
+			idx[j] |= (out[olen * j + k] < 0) << k;
+	}
+
+	for (j = 0; j < ns; j++)
+		cur[j] = sums[j];
+
+	for (i = 0; i < len; i++, seq += n, paths += ns / 16) {
+		bm[0] = seq[0];
+		for (k = 1; k < n; k++)
+			bm[0] += seq[k];
+		for (k = 0; k < n; k++) {
+			for (j = 0; j < (1 << k); j++)
+				bm[j | (1 << k)] = bm[j] - seq[k] - seq[k];
+		}
+
+		for (j = 0; j < ns / 16; j++)
+			dec[j] = (vbatch_t) { 0 };
+
+#pragma GCC unroll 32
+		for (j = 0; j < ns / 2; j++) {
+			m = bm[idx[j]];
+
+			a = cur[2 * j] + m;
+			b = cur[2 * j + 1] - m;
+			c = cur[2 * j] - m;
+			d = cur[2 * j + 1] + m;
+
+			sel = a >= b;
+			nxt[j] = (a & sel) | (b & ~sel);
+			dec[j / 16] |= ~sel & (int16_t) (1 << (j % 16));
+
+			sel = c >= d;
+			nxt[j + ns / 2] = (c & sel) | (d & ~sel);
+			dec[(j + ns / 2) / 16] |= ~sel & (int16_t) (1 << ((j + ns / 2) % 16));
+		}
+
+		for (j = 0; j < ns / 16; j++)
+			paths[j] = dec[j];
+
+		if (!norm) {
+			min = nxt[0];
+			for (j = 1; j < ns; j++) {
+				sel = nxt[j] < min;
+				min = (nxt[j] & sel) | (min & ~sel);
+			}
+			for (j = 0; j < ns; j++)
+				nxt[j] -= min;
+		}
+		if (++norm == intrvl)
+			norm = 0;
+
+		tmp = cur;
+		cur = nxt;
+		nxt = tmp;
+	}
+
+	for (j = 0; j < ns; j++)
+		sums[j] = cur[j];
+}
+
+/* Specialize for the supported codes, so that the loops over states and
+ * code order are unrolled */
+static void batch_forward(int ns, int n, int len, int intrvl,
+	const int16_t *out, const int16_t *seq, int16_t *sums, int16_t *paths)
+{
+	const vbatch_t *vseq = (const vbatch_t *) seq;
+	vbatch_t *vsums = (vbatch_t *) sums;
+	vbatch_t *vpaths = (vbatch_t *) paths;
+
+	switch (ns * 8 + n) {
+	case 16 * 8 + 2:
+		_batch_forward(16, 2, len, intrvl, out, vseq, vsums, vpaths);
+		break;
+	case 16 * 8 + 3:
+		_batch_forward(16, 3, len, intrvl, out, vseq, vsums, vpaths);
+		break;
+	case 16 * 8 + 4:
+		_batch_forward(16, 4, len, intrvl, out, vseq, vsums, vpaths);
+		break;
+	case 64 * 8 + 2:
+		_batch_forward(64, 2, len, intrvl, out, vseq, vsums, vpaths);
+		break;
+	case 64 * 8 + 3:
+		_batch_forward(64, 3, len, intrvl, out, vseq, vsums, vpaths);
+		break;
+	case 64 * 8 + 4:
+		_batch_forward(64, 4, len, intrvl, out, vseq, vsums, vpaths);
+		break;
+	}
+}
@@ -130,3 +130,63 @@ void osmo_conv_sse_metrics_k7_n4(const int8_t *val, const int16_t *out,
 
 	_sse_metrics_k7_n4(_val, out, sums, paths, norm);
 }
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_sse_metrics_k5_n5(const int8_t *val, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	__m128i _val = _mm_setr_epi16(val[0], val[1], val[2], val[3],
+		val[4], 0, 0, 0);
+
+	_sse_metrics_k5_n8(_val, out, sums, paths, norm);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_sse_metrics_k5_n6(const int8_t *val, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	__m128i _val = _mm_setr_epi16(val[0], val[1], val[2], val[3],
+		val[4], val[5], 0, 0);
+
+	_sse_metrics_k5_n8(_val, out, sums, paths, norm);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_sse_metrics_k5_n7(const int8_t *val, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	__m128i _val = _mm_setr_epi16(val[0], val[1], val[2], val[3],
+		val[4], val[5], val[6], 0);
+
+	_sse_metrics_k5_n8(_val, out, sums, paths, norm);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_sse_metrics_k7_n5(const int8_t *val, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	__m128i _val = _mm_setr_epi16(val[0], val[1], val[2], val[3],
+		val[4], 0, 0, 0);
+
+	_sse_metrics_k7_n8(_val, out, sums, paths, norm);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_sse_metrics_k7_n6(const int8_t *val, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	__m128i _val = _mm_setr_epi16(val[0], val[1], val[2], val[3],
+		val[4], val[5], 0, 0);
+
+	_sse_metrics_k7_n8(_val, out, sums, paths, norm);
+}
+
+__attribute__ ((visibility("hidden")))
+void osmo_conv_sse_metrics_k7_n7(const int8_t *val, const int16_t *out,
+	int16_t *sums, int16_t *paths, int norm)
+{
+	__m128i _val = _mm_setr_epi16(val[0], val[1], val[2], val[3],
+		val[4], val[5], val[6], 0);
+
+	_sse_metrics_k7_n8(_val, out, sums, paths, norm);
+}
@@ -165,6 +165,37 @@ extern int sse41_supported;
 	M5 = _mm_hadds_epi16(M0, M1); \
 }
 
+/* Generate branch metrics N = 8:
+ * Compute 8 branch metrics from trellis outputs and input values. This
+ * macro is used for N from 5 to 7 where the extra soft input bits are
+ * padded.
+ *
+ * Input:
+ * M0:7 - 8 x 8 packed 16-bit trellis outputs
+ * M8   - Packed 16-bit input value
+ *
+ * Output:
+ * M9   - 8 computed 16-bit branch metrics
+ */
+#define SSE_BRANCH_METRIC_N8(M0, M1, M2, M3, M4, M5, M6, M7, M8, M9) \
+{ \
+	M0 = _mm_sign_epi16(M8, M0); \
+	M1 = _mm_sign_epi16(M8, M1); \
+	M2 = _mm_sign_epi16(M8, M2); \
+	M3 = _mm_sign_epi16(M8, M3); \
+	M4 = _mm_sign_epi16(M8, M4); \
+	M5 = _mm_sign_epi16(M8, M5); \
+	M6 = _mm_sign_epi16(M8, M6); \
+	M7 = _mm_sign_epi16(M8, M7); \
+	M0 = _mm_hadds_epi16(M0, M1); \
+	M2 = _mm_hadds_epi16(M2, M3); \
+	M4 = _mm_hadds_epi16(M4, M5); \
+	M6 = _mm_hadds_epi16(M6, M7); \
+	M0 = _mm_hadds_epi16(M0, M2); \
+	M4 = _mm_hadds_epi16(M4, M6); \
+	M9 = _mm_hadds_epi16(M0, M4); \
+}
+
 /* Horizontal minimum
  * Compute horizontal minimum of packed unsigned 16-bit integers and place
  * result in the low 16-bit element of the source register. Only SSE 4.1
@@ -503,3 +534,152 @@ __always_inline static void _sse_metrics_k7_n4(const int16_t *val,
 	_mm_store_si128((__m128i *) &sums[48], m2);
 	_mm_store_si128((__m128i *) &sums[56], m11);
 }
+
+/* Combined BMU/PMU (K=5, N=5 to N=7)
+ * Compute branch metrics followed by path metrics for 16-state and rates
+ * to 1/8. 8 butterflies are computed. The input sequence is passed as
+ * eight 16-bit values, and extra values should be set to zero.
+ */
+__always_inline static void _sse_metrics_k5_n8(__m128i val,
+	const int16_t *out, int16_t *sums, int16_t *paths, int norm)
+{
+	__m128i m0, m1, m2, m3, m4, m5, m6, m7, m8;
+
+	/* (BMU) Input sequence */
+	m8 = val;
+
+	/* (BMU) Load trellis outputs */
+	m0 = _mm_load_si128((__m128i *) &out[0]);
+	m1 = _mm_load_si128((__m128i *) &out[8]);
+	m2 = _mm_load_si128((__m128i *) &out[16]);
+	m3 = _mm_load_si128((__m128i *) &out[24]);
+	m4 = _mm_load_si128((__m128i *) &out[32]);
+	m5 = _mm_load_si128((__m128i *) &out[40]);
+	m6 = _mm_load_si128((__m128i *) &out[48]);
+	m7 = _mm_load_si128((__m128i *) &out[56]);
+
+	SSE_BRANCH_METRIC_N8(m0, m1, m2, m3, m4, m5, m6, m7, m8, m2)
+
+	/* (PMU) Load accumulated path metrics */
+	m0 = _mm_load_si128((__m128i *) &sums[0]);
+	m1 = _mm_load_si128((__m128i *) &sums[8]);
+
+	SSE_DEINTERLEAVE_K5(m0, m1, m3, m4)
+
+	/* (PMU) Butterflies: 0-7 */
+	SSE_BUTTERFLY(m3, m4, m2, m5, m6)
+
+	if (norm)
+		SSE_NORMALIZE_K5(m2, m6, m0, m1)
+
+	_mm_store_si128((__m128i *) &sums[0], m2);
+	_mm_store_si128((__m128i *) &sums[8], m6);
+	_mm_store_si128((__m128i *) &paths[0], m5);
+	_mm_store_si128((__m128i *) &paths[8], m4);
+}
+
+/* Combined BMU/PMU (K=7, N=5 to N=7)
+ * Compute branch metrics followed by path metrics for 64-state trellis
+ * and rates to 1/8. 32 butterfly operations are computed. The branch
+ * metrics need more registers than available, so some are spilled.
+ */
+__always_inline static void _sse_metrics_k7_n8(__m128i val,
+	const int16_t *out, int16_t *sums, int16_t *paths, int norm)
+{
+	__m128i m0, m1, m2, m3, m4, m5, m6, m7;
+	__m128i m8, m9, m10, m11, m12, m13, m14, m15;
+	__m128i m16, m17, m18, m19, m20;
+
+	/* (PMU) Load accumulated path metrics */
+	m0 = _mm_load_si128((__m128i *) &sums[0]);
+	m1 = _mm_load_si128((__m128i *) &sums[8]);
+	m2 = _mm_load_si128((__m128i *) &sums[16]);
+	m3 = _mm_load_si128((__m128i *) &sums[24]);
+	m4 = _mm_load_si128((__m128i *) &sums[32]);
+	m5 = _mm_load_si128((__m128i *) &sums[40]);
+	m6 = _mm_load_si128((__m128i *) &sums[48]);
+	m7 = _mm_load_si128((__m128i *) &sums[56]);
+
+	/* (PMU) Deinterleave into even and odd packed registers */
+	SSE_DEINTERLEAVE_K7(m0, m1, m2, m3 ,m4 ,m5, m6, m7,
+			    m8, m9, m10, m11, m12, m13, m14, m15)
+
+	/* (BMU) Input sequence */
+	m16 = val;
+
+	/* (BMU) Load and compute branch metrics */
+	m0 = _mm_load_si128((__m128i *) &out[0]);
+	m1 = _mm_load_si128((__m128i *) &out[8]);
+	m2 = _mm_load_si128((__m128i *) &out[16]);
+	m3 = _mm_load_si128((__m128i *) &out[24]);
+	m4 = _mm_load_si128((__m128i *) &out[32]);
+	m5 = _mm_load_si128((__m128i *) &out[40]);
+	m6 = _mm_load_si128((__m128i *) &out[48]);
+	m7 = _mm_load_si128((__m128i *) &out[56]);
+
+	SSE_BRANCH_METRIC_N8(m0, m1, m2, m3, m4, m5, m6, m7, m16, m17)
+
+	m0 = _mm_load_si128((__m128i *) &out[64]);
+	m1 = _mm_load_si128((__m128i *) &out[72]);
+	m2 = _mm_load_si128((__m128i *) &out[80]);
+	m3 = _mm_load_si128((__m128i *) &out[88]);
+	m4 = _mm_load_si128((__m128i *) &out[96]);
+	m5 = _mm_load_si128((__m128i *) &out[104]);
+	m6 = _mm_load_si128((__m128i *) &out[112]);
+	m7 = _mm_load_si128((__m128i *) &out[120]);
+
+	SSE_BRANCH_METRIC_N8(m0, m1, m2, m3, m4, m5, m6, m7, m16, m18)
+
+	m0 = _mm_load_si128((__m128i *) &out[128]);
+	m1 = _mm_load_si128((__m128i *) &out[136]);
+	m2 = _mm_load_si128((__m128i *) &out[144]);
+	m3 = _mm_load_si128((__m128i *) &out[152]);
+	m4 = _mm_load_si128((__m128i *) &out[160]);
+	m5 = _mm_load_si128((__m128i *) &out[168]);
+	m6 = _mm_load_si128((__m128i *) &out[176]);
+	m7 = _mm_load_si128((__m128i *) &out[184]);
+
+	SSE_BRANCH_METRIC_N8(m0, m1, m2, m3, m4, m5, m6, m7, m16, m19)
+
+	m0 = _mm_load_si128((__m128i *) &out[192]);
+	m1 = _mm_load_si128((__m128i *) &out[200]);
+	m2 = _mm_load_si128((__m128i *) &out[208]);
+	m3 = _mm_load_si128((__m128i *) &out[216]);
+	m4 = _mm_load_si128((__m128i *) &out[224]);
+	m5 = _mm_load_si128((__m128i *) &out[232]);
+	m6 = _mm_load_si128((__m128i *) &out[240]);
+	m7 = _mm_load_si128((__m128i *) &out[248]);
+
+	SSE_BRANCH_METRIC_N8(m0, m1, m2, m3, m4, m5, m6, m7, m16, m20)
+
+	/* (PMU) Butterflies: 0-15 */
+	SSE_BUTTERFLY(m8, m9, m17, m0, m1)
+	SSE_BUTTERFLY(m10, m11, m18, m2, m3)
+
+	_mm_store_si128((__m128i *) &paths[0], m0);
+	_mm_store_si128((__m128i *) &paths[8], m2);
+	_mm_store_si128((__m128i *) &paths[32], m9);
+	_mm_store_si128((__m128i *) &paths[40], m11);
+
+	/* (PMU) Butterflies: 17-31 */
+	SSE_BUTTERFLY(m12, m13, m19, m0, m2)
+	SSE_BUTTERFLY(m14, m15, m20, m9, m11)
+
+	_mm_store_si128((__m128i *) &paths[16], m0);
+	_mm_store_si128((__m128i *) &paths[24], m9);
+	_mm_store_si128((__m128i *) &paths[48], m13);
+	_mm_store_si128((__m128i *) &paths[56], m15);
+
+	if (norm)
+		SSE_NORMALIZE_K7(m17, m1, m18, m3, m19, m2,
+				 m20, m11, m0, m8, m9, m10)
+
+	_mm_store_si128((__m128i *) &sums[0], m17);
+	_mm_store_si128((__m128i *) &sums[8], m18);
+	_mm_store_si128((__m128i *) &sums[16], m19);
+	_mm_store_si128((__m128i *) &sums[24], m20);
+	_mm_store_si128((__m128i *) &sums[32], m1);
+	_mm_store_si128((__m128i *) &sums[40], m3);
+	_mm_store_si128((__m128i *) &sums[48], m2);
+	_mm_store_si128((__m128i *) &sums[56], m11);
+}
@@ -29,10 +29,58 @@
  *  \file crcXXgen.c.tpl */
 
 #include <stdint.h>
+#include "config.h"
 
 #include <osmocom/core/bits.h>
 #include <osmocom/core/crcXXgen.h>
 
+#ifdef HAVE_PCLMUL
+extern int osmo_crc_clmul_supported;
+uint64_t osmo_crc_clmul_compute_bits(int bits, uint64_t poly, uint64_t crc,
+	const ubit_t *in, int len);
+uint64_t osmo_crc_clmul_compute_pbits(int bits, uint64_t poly, uint64_t crc,
+	const pbit_t *in, int len);
+#endif
+
+#define CRCXX_MSB	((uintXX_t)1 << (XX - 1))
+
+/* Fill table with the register after shifting in 4 zero bits, by the 4
+ * bits shifted out, for a register aligned to the MSB of uintXX_t.  The
+ * entries for single bits are enough to XOR the rest. */
+static void
+crcXX_nibble_table(uintXX_t table[16], uintXX_t poly)
+{
+	uintXX_t x;
+	int i, k;
+
+	for (k = 0; k < 4; k++) {
+		x = CRCXX_MSB >> (3 - k);
+		for (i = 0; i < 4; i++)
+			x = (x << 1) ^ (poly & -(uintXX_t)(x >> (XX - 1)));
+		table[1 << k] = x;
+	}
+	table[0] = 0;
+	for (i = 3; i < 16; i++) {
+		if (i & (i - 1))
+			table[i] = table[i & -i] ^ table[i & (i - 1)];
+	}
+}
+
+/* Shift the 4 bits k, the first one in bit 3, into the register */
+static inline uintXX_t
+crcXX_nibble(const uintXX_t table[16], uintXX_t crc, int k)
+{
+	return (uintXX_t)(crc << 4) ^ table[(crc >> (XX - 4)) ^ k];
+}
+
+/* Shift one bit into the register */
+static inline uintXX_t
+crcXX_bit(uintXX_t poly, uintXX_t crc, int bit)
+{
+	crc ^= (uintXX_t)bit << (XX - 1);
+	return (uintXX_t)(crc << 1) ^ (poly & -(uintXX_t)(crc >> (XX - 1)));
+}
+
 
 /*! Compute the CRC value of a given array of hard-bits
  *  \param[in] code The CRC code description to apply
@@ -44,22 +92,75 @@ uintXX_t
 osmo_crcXXgen_compute_bits(const struct osmo_crcXXgen_code *code,
                            const ubit_t *in, int len)
 {
-	const uintXX_t poly = code->poly;
-	uintXX_t crc = code->init;
-	int i, n = code->bits-1;
-
-	for (i=0; i<len; i++) {
-		uintXX_t bit = in[i] & 1;
-		crc ^= (bit << n);
-		if (crc & ((uintXX_t)1 << n)) {
-			crc <<= 1;
-			crc ^= poly;
-		} else {
-			crc <<= 1;
-		}
-		crc &= ((uintXX_t)1 << code->bits) - 1;
+	uintXX_t table[16], poly, crc;
+	int i, k, shift = XX - code->bits;
+
+#ifdef HAVE_PCLMUL
+	if (osmo_crc_clmul_supported) {
+		crc = osmo_crc_clmul_compute_bits(code->bits, code->poly,
+			code->init, in, len);
+		return crc ^ code->remainder;
+	}
+#endif
+
+	/* Keep the register aligned to the MSB of uintXX_t, so that
+	 * CRCs of less than 4 bits work the same as the others */
+	poly = code->poly << shift;
+	crc = code->init << shift;
+	crcXX_nibble_table(table, poly);
+
+	for (i = 0; i + 4 <= len; i += 4) {
+		k = (in[i] & 1) << 3 | (in[i + 1] & 1) << 2 |
+		    (in[i + 2] & 1) << 1 | (in[i + 3] & 1);
+		crc = crcXX_nibble(table, crc, k);
+	}
+
+	for (; i < len; i++)
+		crc = crcXX_bit(poly, crc, in[i] & 1);
+
+	crc >>= shift;
+	crc ^= code->remainder;
+
+	return crc;
+}
+
+/*! Compute the CRC value of a given array of packed bits
+ *  \param[in] code The CRC code description to apply
+ *  \param[in] in Array of packed bits, the first bit in the MSB of in[0]
+ *  \param[in] len Number of bits
+ *  \returns The CRC value
+ *
+ *  Gives the same CRC as osmo_crcXXgen_compute_bits() of the bits
+ *  unpacked by osmo_pbit2ubit(), without unpacking them.
+ */
+uintXX_t
+osmo_crcXXgen_compute_pbits(const struct osmo_crcXXgen_code *code,
+                            const pbit_t *in, int len)
+{
+	uintXX_t table[16], poly, crc;
+	int i, shift = XX - code->bits;
+
+#ifdef HAVE_PCLMUL
+	if (osmo_crc_clmul_supported) {
+		crc = osmo_crc_clmul_compute_pbits(code->bits, code->poly,
+			code->init, in, len);
+		return crc ^ code->remainder;
 	}
+#endif
+
+	poly = code->poly << shift;
+	crc = code->init << shift;
+	crcXX_nibble_table(table, poly);
+
+	for (i = 0; i + 8 <= len; i += 8) {
+		crc = crcXX_nibble(table, crc, in[i / 8] >> 4);
+		crc = crcXX_nibble(table, crc, in[i / 8] & 0xf);
+	}
+
+	for (; i < len; i++)
+		crc = crcXX_bit(poly, crc, (in[i / 8] >> (7 - i % 8)) & 1);
 
+	crc >>= shift;
 	crc ^= code->remainder;
 
 	return crc;
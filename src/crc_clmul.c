@@ -0,0 +1,215 @@
+/*! \file crc_clmul.c
+ * Osmocom generic CRC routines: carry-less multiplication kernel.
+ * Computes the CRC of 64 hard or packed bits per step by Barrett
+ * reduction, for any CRC of up to 64 bits, on CPUs with PCLMULQDQ. */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+#include <osmocom/core/bits.h>
+#include <osmocom/core/simd_internal.h>
+
+/* Set by the constructor below, used by the crcXXgen code to dispatch */
+__attribute__ ((visibility("hidden")))
+int osmo_crc_clmul_supported = 0;
+
+static int clmul_cpu_supported;
+
+static __attribute__((constructor)) void on_dso_load_crc_clmul(void)
+{
+#ifdef HAVE___BUILTIN_CPU_SUPPORTS
+	clmul_cpu_supported = __builtin_cpu_supports("pclmul") &&
+		__builtin_cpu_supports("ssse3");
+#endif
+	osmo_crc_clmul_supported = clmul_cpu_supported;
+}
+
+/* Use the PCLMULQDQ kernel if the CPU supports it, or the generic code
+ * only, e.g. to test the generic code on such CPUs.  Not thread-safe.
+ * Returns whether the kernel is used from now on. */
+int osmo_crc_clmul_enable(int enable)
+{
+	osmo_crc_clmul_supported = enable && clmul_cpu_supported;
+	return osmo_crc_clmul_supported;
+}
+
+/* The Barrett constant depends on the polynomial only, but takes 64 steps
+ * to compute, more than the CRC of a typical block itself.  Remember it
+ * for the last few codes used by each thread. */
+#define MU_CACHE_SIZE	4
+
+static __thread struct {
+	int bits;
+	uint64_t poly;
+	uint64_t mu;
+} mu_cache[MU_CACHE_SIZE];
+static __thread unsigned int mu_cache_next;
+
+/* Low 64 bits of floor(x^(bits + 64) / P), where P = x^bits + poly, by
+ * long division; the quotient bits are the bits shifted out of a CRC
+ * register started at poly. */
+static uint64_t barrett_mu(int bits, uint64_t poly, uint64_t mask)
+{
+	uint64_t r = poly, mu = 0, top;
+	unsigned int i;
+
+	for (i = 0; i < MU_CACHE_SIZE; i++) {
+		if (mu_cache[i].bits == bits && mu_cache[i].poly == poly)
+			return mu_cache[i].mu;
+	}
+
+	for (i = 0; i < 64; i++) {
+		top = (r >> (bits - 1)) & 1;
+		mu = (mu << 1) | top;
+		r = ((r << 1) ^ (poly & -top)) & mask;
+	}
+
+	i = mu_cache_next++ % MU_CACHE_SIZE;
+	mu_cache[i].bits = bits;
+	mu_cache[i].poly = poly;
+	mu_cache[i].mu = mu;
+
+	return mu;
+}
+
+/* Carry-less product of a and b, the high 64 bits in *hi */
+static inline uint64_t clmul(uint64_t a, uint64_t b, uint64_t *hi)
+{
+	__m128i p;
+	uint64_t r[2];
+
+	p = _mm_clmulepi64_si128(_mm_set_epi64x(0, a), _mm_set_epi64x(0, b), 0x00);
+	_mm_storeu_si128((__m128i *) r, p);
+
+	*hi = r[1];
+	return r[0];
+}
+
+/* Pack 16 hard bits, the first one into the MSB */
+static inline uint64_t pack16(const ubit_t *in)
+{
+	const __m128i rev = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+					 8, 9, 10, 11, 12, 13, 14, 15);
+	__m128i v;
+
+	v = _mm_loadu_si128((const __m128i *) in);
+	v = _mm_shuffle_epi8(v, rev);
+
+	/* Bit 0 of each byte into its MSB, as in[i] & 1 */
+	return (uint16_t) _mm_movemask_epi8(_mm_slli_epi16(v, 7));
+}
+
+/* The register after m more bits d, m <= 64, the first bit in bit m - 1
+ * of d.  mu is barrett_mu() of poly. */
+static inline uint64_t clmul_update(int bits, uint64_t poly, uint64_t mask, uint64_t mu,
+				    uint64_t crc, uint64_t d, int m)
+{
+	uint64_t t, q, lo, hi;
+
+	/* The register after m more bits is A mod P, with
+	 * A = crc * x^m + d * x^bits.  Split A at x^bits into t and lo,
+	 * the quotient is q = floor(t * (x^64 + mu) / x^64). */
+	if (m >= bits) {
+		t = d ^ (crc << (m - bits));
+		lo = 0;
+	} else {
+		t = d ^ (crc >> (bits - m));
+		lo = (crc << m) & mask;
+	}
+
+	clmul(t, mu, &hi);
+	q = t ^ hi;
+
+	return (lo ^ clmul(q, poly, &hi)) & mask;
+}
+
+/*! Compute the CRC register after the given hard bits
+ *  \param[in] bits Number of bits of the CRC, 1 to 64
+ *  \param[in] poly Polynomial, normal representation without the MSB
+ *  \param[in] crc Initial CRC register
+ *  \param[in] in Array of hard bits
+ *  \param[in] len Length of the array of hard bits
+ *  \returns CRC register, before the final XOR */
+__attribute__ ((visibility("hidden")))
+uint64_t osmo_crc_clmul_compute_bits(int bits, uint64_t poly, uint64_t crc,
+	const ubit_t *in, int len)
+{
+	uint64_t mask = (bits == 64) ? ~(uint64_t) 0 : ((uint64_t) 1 << bits) - 1;
+	uint64_t mu, d;
+	int i, j, m;
+
+	poly &= mask;
+	crc &= mask;
+	mu = barrett_mu(bits, poly, mask);
+
+	for (i = 0; i < len; i += m) {
+		m = (len - i < 64) ? len - i : 64;
+
+		d = 0;
+		for (j = 0; j + 16 <= m; j += 16)
+			d = (d << 16) | pack16(&in[i + j]);
+		for (; j < m; j++)
+			d = (d << 1) | (in[i + j] & 1);
+
+		crc = clmul_update(bits, poly, mask, mu, crc, d, m);
+	}
+
+	return crc;
+}
+
+/*! Compute the CRC register after the given packed bits
+ *  \param[in] bits Number of bits of the CRC, 1 to 64
+ *  \param[in] poly Polynomial, normal representation without the MSB
+ *  \param[in] crc Initial CRC register
+ *  \param[in] in Array of packed bits, the first one in the MSB of in[0]
+ *  \param[in] len Number of bits
+ *  \returns CRC register, before the final XOR */
+__attribute__ ((visibility("hidden")))
+uint64_t osmo_crc_clmul_compute_pbits(int bits, uint64_t poly, uint64_t crc,
+	const pbit_t *in, int len)
+{
+	uint64_t mask = (bits == 64) ? ~(uint64_t) 0 : ((uint64_t) 1 << bits) - 1;
+	uint64_t mu, d;
+	int i, j, m;
+
+	poly &= mask;
+	crc &= mask;
+	mu = barrett_mu(bits, poly, mask);
+
+	for (i = 0; i + 64 <= len; i += 64) {
+		memcpy(&d, &in[i / 8], sizeof(d));
+		crc = clmul_update(bits, poly, mask, mu, crc, __builtin_bswap64(d), 64);
+	}
+
+	m = len - i;
+	if (m) {
+		d = 0;
+		for (j = 0; j < (m + 7) / 8; j++)
+			d = (d << 8) | in[i / 8 + j];
+		crc = clmul_update(bits, poly, mask, mu, crc, d >> (j * 8 - m), m);
+	}
+
+	return crc;
+}
@@ -28,6 +28,7 @@
 
 #include <ctype.h>
 #include <errno.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -36,6 +37,8 @@
 
 #include <osmocom/ctrl/control_cmd.h>
 
+#include <osmocom/core/hash.h>
+#include <osmocom/core/hashtable.h>
 #include <osmocom/core/msgb.h>
 #include <osmocom/core/talloc.h>
 #include <osmocom/core/utils.h>
@@ -52,14 +55,132 @@ const struct value_string ctrl_type_vals[] = {
 	{ CTRL_TYPE_SET_REPLY,	"SET_REPLY" },
 	{ CTRL_TYPE_TRAP,	"TRAP" },
 	{ CTRL_TYPE_ERROR,	"ERROR" },
+	{ CTRL_TYPE_GET_BULK,	"GET_BULK" },
+	{ CTRL_TYPE_GET_BULK_REPLY, "GET_BULK_REPLY" },
 	{ 0, NULL }
 };
 
 /* Functions from libosmocom */
 extern vector cmd_make_descvec(const char *string, const char *descstr);
 
-/* Get the ctrl_cmd_element that matches this command */
-static struct ctrl_cmd_element *ctrl_cmd_get_element_match(vector vline, vector node)
+/* A node of the word trie of the commands installed at one CTRL node.  The
+ * root of each trie is keyed by the command vector of the CTRL node, every
+ * other trie node by its parent and the word leading to it. */
+struct ctrl_cmd_trie {
+	struct hlist_node node;
+	const void *parent;
+	const char *word;
+	/* trie nodes one word further down, and entry in the parent's list */
+	struct llist_head children;
+	struct llist_head sibling;
+	/* only in the root: number of vector slots covered by the trie */
+	unsigned int num_slots;
+	/* first installed command ending at this trie node */
+	struct ctrl_cmd_element *end;
+	unsigned int end_idx;
+	/* commands continuing with a '*' at this trie node, by install order */
+	struct ctrl_cmd_trie_star {
+		struct ctrl_cmd_element *cmd_el;
+		unsigned int idx;
+	} *stars;
+	unsigned int num_stars;
+};
+
+static DEFINE_HASHTABLE(ctrl_cmd_tries, 8);
+
+static inline uint32_t ctrl_cmd_trie_key(const void *parent, const char *word)
+{
+	return hash_ptr(parent, 32) ^ osmo_fnv1a(word);
+}
+
+static struct ctrl_cmd_trie *ctrl_cmd_trie_find(const void *parent, const char *word)
+{
+	struct ctrl_cmd_trie *t;
+
+	hash_for_each_possible(ctrl_cmd_tries, t, node, ctrl_cmd_trie_key(parent, word)) {
+		if (t->parent == parent && !strcmp(t->word, word))
+			return t;
+	}
+	return NULL;
+}
+
+static struct ctrl_cmd_trie *ctrl_cmd_trie_get(const void *parent, const char *word)
+{
+	struct ctrl_cmd_trie *t = ctrl_cmd_trie_find(parent, word);
+
+	if (t)
+		return t;
+
+	t = talloc_zero(tall_vty_vec_ctx, struct ctrl_cmd_trie);
+	if (!t)
+		return NULL;
+	t->word = talloc_strdup(t, word);
+	if (!t->word) {
+		talloc_free(t);
+		return NULL;
+	}
+	t->parent = parent;
+	t->end_idx = UINT_MAX;
+	INIT_LLIST_HEAD(&t->children);
+	/* the parent of the root is the command vector */
+	if (*word)
+		llist_add_tail(&t->sibling, &((struct ctrl_cmd_trie *)parent)->children);
+	else
+		INIT_LLIST_HEAD(&t->sibling);
+	hash_add(ctrl_cmd_tries, &t->node, ctrl_cmd_trie_key(parent, word));
+	return t;
+}
+
+/* Add the command installed in slot idx of cmds_vec to the trie.  The trie
+ * is only an index: if it cannot be kept complete, lookups at this CTRL node
+ * fall back to ctrl_cmd_get_element_scan(). */
+static void ctrl_cmd_trie_add(vector cmds_vec, unsigned int idx, struct ctrl_cmd_element *cmd_el)
+{
+	struct ctrl_cmd_struct *cmd_desc = &cmd_el->strcmd;
+	struct ctrl_cmd_trie *root, *t;
+	struct ctrl_cmd_trie_star *stars;
+	unsigned int i;
+	int j;
+
+	root = t = ctrl_cmd_trie_get(cmds_vec, "");
+	if (!root)
+		return;
+	if (root->num_slots != idx)
+		goto incomplete;
+
+	for (j = 0; j < cmd_desc->nr_commands; j++) {
+		if (cmd_desc->command[j][0] == '*')
+			break;
+		t = ctrl_cmd_trie_get(t, cmd_desc->command[j]);
+		if (!t)
+			goto incomplete;
+	}
+
+	if (j == cmd_desc->nr_commands) {
+		if (idx < t->end_idx) {
+			t->end = cmd_el;
+			t->end_idx = idx;
+		}
+	} else {
+		stars = talloc_realloc(t, t->stars, struct ctrl_cmd_trie_star, t->num_stars + 1);
+		if (!stars)
+			goto incomplete;
+		for (i = t->num_stars; i > 0 && stars[i - 1].idx > idx; i--)
+			stars[i] = stars[i - 1];
+		stars[i].cmd_el = cmd_el;
+		stars[i].idx = idx;
+		t->stars = stars;
+		t->num_stars++;
+	}
+
+	root->num_slots = idx + 1;
+	return;
+incomplete:
+	root->num_slots = UINT_MAX;
+}
+
+/* Get the ctrl_cmd_element that matches this command by scanning all of them */
+static struct ctrl_cmd_element *ctrl_cmd_get_element_scan(vector vline, vector node)
 {
 	int index, j;
 	const char *desc;
@@ -89,6 +210,111 @@ static struct ctrl_cmd_element *ctrl_cmd_get_element_match(vector vline, vector
 	return NULL;
 }
 
+/* Get the ctrl_cmd_element that matches this command.  Of all commands whose
+ * words up to the end or up to a '*' equal the first words of vline, this
+ * is the one installed first, like ctrl_cmd_get_element_scan() finds it. */
+static struct ctrl_cmd_element *ctrl_cmd_get_element_match(vector vline, vector node)
+{
+	struct ctrl_cmd_trie *t = ctrl_cmd_trie_find(node, "");
+	struct ctrl_cmd_element *cmd_el = NULL;
+	unsigned int idx = UINT_MAX;
+	unsigned int active = vector_active(vline);
+	unsigned int depth, i;
+
+	if (!t || t->num_slots != vector_active(node))
+		return ctrl_cmd_get_element_scan(vline, node);
+
+	for (depth = 0; t; depth++) {
+		if (t->end_idx < idx) {
+			cmd_el = t->end;
+			idx = t->end_idx;
+		}
+		for (i = 0; i < t->num_stars && t->stars[i].idx < idx; i++) {
+			if (t->stars[i].cmd_el->strcmd.nr_commands <= active) {
+				cmd_el = t->stars[i].cmd_el;
+				idx = t->stars[i].idx;
+				break;
+			}
+		}
+		if (depth == active || !vector_slot(vline, depth))
+			break;
+		t = ctrl_cmd_trie_find(t, vector_slot(vline, depth));
+	}
+
+	return cmd_el;
+}
+
+/* Call cb for the commands ending at t and below it */
+static int ctrl_cmd_trie_for_each(struct ctrl_cmd_trie *t,
+				  int (*cb)(struct ctrl_cmd_element *cmd_el, void *data), void *data)
+{
+	struct ctrl_cmd_trie *child;
+	int rc;
+
+	if (t->end) {
+		rc = cb(t->end, data);
+		if (rc)
+			return rc;
+	}
+	llist_for_each_entry(child, &t->children, sibling) {
+		rc = ctrl_cmd_trie_for_each(child, cb, data);
+		if (rc)
+			return rc;
+	}
+	return 0;
+}
+
+/* Call cb for each command installed at node whose name has no '*' and
+ * starts with, but is longer than, the num_words words of vline from first
+ * on.  Stops at and returns the first non-zero return value of cb.  Used
+ * by GET_BULK to expand a variable ending in '*', without looking at the
+ * commands outside of that prefix. */
+int ctrl_cmd_for_each_fixed(vector node, vector vline, unsigned int first, unsigned int num_words,
+			    int (*cb)(struct ctrl_cmd_element *cmd_el, void *data), void *data)
+{
+	struct ctrl_cmd_trie *t = ctrl_cmd_trie_find(node, "");
+	struct ctrl_cmd_trie *child;
+	struct ctrl_cmd_element *cmd_el;
+	struct ctrl_cmd_struct *desc;
+	unsigned int i, j;
+	int rc;
+
+	if (t && t->num_slots == vector_active(node)) {
+		for (i = 0; t && i < num_words; i++)
+			t = ctrl_cmd_trie_find(t, vector_slot(vline, first + i));
+		if (!t)
+			return 0;
+		llist_for_each_entry(child, &t->children, sibling) {
+			rc = ctrl_cmd_trie_for_each(child, cb, data);
+			if (rc)
+				return rc;
+		}
+		return 0;
+	}
+
+	/* no complete trie: scan all commands, in install order */
+	for (i = 0; i < vector_active(node); i++) {
+		cmd_el = vector_slot(node, i);
+		if (!cmd_el)
+			continue;
+		desc = &cmd_el->strcmd;
+		if (desc->nr_commands <= num_words)
+			continue;
+		for (j = 0; j < desc->nr_commands; j++) {
+			if (j < num_words && strcmp(desc->command[j], vector_slot(vline, first + j)))
+				break;
+			if (strchr(desc->command[j], '*'))
+				break;
+		}
+		if (j < desc->nr_commands)
+			continue;
+		rc = cb(cmd_el, data);
+		if (rc)
+			return rc;
+	}
+	return 0;
+}
+
 /*! Execute a given received command
  *  \param[in] vline vector representing the available/registered commands
  *  \param[inout] command parsed received command to be executed
@@ -213,6 +439,7 @@ failure:
 int ctrl_cmd_install(enum ctrl_node_type node, struct ctrl_cmd_element *cmd)
 {
 	vector cmds_vec;
+	unsigned int idx;
 
 	cmds_vec = vector_lookup_ensure(ctrl_node_vec, node);
 
@@ -225,9 +452,10 @@ int ctrl_cmd_install(enum ctrl_node_type node, struct ctrl_cmd_element *cmd)
 		vector_set_index(ctrl_node_vec, node, cmds_vec);
 	}
 
-	vector_set(cmds_vec, cmd);
+	idx = vector_set(cmds_vec, cmd);
 
 	create_cmd_struct(&cmd->strcmd, cmd->name);
+	ctrl_cmd_trie_add(cmds_vec, idx, cmd);
 	return 0;
 }
 
@@ -325,6 +553,43 @@ struct ctrl_cmd *ctrl_cmd_parse2(void *ctx, struct msgb *msg)
 	return ctrl_cmd_parse3(ctx, msg, &unused);
 }
 
+/* Validate the space-separated variables of a GET_BULK, each of which may
+ * end in a '*' component to request all variables below a node */
+static bool bulk_vars_valid(char *vars)
+{
+	char *var, *end, *last;
+	bool valid;
+	char c;
+
+	for (var = vars; *var; var = end) {
+		if (*var == ' ') {
+			end = var + 1;
+			continue;
+		}
+		end = var + strcspn(var, " ");
+		c = *end;
+		*end = '\0';
+
+		last = strrchr(var, '.');
+		last = last ? last + 1 : var;
+		if (!strcmp(last, "*")) {
+			if (last == var)
+				valid = true;
+			else {
+				last[-1] = '\0';
+				valid = osmo_separated_identifiers_valid(var, ".");
+				last[-1] = '.';
+			}
+		} else
+			valid = osmo_separated_identifiers_valid(var, ".");
+
+		*end = c;
+		if (!valid)
+			return false;
+	}
+	return true;
+}
+
 /*! Parse/Decode CTRL from \ref msgb into command struct.
  *  \param[in] ctx talloc context from which to allocate
  *  \param[in] msg message buffer containing command to be decoded
@@ -420,6 +685,51 @@ struct ctrl_cmd *ctrl_cmd_parse3(void *ctx, struct msgb *msg, bool *parse_failed
 			}
 			LOGP(DLCTRL, LOGL_DEBUG, "Command: GET %s\n", cmd->variable);
 			break;
+		case CTRL_TYPE_GET_BULK:
+			var = strtok_r(NULL, "\n", &saveptr);
+			if (!var || !var[strspn(var, " ")]) {
+				cmd->type = CTRL_TYPE_ERROR;
+				cmd->reply = "GET_BULK incomplete";
+				LOGP(DLCTRL, LOGL_NOTICE, "GET_BULK Command incomplete: \"%s\"\n",
+				     osmo_escape_str(str, -1));
+				goto err;
+			}
+			if (!bulk_vars_valid(var)) {
+				cmd->type = CTRL_TYPE_ERROR;
+				cmd->reply = "GET_BULK variable contains invalid characters";
+				LOGP(DLCTRL, LOGL_NOTICE, "GET_BULK variable contains invalid characters: \"%s\"\n",
+				     osmo_escape_str(var, -1));
+				goto err;
+			}
+			cmd->variable = talloc_strdup(cmd, var);
+			if (!cmd->variable)
+				goto oom;
+			var = strtok_r(NULL, "", &saveptr);
+			if (var) {
+				cmd->type = CTRL_TYPE_ERROR;
+				cmd->reply = "GET_BULK with trailing characters";
+				LOGP(DLCTRL, LOGL_NOTICE, "GET_BULK with trailing characters: \"%s\"\n",
+				     osmo_escape_str(var, -1));
+				goto err;
+			}
+			LOGP(DLCTRL, LOGL_DEBUG, "Command: GET_BULK %s\n", cmd->variable);
+			break;
+		case CTRL_TYPE_GET_BULK_REPLY:
+			var = strtok_r(NULL, " \n", &saveptr);
+			val = strtok_r(NULL, "", &saveptr);
+			if (!var || (strcmp(var, "more") && strcmp(var, "last"))) {
+				cmd->type = CTRL_TYPE_ERROR;
+				cmd->reply = "GET_BULK_REPLY incomplete";
+				LOGP(DLCTRL, LOGL_NOTICE, "GET_BULK_REPLY incomplete\n");
+				goto err;
+			}
+			cmd->variable = talloc_strdup(cmd, var);
+			cmd->reply = talloc_strdup(cmd, val ? val : "");
+			if (!cmd->variable || !cmd->reply)
+				goto oom;
+			LOGP(DLCTRL, LOGL_DEBUG, "Command: GET_BULK_REPLY (%s): %s\n", cmd->variable,
+			     osmo_escape_str(cmd->reply, -1));
+			break;
 		case CTRL_TYPE_SET:
 			var = strtok_r(NULL, " ", &saveptr);
 			val = strtok_r(NULL, "\n", &saveptr);
@@ -531,6 +841,7 @@ struct msgb *ctrl_cmd_make(struct ctrl_cmd *cmd)
 
 	switch (cmd->type) {
 	case CTRL_TYPE_GET:
+	case CTRL_TYPE_GET_BULK:
 		if (!cmd->variable)
 			goto err;
 
@@ -572,6 +883,21 @@ struct msgb *ctrl_cmd_make(struct ctrl_cmd *cmd)
 			goto err;
 		}
 
+		msg->l2h = msgb_put(msg, strlen(tmp));
+		memcpy(msg->l2h, tmp, strlen(tmp));
+		talloc_free(tmp);
+		break;
+	case CTRL_TYPE_GET_BULK_REPLY:
+		if (!cmd->variable || !cmd->reply)
+			goto err;
+
+		tmp = talloc_asprintf(cmd, "%s %s %s\n%s", type, cmd->id, cmd->variable,
+				cmd->reply);
+		if (!tmp) {
+			LOGP(DLCTRL, LOGL_ERROR, "Failed to allocate cmd.\n");
+			goto err;
+		}
+
 		msg->l2h = msgb_put(msg, strlen(tmp));
 		memcpy(msg->l2h, tmp, strlen(tmp));
 		talloc_free(tmp);
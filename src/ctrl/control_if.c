@@ -53,6 +53,7 @@
 
 #include <osmocom/core/msgb.h>
 #include <osmocom/core/rate_ctr.h>
+#include <osmocom/core/stat_hist.h>
 #include <osmocom/core/select.h>
 #include <osmocom/core/counter.h>
 #include <osmocom/core/talloc.h>
@@ -65,6 +66,8 @@
 #include <osmocom/vty/vector.h>
 
 extern int osmo_fsm_ctrl_cmds_install(void);
+extern int ctrl_cmd_for_each_fixed(vector node, vector vline, unsigned int first, unsigned int num_words,
+				   int (*cb)(struct ctrl_cmd_element *cmd_el, void *data), void *data);
 
 vector ctrl_node_vec;
 
@@ -211,13 +214,95 @@ static void control_close_conn(struct ctrl_connection *ccon)
 	talloc_free(ccon);
 }
 
+/* Resolve the object addressed by the leading words of vline through the
+ * lookup helpers.  On success, returns 0 and sets *node, cmd->node and the
+ * index *first of the first word of the variable within that node;
+ * otherwise returns a negative value with cmd->reply set. */
+static int ctrl_cmd_lookup_node(struct ctrl_handle *ctrl, struct ctrl_cmd *cmd,
+				vector vline, void *data, int *node, int *first)
+{
+	int i;
+
+	*node = CTRL_NODE_ROOT;
+	cmd->node = data;
+
+	for (i = 0; i < vector_active(vline); i++) {
+		struct lookup_helper *lh;
+		int rc;
+
+		if (ctrl->lookup)
+			rc = ctrl->lookup(data, vline, node, &cmd->node, &i);
+		else
+			rc = 0;
+
+		if (!rc) {
+			llist_for_each_entry(lh, &ctrl_lookup_helpers, list) {
+				rc = lh->lookup(data, vline, node, &cmd->node, &i);
+				if (rc)
+					break;
+			}
+		}
+
+		switch (rc) {
+		case 1: /* do nothing */
+			break;
+		case -ENODEV:
+			cmd->reply = "Error while resolving object";
+			return rc;
+		case -ERANGE:
+			cmd->reply = "Error while parsing the index.";
+			return rc;
+		default: /* If we're here the rest must be the command */
+			*first = i;
+			return 0;
+		}
+
+		if (i+1 == vector_active(vline))
+			cmd->reply = "Command not present.";
+	}
+
+	return -ENOENT;
+}
+
+/* Execute the command in vline, with all words up to the command resolved
+ * to a node by ctrl_cmd_lookup_node() */
+static int ctrl_cmd_exec_vline(struct ctrl_cmd *cmd, vector vline, int node, int first, void *data)
+{
+	/* the words of the command, without copying them */
+	struct _vector cmdvec = {
+		.active = vector_active(vline) - first,
+		.alloced = vector_active(vline) - first,
+		.index = &vline->index[first],
+	};
+	vector cmds_vec;
+
+	/* Get the command vector of the right node */
+	cmds_vec = vector_lookup(ctrl_node_vec, node);
+	if (!cmds_vec) {
+		cmd->reply = "Command not found.";
+		return CTRL_CMD_ERROR;
+	}
+
+	return ctrl_cmd_exec(&cmdvec, cmd, cmds_vec, data);
+}
+
+static int ctrl_cmd_handle_bulk(struct ctrl_handle *ctrl, struct ctrl_cmd *cmd, void *data,
+				struct ctrl_connection *ccon);
+
+/*! Handle a received and parsed CTRL command.
+ *  \param[in] ctrl CTRL interface handle
+ *  \param[inout] cmd parsed command; the reply is stored in it
+ *  \param[in] data opaque data passed to the lookup helpers and commands
+ *  \returns CTRL_CMD_HANDLED or CTRL_CMD_REPLY;  CTRL_CMD_ERROR on error
+ *
+ *  A GET_BULK is answered with a single GET_BULK_REPLY in \a cmd; see
+ *  \ref ctrl_handle_msg for how it is answered on a CTRL connection. */
 int ctrl_cmd_handle(struct ctrl_handle *ctrl, struct ctrl_cmd *cmd,
 		    void *data)
 {
 	char *request;
-	int i, j, ret, node;
-	bool break_cycle = false;
-	vector vline, cmdvec, cmds_vec;
+	int i, ret, node, first;
+	vector vline;
 
 	if (cmd->type == CTRL_TYPE_SET_REPLY ||
 	    cmd->type == CTRL_TYPE_GET_REPLY) {
@@ -236,10 +321,17 @@ int ctrl_cmd_handle(struct ctrl_handle *ctrl, struct ctrl_cmd *cmd,
 			return CTRL_CMD_HANDLED;
 	}
 
+	if (cmd->type == CTRL_TYPE_GET_BULK_REPLY) {
+		LOGP(DLCTRL, LOGL_DEBUG, "%s <%s> ignored\n",
+		     get_value_string(ctrl_type_vals, cmd->type), cmd->id);
+		return CTRL_CMD_HANDLED;
+	}
+
+	if (cmd->type == CTRL_TYPE_GET_BULK)
+		return ctrl_cmd_handle_bulk(ctrl, cmd, data, NULL);
+
 	ret = CTRL_CMD_ERROR;
 	cmd->reply = NULL;
-	node = CTRL_NODE_ROOT;
-	cmd->node = data;
 
 	request = talloc_strdup(cmd, cmd->variable);
 	if (!request)
@@ -257,63 +349,8 @@ int ctrl_cmd_handle(struct ctrl_handle *ctrl, struct ctrl_cmd *cmd,
 		goto err;
 	}
 
-	for (i = 0; i < vector_active(vline); i++) {
-		struct lookup_helper *lh;
-		int rc;
-
-		if (ctrl->lookup)
-			rc = ctrl->lookup(data, vline, &node, &cmd->node, &i);
-		else
-			rc = 0;
-
-		if (!rc) {
-			llist_for_each_entry(lh, &ctrl_lookup_helpers, list) {
-				rc = lh->lookup(data, vline, &node, &cmd->node, &i);
-				if (rc)
-					break;
-			}
-		}
-
-		switch (rc) {
-		case 1: /* do nothing */
-			break;
-		case -ENODEV:
-			cmd_free_strvec(vline);
-			cmd->type = CTRL_TYPE_ERROR;
-			cmd->reply = "Error while resolving object";
-			return ret;
-		case -ERANGE:
-			cmd_free_strvec(vline);
-			cmd->type = CTRL_TYPE_ERROR;
-			cmd->reply = "Error while parsing the index.";
-			return ret;
-		default: /* If we're here the rest must be the command */
-			cmdvec = vector_init(vector_active(vline)-i);
-			for (j = i; j < vector_active(vline); j++) {
-				vector_set(cmdvec, vector_slot(vline, j));
-			}
-
-			/* Get the command vector of the right node */
-			cmds_vec = vector_lookup(ctrl_node_vec, node);
-
-			if (!cmds_vec) {
-				cmd->reply = "Command not found.";
-				vector_free(cmdvec);
-				break;
-			}
-
-			ret = ctrl_cmd_exec(cmdvec, cmd, cmds_vec, data);
-			vector_free(cmdvec);
-			break_cycle = true;
-			break;
-		}
-
-		if (break_cycle)
-			break;
-
-		if (i+1 == vector_active(vline))
-			cmd->reply = "Command not present.";
-	}
+	if (ctrl_cmd_lookup_node(ctrl, cmd, vline, data, &node, &first) == 0)
+		ret = ctrl_cmd_exec_vline(cmd, vline, node, first, data);
 
 	cmd_free_strvec(vline);
 
@@ -339,6 +376,363 @@ err:
 	return ret;
 }
 
+/* Maximum length of the text of one GET_BULK_REPLY message; longer replies
+ * are split into several messages */
+#define CTRL_BULK_MSG_LEN	16384
+
+/*! State of a GET_BULK being answered */
+struct ctrl_bulk {
+	struct ctrl_handle *ctrl;
+	void *data;
+	/*! the GET_BULK */
+	struct ctrl_cmd *bulk;
+	/*! GET run for each variable; its children are freed after each one */
+	struct ctrl_cmd *get;
+	/*! words of the variable being resolved, pointing into words */
+	vector vline;
+	/*! scratch buffers for the words and the name of an expanded variable */
+	char *words, *name;
+	size_t words_size, name_size;
+	/*! connection on which to stream the reply; NULL to collect it in bulk->reply */
+	struct ctrl_connection *ccon;
+	/*! reply message being filled, if streaming */
+	struct msgb *msg;
+	/*! offset of the "more"/"last" flag in msg */
+	unsigned int flag_offs;
+	/*! length and buffer size of bulk->reply, if collecting */
+	size_t reply_len, reply_size;
+};
+
+/* length of a value escaped by ctrl_bulk_escape() */
+static size_t ctrl_bulk_escaped_len(const char *val)
+{
+	size_t len = 0;
+
+	for (; *val; val++)
+		len += (*val == '\\' || *val == '\n') ? 2 : 1;
+	return len;
+}
+
+/* copy a value to dst, escaping backslashes and line breaks; returns the end */
+static char *ctrl_bulk_escape(char *dst, const char *val)
+{
+	for (; *val; val++) {
+		switch (*val) {
+		case '\\':
+			*dst++ = '\\';
+			*dst++ = '\\';
+			break;
+		case '\n':
+			*dst++ = '\\';
+			*dst++ = 'n';
+			break;
+		default:
+			*dst++ = *val;
+		}
+	}
+	return dst;
+}
+
+/* make sure the buffer *buf of size *buf_size holds at least len bytes */
+static int ctrl_bulk_reserve(struct ctrl_bulk *b, char **buf, size_t *buf_size, size_t len)
+{
+	char *tmp;
+
+	if (*buf_size >= len)
+		return 0;
+	if (len < 2 * *buf_size)
+		len = 2 * *buf_size;
+	tmp = talloc_realloc_size(b->bulk, *buf, len);
+	if (!tmp)
+		return -ENOMEM;
+	*buf = tmp;
+	*buf_size = len;
+	return 0;
+}
+
+/* start a new reply message, initially flagged as the last one */
+static int ctrl_bulk_msg_start(struct ctrl_bulk *b)
+{
+	b->msg = msgb_alloc_headroom(CTRL_BULK_MSG_LEN + 128, 128, "ctrl bulk reply");
+	if (!b->msg)
+		return -ENOMEM;
+	b->msg->l2h = b->msg->data;
+	if (msgb_printf(b->msg, "%s %s last\n",
+			get_value_string(ctrl_type_vals, CTRL_TYPE_GET_BULK_REPLY), b->bulk->id)) {
+		msgb_free(b->msg);
+		b->msg = NULL;
+		return -EMSGSIZE;
+	}
+	b->flag_offs = msgb_l2len(b->msg) - 5;
+	return 0;
+}
+
+/* enqueue the reply message being filled; more tells whether another follows */
+static int ctrl_bulk_msg_send(struct ctrl_bulk *b, bool more)
+{
+	struct msgb *msg = b->msg;
+	int rc;
+
+	b->msg = NULL;
+	if (more)
+		memcpy(msg->l2h + b->flag_offs, "more", 4);
+
+	ipa_prepend_header_ext(msg, IPAC_PROTO_EXT_CTRL);
+	ipa_prepend_header(msg, IPAC_PROTO_OSMO);
+
+	rc = osmo_wqueue_enqueue(&b->ccon->write_queue, msg);
+	if (rc != 0) {
+		LOGP(DLCTRL, LOGL_ERROR, "Failed to enqueue the GET_BULK reply.\n");
+		msgb_free(msg);
+	}
+	return rc;
+}
+
+/* append the line "<var> <value>" resp. "!<var> <error>" to the reply */
+static int ctrl_bulk_put(struct ctrl_bulk *b, const char *var, bool ok, const char *val)
+{
+	size_t var_len = strlen(var);
+	size_t len = !ok + var_len + 1 + ctrl_bulk_escaped_len(val) + 1;
+	char *dst;
+	int rc;
+
+	if (!b->ccon) {
+		/* one more byte for the terminating NUL */
+		rc = ctrl_bulk_reserve(b, &b->bulk->reply, &b->reply_size, b->reply_len + len + 1);
+		if (rc)
+			return rc;
+		dst = b->bulk->reply + b->reply_len;
+		b->reply_len += len;
+	} else {
+		if (b->msg && msgb_tailroom(b->msg) < len) {
+			rc = ctrl_bulk_msg_send(b, true);
+			if (rc)
+				return rc;
+		}
+		if (!b->msg) {
+			rc = ctrl_bulk_msg_start(b);
+			if (rc)
+				return rc;
+		}
+		if (msgb_tailroom(b->msg) < len) {
+			/* doesn't fit into a message at all */
+			if (!ok)
+				return -EMSGSIZE;
+			return ctrl_bulk_put(b, var, false, "Reply too long");
+		}
+		dst = (char *)msgb_put(b->msg, len);
+	}
+
+	if (!ok)
+		*dst++ = '!';
+	memcpy(dst, var, var_len);
+	dst += var_len;
+	*dst++ = ' ';
+	dst = ctrl_bulk_escape(dst, val);
+	*dst++ = '\n';
+	if (!b->ccon)
+		*dst = '\0';
+	return 0;
+}
+
+/* append the result of running b->get to the reply, then clean up after it */
+static int ctrl_bulk_put_result(struct ctrl_bulk *b, const char *var, int ret)
+{
+	struct ctrl_cmd *get = b->get;
+	int rc;
+
+	switch (ret) {
+	case CTRL_CMD_REPLY:
+		rc = ctrl_bulk_put(b, var, true, get->reply ? get->reply : "");
+		break;
+	case CTRL_CMD_HANDLED:
+		rc = ctrl_bulk_put(b, var, false, "Deferred reply not supported by GET_BULK");
+		break;
+	default:
+		rc = ctrl_bulk_put(b, var, false, get->reply ? get->reply : "An error has occurred.");
+		break;
+	}
+
+	/* drop everything the command allocated for its reply */
+	talloc_free_children(get);
+	get->reply = NULL;
+	return rc;
+}
+
+/* state of ctrl_bulk_expand() for ctrl_bulk_expand_cmd() */
+struct ctrl_bulk_expand {
+	struct ctrl_bulk *b;
+	/* the variable ending in '*' */
+	const char *var;
+	/* number of words of the command names before the '*' */
+	unsigned int num_words;
+	void *node_data;
+	unsigned int found;
+};
+
+/* GET the variable named by a command found by ctrl_bulk_expand() */
+static int ctrl_bulk_expand_cmd(struct ctrl_cmd_element *cmd_el, void *data)
+{
+	struct ctrl_bulk_expand *e = data;
+	struct ctrl_bulk *b = e->b;
+	struct ctrl_cmd_struct *desc = &cmd_el->strcmd;
+	size_t prefix_len = strlen(e->var) - 1;
+	size_t len = prefix_len + 1;
+	unsigned int j;
+	char *dst;
+	int ret, rc;
+
+	if (!cmd_el->get)
+		return 0;
+
+	for (j = e->num_words; j < desc->nr_commands; j++)
+		len += strlen(desc->command[j]) + 1;
+	rc = ctrl_bulk_reserve(b, &b->name, &b->name_size, len);
+	if (rc)
+		return rc;
+	memcpy(b->name, e->var, prefix_len);
+	dst = b->name + prefix_len;
+	for (j = e->num_words; j < desc->nr_commands; j++) {
+		if (j > e->num_words)
+			*dst++ = '.';
+		dst = stpcpy(dst, desc->command[j]);
+	}
+
+	b->get->type = CTRL_TYPE_GET;
+	b->get->variable = b->name;
+	b->get->node = e->node_data;
+	ret = cmd_el->get(b->get, b->data);
+
+	/* the get() call-back of CTRL_CMD_DEFINE_WO() and
+	 * CTRL_CMD_DEFINE_WO_NOVRF() always fails like this */
+	if (ret == CTRL_CMD_ERROR && b->get->reply && !strcmp(b->get->reply, "Write Only attribute")) {
+		talloc_free_children(b->get);
+		b->get->reply = NULL;
+		return 0;
+	}
+
+	e->found++;
+	return ctrl_bulk_put_result(b, b->name, ret);
+}
+
+/* GET all readable variables of fixed name installed at node below the
+ * words of b->vline from first up to the final '*' */
+static int ctrl_bulk_expand(struct ctrl_bulk *b, const char *var, int node, int first)
+{
+	vector cmds_vec = vector_lookup(ctrl_node_vec, node);
+	struct ctrl_bulk_expand e = {
+		.b = b,
+		.var = var,
+		.num_words = vector_active(b->vline) - 1 - first,
+		.node_data = b->get->node,
+	};
+	int rc;
+
+	if (cmds_vec) {
+		rc = ctrl_cmd_for_each_fixed(cmds_vec, b->vline, first, e.num_words,
+					     ctrl_bulk_expand_cmd, &e);
+		if (rc)
+			return rc;
+	}
+
+	if (!e.found)
+		return ctrl_bulk_put(b, var, false, "Command not found");
+	return 0;
+}
+
+/* GET one variable of a GET_BULK, or all variables below it if it ends in '*' */
+static int ctrl_bulk_get(struct ctrl_bulk *b, char *var)
+{
+	size_t len = strlen(var);
+	int node, first, ret, rc;
+	unsigned int n = 0;
+	char *word;
+
+	/* split into words at the dots like ctrl_cmd_handle(), but in place */
+	rc = ctrl_bulk_reserve(b, &b->words, &b->words_size, len + 1);
+	if (rc)
+		return rc;
+	memcpy(b->words, var, len + 1);
+	for (word = b->words; word; ) {
+		vector_ensure(b->vline, n);
+		vector_slot(b->vline, n++) = word;
+		word = strchr(word, '.');
+		if (word)
+			*word++ = '\0';
+	}
+	b->vline->active = n;
+
+	b->get->type = CTRL_TYPE_GET;
+	b->get->variable = var;
+
+	if (ctrl_cmd_lookup_node(b->ctrl, b->get, b->vline, b->data, &node, &first))
+		ret = CTRL_CMD_ERROR;
+	else if (!strcmp(vector_slot(b->vline, n - 1), "*"))
+		return ctrl_bulk_expand(b, var, node, first);
+	else
+		ret = ctrl_cmd_exec_vline(b->get, b->vline, node, first, b->data);
+
+	return ctrl_bulk_put_result(b, var, ret);
+}
+
+/* Answer a GET_BULK.  If ccon is given, the reply is streamed to it in as
+ * many GET_BULK_REPLY messages as needed, and CTRL_CMD_HANDLED is returned;
+ * otherwise cmd is turned into a single GET_BULK_REPLY. */
+static int ctrl_cmd_handle_bulk(struct ctrl_handle *ctrl, struct ctrl_cmd *cmd, void *data,
+				struct ctrl_connection *ccon)
+{
+	struct ctrl_bulk b = {
+		.ctrl = ctrl,
+		.data = data,
+		.bulk = cmd,
+		.ccon = ccon,
+	};
+	char *var, *saveptr = NULL;
+	int rc = -ENOMEM;
+
+	cmd->reply = NULL;
+	b.get = ctrl_cmd_create(cmd, CTRL_TYPE_GET);
+	b.vline = vector_init(8);
+	if (!b.get || !b.vline)
+		goto out;
+	b.get->id = cmd->id;
+
+	rc = 0;
+	for (var = strtok_r(cmd->variable, " ", &saveptr); var && !rc;
+	     var = strtok_r(NULL, " ", &saveptr))
+		rc = ctrl_bulk_get(&b, var);
+
+	if (ccon && !rc) {
+		if (!b.msg)
+			rc = ctrl_bulk_msg_start(&b);
+		if (!rc)
+			rc = ctrl_bulk_msg_send(&b, false);
+	}
+
+out:
+	msgb_free(b.msg);
+	if (b.vline)
+		vector_free(b.vline);
+	talloc_free(b.get);
+	talloc_free(b.words);
+	talloc_free(b.name);
+
+	if (rc) {
+		LOGP(DLCTRL, LOGL_ERROR, "GET_BULK <%s> failed: %s\n", cmd->id, strerror(-rc));
+		cmd->type = CTRL_TYPE_ERROR;
+		cmd->reply = rc == -ENOMEM ? "OOM" : "GET_BULK failed";
+		return CTRL_CMD_ERROR;
+	}
+
+	if (ccon)
+		return CTRL_CMD_HANDLED;
+
+	cmd->type = CTRL_TYPE_GET_BULK_REPLY;
+	cmd->variable = "last";
+	if (!cmd->reply)
+		cmd->reply = "";
+	return CTRL_CMD_REPLY;
+}
 
 static int handle_control_read(struct osmo_fd * bfd)
 {
@@ -450,6 +844,13 @@ int ctrl_handle_msg(struct ctrl_handle *ctrl, struct ctrl_connection *ccon, stru
 		goto send_reply;
 
 	cmd->ccon = ccon;
+	if (cmd->type == CTRL_TYPE_GET_BULK) {
+		/* stream the reply rather than collecting all of it in cmd */
+		result = ctrl_cmd_handle_bulk(ctrl, cmd, ctrl->data, ccon);
+		if (result == CTRL_CMD_HANDLED)
+			goto just_free;
+		goto send_reply;
+	}
 	result = ctrl_cmd_handle(ctrl, cmd, ctrl->data);
 
 
@@ -681,6 +1082,9 @@ static int get_rate_ctr(struct ctrl_cmd *cmd, void *data)
 		goto err;
 	}
 
+	/* fold in per-thread increments, if any */
+	rate_ctr_group_aggregate(ctrg);
+
 	if (!strlen(saveptr)) {
 		talloc_free(dup);
 		return get_rate_ctr_group_idx(ctrg, intv, cmd);
@@ -718,6 +1122,133 @@ static int verify_rate_ctr(struct ctrl_cmd *cmd, const char *value, void *data)
 	return 0;
 }
 
+/* value of a histogram reported by "stat_hist.<field>..." */
+enum stat_hist_field {
+	STAT_HIST_F_COUNT,
+	STAT_HIST_F_MIN,
+	STAT_HIST_F_MAX,
+	STAT_HIST_F_P50,
+	STAT_HIST_F_P90,
+	STAT_HIST_F_P99,
+	STAT_HIST_F_P999,
+};
+
+static const struct value_string stat_hist_field_names[] = {
+	{ STAT_HIST_F_COUNT, "count" },
+	{ STAT_HIST_F_MIN, "min" },
+	{ STAT_HIST_F_MAX, "max" },
+	{ STAT_HIST_F_P50, "p50" },
+	{ STAT_HIST_F_P90, "p90" },
+	{ STAT_HIST_F_P99, "p99" },
+	{ STAT_HIST_F_P999, "p999" },
+	{ 0, NULL }
+};
+
+static uint64_t get_stat_hist_value(const struct osmo_stat_hist *hist, enum stat_hist_field field)
+{
+	struct osmo_stat_hist_summary sum;
+
+	osmo_stat_hist_get_summary(hist, &sum);
+	switch (field) {
+	case STAT_HIST_F_COUNT: return sum.count;
+	case STAT_HIST_F_MIN: return sum.min;
+	case STAT_HIST_F_MAX: return sum.max;
+	case STAT_HIST_F_P50: return sum.p50;
+	case STAT_HIST_F_P90: return sum.p90;
+	case STAT_HIST_F_P99: return sum.p99;
+	case STAT_HIST_F_P999: return sum.p999;
+	}
+	return 0;
+}
+
+/* stat_hist.<field>.<group>.<idx>[.<name>] */
+CTRL_CMD_DEFINE(stat_hist, "stat_hist *");
+static int get_stat_hist(struct ctrl_cmd *cmd, void *data)
+{
+	int field;
+	unsigned int i;
+	char *hist_group, *hist_idx, *tmp, *dup, *saveptr, *field_name;
+	struct osmo_stat_hist_group *histg;
+	const struct osmo_stat_hist *hist;
+
+	dup = talloc_strdup(cmd, cmd->variable);
+	if (!dup)
+		goto oom;
+
+	/* Skip over possible prefixes (net.) */
+	tmp = strstr(dup, "stat_hist");
+	if (!tmp) {
+		talloc_free(dup);
+		cmd->reply = "stat_hist not a token in stat_hist command!";
+		goto err;
+	}
+
+	strtok_r(tmp, ".", &saveptr);
+	field_name = strtok_r(NULL, ".", &saveptr);
+	field = field_name ? get_string_value(stat_hist_field_names, field_name) : -EINVAL;
+	if (field < 0) {
+		talloc_free(dup);
+		cmd->reply = "Wrong field. Expecting 'count', 'min', 'max', 'p50', 'p90', 'p99' or 'p999'.";
+		goto err;
+	}
+
+	hist_group = strtok_r(NULL, ".", &saveptr);
+	hist_idx = strtok_r(NULL, ".", &saveptr);
+	if (!hist_group || !hist_idx) {
+		talloc_free(dup);
+		cmd->reply = "Histogram group must be of name.index form e. g. "
+			"lapd.0";
+		goto err;
+	}
+
+	histg = osmo_stat_hist_get_group_by_name_idx(hist_group, atoi(hist_idx));
+	if (!histg) {
+		talloc_free(dup);
+		cmd->reply = "Histogram group with given name and index not found";
+		goto err;
+	}
+
+	if (!strlen(saveptr)) {
+		talloc_free(dup);
+		cmd->reply = talloc_strdup(cmd, "");
+		for (i = 0; i < histg->desc->num_hists && cmd->reply; i++)
+			ctrl_cmd_reply_printf(cmd, "%s %"PRIu64";", histg->desc->hist_desc[i].name,
+					      get_stat_hist_value(&histg->hist[i], field));
+		if (!cmd->reply)
+			goto oom;
+		return CTRL_CMD_REPLY;
+	}
+
+	hist = osmo_stat_hist_get_by_name(histg, saveptr);
+	talloc_free(dup);
+	if (!hist) {
+		cmd->reply = "Histogram name not found.";
+		goto err;
+	}
+
+	cmd->reply = talloc_asprintf(cmd, "%"PRIu64, get_stat_hist_value(hist, field));
+	if (!cmd->reply)
+		goto oom;
+
+	return CTRL_CMD_REPLY;
+oom:
+	cmd->reply = "OOM";
+err:
+	return CTRL_CMD_ERROR;
+}
+
+static int set_stat_hist(struct ctrl_cmd *cmd, void *data)
+{
+	cmd->reply = "Can't set histogram.";
+
+	return CTRL_CMD_ERROR;
+}
+
+static int verify_stat_hist(struct ctrl_cmd *cmd, const char *value, void *data)
+{
+	return 0;
+}
+
 /* counter */
 CTRL_CMD_DEFINE(counter, "counter *");
 static int get_counter(struct ctrl_cmd *cmd, void *data)
@@ -806,6 +1337,9 @@ static int ctrl_init(unsigned int node_count)
 	if (ret)
 		goto err_vec;
 	ret = ctrl_cmd_install(CTRL_NODE_ROOT, &cmd_counter);
+	if (ret)
+		goto err_vec;
+	ret = ctrl_cmd_install(CTRL_NODE_ROOT, &cmd_stat_hist);
 	if (ret)
 		goto err_vec;
 
@@ -27,10 +27,13 @@
 #include <inttypes.h>
 
 #include <osmocom/core/fsm.h>
+#include <osmocom/core/hashtable.h>
 #include <osmocom/core/talloc.h>
 #include <osmocom/core/logging.h>
 #include <osmocom/core/utils.h>
 
+#include "hash_internal.h"
+
 /*! \addtogroup fsm
  *  @{
  *  Finite State Machine abstraction
@@ -86,9 +89,71 @@
  *  In order to attach private state to the \ref osmo_fsm_inst, it
  *  offers an opaque private pointer.
  *
+ *  FSMs are found by name (\ref osmo_fsm_find_by_name) and instances by
+ *  id or name (\ref osmo_fsm_inst_find_by_id, \ref
+ *  osmo_fsm_inst_find_by_name) through hash tables maintained on
+ *  registration, allocation, id change and release, so the lookups don't
+ *  depend on the number of FSMs and instances in the process.
+ *
+ *  Ids and names of instances are kept in buffers allocated along with
+ *  the instance, so allocating an instance and changing its id don't
+ *  cost further allocations unless the id or name is unusually long.
+ *  FSMs with a high rate of allocations, e.g. one instance per call, can
+ *  additionally keep released instances for reuse, see \ref
+ *  osmo_fsm_set_inst_pool.
+ *
  * \file fsm.c */
 
 LLIST_HEAD(osmo_g_fsms);
+/* started struct osmo_fsm_inst_cursor */
+static LLIST_HEAD(fsm_inst_cursors);
+
+/* struct osmo_fsm_reg by hash of the FSM name */
+static DEFINE_HASHTABLE(fsms_by_name, 6);
+
+static uint32_t fsm_inst_id_key(const struct hlist_node *node);
+static uint32_t fsm_inst_name_key(const struct hlist_node *node);
+
+/* all FSM instances with an id, by hash of FSM and id */
+static struct osmo_hashtable fsm_insts_by_id = OSMO_HASHTABLE_INIT(fsm_insts_by_id, fsm_inst_id_key);
+/* all FSM instances, by hash of FSM and name */
+static struct osmo_hashtable fsm_insts_by_name = OSMO_HASHTABLE_INIT(fsm_insts_by_name, fsm_inst_name_key);
+
+/* number of FSMs with an instance pool, see osmo_fsm_set_inst_pool() */
+static unsigned int fsm_num_pools;
+
+/*! Library-private state of a registered FSM.  Kept apart from struct
+ *  osmo_fsm, which applications define statically. */
+struct osmo_fsm_reg {
+	/*! entry in fsms_by_name */
+	struct hlist_node node;
+	/*! the registered FSM */
+	struct osmo_fsm *fsm;
+	/*! released instances kept for reuse, linked via their list member */
+	struct llist_head pool;
+	/*! number of instances in pool */
+	unsigned int pool_len;
+	/*! maximum number of instances in pool, 0 if pooling is disabled */
+	unsigned int pool_max;
+};
+
+#define FSM_INST_ID_LEN		32
+#define FSM_INST_NAME_LEN	96
+
+/*! Memory of an FSM instance: the public part, followed by buffers for
+ *  the usual lengths of its id and name. */
+struct fsm_inst_mem {
+	struct osmo_fsm_inst fi;
+	/*! FSM to return the instance to on release, NULL if not pooled */
+	struct osmo_fsm_reg *reg;
+	char id[FSM_INST_ID_LEN];
+	char name[FSM_INST_NAME_LEN];
+};
+
+static inline struct fsm_inst_mem *fsm_inst_mem(struct osmo_fsm_inst *fi)
+{
+	return container_of(fi, struct fsm_inst_mem, fi);
+}
 static bool fsm_log_addr = true;
 static bool fsm_log_timeouts = false;
 /*! See osmo_fsm_term_safely(). */
@@ -237,16 +302,69 @@ static void osmo_fsm_defer_free(void *talloc_object)
 	talloc_steal(fsm_term_safely.collect_ctx, talloc_object);
 }
 
-struct osmo_fsm *osmo_fsm_find_by_name(const char *name)
+/* key of an FSM instance in fsm_insts_by_id and fsm_insts_by_name */
+static inline uint32_t fsm_inst_key(const struct osmo_fsm *fsm, const char *str)
 {
-	struct osmo_fsm *fsm;
-	llist_for_each_entry(fsm, &osmo_g_fsms, list) {
-		if (!strcmp(name, fsm->name))
-			return fsm;
+	return hash_ptr(fsm, 32) ^ osmo_fnv1a(str);
+}
+
+static uint32_t fsm_inst_id_key(const struct hlist_node *node)
+{
+	const struct osmo_fsm_inst *fi = hlist_entry(node, struct osmo_fsm_inst, id_node);
+
+	return fsm_inst_key(fi->fsm, fi->id);
+}
+
+static uint32_t fsm_inst_name_key(const struct hlist_node *node)
+{
+	const struct osmo_fsm_inst *fi = hlist_entry(node, struct osmo_fsm_inst, name_node);
+
+	return fsm_inst_key(fi->fsm, fi->name);
+}
+
+static struct osmo_fsm_reg *fsm_reg_find(const char *name)
+{
+	struct osmo_fsm_reg *reg;
+
+	hash_for_each_possible(fsms_by_name, reg, node, osmo_fnv1a(name)) {
+		if (!strcmp(name, reg->fsm->name))
+			return reg;
 	}
 	return NULL;
 }
 
+/* add an FSM instance to the hash tables, after its id and name were set */
+static void fsm_inst_hash(struct osmo_fsm_inst *fi)
+{
+	if (fi->id)
+		osmo_hashtable_add(&fsm_insts_by_id, &fi->id_node, fsm_inst_key(fi->fsm, fi->id));
+	if (fi->name)
+		osmo_hashtable_add(&fsm_insts_by_name, &fi->name_node, fsm_inst_key(fi->fsm, fi->name));
+}
+
+/* remove an FSM instance from the hash tables */
+static void fsm_inst_unhash(struct osmo_fsm_inst *fi)
+{
+	osmo_hashtable_del(&fsm_insts_by_id, &fi->id_node);
+	osmo_hashtable_del(&fsm_insts_by_name, &fi->name_node);
+}
+
+/*! find a registered FSM by its name
+ *  \param[in] name name of the FSM
+ *  \returns FSM descriptor; NULL if no FSM of that name is registered */
+struct osmo_fsm *osmo_fsm_find_by_name(const char *name)
+{
+	struct osmo_fsm_reg *reg = fsm_reg_find(name);
+
+	return reg ? reg->fsm : NULL;
+}
+
+/*! find an instance of an FSM by its name
+ *  If several instances have the same name, the one most recently
+ *  allocated or renamed is returned.
+ *  \param[in] fsm FSM descriptor of the instance
+ *  \param[in] name name of the instance, as in \ref osmo_fsm_inst.name
+ *  \returns FSM instance; NULL if not found */
 struct osmo_fsm_inst *osmo_fsm_inst_find_by_name(const struct osmo_fsm *fsm,
 						 const char *name)
 {
@@ -255,27 +373,83 @@ struct osmo_fsm_inst *osmo_fsm_inst_find_by_name(const struct osmo_fsm *fsm,
 	if (!name)
 		return NULL;
 
-	llist_for_each_entry(fi, &fsm->instances, list) {
-		if (!fi->name)
-			continue;
-		if (!strcmp(name, fi->name))
+	hlist_for_each_entry(fi, osmo_hashtable_bucket(&fsm_insts_by_name, fsm_inst_key(fsm, name)), name_node) {
+		if (fi->fsm == fsm && !strcmp(name, fi->name))
 			return fi;
 	}
 	return NULL;
 }
 
+/*! find an instance of an FSM by its id
+ *  If several instances have the same id, the one most recently
+ *  allocated or given that id is returned.
+ *  \param[in] fsm FSM descriptor of the instance
+ *  \param[in] id id of the instance
+ *  \returns FSM instance; NULL if not found */
 struct osmo_fsm_inst *osmo_fsm_inst_find_by_id(const struct osmo_fsm *fsm,
 						const char *id)
 {
 	struct osmo_fsm_inst *fi;
 
-	llist_for_each_entry(fi, &fsm->instances, list) {
-		if (!strcmp(id, fi->id))
+	if (!id)
+		return NULL;
+
+	hlist_for_each_entry(fi, osmo_hashtable_bucket(&fsm_insts_by_id, fsm_inst_key(fsm, id)), id_node) {
+		if (fi->fsm == fsm && !strcmp(id, fi->id))
 			return fi;
 	}
 	return NULL;
 }
 
+/* move a cursor to the first instance of the FSM at list entry fsm_entry */
+static void fsm_inst_cursor_set_fsm(struct osmo_fsm_inst_cursor *cur, struct llist_head *fsm_entry)
+{
+	cur->fsm = fsm_entry;
+	if (fsm_entry != &osmo_g_fsms)
+		cur->next = llist_entry(fsm_entry, struct osmo_fsm, list)->instances.next;
+	else
+		cur->next = NULL;
+}
+
+/*! Start walking the instances of all registered FSMs
+ *  \param[out] cur cursor to initialize
+ *
+ *  Unlike iterating over the instance lists, the walk may be interrupted
+ *  and continued later at no cost.  Instances freed meanwhile are
+ *  skipped, instances allocated meanwhile may or may not be returned.
+ *  The cursor must be stopped with \ref osmo_fsm_inst_cursor_stop
+ *  before it is freed. */
+void osmo_fsm_inst_cursor_start(struct osmo_fsm_inst_cursor *cur)
+{
+	fsm_inst_cursor_set_fsm(cur, osmo_g_fsms.next);
+	llist_add(&cur->list, &fsm_inst_cursors);
+}
+
+/*! Get the next FSM instance of a walk
+ *  \param[in] cur cursor started with \ref osmo_fsm_inst_cursor_start
+ *  \returns next FSM instance; NULL after the last one */
+struct osmo_fsm_inst *osmo_fsm_inst_cursor_next(struct osmo_fsm_inst_cursor *cur)
+{
+	struct osmo_fsm_inst *fi;
+
+	while (cur->fsm != &osmo_g_fsms) {
+		if (cur->next != &llist_entry(cur->fsm, struct osmo_fsm, list)->instances) {
+			fi = llist_entry(cur->next, struct osmo_fsm_inst, list);
+			cur->next = cur->next->next;
+			return fi;
+		}
+		fsm_inst_cursor_set_fsm(cur, cur->fsm->next);
+	}
+	return NULL;
+}
+
+/*! Stop walking the instances of all registered FSMs
+ *  \param[in] cur cursor started with \ref osmo_fsm_inst_cursor_start */
+void osmo_fsm_inst_cursor_stop(struct osmo_fsm_inst_cursor *cur)
+{
+	llist_del(&cur->list);
+}
+
 /*! register a FSM with the core
  *
  *  A FSM descriptor needs to be registered with the core before any
@@ -286,6 +460,8 @@ struct osmo_fsm_inst *osmo_fsm_inst_find_by_id(const struct osmo_fsm *fsm,
  */
 int osmo_fsm_register(struct osmo_fsm *fsm)
 {
+	struct osmo_fsm_reg *reg;
+
 	if (!osmo_identifier_valid(fsm->name)) {
 		LOGP(DLGLOBAL, LOGL_ERROR, "Attempting to register FSM with illegal identifier '%s'\n", fsm->name);
 		return -EINVAL;
@@ -294,6 +470,12 @@ int osmo_fsm_register(struct osmo_fsm *fsm)
 		return -EEXIST;
 	if (fsm->event_names == NULL)
 		LOGP(DLGLOBAL, LOGL_ERROR, "FSM '%s' has no event names! Please fix!\n", fsm->name);
+	reg = talloc_zero(NULL, struct osmo_fsm_reg);
+	if (!reg)
+		return -ENOMEM;
+	reg->fsm = fsm;
+	INIT_LLIST_HEAD(&reg->pool);
+	hash_add(fsms_by_name, &reg->node, osmo_fnv1a(fsm->name));
 	llist_add_tail(&fsm->list, &osmo_g_fsms);
 	INIT_LLIST_HEAD(&fsm->instances);
 
@@ -309,9 +491,114 @@ int osmo_fsm_register(struct osmo_fsm *fsm)
  */
 void osmo_fsm_unregister(struct osmo_fsm *fsm)
 {
+	struct osmo_fsm_reg *reg = fsm_reg_find(fsm->name);
+	struct osmo_fsm_inst *fi;
+
+	if (reg && reg->fsm == fsm) {
+		/* remaining instances are freed instead of returned to the pool */
+		llist_for_each_entry(fi, &fsm->instances, list)
+			fsm_inst_mem(fi)->reg = NULL;
+		if (reg->pool_max)
+			fsm_num_pools--;
+		hash_del(&reg->node);
+		/* frees the pooled instances */
+		talloc_free(reg);
+	}
+	if (!llist_empty(&fsm_inst_cursors)) {
+		struct osmo_fsm_inst_cursor *cur;
+
+		llist_for_each_entry(cur, &fsm_inst_cursors, list) {
+			if (cur->fsm == &fsm->list)
+				fsm_inst_cursor_set_fsm(cur, fsm->list.next);
+		}
+	}
 	llist_del(&fsm->list);
 }
 
+/*! Keep released instances of an FSM for reuse by later allocations.
+ *
+ *  Instances released by osmo_fsm_inst_free() are kept, up to max_free
+ *  of them, and handed out again by osmo_fsm_inst_alloc() instead of
+ *  allocating new memory.  This saves allocations for FSMs with a high
+ *  rate of short-lived instances, e.g. one per call.  Talloc children of
+ *  an instance are freed on release, as before.  Instances of a pooled
+ *  FSM must not have a talloc destructor or reference of their own.
+ *
+ *  Instances are not pooled while a context for deferred deallocation
+ *  is set (see osmo_fsm_set_dealloc_ctx()), or while they are released
+ *  as part of an osmo_fsm_term_safely() cascade.
+ *
+ *  \param[in] fsm registered FSM
+ *  \param[in] max_free maximum number of released instances to keep; 0 to disable pooling
+ *  \returns 0 on success; -ENOENT if the FSM is not registered
+ */
+int osmo_fsm_set_inst_pool(struct osmo_fsm *fsm, unsigned int max_free)
+{
+	struct osmo_fsm_reg *reg = fsm_reg_find(fsm->name);
+	struct fsm_inst_mem *mem;
+
+	if (!reg || reg->fsm != fsm)
+		return -ENOENT;
+
+	if (!reg->pool_max && max_free)
+		fsm_num_pools++;
+	else if (reg->pool_max && !max_free)
+		fsm_num_pools--;
+	reg->pool_max = max_free;
+
+	while (reg->pool_len > max_free) {
+		mem = llist_first_entry(&reg->pool, struct fsm_inst_mem, fi.list);
+		llist_del(&mem->fi.list);
+		reg->pool_len--;
+		talloc_free(mem);
+	}
+	return 0;
+}
+
+/* allocate the memory of a new instance, from the pool of the FSM if it has one */
+static struct osmo_fsm_inst *fsm_inst_mem_alloc(struct osmo_fsm *fsm, void *ctx)
+{
+	struct osmo_fsm_reg *reg = NULL;
+	struct fsm_inst_mem *mem;
+
+	if (fsm_num_pools) {
+		reg = fsm_reg_find(fsm->name);
+		if (reg && (reg->fsm != fsm || !reg->pool_max))
+			reg = NULL;
+	}
+
+	if (reg && !llist_empty(&reg->pool)) {
+		mem = llist_first_entry(&reg->pool, struct fsm_inst_mem, fi.list);
+		llist_del(&mem->fi.list);
+		reg->pool_len--;
+		talloc_steal(ctx, mem);
+		memset(mem, 0, sizeof(*mem));
+	} else {
+		mem = talloc_zero_size(ctx, sizeof(*mem));
+		if (!mem)
+			return NULL;
+		talloc_set_name_const(mem, "struct osmo_fsm_inst");
+	}
+	mem->reg = reg;
+	return &mem->fi;
+}
+
+/* return a released instance to the pool of its FSM; false if it is to be freed instead */
+static bool fsm_inst_mem_pool(struct osmo_fsm_inst *fi)
+{
+	struct fsm_inst_mem *mem = fsm_inst_mem(fi);
+	struct osmo_fsm_reg *reg = mem->reg;
+
+	if (!reg || reg->pool_len >= reg->pool_max || fsm_term_safely.fsm_dealloc_ctx)
+		return false;
+
+	talloc_free_children(mem);
+	talloc_steal(reg, mem);
+	llist_add(&fi->list, &reg->pool);
+	reg->pool_len++;
+	return true;
+}
+
 /* small wrapper function around timer expiration (for logging) */
 static void fsm_tmr_cb(void *data)
 {
@@ -350,22 +637,40 @@ int osmo_fsm_inst_update_id(struct osmo_fsm_inst *fi, const char *id)
 		return osmo_fsm_inst_update_id_f(fi, "%s", id);
 }
 
-static void update_name(struct osmo_fsm_inst *fi)
+static int fsm_inst_name_fmt(char *buf, size_t len, const struct osmo_fsm_inst *fi)
 {
-	if (fi->name)
-		talloc_free((char*)fi->name);
-
 	if (!fsm_log_addr) {
 		if (fi->id)
-			fi->name = talloc_asprintf(fi, "%s(%s)", fi->fsm->name, fi->id);
+			return snprintf(buf, len, "%s(%s)", fi->fsm->name, fi->id);
 		else
-			fi->name = talloc_asprintf(fi, "%s", fi->fsm->name);
+			return snprintf(buf, len, "%s", fi->fsm->name);
 	} else {
 		if (fi->id)
-			fi->name = talloc_asprintf(fi, "%s(%s)[%p]", fi->fsm->name, fi->id, fi);
+			return snprintf(buf, len, "%s(%s)[%p]", fi->fsm->name, fi->id, fi);
 		else
-			fi->name = talloc_asprintf(fi, "%s[%p]", fi->fsm->name, fi);
+			return snprintf(buf, len, "%s[%p]", fi->fsm->name, fi);
+	}
+}
+
+static void update_name(struct osmo_fsm_inst *fi)
+{
+	struct fsm_inst_mem *mem = fsm_inst_mem(fi);
+	char *name;
+	int len;
+
+	if (fi->name != mem->name)
+		talloc_free((char*)fi->name);
+
+	len = fsm_inst_name_fmt(mem->name, sizeof(mem->name), fi);
+	if (len < sizeof(mem->name)) {
+		fi->name = mem->name;
+		return;
 	}
+
+	name = talloc_size(fi, len + 1);
+	if (name)
+		fsm_inst_name_fmt(name, len + 1, fi);
+	fi->name = name;
 }
 
 /*! Change id of the FSM instance using a string format.
@@ -376,29 +681,53 @@ static void update_name(struct osmo_fsm_inst *fi)
  */
 int osmo_fsm_inst_update_id_f(struct osmo_fsm_inst *fi, const char *fmt, ...)
 {
+	struct fsm_inst_mem *mem = fsm_inst_mem(fi);
+	char buf[FSM_INST_ID_LEN];
 	char *id = NULL;
+	const char *new_id = NULL;
+	bool hashed;
+	int len = 0;
 
 	if (fmt) {
 		va_list ap;
 
 		va_start(ap, fmt);
-		id = talloc_vasprintf(fi, fmt, ap);
+		len = vsnprintf(buf, sizeof(buf), fmt, ap);
 		va_end(ap);
 
-		if (!osmo_identifier_valid(id)) {
+		if (len >= 0 && len < sizeof(buf)) {
+			new_id = buf;
+		} else {
+			va_start(ap, fmt);
+			id = talloc_vasprintf(fi, fmt, ap);
+			va_end(ap);
+			new_id = id;
+		}
+
+		if (!osmo_identifier_valid(new_id)) {
 			LOGP(DLGLOBAL, LOGL_ERROR,
 			     "Attempting to set illegal id for FSM instance of type '%s': %s\n",
-			     fi->fsm->name, osmo_quote_str(id, -1));
+			     fi->fsm->name, osmo_quote_str(new_id, -1));
 			talloc_free(id);
 			return -EINVAL;
 		}
 	}
 
-	if (fi->id)
+	/* only instances already on fsm->instances are in the hash tables */
+	hashed = !hlist_unhashed(&fi->name_node);
+	fsm_inst_unhash(fi);
+
+	if (fi->id != mem->id)
 		talloc_free((char*)fi->id);
-	fi->id = id;
+	if (new_id == buf) {
+		memcpy(mem->id, buf, len + 1);
+		fi->id = mem->id;
+	} else
+		fi->id = id;
 
 	update_name(fi);
+	if (hashed)
+		fsm_inst_hash(fi);
 	return 0;
 }
 
@@ -442,7 +771,10 @@ int osmo_fsm_inst_update_id_f_sanitize(struct osmo_fsm_inst *fi, char replace_wi
 struct osmo_fsm_inst *osmo_fsm_inst_alloc(struct osmo_fsm *fsm, void *ctx, void *priv,
 					  int log_level, const char *id)
 {
-	struct osmo_fsm_inst *fi = talloc_zero(ctx, struct osmo_fsm_inst);
+	struct osmo_fsm_inst *fi = fsm_inst_mem_alloc(fsm, ctx);
+
+	if (!fi)
+		return NULL;
 
 	fi->fsm = fsm;
 	fi->priv = priv;
@@ -457,6 +789,7 @@ struct osmo_fsm_inst *osmo_fsm_inst_alloc(struct osmo_fsm *fsm, void *ctx, void
 	INIT_LLIST_HEAD(&fi->proc.children);
 	INIT_LLIST_HEAD(&fi->proc.child);
 	llist_add(&fi->list, &fsm->instances);
+	fsm_inst_hash(fi);
 
 	LOGPFSM(fi, "Allocated\n");
 
@@ -541,7 +874,16 @@ void osmo_fsm_inst_change_parent(struct osmo_fsm_inst *fi,
 void osmo_fsm_inst_free(struct osmo_fsm_inst *fi)
 {
 	osmo_timer_del(&fi->timer);
+	if (!llist_empty(&fsm_inst_cursors)) {
+		struct osmo_fsm_inst_cursor *cur;
+
+		llist_for_each_entry(cur, &fsm_inst_cursors, list) {
+			if (cur->next == &fi->list)
+				cur->next = fi->list.next;
+		}
+	}
 	llist_del(&fi->list);
+	fsm_inst_unhash(fi);
 
 	if (fsm_term_safely.depth) {
 		/* Another FSM instance has caused this one to free and is still busy with its termination. Don't free
@@ -571,7 +913,8 @@ void osmo_fsm_inst_free(struct osmo_fsm_inst *fi)
 		fsm_term_safely.collect_ctx = NULL;
 	} else {
 		LOGPFSM(fi, "Deallocated\n");
-		fsm_free_or_steal(fi);
+		if (!fsm_inst_mem_pool(fi))
+			fsm_free_or_steal(fi);
 	}
 	fsm_term_safely.root_fi = NULL;
 }
@@ -0,0 +1,180 @@
+/*! \file hash_internal.c
+ * Hash tables shared by the FSM, rate counter and stat item lookups. */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <osmocom/core/hash.h>
+#include <osmocom/core/hashtable.h>
+#include <osmocom/core/talloc.h>
+
+#include "hash_internal.h"
+
+/* move all objects of tbl into 2^bits buckets; keep the current buckets
+ * if allocating new ones fails, lookups just get slower then */
+static void osmo_hashtable_resize(struct osmo_hashtable *tbl, unsigned int bits)
+{
+	struct hlist_head *buckets, *old = tbl->buckets;
+	unsigned int i, old_size = 1U << tbl->bits;
+
+	if (bits == OSMO_HASHTABLE_MIN_BITS) {
+		buckets = tbl->min_buckets;
+		__hash_init(buckets, HASH_SIZE(tbl->min_buckets));
+	} else {
+		buckets = talloc_zero_array(NULL, struct hlist_head, 1U << bits);
+		if (!buckets)
+			return;
+	}
+
+	tbl->buckets = buckets;
+	tbl->bits = bits;
+	for (i = 0; i < old_size; i++) {
+		struct hlist_node *node = old[i].first, *rev = NULL, *next;
+
+		/* reverse the chain first, so that adding each object at the
+		 * head of its new bucket keeps the newest object first */
+		while (node) {
+			next = node->next;
+			node->next = rev;
+			rev = node;
+			node = next;
+		}
+		old[i].first = NULL;
+
+		while (rev) {
+			next = rev->next;
+			hlist_add_head(rev, osmo_hashtable_bucket(tbl, tbl->key(rev)));
+			rev = next;
+		}
+	}
+
+	if (old != tbl->min_buckets)
+		talloc_free(old);
+}
+
+/* add an object to tbl; key must be what tbl->key() returns for it */
+void osmo_hashtable_add(struct osmo_hashtable *tbl, struct hlist_node *node, uint32_t key)
+{
+	if (tbl->count >= (1U << tbl->bits) && tbl->bits < 31)
+		osmo_hashtable_resize(tbl, tbl->bits + 1);
+	hlist_add_head(node, osmo_hashtable_bucket(tbl, key));
+	tbl->count++;
+}
+
+/* remove an object from tbl; nothing happens if it is not in a table */
+void osmo_hashtable_del(struct osmo_hashtable *tbl, struct hlist_node *node)
+{
+	if (hlist_unhashed(node))
+		return;
+	hash_del(node);
+	tbl->count--;
+	if (tbl->bits > OSMO_HASHTABLE_MIN_BITS && tbl->count < (1U << tbl->bits) / 4)
+		osmo_hashtable_resize(tbl, tbl->bits - 1);
+}
+
+struct osmo_name_index {
+	/* entry in name_indexes */
+	struct hlist_node node;
+	/* the description array indexed */
+	const void *desc;
+	/* name of the first array entry, and distance between the names */
+	const char * const *first_name;
+	size_t stride;
+	/* number of users of this index */
+	unsigned int use_count;
+	/* number of slots minus one; the number of slots is a power of two */
+	unsigned int mask;
+	/* open addressing table of array index plus one; zero if unused */
+	unsigned int slot[0];
+};
+
+/* struct osmo_name_index by description */
+static DEFINE_HASHTABLE(name_indexes, 6);
+
+static inline const char *name_index_name(const struct osmo_name_index *ni, unsigned int i)
+{
+	return *(const char * const *)((const uint8_t *)ni->first_name + i * ni->stride);
+}
+
+/* Get the index of the names of the num entries of the array desc, which
+ * are stride bytes apart, starting at first_name.  Allocate it from ctx,
+ * unless it exists already.  Returns NULL if out of memory. */
+struct osmo_name_index *osmo_name_index_get(void *ctx, const void *desc, const char * const *first_name,
+					    size_t stride, unsigned int num)
+{
+	struct osmo_name_index *ni;
+	unsigned int size = 8;
+	unsigned int i, s;
+
+	hash_for_each_possible(name_indexes, ni, node, (unsigned long)desc) {
+		if (ni->desc == desc) {
+			ni->use_count++;
+			return ni;
+		}
+	}
+
+	/* keep the table at most half full */
+	while (size < 2 * num)
+		size *= 2;
+	ni = talloc_zero_size(ctx, sizeof(*ni) + size * sizeof(ni->slot[0]));
+	if (!ni)
+		return NULL;
+	ni->desc = desc;
+	ni->first_name = first_name;
+	ni->stride = stride;
+	ni->use_count = 1;
+	ni->mask = size - 1;
+
+	for (i = 0; i < num; i++) {
+		const char *name = name_index_name(ni, i);
+
+		for (s = osmo_fnv1a(name) & ni->mask; ni->slot[s]; s = (s + 1) & ni->mask) {
+			/* with duplicate names, the first entry is found */
+			if (!strcmp(name_index_name(ni, ni->slot[s] - 1), name))
+				break;
+		}
+		if (!ni->slot[s])
+			ni->slot[s] = i + 1;
+	}
+
+	hash_add(name_indexes, &ni->node, (unsigned long)desc);
+	return ni;
+}
+
+/* release a use of an index from osmo_name_index_get() */
+void osmo_name_index_put(struct osmo_name_index *ni)
+{
+	if (--ni->use_count)
+		return;
+	hash_del(&ni->node);
+	talloc_free(ni);
+}
+
+/* returns the array index of the first entry called name, or -1 */
+int osmo_name_index_find(const struct osmo_name_index *ni, const char *name)
+{
+	unsigned int s;
+
+	for (s = osmo_fnv1a(name) & ni->mask; ni->slot[s]; s = (s + 1) & ni->mask) {
+		if (!strcmp(name_index_name(ni, ni->slot[s] - 1), name))
+			return ni->slot[s] - 1;
+	}
+	return -1;
+}
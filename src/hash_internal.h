@@ -0,0 +1,73 @@
+/*! \file hash_internal.h
+ * Hash tables shared by the FSM, rate counter and stat item lookups. */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <osmocom/core/linuxlist.h>
+#include <osmocom/core/hashtable.h>
+
+/* log2 of the number of buckets a growable hash table starts with */
+#define OSMO_HASHTABLE_MIN_BITS	6
+
+/* A hash table of hlist buckets like DEFINE_HASHTABLE(), which doubles
+ * its number of buckets when it holds more objects than buckets, and
+ * halves it when it holds less than a quarter of that.  Lookups iterate
+ * over the bucket of a key with hlist_for_each_entry() and compare the
+ * full key themselves.  Objects with the same key are found newest
+ * first, also after a resize. */
+struct osmo_hashtable {
+	/* buckets in use: min_buckets or a talloc-allocated array */
+	struct hlist_head *buckets;
+	/* log2 of the number of buckets */
+	unsigned int bits;
+	/* number of objects in the table */
+	unsigned int count;
+	/* returns the key an object was added with, to move it on resize */
+	uint32_t (*key)(const struct hlist_node *node);
+	DECLARE_HASHTABLE(min_buckets, OSMO_HASHTABLE_MIN_BITS);
+};
+
+/* Initializer of a static struct osmo_hashtable called name */
+#define OSMO_HASHTABLE_INIT(name, key_fn) {		\
+		.buckets = (name).min_buckets,		\
+		.bits = OSMO_HASHTABLE_MIN_BITS,	\
+		.key = key_fn,				\
+	}
+
+/* the bucket in which objects with key are */
+static inline struct hlist_head *osmo_hashtable_bucket(const struct osmo_hashtable *tbl, uint32_t key)
+{
+	return &tbl->buckets[hash_32(key, tbl->bits)];
+}
+
+void osmo_hashtable_add(struct osmo_hashtable *tbl, struct hlist_node *node, uint32_t key);
+void osmo_hashtable_del(struct osmo_hashtable *tbl, struct hlist_node *node);
+
+/* An index of the names of an array of descriptions (e.g. the counters of
+ * a struct rate_ctr_group_desc), for finding an array entry by name.  It
+ * is shared by all users of the same description array. */
+struct osmo_name_index;
+
+struct osmo_name_index *osmo_name_index_get(void *ctx, const void *desc, const char * const *first_name,
+					    size_t stride, unsigned int num);
+void osmo_name_index_put(struct osmo_name_index *ni);
+int osmo_name_index_find(const struct osmo_name_index *ni, const char *name);
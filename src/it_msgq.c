@@ -0,0 +1,201 @@
+/*! \file it_msgq.c
+ * Inter-thread msgb queue on top of a lock-free ring buffer.
+ *
+ * Producer threads enqueue msgb pointers into an \ref osmo_ring and signal
+ * an eventfd which is registered with the select loop of the consumer
+ * thread.  The eventfd is only written if no wake-up is already pending,
+ * so a burst of msgbs costs one write(2) and one read(2) in total rather
+ * than one per msgb.
+ */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "../config.h"
+
+#ifdef HAVE_SYS_EVENTFD_H
+
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include <osmocom/core/it_msgq.h>
+#include <osmocom/core/logging.h>
+#include <osmocom/core/talloc.h>
+#include <osmocom/core/utils.h>
+
+/*! \addtogroup osmo_it_msgq
+ *  @{
+ *  Lock-free msgb queues between threads.
+ *
+ *  libosmocore is generally not thread-safe.  An osmo_it_msgq is the
+ *  exception: osmo_it_msgq_enqueue() may be called from any thread (from
+ *  exactly one thread for OSMO_RING_SPSC queues), while the msgbs are
+ *  delivered to osmo_it_msgq::read_cb from within osmo_select_main() of the
+ *  thread that called osmo_it_msgq_alloc().
+ *
+ *  Note that talloc itself is not thread-safe: msgbs passed through the
+ *  queue must be allocated from a talloc context which is not concurrently
+ *  modified by the other thread (e.g. a per-thread context, or NULL).
+ *
+ * \file it_msgq.c */
+
+static void it_msgq_signal(struct osmo_it_msgq *q)
+{
+	uint64_t val = 1;
+	int rc;
+
+	/* only the first producer after the consumer drained the ring needs
+	 * to wake it up */
+	if (__atomic_exchange_n(&q->wakeup_pending, 1, __ATOMIC_SEQ_CST))
+		return;
+
+	rc = write(q->event_ofd.fd, &val, sizeof(val));
+	if (rc != sizeof(val))
+		LOGP(DLGLOBAL, LOGL_ERROR, "it_msgq(%s): cannot write to eventfd: %d\n", q->name, rc);
+}
+
+static int it_msgq_event_cb(struct osmo_fd *ofd, unsigned int what)
+{
+	struct osmo_it_msgq *q = ofd->data;
+	unsigned int count = 0;
+	struct msgb *msg;
+	uint64_t val;
+	int rc;
+
+	rc = read(ofd->fd, &val, sizeof(val));
+	if (rc < 0 && errno != EAGAIN)
+		return rc;
+
+	/* re-arm the wake-up before draining, so that any msgb enqueued from
+	 * now on either gets drained below or triggers another wake-up */
+	__atomic_store_n(&q->wakeup_pending, 0, __ATOMIC_SEQ_CST);
+
+	while ((msg = osmo_ring_dequeue_ptr(q->ring))) {
+		q->read_cb(q, msg);
+		if (q->batch_max && ++count >= q->batch_max) {
+			/* give other file descriptors a chance and come back
+			 * in the next select loop iteration */
+			if (osmo_ring_count(q->ring))
+				it_msgq_signal(q);
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/*! Allocate a new inter-thread msgb queue and register it with the select
+ *  loop of the calling (consumer) thread.
+ *  \param[in] ctx talloc context from which to allocate
+ *  \param[in] name human-readable name of the queue
+ *  \param[in] type OSMO_RING_SPSC for a single producer thread; OSMO_RING_MPSC otherwise
+ *  \param[in] max_length maximum number of msgbs in the queue (rounded up to a power of two)
+ *  \param[in] read_cb call-back for each msgb arriving in the consumer thread
+ *  \param[in] data opaque data pointer stored in the queue
+ *  \returns newly-allocated queue; NULL on error */
+struct osmo_it_msgq *osmo_it_msgq_alloc(void *ctx, const char *name, enum osmo_ring_type type,
+					unsigned int max_length, osmo_it_msgq_read_cb *read_cb,
+					void *data)
+{
+	struct osmo_it_msgq *q;
+	int fd, rc;
+
+	q = talloc_zero(ctx, struct osmo_it_msgq);
+	if (!q)
+		return NULL;
+
+	q->name = talloc_strdup(q, name);
+	q->read_cb = read_cb;
+	q->data = data;
+	q->ring = osmo_ring_alloc(q, type, max_length, sizeof(struct msgb *));
+	if (!q->ring)
+		goto out_free;
+
+	fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (fd < 0)
+		goto out_free;
+
+	osmo_fd_setup(&q->event_ofd, fd, OSMO_FD_READ, it_msgq_event_cb, q, 0);
+	rc = osmo_fd_register(&q->event_ofd);
+	if (rc < 0) {
+		close(fd);
+		goto out_free;
+	}
+
+	return q;
+
+out_free:
+	talloc_free(q);
+	return NULL;
+}
+
+/*! Free all msgbs still in the queue.
+ *  \param[in] q queue to flush
+ *
+ *  Must be called from the consumer thread. */
+void osmo_it_msgq_flush(struct osmo_it_msgq *q)
+{
+	struct msgb *msg;
+
+	while ((msg = osmo_ring_dequeue_ptr(q->ring)))
+		msgb_free(msg);
+}
+
+/*! Unregister and free an inter-thread msgb queue, including all msgbs
+ *  still in it.
+ *  \param[in] q queue to destroy
+ *
+ *  Must be called from the consumer thread, after all producers stopped
+ *  enqueueing. */
+void osmo_it_msgq_destroy(struct osmo_it_msgq *q)
+{
+	osmo_it_msgq_flush(q);
+	osmo_fd_close(&q->event_ofd);
+	talloc_free(q);
+}
+
+/*! Enqueue a msgb into an inter-thread queue; may be called from any thread.
+ *  \param[in] q queue into which to enqueue
+ *  \param[in] msg message buffer; ownership passes to the queue on success
+ *  \returns 0 on success; -ENOSPC if the queue is full */
+int osmo_it_msgq_enqueue(struct osmo_it_msgq *q, struct msgb *msg)
+{
+	int rc;
+
+	rc = osmo_ring_enqueue_ptr(q->ring, msg);
+	if (rc < 0)
+		return rc;
+
+	it_msgq_signal(q);
+	return 0;
+}
+
+/*! Dequeue a msgb from an inter-thread queue without waiting for the select loop.
+ *  \param[in] q queue from which to dequeue
+ *  \returns oldest msgb in the queue; NULL if the queue is empty
+ *
+ *  Must be called from the consumer thread. */
+struct msgb *osmo_it_msgq_dequeue(struct osmo_it_msgq *q)
+{
+	return osmo_ring_dequeue_ptr(q->ring);
+}
+
+/*! @} */
+
+#endif /* HAVE_SYS_EVENTFD_H */
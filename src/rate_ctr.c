@@ -46,32 +46,126 @@
  *  rate_ctr_inc to increment the value as certain events (e.g. location
  *  update) happens.
  *
- *  The library internally keeps a timer once per second which iterates
- *  over all registered counters and which updates the per-second,
- *  per-minute, per-hour and per-day averages based on the current
- *  value.
+ *  The library internally keeps a timer once per second which merely
+ *  counts the seconds.  The per-second, per-minute, per-hour and per-day
+ *  averages of a group are brought up to date lazily, when the group is
+ *  read, so idle counter groups cost nothing.
  *
  *  The counters can be reported using \ref stats or by VTY
  *  introspection, as well as by any application-specific code accessing
- *  the \ref rate_ctr.intv array directly.
+ *  the \ref rate_ctr.intv array directly after calling \ref
+ *  rate_ctr_group_aggregate.
+ *
+ *  Like the rest of libosmocore, rate counters are not thread-safe by
+ *  default.  If the counters of a group are to be incremented from
+ *  several threads, the owning thread calls \ref
+ *  rate_ctr_group_enable_shards on it.  \ref rate_ctr_add2 and \ref
+ *  rate_ctr_inc2 then increment a per-thread shard of the group (each
+ *  shard on its own cache lines) without locking.  The shards are folded
+ *  into \ref rate_ctr.current by \ref rate_ctr_group_aggregate, which the
+ *  stats reporting, VTY and CTRL call before reading the counters.  All
+ *  other functions of this module must only be called from the thread
+ *  owning the group.
+ *
+ *  Groups are found by name and index (\ref
+ *  rate_ctr_get_group_by_name_idx) and counters by name (\ref
+ *  rate_ctr_get_by_name) through hash tables maintained on allocation
+ *  and release of the groups, so CTRL and VTY lookups don't depend on
+ *  the number of groups and counters in the process.
+ *
+ *  Incrementing a counter also puts its group on a list of changed
+ *  groups, so the stats reporting only needs to visit the groups that
+ *  changed since the last report (see \ref
+ *  rate_ctr_for_each_dirty_group), instead of all counters of all groups.
  *
  * \file rate_ctr.c */
 
+#include <errno.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
 #include <osmocom/core/utils.h>
 #include <osmocom/core/linuxlist.h>
+#include <osmocom/core/hashtable.h>
 #include <osmocom/core/talloc.h>
 #include <osmocom/core/timer.h>
 #include <osmocom/core/rate_ctr.h>
 #include <osmocom/core/logging.h>
 
+#include "hash_internal.h"
+
 static LLIST_HEAD(rate_ctr_groups);
+/* started struct rate_ctr_group_cursor */
+static LLIST_HEAD(rate_ctr_group_cursors);
+
+/* key of a group in rate_ctr_groups_by_name_idx */
+static inline uint32_t rate_ctr_group_key(const char *name, unsigned int idx)
+{
+	return osmo_fnv1a(name) ^ __hash_32(idx);
+}
+
+static uint32_t rate_ctr_group_node_key(const struct hlist_node *node)
+{
+	const struct rate_ctr_group *grp = hlist_entry(node, struct rate_ctr_group, name_idx_node);
+
+	return rate_ctr_group_key(grp->desc->group_name_prefix, grp->idx);
+}
+
+/* all groups, by hash of group name prefix and index */
+static struct osmo_hashtable rate_ctr_groups_by_name_idx =
+	OSMO_HASHTABLE_INIT(rate_ctr_groups_by_name_idx, rate_ctr_group_node_key);
+/* struct rate_ctr_prefix by hash of the group name prefix */
+static DEFINE_HASHTABLE(rate_ctr_prefixes, 6);
+
+/*! Groups sharing one group name prefix */
+struct rate_ctr_prefix {
+	/*! entry in rate_ctr_prefixes */
+	struct hlist_node node;
+	/*! the group name prefix */
+	char *name;
+	/*! number of groups with this prefix */
+	unsigned int num_groups;
+	/*! above the index of all groups with this prefix */
+	unsigned int next_idx;
+};
 
 static void *tall_rate_ctr_ctx;
 
+/* size of a CPU cache line, shards are aligned to it to avoid false sharing */
+#define RATE_CTR_CACHELINE	64
+
+/*! Per-thread shards of the counter values of one group */
+struct rate_ctr_group_shards {
+	/*! entry in rate_ctr_sharded_groups */
+	struct llist_head list;
+	/*! group the shards belong to */
+	struct rate_ctr_group *ctrg;
+	/*! number of shards */
+	unsigned int num_shards;
+	/*! distance between two shards in number of uint64_t, a multiple of a cache line */
+	unsigned int stride;
+	/*! cache-line aligned storage of num_shards * stride values */
+	uint64_t *val;
+};
+
+/* source of per-thread shard numbers */
+static unsigned int rate_ctr_thread_count;
+/* shard number of the current thread plus one; zero if not yet assigned */
+static __thread unsigned int rate_ctr_thread_id;
+
+/* groups with shards, whose changes are only noticed when aggregating them */
+static LLIST_HEAD(rate_ctr_sharded_groups);
+
+/* groups changed since the current reporting pass started */
+static LLIST_HEAD(rate_ctr_dirty_groups);
+/* changed groups still to be visited in the current reporting pass */
+static LLIST_HEAD(rate_ctr_pending_groups);
+
+static struct osmo_timer_list rate_ctr_timer;
+/* seconds since rate_ctr_init() */
+static uint64_t timer_ticks;
+
 
 static bool rate_ctrl_group_desc_validate(const struct rate_ctr_group_desc *desc)
 {
@@ -184,25 +278,83 @@ err_free:
 	return NULL;
 }
 
+static struct rate_ctr_prefix *rate_ctr_prefix_find(const char *name)
+{
+	struct rate_ctr_prefix *prefix;
+
+	hash_for_each_possible(rate_ctr_prefixes, prefix, node, osmo_fnv1a(name)) {
+		if (!strcmp(prefix->name, name))
+			return prefix;
+	}
+	return NULL;
+}
+
 /*! Find an unused index for this rate counter group.
  *  \param[in] name Name of the counter group
- *  \returns the largest used index number + 1, or 0 if none exist yet. */
+ *  \returns an index above all used indexes, or 0 if none exist yet. */
 static unsigned int rate_ctr_get_unused_name_idx(const char *name)
 {
-	unsigned int idx = 0;
-	struct rate_ctr_group *ctrg;
+	struct rate_ctr_prefix *prefix = rate_ctr_prefix_find(name);
 
-	llist_for_each_entry(ctrg, &rate_ctr_groups, list) {
-		if (!ctrg->desc)
-			continue;
+	return prefix ? prefix->next_idx : 0;
+}
 
-		if (strcmp(ctrg->desc->group_name_prefix, name))
-			continue;
+/* add the group to the hash tables, after its index changed */
+static void rate_ctr_group_hash(struct rate_ctr_group *grp, struct rate_ctr_prefix *prefix)
+{
+	osmo_hashtable_add(&rate_ctr_groups_by_name_idx, &grp->name_idx_node,
+			   rate_ctr_group_key(grp->desc->group_name_prefix, grp->idx));
+	if (prefix->next_idx <= grp->idx)
+		prefix->next_idx = grp->idx + 1;
+}
+
+/* add a new group to the hash tables */
+static int rate_ctr_group_index(struct rate_ctr_group *grp)
+{
+	const char *name = grp->desc->group_name_prefix;
+	struct rate_ctr_prefix *prefix = rate_ctr_prefix_find(name);
+
+	if (!prefix) {
+		prefix = talloc_zero(tall_rate_ctr_ctx, struct rate_ctr_prefix);
+		if (!prefix)
+			return -ENOMEM;
+		prefix->name = talloc_strdup(prefix, name);
+		if (!prefix->name) {
+			talloc_free(prefix);
+			return -ENOMEM;
+		}
+		hash_add(rate_ctr_prefixes, &prefix->node, osmo_fnv1a(name));
+	}
 
-		if (idx <= ctrg->idx)
-			idx = ctrg->idx + 1;
+	grp->desc_index = osmo_name_index_get(tall_rate_ctr_ctx, grp->desc, &grp->desc->ctr_desc[0].name,
+					      sizeof(grp->desc->ctr_desc[0]), grp->desc->num_ctr);
+	if (!grp->desc_index) {
+		if (!prefix->num_groups) {
+			hash_del(&prefix->node);
+			talloc_free(prefix);
+		}
+		return -ENOMEM;
 	}
-	return idx;
+
+	prefix->num_groups++;
+	rate_ctr_group_hash(grp, prefix);
+	return 0;
+}
+
+/* remove a group from the hash tables */
+static void rate_ctr_group_unindex(struct rate_ctr_group *grp)
+{
+	struct rate_ctr_prefix *prefix = rate_ctr_prefix_find(grp->desc->group_name_prefix);
+
+	osmo_hashtable_del(&rate_ctr_groups_by_name_idx, &grp->name_idx_node);
+	osmo_name_index_put(grp->desc_index);
+	grp->desc_index = NULL;
+
+	OSMO_ASSERT(prefix);
+	if (--prefix->num_groups)
+		return;
+	hash_del(&prefix->node);
+	talloc_free(prefix);
 }
 
 /*! Allocate a new group of counters according to description
@@ -216,6 +368,7 @@ struct rate_ctr_group *rate_ctr_group_alloc(void *ctx,
 {
 	unsigned int size;
 	struct rate_ctr_group *group;
+	unsigned int i;
 
 	if (rate_ctr_get_group_by_name_idx(desc->group_name_prefix, idx)) {
 		unsigned int new_idx = rate_ctr_get_unused_name_idx(desc->group_name_prefix);
@@ -246,6 +399,15 @@ struct rate_ctr_group *rate_ctr_group_alloc(void *ctx,
 
 	group->desc = desc;
 	group->idx = idx;
+	group->intv_tick = timer_ticks;
+	INIT_LLIST_HEAD(&group->dirty_list);
+	for (i = 0; i < desc->num_ctr; i++)
+		group->ctr[i].group = group;
+
+	if (rate_ctr_group_index(group) < 0) {
+		talloc_free(group);
+		return NULL;
+	}
 
 	llist_add(&group->list, &rate_ctr_groups);
 
@@ -258,15 +420,143 @@ void rate_ctr_group_free(struct rate_ctr_group *grp)
 	if (!grp)
 		return;
 
-	if (!llist_empty(&grp->list))
+	if (!llist_empty(&grp->list)) {
+		struct rate_ctr_group_cursor *cur;
+
+		llist_for_each_entry(cur, &rate_ctr_group_cursors, list) {
+			if (cur->next == &grp->list)
+				cur->next = grp->list.next;
+		}
 		llist_del(&grp->list);
+	}
+	if (grp->desc_index)
+		rate_ctr_group_unindex(grp);
+	llist_del(&grp->dirty_list);
+	if (grp->shards)
+		llist_del(&grp->shards->list);
 	talloc_free(grp);
 }
 
+/*! Change the index of a counter group
+ *  \param[in] grp counter group
+ *  \param[in] idx new index of \a grp within its class */
+void rate_ctr_group_upd_idx(struct rate_ctr_group *grp, unsigned int idx)
+{
+	grp->idx = idx;
+	if (!grp->desc_index)
+		return;
+	osmo_hashtable_del(&rate_ctr_groups_by_name_idx, &grp->name_idx_node);
+	rate_ctr_group_hash(grp, rate_ctr_prefix_find(grp->desc->group_name_prefix));
+}
+
+static inline void rate_ctr_group_mark_dirty(struct rate_ctr_group *grp)
+{
+	if (llist_empty(&grp->dirty_list))
+		llist_add_tail(&grp->dirty_list, &rate_ctr_dirty_groups);
+}
+
 /*! Add a number to the counter */
 void rate_ctr_add(struct rate_ctr *ctr, int inc)
 {
 	ctr->current += inc;
+	if (ctr->group)
+		rate_ctr_group_mark_dirty(ctr->group);
+}
+
+/*! Enable per-thread shards, so the group's counters may be incremented from several threads.
+ *  \param[in] ctrg counter group; must not yet be used by other threads
+ *  \param[in] num_shards number of shards, typically the number of threads incrementing the counters
+ *  \returns 0 on success; negative on error
+ *
+ *  Threads are assigned to shards in the order in which they first
+ *  increment a sharded counter.  If more threads than shards exist,
+ *  several threads share a shard; increments remain correct, but the
+ *  cache line of that shard is then contended. */
+int rate_ctr_group_enable_shards(struct rate_ctr_group *ctrg, unsigned int num_shards)
+{
+	struct rate_ctr_group_shards *shards;
+	unsigned int per_line = RATE_CTR_CACHELINE / sizeof(uint64_t);
+	uintptr_t mem;
+
+	if (num_shards == 0)
+		return -EINVAL;
+	if (ctrg->shards)
+		return -EALREADY;
+
+	shards = talloc_zero(ctrg, struct rate_ctr_group_shards);
+	if (!shards)
+		return -ENOMEM;
+
+	shards->ctrg = ctrg;
+	shards->num_shards = num_shards;
+	shards->stride = (ctrg->desc->num_ctr + per_line - 1) / per_line * per_line;
+	mem = (uintptr_t)talloc_zero_size(shards, num_shards * shards->stride * sizeof(uint64_t)
+							+ RATE_CTR_CACHELINE - 1);
+	if (!mem) {
+		talloc_free(shards);
+		return -ENOMEM;
+	}
+	shards->val = (uint64_t *)((mem + RATE_CTR_CACHELINE - 1) & ~(uintptr_t)(RATE_CTR_CACHELINE - 1));
+
+	ctrg->shards = shards;
+	llist_add_tail(&shards->list, &rate_ctr_sharded_groups);
+	return 0;
+}
+
+/*! Add a number to a counter of a group with shards; may be called from any thread.
+ *  Usually called via \ref rate_ctr_add2 or \ref rate_ctr_inc2.
+ *  \param[in] ctrg counter group on which rate_ctr_group_enable_shards() was called
+ *  \param[in] idx index of the counter in the group
+ *  \param[in] inc quantity to add */
+void rate_ctr_group_shard_add(struct rate_ctr_group *ctrg, unsigned int idx, int inc)
+{
+	struct rate_ctr_group_shards *shards = ctrg->shards;
+	unsigned int shard;
+
+	if (!rate_ctr_thread_id)
+		rate_ctr_thread_id = __atomic_add_fetch(&rate_ctr_thread_count, 1, __ATOMIC_RELAXED);
+	shard = (rate_ctr_thread_id - 1) % shards->num_shards;
+
+	/* the shard is usually only written by this thread, so the atomic add
+	 * is uncontended; it merely keeps threads sharing a shard correct */
+	__atomic_fetch_add(&shards->val[shard * shards->stride + idx], (uint64_t)(int64_t)inc,
+			   __ATOMIC_RELAXED);
+}
+
+static void rate_ctr_group_intv(struct rate_ctr_group *grp);
+
+/*! Bring the counters of a group up to date before reading them.
+ *  \param[in] ctrg counter group
+ *
+ *  Folds the per-thread shards (if any) into \ref rate_ctr.current and
+ *  computes the \ref rate_ctr.intv rates for the seconds elapsed since the
+ *  group was last brought up to date.  Called internally before the
+ *  counters are reported via stats, VTY or CTRL; code reading \ref
+ *  rate_ctr.intv directly must call it first.
+ *
+ *  Must be called from the thread owning the group. */
+void rate_ctr_group_aggregate(struct rate_ctr_group *ctrg)
+{
+	struct rate_ctr_group_shards *shards = ctrg->shards;
+	unsigned int s, i;
+
+	if (!shards)
+		goto out;
+
+	for (s = 0; s < shards->num_shards; s++) {
+		uint64_t *val = &shards->val[s * shards->stride];
+		for (i = 0; i < ctrg->desc->num_ctr; i++) {
+			/* avoid the read-modify-write (and stealing the writer's
+			 * cache line) for counters that didn't change */
+			if (!__atomic_load_n(&val[i], __ATOMIC_RELAXED))
+				continue;
+			ctrg->ctr[i].current += __atomic_exchange_n(&val[i], 0, __ATOMIC_RELAXED);
+			rate_ctr_group_mark_dirty(ctrg);
+		}
+	}
+
+out:
+	rate_ctr_group_intv(ctrg);
 }
 
 /*! Return the counter difference since the last call to this function */
@@ -281,51 +571,101 @@ int64_t rate_ctr_difference(struct rate_ctr *ctr)
 /* TODO: support update intervals > 1s */
 /* TODO: implement this as a special stats reporter */
 
-static void interval_expired(struct rate_ctr *ctr, enum rate_ctr_intv intv)
+/* length of each interval in seconds */
+static const uint32_t intv_secs[RATE_CTR_INTV_NUM] = {
+	[RATE_CTR_INTV_SEC] = 1,
+	[RATE_CTR_INTV_MIN] = 60,
+	[RATE_CTR_INTV_HOUR] = 60*60,
+	[RATE_CTR_INTV_DAY] = 24*60*60,
+};
+
+/* Part of the change d over e seconds that falls into x of them, assuming
+ * it is spread evenly; rounded away from zero, so that a counter that
+ * moved never shows a rate of 0 */
+static int64_t rate_share(int64_t d, uint64_t x, uint64_t e)
 {
-	/* calculate rate over last interval */
-	ctr->intv[intv].rate = ctr->current - ctr->intv[intv].last;
-	/* save current counter for next interval */
-	ctr->intv[intv].last = ctr->current;
+	uint64_t m = d < 0 ? -d : d;
+	uint64_t r = (m / e) * x + ((m % e) * x + e - 1) / e;
 
-	/* update the rate of the next bigger interval.  This will
-	 * be overwritten when that next larger interval expires */
-	if (intv + 1 < ARRAY_SIZE(ctr->intv))
-		ctr->intv[intv+1].rate += ctr->intv[intv].rate;
+	return d < 0 ? -(int64_t) r : (int64_t) r;
 }
 
-static struct osmo_timer_list rate_ctr_timer;
-static uint64_t timer_ticks;
-
-/* The one-second interval has expired */
+/* Catch up on the intervals expired since the group was last updated.
+ *
+ * Rather than walking all counters of all groups every second, the rates
+ * are only computed when the group is read.  The increments since the last
+ * update are taken as spread evenly over the seconds elapsed since, so a
+ * group read only every few seconds or minutes shows the average rate over
+ * that span.  A group read every second gets exactly the rates the
+ * per-second scan of all counters used to compute. */
 static void rate_ctr_group_intv(struct rate_ctr_group *grp)
 {
-	unsigned int i;
+	uint64_t from = grp->intv_tick, now = timer_ticks;
+	uint64_t elapsed = now - from;
+	unsigned int expired[RATE_CTR_INTV_NUM];
+	uint64_t boundary[RATE_CTR_INTV_NUM];
+	unsigned int i, j;
+
+	if (!elapsed)
+		return;
+	grp->intv_tick = now;
+
+	for (j = 0; j < RATE_CTR_INTV_NUM; j++) {
+		/* number of times the interval expired in (from, now] */
+		expired[j] = now / intv_secs[j] - from / intv_secs[j];
+		/* the last time it did */
+		boundary[j] = now / intv_secs[j] * intv_secs[j];
+	}
 
 	for (i = 0; i < grp->desc->num_ctr; i++) {
 		struct rate_ctr *ctr = &grp->ctr[i];
-
-		interval_expired(ctr, RATE_CTR_INTV_SEC);
-		if ((timer_ticks % 60) == 0)
-			interval_expired(ctr, RATE_CTR_INTV_MIN);
-		if ((timer_ticks % (60*60)) == 0)
-			interval_expired(ctr, RATE_CTR_INTV_HOUR);
-		if ((timer_ticks % (24*60*60)) == 0)
-			interval_expired(ctr, RATE_CTR_INTV_DAY);
+		/* the per-second interval expires on every update, so its
+		 * last value is the counter at the time of the last update */
+		uint64_t prev = ctr->intv[RATE_CTR_INTV_SEC].last;
+		int64_t d = ctr->current - prev;
+		/* of the next smaller interval: what its intervals finished
+		 * since the last update counted in total, and up to its last
+		 * boundary since the last update */
+		int64_t fin = d, before_prev = d;
+
+		for (j = 0; j < RATE_CTR_INTV_NUM; j++) {
+			struct rate_ctr_per_intv *intv = &ctr->intv[j];
+			int64_t before;
+
+			/* the rate of a running interval is the one of the
+			 * last finished interval plus the smaller intervals
+			 * finished since; it is overwritten when it expires */
+			if (!expired[j]) {
+				intv->rate += fin;
+				fin = 0;
+				before_prev = 0;
+				continue;
+			}
+
+			/* the counts up to the boundary finish the interval */
+			before = rate_share(d, boundary[j] - from, elapsed);
+			fin = prev + before - intv->last;
+			if (expired[j] == 1)
+				intv->rate = fin;
+			else
+				intv->rate = rate_share(d, intv_secs[j], elapsed);
+			intv->last = prev + before;
+
+			/* the smaller intervals finished after the boundary
+			 * start the next one */
+			if (j > RATE_CTR_INTV_SEC)
+				intv->rate += before_prev - before;
+			before_prev = before;
+		}
 	}
 }
 
 static void rate_ctr_timer_cb(void *data)
 {
-	struct rate_ctr_group *ctrg;
-
 	/* Increment number of ticks before we calculate intervals,
 	 * as a counter value of 0 would already wrap all counters */
 	timer_ticks++;
 
-	llist_for_each_entry(ctrg, &rate_ctr_groups, list)
-		rate_ctr_group_intv(ctrg);
-
 	osmo_timer_schedule(&rate_ctr_timer, 1, 0);
 }
 
@@ -349,14 +689,10 @@ struct rate_ctr_group *rate_ctr_get_group_by_name_idx(const char *name, const un
 {
 	struct rate_ctr_group *ctrg;
 
-	llist_for_each_entry(ctrg, &rate_ctr_groups, list) {
-		if (!ctrg->desc)
-			continue;
-
-		if (!strcmp(ctrg->desc->group_name_prefix, name) &&
-				ctrg->idx == idx) {
+	hlist_for_each_entry(ctrg, osmo_hashtable_bucket(&rate_ctr_groups_by_name_idx,
+							 rate_ctr_group_key(name, idx)), name_idx_node) {
+		if (ctrg->idx == idx && !strcmp(ctrg->desc->group_name_prefix, name))
 			return ctrg;
-		}
 	}
 	return NULL;
 }
@@ -369,19 +705,12 @@ struct rate_ctr_group *rate_ctr_get_group_by_name_idx(const char *name, const un
 const struct rate_ctr *rate_ctr_get_by_name(const struct rate_ctr_group *ctrg, const char *name)
 {
 	int i;
-	const struct rate_ctr_desc *ctr_desc;
 
-	if (!ctrg->desc)
+	if (!ctrg->desc_index)
 		return NULL;
 
-	for (i = 0; i < ctrg->desc->num_ctr; i++) {
-		ctr_desc = &ctrg->desc->ctr_desc[i];
-
-		if (!strcmp(ctr_desc->name, name)) {
-			return &ctrg->ctr[i];
-		}
-	}
-	return NULL;
+	i = osmo_name_index_find(ctrg->desc_index, name);
+	return i < 0 ? NULL : &ctrg->ctr[i];
 }
 
 /*! Iterate over each counter in group and call function
@@ -396,6 +725,8 @@ int rate_ctr_for_each_counter(struct rate_ctr_group *ctrg,
 	int rc = 0;
 	int i;
 
+	rate_ctr_group_aggregate(ctrg);
+
 	for (i = 0; i < ctrg->desc->num_ctr; i++) {
 		struct rate_ctr *ctr = &ctrg->ctr[i];
 		rc = handle_counter(ctrg,
@@ -426,12 +757,101 @@ int rate_ctr_for_each_group(rate_ctr_group_handler_t handle_group, void *data)
 	return rc;
 }
 
+/*! Start walking the list of all counter groups
+ *  \param[out] cur cursor to initialize
+ *
+ *  Unlike \ref rate_ctr_for_each_group, the walk may be interrupted and
+ *  continued later at no cost.  Groups freed meanwhile are skipped,
+ *  groups allocated meanwhile are not returned.  The cursor must be
+ *  stopped with \ref rate_ctr_group_cursor_stop before it is freed. */
+void rate_ctr_group_cursor_start(struct rate_ctr_group_cursor *cur)
+{
+	cur->next = rate_ctr_groups.next;
+	llist_add(&cur->list, &rate_ctr_group_cursors);
+}
+
+/*! Get the next counter group of a walk
+ *  \param[in] cur cursor started with \ref rate_ctr_group_cursor_start
+ *  \returns next counter group; NULL at the end of the list */
+struct rate_ctr_group *rate_ctr_group_cursor_next(struct rate_ctr_group_cursor *cur)
+{
+	struct rate_ctr_group *grp;
+
+	if (cur->next == &rate_ctr_groups)
+		return NULL;
+	grp = llist_entry(cur->next, struct rate_ctr_group, list);
+	cur->next = cur->next->next;
+	return grp;
+}
+
+/*! Stop walking the list of all counter groups
+ *  \param[in] cur cursor started with \ref rate_ctr_group_cursor_start */
+void rate_ctr_group_cursor_stop(struct rate_ctr_group_cursor *cur)
+{
+	llist_del(&cur->list);
+}
+
+/*! Iterate over the counter groups changed since they were last visited
+ *  \param[in] handle_group function pointer of callback function
+ *  \param[in] data Data to hand transparently to handle_group()
+ *  \param[in] max_groups visit at most this many groups; 0 for no limit
+ *  \returns 0 if all changed groups were visited; 1 if groups remain to
+ *  be visited by the next call; negative if \a handle_group failed
+ *
+ *  A group is marked as changed by rate_ctr_add() and friends on any of
+ *  its counters, and removed from the set of changed groups before \a
+ *  handle_group is called for it.  The groups changed up to the first call
+ *  form one pass, which may be spread across several calls by means of \a
+ *  max_groups; changes made meanwhile are visited in the next pass.  This
+ *  is meant for the stats reporting, which otherwise had to visit all
+ *  groups periodically; there can only be one such user. */
+int rate_ctr_for_each_dirty_group(rate_ctr_group_handler_t handle_group, void *data,
+				  unsigned int max_groups)
+{
+	struct rate_ctr_group_shards *shards;
+	struct rate_ctr_group *ctrg;
+	unsigned int n = 0;
+	int rc;
+
+	if (llist_empty(&rate_ctr_pending_groups)) {
+		/* start a new pass; only aggregating tells whether groups with
+		 * shards changed */
+		llist_for_each_entry(shards, &rate_ctr_sharded_groups, list)
+			rate_ctr_group_aggregate(shards->ctrg);
+		llist_splice_init(&rate_ctr_dirty_groups, &rate_ctr_pending_groups);
+	}
+
+	while (!llist_empty(&rate_ctr_pending_groups)) {
+		if (max_groups && n++ == max_groups)
+			return 1;
+		ctrg = llist_first_entry(&rate_ctr_pending_groups, struct rate_ctr_group, dirty_list);
+		llist_del_init(&ctrg->dirty_list);
+		rc = handle_group(ctrg, data);
+		if (rc < 0)
+			return rc;
+	}
+
+	return 0;
+}
+
+/*! Mark all counter groups as changed, e.g. to report all of them once */
+void rate_ctr_mark_all_dirty(void)
+{
+	struct rate_ctr_group *ctrg;
+
+	llist_for_each_entry(ctrg, &rate_ctr_groups, list)
+		rate_ctr_group_mark_dirty(ctrg);
+}
+
 /*! Reset a rate counter back to zero
  *  \param[in] ctr counter to reset
  */
 void rate_ctr_reset(struct rate_ctr *ctr)
 {
+	struct rate_ctr_group *group = ctr->group;
+
         memset(ctr, 0, sizeof(*ctr));
+	ctr->group = group;
 }
 
 /*! Reset all counters in a group
@@ -441,6 +861,9 @@ void rate_ctr_group_reset(struct rate_ctr_group *ctrg)
 {
 	int i;
 
+	/* discard pending per-thread increments */
+	rate_ctr_group_aggregate(ctrg);
+
 	for (i = 0; i < ctrg->desc->num_ctr; i++) {
 		struct rate_ctr *ctr = &ctrg->ctr[i];
                 rate_ctr_reset(ctr);
@@ -0,0 +1,279 @@
+/*! \file ring.c
+ * Lock-free bounded ring buffers for passing data between threads.
+ *
+ * Two variants are offered:
+ * - OSMO_RING_SPSC: a classic single-producer/single-consumer ring, where
+ *   each side owns one free-running index and only ever reads the index
+ *   of the other side.
+ * - OSMO_RING_MPSC: a bounded multi-producer/single-consumer ring with a
+ *   per-slot sequence number (after D. Vyukov's bounded MPMC queue).
+ *   Producers claim a slot by advancing the tail with a compare-and-swap
+ *   and publish it by bumping the slot sequence number.
+ *
+ * Producer and consumer indexes are kept on separate cache lines, so that
+ * the two sides do not invalidate each other's cache line on every
+ * operation.  Elements are copied by value into the ring; the ring itself
+ * never allocates after osmo_ring_alloc().
+ */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <osmocom/core/ring.h>
+#include <osmocom/core/talloc.h>
+#include <osmocom/core/utils.h>
+
+/*! \addtogroup osmo_ring
+ *  @{
+ *  Lock-free SPSC/MPSC ring buffers.
+ *
+ *  The ring is allocated by (and must be free'd on) one thread, but
+ *  osmo_ring_enqueue() and osmo_ring_dequeue() may be called concurrently
+ *  from the producer and consumer threads without any locking.
+ *
+ * \file ring.c */
+
+/* offset of the element payload within one slot; the first word holds
+ * the sequence number used by the MPSC variant */
+#define SLOT_DATA_OFS	8
+
+struct osmo_ring {
+	/* read-only after allocation */
+	enum osmo_ring_type type;
+	uint32_t mask;
+	size_t elem_size;
+	size_t stride;
+	uint8_t *slots;
+
+	uint8_t _pad0[OSMO_CACHELINE_SIZE];
+
+	/* producer side */
+	uint32_t tail;
+	uint32_t head_cache;
+
+	uint8_t _pad1[OSMO_CACHELINE_SIZE];
+
+	/* consumer side */
+	uint32_t head;
+	uint32_t tail_cache;
+
+	uint8_t _pad2[OSMO_CACHELINE_SIZE];
+};
+
+static inline uint32_t *slot_seq(const struct osmo_ring *ring, uint32_t pos)
+{
+	return (uint32_t *)(ring->slots + (pos & ring->mask) * ring->stride);
+}
+
+static inline uint8_t *slot_data(const struct osmo_ring *ring, uint32_t pos)
+{
+	return ring->slots + (pos & ring->mask) * ring->stride + SLOT_DATA_OFS;
+}
+
+/*! Allocate a lock-free ring buffer.
+ *  \param[in] ctx talloc context from which to allocate
+ *  \param[in] type concurrency model (SPSC or MPSC)
+ *  \param[in] num_elem number of slots; rounded up to the next power of two,
+ *  and for OSMO_RING_MPSC to at least 2
+ *  \param[in] elem_size size of each element in bytes
+ *  \returns newly-allocated ring buffer; NULL on error */
+struct osmo_ring *osmo_ring_alloc(void *ctx, enum osmo_ring_type type,
+				  unsigned int num_elem, size_t elem_size)
+{
+	struct osmo_ring *ring;
+	uint32_t size;
+	uint32_t i;
+
+	if (num_elem == 0 || num_elem > (1U << 31) || elem_size == 0)
+		return NULL;
+	if (type != OSMO_RING_SPSC && type != OSMO_RING_MPSC)
+		return NULL;
+
+	/* An MPSC slot holding the element of position pos has sequence
+	 * pos + 1, and when free again for the next lap pos + size.  With
+	 * a single slot the two would be equal, and a full slot would look
+	 * free to the producers. */
+	size = type == OSMO_RING_MPSC ? 2 : 1;
+	while (size < num_elem)
+		size <<= 1;
+
+	ring = talloc_zero(ctx, struct osmo_ring);
+	if (!ring)
+		return NULL;
+
+	ring->type = type;
+	ring->mask = size - 1;
+	ring->elem_size = elem_size;
+	ring->stride = SLOT_DATA_OFS + ((elem_size + 7) & ~(size_t)7);
+	ring->slots = talloc_zero_size(ring, ring->stride * size);
+	if (!ring->slots) {
+		talloc_free(ring);
+		return NULL;
+	}
+
+	/* in MPSC mode, slot i is free for the producer at position i */
+	for (i = 0; i < size; i++)
+		*slot_seq(ring, i) = i;
+
+	return ring;
+}
+
+/*! Free a ring buffer. Any elements still enqueued are discarded.
+ *  \param[in] ring ring buffer to free */
+void osmo_ring_free(struct osmo_ring *ring)
+{
+	talloc_free(ring);
+}
+
+static int spsc_enqueue(struct osmo_ring *ring, const void *elem)
+{
+	uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+
+	if (tail - ring->head_cache > ring->mask) {
+		ring->head_cache = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+		if (tail - ring->head_cache > ring->mask)
+			return -ENOSPC;
+	}
+
+	memcpy(slot_data(ring, tail), elem, ring->elem_size);
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+static bool spsc_dequeue(struct osmo_ring *ring, void *elem)
+{
+	uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+
+	if (head == ring->tail_cache) {
+		ring->tail_cache = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+		if (head == ring->tail_cache)
+			return false;
+	}
+
+	memcpy(elem, slot_data(ring, head), ring->elem_size);
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+static int mpsc_enqueue(struct osmo_ring *ring, const void *elem)
+{
+	uint32_t pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	uint32_t seq;
+	int32_t dif;
+
+	while (1) {
+		seq = __atomic_load_n(slot_seq(ring, pos), __ATOMIC_ACQUIRE);
+		dif = (int32_t)(seq - pos);
+		if (dif == 0) {
+			/* slot is free: try to claim it; on failure 'pos' is
+			 * updated to the current tail */
+			if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, true,
+							__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;
+		} else if (dif < 0) {
+			/* slot still holds an element from the previous lap */
+			return -ENOSPC;
+		} else
+			pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	}
+
+	memcpy(slot_data(ring, pos), elem, ring->elem_size);
+	/* publish the element to the consumer */
+	__atomic_store_n(slot_seq(ring, pos), pos + 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+static bool mpsc_dequeue(struct osmo_ring *ring, void *elem)
+{
+	uint32_t pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+	uint32_t seq = __atomic_load_n(slot_seq(ring, pos), __ATOMIC_ACQUIRE);
+
+	if ((int32_t)(seq - (pos + 1)) < 0)
+		return false;
+
+	memcpy(elem, slot_data(ring, pos), ring->elem_size);
+	/* hand the slot back to the producers for the next lap */
+	__atomic_store_n(slot_seq(ring, pos), pos + ring->mask + 1, __ATOMIC_RELEASE);
+	__atomic_store_n(&ring->head, pos + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+/*! Append one element to the ring buffer (producer side).
+ *  \param[in] ring ring buffer to which to append
+ *  \param[in] elem element of the ring's elem_size to copy into the ring
+ *  \returns 0 on success; -ENOSPC if the ring is full
+ *
+ *  With OSMO_RING_SPSC, only one thread may call this function at any
+ *  given time.  With OSMO_RING_MPSC, any number of threads may call it
+ *  concurrently. */
+int osmo_ring_enqueue(struct osmo_ring *ring, const void *elem)
+{
+	if (ring->type == OSMO_RING_SPSC)
+		return spsc_enqueue(ring, elem);
+	return mpsc_enqueue(ring, elem);
+}
+
+/*! Remove the oldest element from the ring buffer (consumer side).
+ *  \param[in] ring ring buffer from which to dequeue
+ *  \param[out] elem caller-allocated buffer of the ring's elem_size
+ *  \returns true if an element was dequeued; false if the ring is empty
+ *
+ *  Only one thread may call this function at any given time. */
+bool osmo_ring_dequeue(struct osmo_ring *ring, void *elem)
+{
+	if (ring->type == OSMO_RING_SPSC)
+		return spsc_dequeue(ring, elem);
+	return mpsc_dequeue(ring, elem);
+}
+
+/*! Return the number of elements currently in the ring buffer.
+ *  \param[in] ring ring buffer to inspect
+ *  \returns number of enqueued elements
+ *
+ *  When called concurrently with producers or the consumer, the result is
+ *  only a snapshot.  In MPSC mode, it includes slots that have been
+ *  claimed by a producer but not yet published. */
+unsigned int osmo_ring_count(const struct osmo_ring *ring)
+{
+	uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	return tail - head;
+}
+
+/*! Return the number of slots of the ring buffer. */
+unsigned int osmo_ring_size(const struct osmo_ring *ring)
+{
+	return ring->mask + 1;
+}
+
+/*! Return the size of one element of the ring buffer. */
+size_t osmo_ring_elem_size(const struct osmo_ring *ring)
+{
+	return ring->elem_size;
+}
+
+/*! Return the concurrency model of the ring buffer. */
+enum osmo_ring_type osmo_ring_get_type(const struct osmo_ring *ring)
+{
+	return ring->type;
+}
+
+/*! @} */
@@ -30,6 +30,7 @@
 #include <unistd.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <errno.h>
 
 #include <osmocom/core/select.h>
@@ -38,6 +39,7 @@
 #include <osmocom/core/logging.h>
 #include <osmocom/core/talloc.h>
 #include <osmocom/core/utils.h>
+#include <osmocom/core/ring.h>
 
 #include "../config.h"
 
@@ -56,6 +58,25 @@ static __thread int maxfd = 0;
 static __thread struct llist_head osmo_fds; /* TLS cannot use LLIST_HEAD() */
 static __thread int unregistered_count;
 
+/* closure posted to a select loop via osmo_loop_post() */
+struct osmo_loop_task {
+	osmo_loop_task_cb *cb;
+	void *data;
+};
+
+/*! select loop of one thread, as far as it can receive closures from other threads */
+struct osmo_loop {
+	/* MPSC ring of struct osmo_loop_task */
+	struct osmo_ring *ring;
+	/* eventfd to wake up the thread blocking in select() */
+	struct osmo_fd event_ofd;
+	/* non-zero while a wake-up is signalled but not yet handled */
+	int wakeup_pending;
+};
+
+/* the osmo_loop of the current thread, if any */
+static __thread struct osmo_loop *loop_self;
+
 /*! Set up an osmo-fd. Will not register it.
  *  \param[inout] ofd Osmo FD to be set-up
  *  \param[in] fd OS-level file descriptor number
@@ -240,9 +261,14 @@ restart:
 static int _osmo_select_main(int polling)
 {
 	fd_set readset, writeset, exceptset;
-	int rc;
+	int rc, work;
 	struct timeval no_time = {0, 0};
 
+	/* execute closures posted to this thread from other threads; if there
+	 * were any, don't block in select() below, so that the caller gets to
+	 * see their effects before waiting for the next event */
+	work = osmo_loop_run_tasks() > 0;
+
 	FD_ZERO(&readset);
 	FD_ZERO(&writeset);
 	FD_ZERO(&exceptset);
@@ -252,9 +278,10 @@ static int _osmo_select_main(int polling)
 
 	if (!polling)
 		osmo_timers_prepare();
-	rc = select(maxfd+1, &readset, &writeset, &exceptset, polling ? &no_time : osmo_timers_nearest());
+	rc = select(maxfd+1, &readset, &writeset, &exceptset,
+		    (polling || work) ? &no_time : osmo_timers_nearest());
 	if (rc < 0)
-		return 0;
+		return work;
 
 	/* fire timers */
 	osmo_timers_update();
@@ -262,7 +289,7 @@ static int _osmo_select_main(int polling)
 	OSMO_ASSERT(osmo_ctx->select);
 
 	/* call registered callback functions */
-	return osmo_fd_disp_fds(&readset, &writeset, &exceptset);
+	return osmo_fd_disp_fds(&readset, &writeset, &exceptset) | work;
 }
 
 /*! select main loop integration
@@ -453,6 +480,171 @@ osmo_signalfd_setup(void *ctx, sigset_t set, osmo_signalfd_cb *cb, void *data)
 
 #endif /* HAVE_SYS_SIGNALFD_H */
 
+/*! Execute all closures which were posted to the current thread's loop.
+ *  \returns number of closures executed
+ *
+ *  This is called at the top of each osmo_select_main() iteration.  Users
+ *  of a foreign event loop (see osmo_fd_disp_fds()) need to call it
+ *  themselves.  Only the closures which were queued when this function
+ *  was entered are executed; closures posted by those closures are
+ *  executed in the next iteration. */
+int osmo_loop_run_tasks(void)
+{
+	struct osmo_loop *loop = loop_self;
+	struct osmo_loop_task task;
+	unsigned int i, count;
+
+	if (!loop)
+		return 0;
+
+	/* re-arm the wake-up before draining, so that any closure posted from
+	 * now on either gets executed below or triggers another wake-up */
+	__atomic_store_n(&loop->wakeup_pending, 0, __ATOMIC_SEQ_CST);
+
+	count = osmo_ring_count(loop->ring);
+	for (i = 0; i < count; i++) {
+		if (!osmo_ring_dequeue(loop->ring, &task))
+			break;
+		task.cb(task.data);
+	}
+
+	return i;
+}
+
+#ifdef HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+
+static int loop_event_cb(struct osmo_fd *ofd, unsigned int what)
+{
+	uint64_t val;
+	int rc;
+
+	/* only consume the wake-up; the closures are executed at the top of the
+	 * next select loop iteration by osmo_loop_run_tasks() */
+	rc = read(ofd->fd, &val, sizeof(val));
+	if (rc < 0 && errno != EAGAIN)
+		return rc;
+	return 0;
+}
+
+/*! Enable posting of closures from other threads to the current thread's select loop.
+ *  \param[in] ctx talloc context from which to allocate
+ *  \param[in] max_tasks maximum number of pending closures (rounded up to a power of two)
+ *  \returns 0 on success; negative on error
+ *
+ *  Must be called from the thread which runs the select loop.  The
+ *  returned handle of osmo_loop_self() may then be passed to other threads. */
+int osmo_loop_init(void *ctx, unsigned int max_tasks)
+{
+	struct osmo_loop *loop;
+	int fd, rc;
+
+	if (loop_self)
+		return -EALREADY;
+
+	loop = talloc_zero(ctx, struct osmo_loop);
+	if (!loop)
+		return -ENOMEM;
+
+	loop->ring = osmo_ring_alloc(loop, OSMO_RING_MPSC, max_tasks, sizeof(struct osmo_loop_task));
+	if (!loop->ring) {
+		talloc_free(loop);
+		return -ENOMEM;
+	}
+
+	fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (fd < 0) {
+		talloc_free(loop);
+		return -errno;
+	}
+
+	osmo_fd_setup(&loop->event_ofd, fd, OSMO_FD_READ, loop_event_cb, loop, 0);
+	rc = osmo_fd_register(&loop->event_ofd);
+	if (rc < 0) {
+		close(fd);
+		talloc_free(loop);
+		return rc;
+	}
+
+	loop_self = loop;
+	return 0;
+}
+
+/*! Disable posting of closures to the current thread's select loop.
+ *
+ *  Closures still pending are discarded without being executed.  The
+ *  caller must ensure that no other thread still holds the osmo_loop
+ *  handle of this thread. */
+void osmo_loop_exit(void)
+{
+	struct osmo_loop *loop = loop_self;
+
+	if (!loop)
+		return;
+
+	loop_self = NULL;
+	osmo_fd_close(&loop->event_ofd);
+	talloc_free(loop);
+}
+
+/*! Post a closure to be executed by the select loop of another (or the same) thread.
+ *  \param[in] loop target loop, as returned by osmo_loop_self() in the target thread
+ *  \param[in] cb call-back function to execute in the target thread
+ *  \param[in] data opaque data passed to \a cb
+ *  \returns 0 on success; -ENOSPC if the target loop's task queue is full
+ *
+ *  May be called from any thread, without locking.  The closure is
+ *  executed at the top of the next osmo_select_main() iteration of the
+ *  target thread, in the order in which it was posted by the calling
+ *  thread. */
+int osmo_loop_post(struct osmo_loop *loop, osmo_loop_task_cb *cb, void *data)
+{
+	struct osmo_loop_task task = {
+		.cb = cb,
+		.data = data,
+	};
+	uint64_t val = 1;
+	int rc;
+
+	rc = osmo_ring_enqueue(loop->ring, &task);
+	if (rc < 0)
+		return rc;
+
+	/* only the first poster after the target drained its queue needs to wake it up */
+	if (__atomic_exchange_n(&loop->wakeup_pending, 1, __ATOMIC_SEQ_CST))
+		return 0;
+
+	rc = write(loop->event_ofd.fd, &val, sizeof(val));
+	if (rc != sizeof(val))
+		return -errno;
+	return 0;
+}
+
+#else /* HAVE_SYS_EVENTFD_H */
+
+int osmo_loop_init(void *ctx, unsigned int max_tasks)
+{
+	return -ENOTSUP;
+}
+
+void osmo_loop_exit(void)
+{
+}
+
+int osmo_loop_post(struct osmo_loop *loop, osmo_loop_task_cb *cb, void *data)
+{
+	return -ENOTSUP;
+}
+
+#endif /* HAVE_SYS_EVENTFD_H */
+
+/*! Return the handle of the current thread's select loop for osmo_loop_post().
+ *  \returns loop handle; NULL if osmo_loop_init() was not called on this thread */
+struct osmo_loop *osmo_loop_self(void)
+{
+	return loop_self;
+}
+
 /*! @} */
 
 #endif /* _HAVE_SYS_SELECT_H */
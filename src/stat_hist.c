@@ -0,0 +1,357 @@
+/*! \file stat_hist.c
+ * Log-bucketed histograms of statistical values, e.g. latencies. */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*! \addtogroup osmo_stat_hist
+ *  @{
+ *
+ *  While an \ref osmo_stat_item only keeps the most recent values, an
+ *  osmo_stat_hist keeps the distribution of all values recorded since
+ *  it was allocated or reset, e.g. to report the median and tail
+ *  latencies of a protocol exchange.
+ *
+ *  Values are uint32_t in the unit given in the \ref
+ *  osmo_stat_hist_desc.  They are counted in buckets in the style of HDR
+ *  histograms: values below 2^OSMO_STAT_HIST_SUB_BITS get a bucket each;
+ *  every higher power of two is split into OSMO_STAT_HIST_SUB_BUCKETS
+ *  equally sized buckets.  This bounds the relative error of reported
+ *  percentiles to 1/OSMO_STAT_HIST_SUB_BUCKETS at a fixed size of
+ *  OSMO_STAT_HIST_NUM_BUCKETS counters per histogram.
+ *
+ *  \ref osmo_stat_hist_record takes constant time, does not allocate and
+ *  may be called from any thread: it only does relaxed atomic updates.
+ *  All other functions must be called from the thread which allocated
+ *  the group, and reading a histogram while other threads record values
+ *  may yield a summary which is off by the values recorded meanwhile.
+ *
+ *  Histograms are shown by the VTY "show stats" command, can be
+ *  retrieved via the CTRL interface ("stat_hist.p99.group.0.name") and
+ *  are reported by the stats reporters.  Reporters get the percentiles
+ *  of the values recorded during the last reporting interval.
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <osmocom/core/utils.h>
+#include <osmocom/core/linuxlist.h>
+#include <osmocom/core/talloc.h>
+#include <osmocom/core/stat_hist.h>
+
+/*! global list of stat_hist groups */
+static LLIST_HEAD(osmo_stat_hist_groups);
+
+/*! talloc context from which we allocate */
+static void *tall_stat_hist_ctx;
+
+/*! Allocate a new group of histograms according to description.
+ *  \param[in] ctx \ref talloc context
+ *  \param[in] desc Histogram group description
+ *  \param[in] idx Index of new histogram group
+ *  \returns newly-allocated group; NULL on error */
+struct osmo_stat_hist_group *osmo_stat_hist_group_alloc(void *ctx,
+							 const struct osmo_stat_hist_group_desc *desc,
+							 unsigned int idx)
+{
+	struct osmo_stat_hist_group *group;
+	unsigned int i;
+
+	if (!ctx)
+		ctx = tall_stat_hist_ctx;
+
+	group = talloc_zero_size(ctx, sizeof(*group) + desc->num_hists * sizeof(struct osmo_stat_hist));
+	if (!group)
+		return NULL;
+
+	group->desc = desc;
+	group->idx = idx;
+
+	for (i = 0; i < desc->num_hists; i++) {
+		group->hist[i].desc = &desc->hist_desc[i];
+		group->hist[i].min = UINT32_MAX;
+	}
+
+	llist_add(&group->list, &osmo_stat_hist_groups);
+
+	return group;
+}
+
+/*! Free the memory for the specified group of histograms */
+void osmo_stat_hist_group_free(struct osmo_stat_hist_group *histg)
+{
+	if (!histg)
+		return;
+
+	llist_del(&histg->list);
+	talloc_free(histg);
+}
+
+/*! Get the bucket in which a value is counted.
+ *  \param[in] value value to look up
+ *  \returns bucket index, less than OSMO_STAT_HIST_NUM_BUCKETS */
+unsigned int osmo_stat_hist_bucket(uint32_t value)
+{
+	unsigned int shift;
+
+	if (value < OSMO_STAT_HIST_SUB_BUCKETS)
+		return value;
+
+	/* position of the highest bit set, minus the bits kept below it */
+	shift = 31 - __builtin_clz(value) - OSMO_STAT_HIST_SUB_BITS;
+	return (shift + 1) * OSMO_STAT_HIST_SUB_BUCKETS + ((value >> shift) & (OSMO_STAT_HIST_SUB_BUCKETS - 1));
+}
+
+/*! Get the largest value counted in a given bucket.
+ *  \param[in] bucket bucket index
+ *  \returns largest value for which osmo_stat_hist_bucket() returns \a bucket */
+uint32_t osmo_stat_hist_bucket_max(unsigned int bucket)
+{
+	unsigned int shift, sub;
+
+	if (bucket < OSMO_STAT_HIST_SUB_BUCKETS)
+		return bucket;
+
+	shift = bucket / OSMO_STAT_HIST_SUB_BUCKETS - 1;
+	sub = bucket % OSMO_STAT_HIST_SUB_BUCKETS;
+	return (((uint64_t)(OSMO_STAT_HIST_SUB_BUCKETS + sub + 1)) << shift) - 1;
+}
+
+/*! Record a value in a histogram; may be called from any thread.
+ *  \param[in] hist histogram in which to record
+ *  \param[in] value value to record */
+void osmo_stat_hist_record(struct osmo_stat_hist *hist, uint32_t value)
+{
+	uint32_t cur;
+
+	__atomic_fetch_add(&hist->buckets[osmo_stat_hist_bucket(value)], 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&hist->count, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&hist->sum, value, __ATOMIC_RELAXED);
+
+	/* min and max rarely change once some values were recorded, so
+	 * usually this is just a load and a compare each */
+	cur = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+	while (value > cur && !__atomic_compare_exchange_n(&hist->max, &cur, value, true,
+							   __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+	cur = __atomic_load_n(&hist->min, __ATOMIC_RELAXED);
+	while (value < cur && !__atomic_compare_exchange_n(&hist->min, &cur, value, true,
+							   __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+
+/* find the bucket in which the value of the given rank lies; rank counts from 1 */
+static unsigned int bucket_of_rank(const uint32_t *buckets, uint64_t rank)
+{
+	uint64_t seen = 0;
+	unsigned int i;
+
+	for (i = 0; i < OSMO_STAT_HIST_NUM_BUCKETS - 1; i++) {
+		seen += buckets[i];
+		if (seen >= rank)
+			break;
+	}
+	return i;
+}
+
+static uint32_t percentile_of(const uint32_t *buckets, uint64_t count, uint32_t min, uint32_t max,
+			      double percentile)
+{
+	double exact_rank = percentile / 100.0 * count;
+	uint64_t rank;
+	uint32_t val;
+
+	if (!count)
+		return 0;
+
+	/* nearest-rank method: the smallest value such that at least
+	 * percentile % of all values are less than or equal to it */
+	rank = exact_rank;
+	if (rank < exact_rank)
+		rank++;
+	rank = OSMO_MAX(rank, 1);
+	rank = OSMO_MIN(rank, count);
+
+	/* report the largest value of the bucket, but stay within the
+	 * range of values actually recorded */
+	val = osmo_stat_hist_bucket_max(bucket_of_rank(buckets, rank));
+	val = OSMO_MIN(val, max);
+	val = OSMO_MAX(val, min);
+	return val;
+}
+
+/*! Summarize the values counted in an array of buckets.
+ *  \param[in] buckets array of OSMO_STAT_HIST_NUM_BUCKETS bucket counts
+ *  \param[in] min lower bound of the values, used to tighten the summary
+ *  \param[in] max upper bound of the values, used to tighten the summary
+ *  \param[out] sum caller-allocated summary to fill in
+ *
+ *  Used by stats reporters to summarize the difference between two
+ *  snapshots of a histogram's buckets. */
+void osmo_stat_hist_summarize_buckets(const uint32_t *buckets, uint32_t min, uint32_t max,
+				      struct osmo_stat_hist_summary *sum)
+{
+	unsigned int i;
+
+	memset(sum, 0, sizeof(*sum));
+	for (i = 0; i < OSMO_STAT_HIST_NUM_BUCKETS; i++)
+		sum->count += buckets[i];
+	if (!sum->count)
+		return;
+
+	sum->min = percentile_of(buckets, sum->count, min, max, 0);
+	sum->max = percentile_of(buckets, sum->count, min, max, 100);
+	sum->p50 = percentile_of(buckets, sum->count, min, max, 50);
+	sum->p90 = percentile_of(buckets, sum->count, min, max, 90);
+	sum->p99 = percentile_of(buckets, sum->count, min, max, 99);
+	sum->p999 = percentile_of(buckets, sum->count, min, max, 99.9);
+}
+
+/*! Get a percentile of all values recorded in a histogram.
+ *  \param[in] hist histogram to query
+ *  \param[in] percentile percentile to compute, between 0 and 100
+ *  \returns value below or equal to which \a percentile % of the values lie; 0 if no values were recorded */
+uint32_t osmo_stat_hist_get_percentile(const struct osmo_stat_hist *hist, double percentile)
+{
+	uint64_t count = 0;
+	unsigned int i;
+
+	/* count the buckets rather than using hist->count, which may be
+	 * ahead of the buckets while another thread records a value */
+	for (i = 0; i < OSMO_STAT_HIST_NUM_BUCKETS; i++)
+		count += hist->buckets[i];
+
+	return percentile_of(hist->buckets, count, hist->min, hist->max, percentile);
+}
+
+/*! Summarize all values recorded in a histogram.
+ *  \param[in] hist histogram to summarize
+ *  \param[out] sum caller-allocated summary to fill in */
+void osmo_stat_hist_get_summary(const struct osmo_stat_hist *hist, struct osmo_stat_hist_summary *sum)
+{
+	osmo_stat_hist_summarize_buckets(hist->buckets, hist->min, hist->max, sum);
+	if (sum->count)
+		sum->min = hist->min;
+}
+
+/*! Initialize the stat histogram module. Call this once from your program.
+ *  \param[in] tall_ctx Talloc context from which this module allocates
+ *  \returns 0 on success; negative on error */
+int osmo_stat_hist_init(void *tall_ctx)
+{
+	tall_stat_hist_ctx = tall_ctx;
+
+	return 0;
+}
+
+/*! Search for histogram group based on group name and index
+ *  \param[in] name Name of stat_hist_group we want to find
+ *  \param[in] idx Index of the group we want to find
+ *  \returns pointer to group, if found; NULL otherwise */
+struct osmo_stat_hist_group *osmo_stat_hist_get_group_by_name_idx(const char *name,
+								  const unsigned int idx)
+{
+	struct osmo_stat_hist_group *histg;
+
+	llist_for_each_entry(histg, &osmo_stat_hist_groups, list) {
+		if (!strcmp(histg->desc->group_name_prefix, name) && histg->idx == idx)
+			return histg;
+	}
+	return NULL;
+}
+
+/*! Search for histogram based on group + histogram name
+ *  \param[in] histg group in which to search for the histogram
+ *  \param[in] name name of histogram to search within \a histg
+ *  \returns pointer to histogram, if found; NULL otherwise */
+const struct osmo_stat_hist *osmo_stat_hist_get_by_name(const struct osmo_stat_hist_group *histg,
+							const char *name)
+{
+	unsigned int i;
+
+	for (i = 0; i < histg->desc->num_hists; i++) {
+		if (!strcmp(histg->desc->hist_desc[i].name, name))
+			return &histg->hist[i];
+	}
+	return NULL;
+}
+
+/*! Iterate over all histograms in group, call user-supplied function on each
+ *  \param[in] histg stat_hist group over whose histograms to iterate
+ *  \param[in] handle_hist Call-back function, aborts if rc < 0
+ *  \param[in] data Private data handed through to \a handle_hist
+ *  \returns 0 on success; negative otherwise */
+int osmo_stat_hist_for_each_hist(struct osmo_stat_hist_group *histg,
+				 osmo_stat_hist_handler_t handle_hist, void *data)
+{
+	int rc = 0;
+	unsigned int i;
+
+	for (i = 0; i < histg->desc->num_hists; i++) {
+		rc = handle_hist(histg, &histg->hist[i], data);
+		if (rc < 0)
+			return rc;
+	}
+
+	return rc;
+}
+
+/*! Iterate over all stat_hist groups in system, call user-supplied function on each
+ *  \param[in] handle_group Call-back function, aborts if rc < 0
+ *  \param[in] data Private data handed through to \a handle_group
+ *  \returns 0 on success; negative otherwise */
+int osmo_stat_hist_for_each_group(osmo_stat_hist_group_handler_t handle_group, void *data)
+{
+	struct osmo_stat_hist_group *histg;
+	int rc = 0;
+
+	llist_for_each_entry(histg, &osmo_stat_hist_groups, list) {
+		rc = handle_group(histg, data);
+		if (rc < 0)
+			return rc;
+	}
+
+	return rc;
+}
+
+/*! Remove all values of a histogram
+ *  \param[in] hist histogram to reset; must not be recorded to concurrently */
+void osmo_stat_hist_reset(struct osmo_stat_hist *hist)
+{
+	memset(hist->buckets, 0, sizeof(hist->buckets));
+	if (hist->reported)
+		memset(hist->reported, 0, sizeof(hist->buckets));
+	hist->count = 0;
+	hist->sum = 0;
+	hist->min = UINT32_MAX;
+	hist->max = 0;
+}
+
+/*! Reset all histograms in a group
+ *  \param[in] histg histogram group to reset */
+void osmo_stat_hist_group_reset(struct osmo_stat_hist_group *histg)
+{
+	unsigned int i;
+
+	for (i = 0; i < histg->desc->num_hists; i++)
+		osmo_stat_hist_reset(&histg->hist[i]);
+}
+
+/*! @} */
@@ -50,6 +50,9 @@
  *  overwritten.  Lost values are skipped when getting values from the
  *  item.
  *
+ *  Groups are found by name and index and items by name through hash
+ *  tables maintained on allocation and release of the groups.
+ *
  */
 
 #include <stdint.h>
@@ -57,18 +60,42 @@
 
 #include <osmocom/core/utils.h>
 #include <osmocom/core/linuxlist.h>
+#include <osmocom/core/hashtable.h>
 #include <osmocom/core/talloc.h>
 #include <osmocom/core/timer.h>
 #include <osmocom/core/stat_item.h>
 
+#include "hash_internal.h"
+
 /*! global list of stat_item groups */
 static LLIST_HEAD(osmo_stat_item_groups);
+/*! groups changed since the current reporting pass started */
+static LLIST_HEAD(osmo_stat_item_dirty_groups);
+/*! changed groups still to be visited in the current reporting pass */
+static LLIST_HEAD(osmo_stat_item_pending_groups);
 /*! counter for assigning globally unique value identifiers */
 static int32_t global_value_id = 0;
 
 /*! talloc context from which we allocate */
 static void *tall_stat_item_ctx;
 
+/* key of a group in osmo_stat_item_groups_by_name_idx */
+static inline uint32_t stat_item_group_key(const char *name, unsigned int idx)
+{
+	return osmo_fnv1a(name) ^ __hash_32(idx);
+}
+
+static uint32_t stat_item_group_node_key(const struct hlist_node *node)
+{
+	const struct osmo_stat_item_group *statg = hlist_entry(node, struct osmo_stat_item_group, name_idx_node);
+
+	return stat_item_group_key(statg->desc->group_name_prefix, statg->idx);
+}
+
+/*! all groups, by hash of group name prefix and index */
+static struct osmo_hashtable osmo_stat_item_groups_by_name_idx =
+	OSMO_HASHTABLE_INIT(osmo_stat_item_groups_by_name_idx, stat_item_group_node_key);
+
 /*! Allocate a new group of counters according to description.
  *  Allocate a group of stat items described in \a desc from talloc context \a ctx,
  *  giving the new group the index \a idx.
@@ -99,6 +126,7 @@ struct osmo_stat_item_group *osmo_stat_item_group_alloc(void *ctx,
 
 	group->desc = desc;
 	group->idx = idx;
+	INIT_LLIST_HEAD(&group->dirty_list);
 
 	/* Get combined size of all items */
 	for (item_idx = 0; item_idx < desc->num_items; item_idx++) {
@@ -131,6 +159,7 @@ struct osmo_stat_item_group *osmo_stat_item_group_alloc(void *ctx,
 		item->last_offs = desc->item_desc[item_idx].num_values - 1;
 		item->last_value_index = -1;
 		item->desc = &desc->item_desc[item_idx];
+		item->group = group;
 
 		for (i = 0; i <= item->last_offs; i++) {
 			item->values[i].value = desc->item_desc[item_idx].default_value;
@@ -138,6 +167,15 @@ struct osmo_stat_item_group *osmo_stat_item_group_alloc(void *ctx,
 		}
 	}
 
+	group->desc_index = osmo_name_index_get(tall_stat_item_ctx, desc, &desc->item_desc[0].name,
+						sizeof(desc->item_desc[0]), desc->num_items);
+	if (!group->desc_index) {
+		talloc_free(group);
+		return NULL;
+	}
+	osmo_hashtable_add(&osmo_stat_item_groups_by_name_idx, &group->name_idx_node,
+			   stat_item_group_key(desc->group_name_prefix, idx));
+
 	llist_add(&group->list, &osmo_stat_item_groups);
 
 	return group;
@@ -147,9 +185,23 @@ struct osmo_stat_item_group *osmo_stat_item_group_alloc(void *ctx,
 void osmo_stat_item_group_free(struct osmo_stat_item_group *grp)
 {
 	llist_del(&grp->list);
+	llist_del(&grp->dirty_list);
+	osmo_hashtable_del(&osmo_stat_item_groups_by_name_idx, &grp->name_idx_node);
+	osmo_name_index_put(grp->desc_index);
 	talloc_free(grp);
 }
 
+/*! Change the index of a stat item group
+ *  \param[in] grp stat item group
+ *  \param[in] idx new index of \a grp within its class */
+void osmo_stat_item_group_udp_idx(struct osmo_stat_item_group *grp, unsigned int idx)
+{
+	grp->idx = idx;
+	osmo_hashtable_del(&osmo_stat_item_groups_by_name_idx, &grp->name_idx_node);
+	osmo_hashtable_add(&osmo_stat_item_groups_by_name_idx, &grp->name_idx_node,
+			   stat_item_group_key(grp->desc->group_name_prefix, idx));
+}
+
 /*! Increase the stat_item to the given value.
  *  This function adds a new value for the given stat_item at the end of
  *  the FIFO.
@@ -192,6 +244,9 @@ void osmo_stat_item_set(struct osmo_stat_item *item, int32_t value)
 
 	item->values[item->last_offs].value = value;
 	item->values[item->last_offs].id    = global_value_id;
+
+	if (llist_empty(&item->group->dirty_list))
+		llist_add_tail(&item->group->dirty_list, &osmo_stat_item_dirty_groups);
 }
 
 /*! Retrieve the next value from the osmo_stat_item object.
@@ -283,12 +338,9 @@ struct osmo_stat_item_group *osmo_stat_item_get_group_by_name_idx(
 {
 	struct osmo_stat_item_group *statg;
 
-	llist_for_each_entry(statg, &osmo_stat_item_groups, list) {
-		if (!statg->desc)
-			continue;
-
-		if (!strcmp(statg->desc->group_name_prefix, name) &&
-				statg->idx == idx)
+	hlist_for_each_entry(statg, osmo_hashtable_bucket(&osmo_stat_item_groups_by_name_idx,
+							  stat_item_group_key(name, idx)), name_idx_node) {
+		if (statg->idx == idx && !strcmp(statg->desc->group_name_prefix, name))
 			return statg;
 	}
 	return NULL;
@@ -302,19 +354,12 @@ const struct osmo_stat_item *osmo_stat_item_get_by_name(
 	const struct osmo_stat_item_group *statg, const char *name)
 {
 	int i;
-	const struct osmo_stat_item_desc *item_desc;
 
-	if (!statg->desc)
+	if (!statg->desc_index)
 		return NULL;
 
-	for (i = 0; i < statg->desc->num_items; i++) {
-		item_desc = &statg->desc->item_desc[i];
-
-		if (!strcmp(item_desc->name, name)) {
-			return statg->items[i];
-		}
-	}
-	return NULL;
+	i = osmo_name_index_find(statg->desc_index, name);
+	return i < 0 ? NULL : statg->items[i];
 }
 
 /*! Iterate over all items in group, call user-supplied function on each
@@ -356,6 +401,58 @@ int osmo_stat_item_for_each_group(osmo_stat_item_group_handler_t handle_group, v
 	return rc;
 }
 
+/*! Iterate over the stat_item groups changed since they were last visited
+ *  \param[in] handle_group Call-back function, aborts if rc < 0
+ *  \param[in] data Private data handed through to \a handle_group
+ *  \param[in] max_groups visit at most this many groups; 0 for no limit
+ *  \returns 0 if all changed groups were visited; 1 if groups remain to
+ *  be visited by the next call; negative if \a handle_group failed
+ *
+ *  Works like rate_ctr_for_each_dirty_group(): a group is marked as
+ *  changed when a value of one of its items is set. */
+int osmo_stat_item_for_each_dirty_group(osmo_stat_item_group_handler_t handle_group, void *data,
+					unsigned int max_groups)
+{
+	struct osmo_stat_item_group *statg;
+	unsigned int n = 0;
+	int rc;
+
+	if (llist_empty(&osmo_stat_item_pending_groups))
+		llist_splice_init(&osmo_stat_item_dirty_groups, &osmo_stat_item_pending_groups);
+
+	while (!llist_empty(&osmo_stat_item_pending_groups)) {
+		if (max_groups && n++ == max_groups)
+			return 1;
+		statg = llist_first_entry(&osmo_stat_item_pending_groups, struct osmo_stat_item_group,
+					  dirty_list);
+		llist_del_init(&statg->dirty_list);
+		rc = handle_group(statg, data);
+		if (rc < 0)
+			return rc;
+	}
+
+	return 0;
+}
+
+/*! Mark a stat_item group as changed, e.g. to visit it again with the next
+ *  osmo_stat_item_for_each_dirty_group() pass
+ *  \param[in] statg stat_item group to mark */
+void osmo_stat_item_group_mark_dirty(struct osmo_stat_item_group *statg)
+{
+	if (llist_empty(&statg->dirty_list))
+		llist_add_tail(&statg->dirty_list, &osmo_stat_item_dirty_groups);
+}
+
+/*! Mark all stat_item groups as changed, e.g. to report all of them once */
+void osmo_stat_item_mark_all_dirty(void)
+{
+	struct osmo_stat_item_group *statg;
+
+	llist_for_each_entry(statg, &osmo_stat_item_groups, list) {
+		if (llist_empty(&statg->dirty_list))
+			llist_add_tail(&statg->dirty_list, &osmo_stat_item_dirty_groups);
+	}
+}
 
 /*! Remove all values of a stat item
  *  \param[in] item stat item to reset
@@ -44,6 +44,10 @@
  *   \ref osmo_stats_reporter_create_statsd() creates a new stats_reporter
  *   which reports via UDP to statsd.
  *
+ * - serving Prometheus/OpenMetrics scrapes via HTTP
+ *   \ref osmo_stats_reporter_create_prometheus() creates a new
+ *   stats_reporter which renders all values whenever it is scraped.
+ *
  * You can either use the above API functions directly to create \ref
  * osmo_stats_reporter instances, or you can use the VTY support
  * contained in libosmovty.  See the "stats" configuration node
@@ -54,12 +58,18 @@
  * - \ref osmo_counter
  * - \ref rate_ctr
  * - \ref osmo_stat_item
+ * - \ref osmo_stat_hist
  *
  * You do not need to do anything in particular to expose a given
  * counter or stat_item, they are all exported automatically via any
  * \ref osmo_stats_reporter.  If you have multiple \ref
  * osmo_stats_reporter, they will each report all counters/stat_items.
  *
+ * Only the \ref rate_ctr_group and \ref osmo_stat_item_group changed
+ * since the previous report are visited when reporting, so idle groups
+ * cost nothing.  With many changing groups, a report can be spread
+ * across several main loop iterations, see osmo_stats_set_batch_size().
+ *
  * \file stats.c */
 
 #include "config.h"
@@ -75,6 +85,7 @@
 #include <stdio.h>
 #include <sys/types.h>
 #include <inttypes.h>
+#include <stdbool.h>
 
 #ifdef HAVE_SYS_SOCKET_H
 #include <sys/socket.h>
@@ -86,9 +97,11 @@
 #include <osmocom/core/logging.h>
 #include <osmocom/core/rate_ctr.h>
 #include <osmocom/core/stat_item.h>
+#include <osmocom/core/stat_hist.h>
 #include <osmocom/core/select.h>
 #include <osmocom/core/counter.h>
 #include <osmocom/core/msgb.h>
+#include <osmocom/core/timer.h>
 
 #define STATS_DEFAULT_INTERVAL 5 /* secs */
 #define STATS_DEFAULT_BUFLEN 256
@@ -105,6 +118,14 @@ struct osmo_stats_config *osmo_stats_config = &s_stats_config;
 
 static struct osmo_fd osmo_stats_timer = { .fd = -1 };
 
+/* continues a reporting pass spread across several main loop iterations */
+static struct osmo_timer_list osmo_stats_batch_timer;
+/* a reporting pass is in progress */
+static bool osmo_stats_pass_running;
+/* stat item index up to which the current pass reports values; values
+ * set while the pass runs are left to the next one */
+static int32_t pass_stat_item_index;
+
 static int osmo_stats_reporter_log_send_counter(struct osmo_stats_reporter *srep,
 	const struct rate_ctr_group *ctrg,
 	const struct rate_ctr_desc *desc,
@@ -112,6 +133,10 @@ static int osmo_stats_reporter_log_send_counter(struct osmo_stats_reporter *srep
 static int osmo_stats_reporter_log_send_item(struct osmo_stats_reporter *srep,
 	const struct osmo_stat_item_group *statg,
 	const struct osmo_stat_item_desc *desc, int64_t value);
+static int osmo_stats_reporter_log_send_hist(struct osmo_stats_reporter *srep,
+	const struct osmo_stat_hist_group *histg,
+	const struct osmo_stat_hist_desc *desc,
+	const struct osmo_stat_hist_summary *sum);
 
 static int update_srep_config(struct osmo_stats_reporter *srep)
 {
@@ -336,6 +361,23 @@ int osmo_stats_reporter_set_local_addr(struct osmo_stats_reporter *srep, const c
 	return update_srep_config(srep);
 }
 
+/*! Set the local (TCP) port of a given stats_reporter accepting connections.
+ *  \param[in] srep stats_reporter whose local port is to be set
+ *  \param[in] port TCP port on which to listen; 0 for any free port
+ *  \returns 0 on success; negative on error */
+int osmo_stats_reporter_set_local_port(struct osmo_stats_reporter *srep, int port)
+{
+	if (!srep->have_net_config)
+		return -ENOTSUP;
+
+	if (port < 0 || port > 65535)
+		return -EINVAL;
+
+	srep->bind_port = port;
+
+	return update_srep_config(srep);
+}
+
 /*! Set the maximum transmission unit of a given stats_reporter.
  *  \param[in] srep stats_reporter whose remote address is to be set
  *  \param[in] mtu Maximum Transmission Unit of \a srep
@@ -380,6 +422,17 @@ int osmo_stats_set_interval(int interval)
 	return 0;
 }
 
+/*! Spread each report across several main loop iterations
+ *  \param[in] batch_size number of changed counter and stat item groups to
+ *  report per main loop iteration; 0 to report all at once (default)
+ *  \returns 0 on success; negative on error */
+int osmo_stats_set_batch_size(unsigned int batch_size)
+{
+	osmo_stats_config->batch_size = batch_size;
+
+	return 0;
+}
+
 /*! Set the regular flush period for a given stats_reporter
  *
  * Send all stats even if they have not changed (i.e. force the flush)
@@ -563,6 +616,7 @@ struct osmo_stats_reporter *osmo_stats_reporter_create_log(const char *name)
 
 	srep->send_counter = osmo_stats_reporter_log_send_counter;
 	srep->send_item = osmo_stats_reporter_log_send_item;
+	srep->send_hist = osmo_stats_reporter_log_send_hist;
 
 	return srep;
 }
@@ -607,6 +661,22 @@ static int osmo_stats_reporter_log_send_item(struct osmo_stats_reporter *srep,
 		desc->name, value, desc->unit);
 }
 
+static int osmo_stats_reporter_log_send_hist(struct osmo_stats_reporter *srep,
+	const struct osmo_stat_hist_group *histg,
+	const struct osmo_stat_hist_desc *desc,
+	const struct osmo_stat_hist_summary *sum)
+{
+	LOGP(DLSTATS, LOGL_INFO,
+		"stats t=h p=%s g=%s i=%u n=%s c=%"PRIu64" min=%"PRIu32" p50=%"PRIu32
+		" p90=%"PRIu32" p99=%"PRIu32" p999=%"PRIu32" max=%"PRIu32" u=%s\n",
+		srep->name_prefix ? srep->name_prefix : "",
+		histg->desc->group_name_prefix, histg->idx, desc->name,
+		sum->count, sum->min, sum->p50, sum->p90, sum->p99, sum->p999, sum->max,
+		desc->unit ? desc->unit : "");
+
+	return 0;
+}
+
 /*** helper for reporting ***/
 
 static int osmo_stats_reporter_check_config(struct osmo_stats_reporter *srep,
@@ -679,6 +749,26 @@ static int osmo_stats_reporter_send_item(struct osmo_stats_reporter *srep,
 	return srep->send_item(srep, statg, desc, value);
 }
 
+/* Read the next value of \a item that was set before the current pass
+ * started.  A value set since then is left to the next pass, which must
+ * visit the group again even if the group was pending in this pass. */
+static int stat_item_get_next_of_pass(struct osmo_stat_item_group *statg,
+	struct osmo_stat_item *item, int32_t *idx, int32_t *value)
+{
+	int32_t next_idx = *idx;
+
+	if (osmo_stat_item_get_next(item, &next_idx, value) <= 0)
+		return 0;
+
+	if (next_idx - pass_stat_item_index > 0) {
+		osmo_stat_item_group_mark_dirty(statg);
+		return 0;
+	}
+
+	*idx = next_idx;
+	return 1;
+}
+
 static int osmo_stat_item_handler(
 	struct osmo_stat_item_group *statg, struct osmo_stat_item *item, void *sctx_)
 {
@@ -687,7 +777,7 @@ static int osmo_stat_item_handler(
 	int32_t value;
 	int have_value;
 
-	have_value = osmo_stat_item_get_next(item, &idx, &value) > 0;
+	have_value = stat_item_get_next_of_pass(statg, item, &idx, &value);
 	if (!have_value)
 		/* Send the last value in case a flush is requested */
 		value = osmo_stat_item_get_last(item);
@@ -711,7 +801,7 @@ static int osmo_stat_item_handler(
 		if (!have_value)
 			break;
 
-		have_value = osmo_stat_item_get_next(item, &idx, &value) > 0;
+		have_value = stat_item_get_next_of_pass(statg, item, &idx, &value);
 	} while (have_value);
 
 	return 0;
@@ -724,6 +814,54 @@ static int osmo_stat_item_group_handler(struct osmo_stat_item_group *statg, void
 	return 0;
 }
 
+/*** stat histogram support ***/
+
+static int osmo_stat_hist_handler(
+	struct osmo_stat_hist_group *histg, struct osmo_stat_hist *hist, void *sctx_)
+{
+	struct osmo_stats_reporter *srep;
+	struct osmo_stat_hist_summary sum;
+	uint32_t delta[OSMO_STAT_HIST_NUM_BUCKETS];
+	unsigned int i;
+
+	if (!hist->reported) {
+		hist->reported = talloc_zero_array(histg, uint32_t, OSMO_STAT_HIST_NUM_BUCKETS);
+		if (!hist->reported)
+			return -ENOMEM;
+	}
+
+	/* report the values recorded since the last report */
+	for (i = 0; i < OSMO_STAT_HIST_NUM_BUCKETS; i++) {
+		uint32_t val = __atomic_load_n(&hist->buckets[i], __ATOMIC_RELAXED);
+		delta[i] = val - hist->reported[i];
+		hist->reported[i] = val;
+	}
+	osmo_stat_hist_summarize_buckets(delta, hist->min, hist->max, &sum);
+
+	llist_for_each_entry(srep, &osmo_stats_reporter_list, list) {
+		if (!srep->running || !srep->send_hist)
+			continue;
+
+		if (sum.count == 0 && !srep->force_single_flush)
+			continue;
+
+		if (!osmo_stats_reporter_check_config(srep,
+				histg->idx, histg->desc->class_id))
+			continue;
+
+		srep->send_hist(srep, histg, hist->desc, &sum);
+	}
+
+	return 0;
+}
+
+static int osmo_stat_hist_group_handler(struct osmo_stat_hist_group *histg, void *sctx_)
+{
+	osmo_stat_hist_for_each_hist(histg, osmo_stat_hist_handler, sctx_);
+
+	return 0;
+}
+
 /*** osmo counter support ***/
 
 static int handle_counter(struct osmo_counter *counter, void *sctx_)
@@ -778,15 +916,66 @@ static void flush_all_reporters()
 	}
 }
 
+static bool any_reporter_flushing(void)
+{
+	struct osmo_stats_reporter *srep;
+
+	llist_for_each_entry(srep, &osmo_stats_reporter_list, list) {
+		if (srep->running && srep->force_single_flush)
+			return true;
+	}
+	return false;
+}
+
+static void osmo_stats_batch_timer_cb(void *data)
+{
+	osmo_stats_report();
+}
+
+/*! Report all changed statistics to all running reporters.
+ *  Called every reporting interval.  Only the counter and stat item groups
+ *  changed since the last report are visited, unless a reporter needs to
+ *  flush all values.  If a batch size is configured (see
+ *  osmo_stats_set_batch_size()), one report is spread across as many main
+ *  loop iterations as needed to visit at most that many groups in each;
+ *  calling this function while such a report is in progress continues it.
+ *  \returns 0 */
 int osmo_stats_report()
 {
+	unsigned int batch_size = osmo_stats_config->batch_size;
+	int more = 0;
+
+	if (!osmo_stats_pass_running) {
+		osmo_stats_pass_running = true;
+		/* values set from now on are reported by the next pass */
+		pass_stat_item_index = current_stat_item_index;
+		osmo_stat_item_discard_all(&pass_stat_item_index);
+
+		if (any_reporter_flushing()) {
+			rate_ctr_mark_all_dirty();
+			osmo_stat_item_mark_all_dirty();
+		}
+
+		osmo_counters_for_each(handle_counter, NULL);
+		osmo_stat_hist_for_each_group(osmo_stat_hist_group_handler, NULL);
+	}
+
 	/* per group actions */
-	osmo_counters_for_each(handle_counter, NULL);
-	rate_ctr_for_each_group(rate_ctr_group_handler, NULL);
-	osmo_stat_item_for_each_group(osmo_stat_item_group_handler, NULL);
+	if (rate_ctr_for_each_dirty_group(rate_ctr_group_handler, NULL, batch_size) > 0)
+		more = 1;
+	if (osmo_stat_item_for_each_dirty_group(osmo_stat_item_group_handler, NULL, batch_size) > 0)
+		more = 1;
+
+	if (more) {
+		if (!osmo_stats_batch_timer.cb)
+			osmo_timer_setup(&osmo_stats_batch_timer, osmo_stats_batch_timer_cb, NULL);
+		osmo_timer_schedule(&osmo_stats_batch_timer, 0, 0);
+		return 0;
+	}
 
 	/* global actions */
-	osmo_stat_item_discard_all(&current_stat_item_index);
+	osmo_stats_pass_running = false;
+	current_stat_item_index = pass_stat_item_index;
 	flush_all_reporters();
 
 	return 0;
@@ -0,0 +1,682 @@
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*! \addtogroup stats
+ *  @{
+ *
+ *  The Prometheus reporter is pull-based: instead of sending values every
+ *  reporting interval, it listens for HTTP connections and renders all
+ *  \ref rate_ctr and \ref osmo_stat_item values in the OpenMetrics text
+ *  format whenever it is scraped.  Every counter of a group class becomes
+ *  one metric family, the group index becomes the "idx" label:
+ *
+ *  \verbatim
+ *  # TYPE bsc_chreq counter
+ *  # HELP bsc_chreq Received channel requests
+ *  bsc_chreq_total{idx="0"} 42
+ *  \endverbatim
+ *
+ *  The response is rendered in one pass into a buffer sized after the
+ *  previous response, so a scrape does not depend on the reporting
+ *  interval and costs no more than walking all values once.
+ *
+ *  Names that only differ in characters not allowed in metric names map to
+ *  the same metric family.  Only the first of such families is rendered,
+ *  the others are skipped and logged, since a family must not appear twice.
+ *
+ *  \file stats_prometheus.c */
+
+#include "config.h"
+#if !defined(EMBEDDED)
+
+#include <osmocom/core/stats.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
+
+#include <osmocom/core/hash.h>
+#include <osmocom/core/linuxlist.h>
+#include <osmocom/core/logging.h>
+#include <osmocom/core/rate_ctr.h>
+#include <osmocom/core/select.h>
+#include <osmocom/core/socket.h>
+#include <osmocom/core/stat_item.h>
+#include <osmocom/core/talloc.h>
+#include <osmocom/core/utils.h>
+
+#ifdef HAVE_SYS_SOCKET_H
+
+#define PROM_MAX_REQ_LEN	2048
+#define PROM_MAX_CONNS		16
+#define PROM_HDR_ROOM		160
+#define PROM_CONTENT_TYPE	"application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+struct prom_reporter {
+	struct osmo_stats_reporter *srep;
+	struct osmo_fd listen_ofd;
+	struct llist_head conns;
+	unsigned int num_conns;
+	/* size of the last response, to size the next one in advance */
+	size_t last_len;
+	/* number of metric families skipped by the last scrape */
+	unsigned int last_dups;
+};
+
+struct prom_conn {
+	struct llist_head list;
+	struct prom_reporter *prom;
+	struct osmo_fd ofd;
+	char req[PROM_MAX_REQ_LEN];
+	size_t req_len;
+	char *resp_buf;
+	const char *resp;
+	size_t resp_len;
+	size_t resp_pos;
+};
+
+/* output buffer growing as needed */
+struct prom_buf {
+	void *ctx;
+	char *data;
+	size_t len;
+	size_t size;
+	bool oom;
+};
+
+static bool prom_reserve(struct prom_buf *b, size_t n)
+{
+	size_t size;
+	char *data;
+
+	if (b->oom)
+		return false;
+	if (b->len + n <= b->size)
+		return true;
+
+	size = OSMO_MAX(b->size * 2, b->len + n);
+	data = talloc_realloc_size(b->ctx, b->data, size);
+	if (!data) {
+		b->oom = true;
+		return false;
+	}
+	b->data = data;
+	b->size = size;
+	return true;
+}
+
+static void prom_put(struct prom_buf *b, const char *str, size_t len)
+{
+	if (!prom_reserve(b, len))
+		return;
+	memcpy(b->data + b->len, str, len);
+	b->len += len;
+}
+
+static void prom_puts(struct prom_buf *b, const char *str)
+{
+	prom_put(b, str, strlen(str));
+}
+
+static void prom_printf(struct prom_buf *b, const char *fmt, ...)
+{
+	va_list ap;
+	int len;
+
+	if (b->oom)
+		return;
+
+	va_start(ap, fmt);
+	len = vsnprintf(b->data + b->len, b->size - b->len, fmt, ap);
+	va_end(ap);
+	if (len < 0)
+		return;
+
+	if (b->len + len >= b->size) {
+		if (!prom_reserve(b, len + 1))
+			return;
+		va_start(ap, fmt);
+		vsnprintf(b->data + b->len, b->size - b->len, fmt, ap);
+		va_end(ap);
+	}
+	b->len += len;
+}
+
+/* HELP texts escape backslash, double quote and newline */
+static void prom_put_escaped(struct prom_buf *b, const char *str)
+{
+	for (; *str; str++) {
+		switch (*str) {
+		case '\\':
+			prom_put(b, "\\\\", 2);
+			break;
+		case '"':
+			prom_put(b, "\\\"", 2);
+			break;
+		case '\n':
+			prom_put(b, "\\n", 2);
+			break;
+		default:
+			prom_put(b, str, 1);
+			break;
+		}
+	}
+}
+
+/* Compose a metric name matching [a-zA-Z_][a-zA-Z0-9_]* from the reporter
+ * prefix, the group prefix and the counter name, e.g. "ctr-test:one" and
+ * "ctr:a" become "ctr_test_one_ctr_a" */
+static void prom_metric_name(char *buf, size_t buf_len, const char *prefix,
+			     const char *group, const char *name)
+{
+	char *p;
+
+	if (prefix)
+		snprintf(buf, buf_len, "%s_%s_%s", prefix, group, name);
+	else
+		snprintf(buf, buf_len, "%s_%s", group, name);
+
+	for (p = buf; *p; p++) {
+		if (!((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || *p == '_'
+		      || (p != buf && *p >= '0' && *p <= '9')))
+			*p = '_';
+	}
+}
+
+/* the metric families rendered so far, to skip duplicates */
+struct prom_names {
+	/* open addressing table of the hash of a name and of its offset
+	 * into the response; an offset of zero marks an unused slot */
+	struct {
+		uint32_t hash;
+		uint32_t ofs;
+	} *slot;
+	unsigned int mask;
+	unsigned int num;
+	/* number of skipped families, and the name of the first one */
+	unsigned int dups;
+	char first_dup[256];
+};
+
+static bool prom_names_grow(struct prom_buf *b, struct prom_names *n)
+{
+	unsigned int size = n->slot ? 2 * (n->mask + 1) : 256;
+	unsigned int i, s;
+	__typeof__(n->slot) slot;
+
+	slot = talloc_zero_array(b->ctx, __typeof__(*n->slot), size);
+	if (!slot) {
+		b->oom = true;
+		return false;
+	}
+	for (i = 0; n->slot && i <= n->mask; i++) {
+		if (!n->slot[i].ofs)
+			continue;
+		for (s = n->slot[i].hash & (size - 1); slot[s].ofs; s = (s + 1) & (size - 1));
+		slot[s] = n->slot[i];
+	}
+	talloc_free(n->slot);
+	n->slot = slot;
+	n->mask = size - 1;
+	return true;
+}
+
+/* Add the name of a family about to be rendered at b->len.  Returns false
+ * if a family of that name was rendered before, or if out of memory. */
+static bool prom_names_add(struct prom_buf *b, struct prom_names *n, const char *name, size_t ofs)
+{
+	uint32_t hash = osmo_fnv1a(name);
+	size_t len = strlen(name);
+	unsigned int s;
+
+	if (b->oom)
+		return false;
+	if (2 * (n->num + 1) > (n->slot ? n->mask + 1 : 0) && !prom_names_grow(b, n))
+		return false;
+
+	for (s = hash & n->mask; n->slot[s].ofs; s = (s + 1) & n->mask) {
+		const char *other = b->data + n->slot[s].ofs;
+
+		if (n->slot[s].hash == hash && !memcmp(other, name, len) && other[len] == ' ') {
+			if (!n->dups++)
+				OSMO_STRLCPY_ARRAY(n->first_dup, name);
+			return false;
+		}
+	}
+	n->slot[s].hash = hash;
+	n->slot[s].ofs = ofs;
+	n->num++;
+	return true;
+}
+
+static bool prom_check_config(const struct osmo_stats_reporter *srep, unsigned int idx, int class_id)
+{
+	if (class_id == OSMO_STATS_CLASS_UNKNOWN)
+		class_id = idx != 0 ? OSMO_STATS_CLASS_SUBSCRIBER : OSMO_STATS_CLASS_GLOBAL;
+
+	return class_id <= srep->max_class;
+}
+
+/* array of group pointers collected before rendering */
+struct prom_groups {
+	const struct osmo_stats_reporter *srep;
+	void *ctx;
+	void **grp;
+	unsigned int num;
+	unsigned int alloc;
+	bool oom;
+};
+
+static void prom_groups_add(struct prom_groups *g, void *grp)
+{
+	void **arr;
+
+	if (g->num == g->alloc) {
+		arr = talloc_realloc(g->ctx, g->grp, void *, OSMO_MAX(g->alloc * 2, 64));
+		if (!arr) {
+			g->oom = true;
+			return;
+		}
+		g->grp = arr;
+		g->alloc = OSMO_MAX(g->alloc * 2, 64);
+	}
+	g->grp[g->num++] = grp;
+}
+
+static int prom_ctrg_collect(struct rate_ctr_group *ctrg, void *data)
+{
+	struct prom_groups *g = data;
+
+	if (prom_check_config(g->srep, ctrg->idx, ctrg->desc->class_id))
+		prom_groups_add(g, ctrg);
+	return 0;
+}
+
+static int prom_statg_collect(struct osmo_stat_item_group *statg, void *data)
+{
+	struct prom_groups *g = data;
+
+	if (prom_check_config(g->srep, statg->idx, statg->desc->class_id))
+		prom_groups_add(g, statg);
+	return 0;
+}
+
+/* group instances of the same class next to each other, so that all
+ * samples of a metric family are rendered together; order the classes by
+ * name, so that it is the same on each run which of several families of
+ * colliding names is rendered */
+static int prom_ctrg_cmp(const void *a, const void *b)
+{
+	const struct rate_ctr_group *ga = *(const struct rate_ctr_group **)a;
+	const struct rate_ctr_group *gb = *(const struct rate_ctr_group **)b;
+	int rc;
+
+	rc = strcmp(ga->desc->group_name_prefix, gb->desc->group_name_prefix);
+	if (rc)
+		return rc;
+	if (ga->desc != gb->desc)
+		return (uintptr_t)ga->desc < (uintptr_t)gb->desc ? -1 : 1;
+	return ga->idx < gb->idx ? -1 : ga->idx > gb->idx;
+}
+
+static int prom_statg_cmp(const void *a, const void *b)
+{
+	const struct osmo_stat_item_group *ga = *(const struct osmo_stat_item_group **)a;
+	const struct osmo_stat_item_group *gb = *(const struct osmo_stat_item_group **)b;
+	int rc;
+
+	rc = strcmp(ga->desc->group_name_prefix, gb->desc->group_name_prefix);
+	if (rc)
+		return rc;
+	if (ga->desc != gb->desc)
+		return (uintptr_t)ga->desc < (uintptr_t)gb->desc ? -1 : 1;
+	return ga->idx < gb->idx ? -1 : ga->idx > gb->idx;
+}
+
+/* render the TYPE and HELP of a family; returns false if its samples are
+ * to be skipped, because a family of that name was rendered already */
+static bool prom_family(struct prom_buf *b, struct prom_names *names, const char *name,
+			const char *type, const char *help)
+{
+	if (!prom_names_add(b, names, name, b->len + strlen("# TYPE ")))
+		return false;
+
+	prom_printf(b, "# TYPE %s %s\n", name, type);
+	if (help && *help) {
+		prom_printf(b, "# HELP %s ", name);
+		prom_put_escaped(b, help);
+		prom_put(b, "\n", 1);
+	}
+	return true;
+}
+
+static void prom_render_rate_ctr(struct prom_buf *b, const struct osmo_stats_reporter *srep,
+				 struct prom_groups *g, struct prom_names *names)
+{
+	struct rate_ctr_group **grp = (struct rate_ctr_group **)g->grp;
+	char name[256];
+	unsigned int first, last, i, j;
+
+	for (i = 0; i < g->num; i++)
+		rate_ctr_group_aggregate(grp[i]);
+	qsort(grp, g->num, sizeof(*grp), prom_ctrg_cmp);
+
+	for (first = 0; first < g->num; first = last) {
+		const struct rate_ctr_group_desc *desc = grp[first]->desc;
+
+		for (last = first; last < g->num && grp[last]->desc == desc; last++);
+
+		for (i = 0; i < desc->num_ctr; i++) {
+			prom_metric_name(name, sizeof(name), srep->name_prefix,
+					 desc->group_name_prefix, desc->ctr_desc[i].name);
+			if (!prom_family(b, names, name, "counter", desc->ctr_desc[i].description))
+				continue;
+			for (j = first; j < last; j++)
+				prom_printf(b, "%s_total{idx=\"%u\"} %"PRIu64"\n", name, grp[j]->idx,
+					    grp[j]->ctr[i].current);
+		}
+	}
+}
+
+static void prom_render_stat_item(struct prom_buf *b, const struct osmo_stats_reporter *srep,
+				  struct prom_groups *g, struct prom_names *names)
+{
+	struct osmo_stat_item_group **grp = (struct osmo_stat_item_group **)g->grp;
+	char name[256];
+	unsigned int first, last, i, j;
+
+	qsort(grp, g->num, sizeof(*grp), prom_statg_cmp);
+
+	for (first = 0; first < g->num; first = last) {
+		const struct osmo_stat_item_group_desc *desc = grp[first]->desc;
+
+		for (last = first; last < g->num && grp[last]->desc == desc; last++);
+
+		for (i = 0; i < desc->num_items; i++) {
+			prom_metric_name(name, sizeof(name), srep->name_prefix,
+					 desc->group_name_prefix, desc->item_desc[i].name);
+			if (!prom_family(b, names, name, "gauge", desc->item_desc[i].description))
+				continue;
+			for (j = first; j < last; j++)
+				prom_printf(b, "%s{idx=\"%u\"} %d\n", name, grp[j]->idx,
+					    osmo_stat_item_get_last(grp[j]->items[i]));
+		}
+	}
+}
+
+/* render all values into b, starting at b->len */
+static void prom_render(struct prom_reporter *prom, struct prom_buf *b)
+{
+	struct prom_groups g = { .srep = prom->srep, .ctx = b->ctx };
+	struct prom_names names = {};
+
+	rate_ctr_for_each_group(prom_ctrg_collect, &g);
+	if (!g.oom)
+		prom_render_rate_ctr(b, prom->srep, &g, &names);
+
+	g.num = 0;
+	osmo_stat_item_for_each_group(prom_statg_collect, &g);
+	if (!g.oom)
+		prom_render_stat_item(b, prom->srep, &g, &names);
+
+	prom_puts(b, "# EOF\n");
+	talloc_free(g.grp);
+	talloc_free(names.slot);
+	if (g.oom)
+		b->oom = true;
+
+	/* log once for each change, not on every scrape */
+	if (!b->oom && names.dups != prom->last_dups) {
+		if (names.dups)
+			LOGP(DLSTATS, LOGL_NOTICE, "Prometheus: skipped %u metric families whose names "
+			     "collide with others, the first one is %s\n", names.dups, names.first_dup);
+		prom->last_dups = names.dups;
+	}
+}
+
+static void prom_conn_close(struct prom_conn *conn)
+{
+	osmo_fd_unregister(&conn->ofd);
+	close(conn->ofd.fd);
+	llist_del(&conn->list);
+	conn->prom->num_conns--;
+	talloc_free(conn);
+}
+
+/* prepare the response to a complete request in conn->req */
+static void prom_conn_respond(struct prom_conn *conn)
+{
+	struct prom_reporter *prom = conn->prom;
+	struct prom_buf b = { .ctx = conn };
+	const char *status = "200 OK";
+	char *path, *end;
+	char hdr[PROM_HDR_ROOM];
+	int hdr_len;
+	bool ok;
+
+	/* leave room for the header in front of the body to avoid a copy */
+	b.len = PROM_HDR_ROOM;
+	prom_reserve(&b, prom->last_len + prom->last_len / 8 + PROM_HDR_ROOM + 4096);
+
+	path = conn->req + 4;
+	end = strpbrk(path, " ?\r\n");
+	if (strncmp(conn->req, "GET ", 4) != 0 || !end) {
+		status = "400 Bad Request";
+	} else {
+		*end = '\0';
+		if (strcmp(path, "/metrics") == 0 || strcmp(path, "/") == 0)
+			prom_render(prom, &b);
+		else
+			status = "404 Not Found";
+	}
+
+	if (b.oom) {
+		status = "500 Internal Server Error";
+		b.oom = false;
+		b.len = PROM_HDR_ROOM;
+	}
+	ok = strcmp(status, "200 OK") == 0;
+	if (ok)
+		prom->last_len = b.len - PROM_HDR_ROOM;
+
+	hdr_len = snprintf(hdr, sizeof(hdr),
+			   "HTTP/1.0 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+			   status, ok ? PROM_CONTENT_TYPE : "text/plain", b.len - PROM_HDR_ROOM);
+	OSMO_ASSERT(hdr_len > 0 && hdr_len < PROM_HDR_ROOM);
+	if (!b.data) {
+		prom_conn_close(conn);
+		return;
+	}
+	memcpy(b.data + PROM_HDR_ROOM - hdr_len, hdr, hdr_len);
+
+	conn->resp_buf = b.data;
+	conn->resp = b.data + PROM_HDR_ROOM - hdr_len;
+	conn->resp_len = b.len - PROM_HDR_ROOM + hdr_len;
+	conn->resp_pos = 0;
+	conn->ofd.when = OSMO_FD_WRITE;
+}
+
+static int prom_conn_cb(struct osmo_fd *ofd, unsigned int what)
+{
+	struct prom_conn *conn = ofd->data;
+	ssize_t rc;
+
+	if (what & OSMO_FD_READ) {
+		rc = recv(ofd->fd, conn->req + conn->req_len, sizeof(conn->req) - 1 - conn->req_len, 0);
+		if (rc < 0 && (errno == EAGAIN || errno == EINTR))
+			return 0;
+		if (rc <= 0) {
+			prom_conn_close(conn);
+			return 0;
+		}
+		conn->req_len += rc;
+		conn->req[conn->req_len] = '\0';
+
+		/* respond once the request header is complete */
+		if (strstr(conn->req, "\r\n\r\n") || strstr(conn->req, "\n\n")) {
+			prom_conn_respond(conn);
+		} else if (conn->req_len == sizeof(conn->req) - 1) {
+			prom_conn_close(conn);
+		}
+		return 0;
+	}
+
+	if (what & OSMO_FD_WRITE) {
+		rc = send(ofd->fd, conn->resp + conn->resp_pos, conn->resp_len - conn->resp_pos,
+#ifdef MSG_NOSIGNAL
+			  MSG_NOSIGNAL |
+#endif
+			  MSG_DONTWAIT);
+		if (rc < 0 && (errno == EAGAIN || errno == EINTR))
+			return 0;
+		if (rc < 0) {
+			prom_conn_close(conn);
+			return 0;
+		}
+		conn->resp_pos += rc;
+		if (conn->resp_pos == conn->resp_len)
+			prom_conn_close(conn);
+	}
+
+	return 0;
+}
+
+static int prom_accept_cb(struct osmo_fd *ofd, unsigned int what)
+{
+	struct prom_reporter *prom = ofd->data;
+	struct prom_conn *conn;
+	int fd;
+
+	fd = accept(ofd->fd, NULL, NULL);
+	if (fd < 0)
+		return 0;
+
+	if (prom->num_conns >= PROM_MAX_CONNS) {
+		LOGP(DLSTATS, LOGL_NOTICE, "Too many Prometheus connections, rejecting\n");
+		close(fd);
+		return 0;
+	}
+
+	conn = talloc_zero(prom, struct prom_conn);
+	if (!conn || fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) < 0) {
+		talloc_free(conn);
+		close(fd);
+		return 0;
+	}
+	conn->prom = prom;
+	osmo_fd_setup(&conn->ofd, fd, OSMO_FD_READ, prom_conn_cb, conn, 0);
+	if (osmo_fd_register(&conn->ofd) < 0) {
+		talloc_free(conn);
+		close(fd);
+		return 0;
+	}
+	llist_add_tail(&conn->list, &prom->conns);
+	prom->num_conns++;
+
+	return 0;
+}
+
+static int osmo_stats_reporter_prometheus_open(struct osmo_stats_reporter *srep)
+{
+	struct prom_reporter *prom;
+	char ip[INET6_ADDRSTRLEN];
+	char port[6];
+	int rc;
+
+	prom = talloc_zero(srep, struct prom_reporter);
+	if (!prom)
+		return -ENOMEM;
+	prom->srep = srep;
+	INIT_LLIST_HEAD(&prom->conns);
+
+	osmo_fd_setup(&prom->listen_ofd, -1, OSMO_FD_READ, prom_accept_cb, prom, 0);
+	rc = osmo_sock_init_ofd(&prom->listen_ofd, AF_INET, SOCK_STREAM, IPPROTO_TCP,
+				srep->bind_addr_str, srep->bind_port, OSMO_SOCK_F_BIND | OSMO_SOCK_F_NONBLOCK);
+	if (rc < 0) {
+		LOGP(DLSTATS, LOGL_ERROR, "Cannot listen for Prometheus scrapes on %s:%d\n",
+		     srep->bind_addr_str ? : "0.0.0.0", srep->bind_port);
+		talloc_free(prom);
+		return rc;
+	}
+
+	/* the default local port 0 binds an ephemeral port */
+	if (osmo_sock_get_local_ip(prom->listen_ofd.fd, ip, sizeof(ip)) == 0
+	    && osmo_sock_get_local_ip_port(prom->listen_ofd.fd, port, sizeof(port)) == 0)
+		LOGP(DLSTATS, LOGL_NOTICE, "Listening for Prometheus scrapes on %s:%s\n", ip, port);
+
+	srep->fd = prom->listen_ofd.fd;
+	srep->priv = prom;
+	return 0;
+}
+
+static int osmo_stats_reporter_prometheus_close(struct osmo_stats_reporter *srep)
+{
+	struct prom_reporter *prom = srep->priv;
+	struct prom_conn *conn, *conn2;
+
+	if (!prom)
+		return -EBADF;
+
+	llist_for_each_entry_safe(conn, conn2, &prom->conns, list)
+		prom_conn_close(conn);
+	osmo_fd_unregister(&prom->listen_ofd);
+	close(prom->listen_ofd.fd);
+
+	talloc_free(prom);
+	srep->priv = NULL;
+	srep->fd = -1;
+	return 0;
+}
+
+/*! Create a stats_reporter serving OpenMetrics to Prometheus.
+ *  This creates a stats_reporter which listens for HTTP connections on the
+ *  local address and port (see osmo_stats_reporter_set_local_addr() and
+ *  osmo_stats_reporter_set_local_port()) and answers each "GET /metrics"
+ *  with the current values of all counters and stat items.  Without a local
+ *  port, an ephemeral port is bound; the port is logged when the reporter
+ *  is enabled.
+ *  \param[in] name Name of the to-be-created stats_reporter
+ *  \returns stats_reporter on success; NULL on error */
+struct osmo_stats_reporter *osmo_stats_reporter_create_prometheus(const char *name)
+{
+	struct osmo_stats_reporter *srep;
+	srep = osmo_stats_reporter_alloc(OSMO_STATS_REPORTER_PROMETHEUS, name);
+
+	srep->have_net_config = 1;
+
+	srep->open = osmo_stats_reporter_prometheus_open;
+	srep->close = osmo_stats_reporter_prometheus_close;
+
+	return srep;
+}
+
+#endif /* HAVE_SYS_SOCKET_H */
+#endif /* !EMBEDDED */
+
+/*! @} */
@@ -0,0 +1,473 @@
+/*! \file stats_shm.c
+ * Export of all statistics to a memory-mapped file. */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*! \addtogroup stats_shm
+ *  @{
+ *
+ *  Monitoring agents polling many values via VTY, CTRL or statsd load
+ *  the event loop of the monitored process.  Instead, the process can
+ *  mirror all \ref osmo_counter, \ref rate_ctr, \ref osmo_stat_item and
+ *  \ref osmo_stat_hist values into a memory-mapped file (typically below
+ *  /dev/shm), which any number of readers can map and poll without
+ *  involving the process at all.
+ *
+ *  The segment starts with a struct osmo_stats_shm_hdr, followed by an
+ *  array of struct osmo_stats_shm_entry and the NUL-terminated names of
+ *  the entries.  The writer refreshes all values every interval_ms
+ *  milliseconds; the names are only rewritten when counter groups were
+ *  allocated or freed, which increments osmo_stats_shm_hdr::generation.
+ *
+ *  Readers get a consistent copy of the segment using the sequence lock
+ *  in osmo_stats_shm_hdr::seq, as implemented by
+ *  osmo_stats_shm_snapshot():
+ *  -# read seq; if it is odd, the writer is busy: retry
+ *  -# copy osmo_stats_shm_hdr::used bytes from the start of the segment
+ *  -# read seq again; if it changed, retry
+ *
+ *  The file grows when the entries no longer fit.  Readers whose mapping
+ *  is smaller than osmo_stats_shm_hdr::size need to map it again.
+ *
+ * \file stats_shm.c */
+
+#include "config.h"
+#if !defined(EMBEDDED)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <osmocom/core/linuxlist.h>
+#include <osmocom/core/counter.h>
+#include <osmocom/core/logging.h>
+#include <osmocom/core/rate_ctr.h>
+#include <osmocom/core/stat_hist.h>
+#include <osmocom/core/stat_item.h>
+#include <osmocom/core/stats_shm.h>
+#include <osmocom/core/talloc.h>
+#include <osmocom/core/timer.h>
+#include <osmocom/core/utils.h>
+
+#define STATS_SHM_DEFAULT_SIZE	(64 * 1024)
+
+/* identity of one counter group (or ungrouped counter) in the segment */
+struct stats_shm_sig {
+	const void *obj;
+	const void *desc;
+	unsigned int idx;
+};
+
+enum stats_shm_walk {
+	/* compare with the current layout and update the values only */
+	STATS_SHM_WALK_VALUES,
+	/* determine the size of a new layout */
+	STATS_SHM_WALK_COUNT,
+	/* write a new layout including names and values */
+	STATS_SHM_WALK_LAYOUT,
+};
+
+struct osmo_stats_shm {
+	char *path;
+	int fd;
+	struct osmo_stats_shm_hdr *hdr;
+	size_t size;
+	unsigned int interval_ms;
+	struct osmo_timer_list timer;
+
+	/* groups in the order in which they appear in the current layout */
+	struct stats_shm_sig *sig;
+	unsigned int num_sig;
+	unsigned int sig_alloc;
+
+	/* state of the current walk over all statistics */
+	enum stats_shm_walk walk;
+	unsigned int sig_pos;
+	unsigned int entry_pos;
+	size_t str_len;
+	size_t str_offs;
+};
+
+static inline struct osmo_stats_shm_entry *shm_entries(struct osmo_stats_shm *shm)
+{
+	return (struct osmo_stats_shm_entry *)((uint8_t *)shm->hdr + shm->hdr->entries_offs);
+}
+
+/* Called for each group; returns false if the layout doesn't match */
+static bool shm_group(struct osmo_stats_shm *shm, const void *obj, const void *desc, unsigned int idx)
+{
+	struct stats_shm_sig *sig;
+
+	switch (shm->walk) {
+	case STATS_SHM_WALK_VALUES:
+		if (shm->sig_pos >= shm->num_sig)
+			return false;
+		sig = &shm->sig[shm->sig_pos];
+		if (sig->obj != obj || sig->desc != desc || sig->idx != idx)
+			return false;
+		break;
+	case STATS_SHM_WALK_COUNT:
+		break;
+	case STATS_SHM_WALK_LAYOUT:
+		shm->sig[shm->sig_pos] = (struct stats_shm_sig){ obj, desc, idx };
+		break;
+	}
+
+	shm->sig_pos++;
+	return true;
+}
+
+static void shm_entry(struct osmo_stats_shm *shm, enum osmo_stats_shm_type type,
+		      const char *group, unsigned int idx, const char *name, const char *suffix,
+		      int64_t value)
+{
+	struct osmo_stats_shm_entry *entry;
+	char *str;
+	int len;
+
+	switch (shm->walk) {
+	case STATS_SHM_WALK_VALUES:
+		shm_entries(shm)[shm->entry_pos].value = value;
+		break;
+	case STATS_SHM_WALK_COUNT:
+		if (group)
+			len = snprintf(NULL, 0, "%s.%u.%s%s", group, idx, name, suffix);
+		else
+			len = snprintf(NULL, 0, "%s%s", name, suffix);
+		shm->str_len += len + 1;
+		break;
+	case STATS_SHM_WALK_LAYOUT:
+		entry = &shm_entries(shm)[shm->entry_pos];
+		str = (char *)shm->hdr + shm->str_offs;
+		if (group)
+			len = sprintf(str, "%s.%u.%s%s", group, idx, name, suffix);
+		else
+			len = sprintf(str, "%s%s", name, suffix);
+		*entry = (struct osmo_stats_shm_entry){
+			.value = value,
+			.name_offs = shm->str_offs,
+			.group_idx = idx,
+			.type = type,
+		};
+		shm->str_offs += len + 1;
+		break;
+	}
+
+	shm->entry_pos++;
+}
+
+static int shm_counter_handler(struct osmo_counter *counter, void *data)
+{
+	struct osmo_stats_shm *shm = data;
+
+	if (!shm_group(shm, counter, counter->name, 0))
+		return -EAGAIN;
+	shm_entry(shm, OSMO_STATS_SHM_T_COUNTER, NULL, 0, counter->name, "", counter->value);
+	return 0;
+}
+
+static int shm_rate_ctr_group_handler(struct rate_ctr_group *ctrg, void *data)
+{
+	struct osmo_stats_shm *shm = data;
+	unsigned int i;
+
+	if (!shm_group(shm, ctrg, ctrg->desc, ctrg->idx))
+		return -EAGAIN;
+
+	rate_ctr_group_aggregate(ctrg);
+	for (i = 0; i < ctrg->desc->num_ctr; i++)
+		shm_entry(shm, OSMO_STATS_SHM_T_RATE_CTR, ctrg->desc->group_name_prefix, ctrg->idx,
+			  ctrg->desc->ctr_desc[i].name, "", ctrg->ctr[i].current);
+	return 0;
+}
+
+static int shm_stat_item_group_handler(struct osmo_stat_item_group *statg, void *data)
+{
+	struct osmo_stats_shm *shm = data;
+	unsigned int i;
+
+	if (!shm_group(shm, statg, statg->desc, statg->idx))
+		return -EAGAIN;
+
+	for (i = 0; i < statg->desc->num_items; i++)
+		shm_entry(shm, OSMO_STATS_SHM_T_STAT_ITEM, statg->desc->group_name_prefix, statg->idx,
+			  statg->desc->item_desc[i].name, "", osmo_stat_item_get_last(statg->items[i]));
+	return 0;
+}
+
+static int shm_stat_hist_group_handler(struct osmo_stat_hist_group *histg, void *data)
+{
+	struct osmo_stats_shm *shm = data;
+	struct osmo_stat_hist_summary sum;
+	unsigned int i;
+
+	if (!shm_group(shm, histg, histg->desc, histg->idx))
+		return -EAGAIN;
+
+	for (i = 0; i < histg->desc->num_hists; i++) {
+		const char *prefix = histg->desc->group_name_prefix;
+		const char *name = histg->desc->hist_desc[i].name;
+
+		osmo_stat_hist_get_summary(&histg->hist[i], &sum);
+		shm_entry(shm, OSMO_STATS_SHM_T_STAT_HIST, prefix, histg->idx, name, ".count", sum.count);
+		shm_entry(shm, OSMO_STATS_SHM_T_STAT_HIST, prefix, histg->idx, name, ".p50", sum.p50);
+		shm_entry(shm, OSMO_STATS_SHM_T_STAT_HIST, prefix, histg->idx, name, ".p90", sum.p90);
+		shm_entry(shm, OSMO_STATS_SHM_T_STAT_HIST, prefix, histg->idx, name, ".p99", sum.p99);
+		shm_entry(shm, OSMO_STATS_SHM_T_STAT_HIST, prefix, histg->idx, name, ".max", sum.max);
+	}
+	return 0;
+}
+
+/* walk over all statistics; returns false if the layout doesn't match */
+static bool shm_walk(struct osmo_stats_shm *shm, enum stats_shm_walk walk)
+{
+	shm->walk = walk;
+	shm->sig_pos = 0;
+	shm->entry_pos = 0;
+	shm->str_len = 0;
+
+	if (osmo_counters_for_each(shm_counter_handler, shm) < 0
+	    || rate_ctr_for_each_group(shm_rate_ctr_group_handler, shm) < 0
+	    || osmo_stat_item_for_each_group(shm_stat_item_group_handler, shm) < 0
+	    || osmo_stat_hist_for_each_group(shm_stat_hist_group_handler, shm) < 0)
+		return false;
+
+	/* groups may have been freed at the end of the list */
+	return walk != STATS_SHM_WALK_VALUES || shm->sig_pos == shm->num_sig;
+}
+
+/* grow the file and its mapping to at least new_size bytes */
+static int shm_grow(struct osmo_stats_shm *shm, size_t new_size)
+{
+	void *mem;
+
+	if (new_size <= shm->size)
+		return 0;
+
+	/* grow in large steps, so the readers rarely need to remap */
+	new_size = OSMO_MAX(new_size, shm->size * 2);
+	if (ftruncate(shm->fd, new_size) < 0)
+		return -errno;
+
+	mem = mmap(NULL, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm->fd, 0);
+	if (mem == MAP_FAILED)
+		return -errno;
+	munmap(shm->hdr, shm->size);
+
+	shm->hdr = mem;
+	shm->size = new_size;
+	shm->hdr->size = new_size;
+	return 0;
+}
+
+/* write a new layout; called while the sequence lock is held */
+static int shm_relayout(struct osmo_stats_shm *shm)
+{
+	struct osmo_stats_shm_hdr *hdr;
+	size_t needed;
+	int rc;
+
+	shm_walk(shm, STATS_SHM_WALK_COUNT);
+
+	if (shm->sig_pos > shm->sig_alloc) {
+		struct stats_shm_sig *sig;
+		sig = talloc_realloc(shm, shm->sig, struct stats_shm_sig, shm->sig_pos * 2);
+		if (!sig)
+			return -ENOMEM;
+		shm->sig = sig;
+		shm->sig_alloc = shm->sig_pos * 2;
+	}
+
+	needed = shm->hdr->entries_offs + shm->entry_pos * sizeof(struct osmo_stats_shm_entry) + shm->str_len;
+	rc = shm_grow(shm, needed);
+	if (rc < 0)
+		return rc;
+
+	hdr = shm->hdr;
+	hdr->num_entries = shm->entry_pos;
+	shm->num_sig = shm->sig_pos;
+	shm->str_offs = hdr->entries_offs + hdr->num_entries * sizeof(struct osmo_stats_shm_entry);
+	shm_walk(shm, STATS_SHM_WALK_LAYOUT);
+
+	hdr->used = shm->str_offs;
+	hdr->generation++;
+	return 0;
+}
+
+/*! Update all values in a stats segment.
+ *  \param[in] shm stats segment to update
+ *  \returns 0 on success; negative on error
+ *
+ *  Called every interval_ms milliseconds by a timer; call it directly to
+ *  make the latest values visible right away. */
+int osmo_stats_shm_update(struct osmo_stats_shm *shm)
+{
+	struct timespec ts;
+	uint64_t seq = shm->hdr->seq;
+	int rc = 0;
+
+	/* sequence lock: the odd value must be visible before any data */
+	__atomic_store_n(&shm->hdr->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	if (!shm_walk(shm, STATS_SHM_WALK_VALUES))
+		rc = shm_relayout(shm);
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	shm->hdr->timestamp_ns = (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+
+	__atomic_store_n(&shm->hdr->seq, seq + 2, __ATOMIC_RELEASE);
+
+	if (rc < 0)
+		LOGP(DLSTATS, LOGL_ERROR, "stats segment %s: cannot update layout: %s\n",
+		     shm->path, strerror(-rc));
+	return rc;
+}
+
+static void shm_timer_cb(void *data)
+{
+	struct osmo_stats_shm *shm = data;
+
+	osmo_stats_shm_update(shm);
+	osmo_timer_schedule(&shm->timer, shm->interval_ms / 1000, (shm->interval_ms % 1000) * 1000);
+}
+
+/*! Create a memory-mapped file and periodically export all statistics to it.
+ *  \param[in] ctx talloc context from which to allocate
+ *  \param[in] path file to create (and replace, if it exists), e.g. "/dev/shm/osmo-bsc.stats"
+ *  \param[in] size initial size of the file in bytes; 0 for a default; the file grows as needed
+ *  \param[in] interval_ms update interval in milliseconds; 0 to only update on osmo_stats_shm_update()
+ *  \returns stats segment on success; NULL on error */
+struct osmo_stats_shm *osmo_stats_shm_open(void *ctx, const char *path, size_t size,
+					   unsigned int interval_ms)
+{
+	struct osmo_stats_shm *shm;
+	struct osmo_stats_shm_hdr *hdr;
+
+	if (!size)
+		size = STATS_SHM_DEFAULT_SIZE;
+	size = OSMO_MAX(size, sizeof(*hdr));
+
+	shm = talloc_zero(ctx, struct osmo_stats_shm);
+	if (!shm)
+		return NULL;
+	shm->path = talloc_strdup(shm, path);
+	shm->interval_ms = interval_ms;
+
+	/* readers might still have an old segment mapped, don't modify it */
+	unlink(path);
+	shm->fd = open(path, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+	if (shm->fd < 0)
+		goto out_free;
+	if (ftruncate(shm->fd, size) < 0)
+		goto out_close;
+
+	hdr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, shm->fd, 0);
+	if (hdr == MAP_FAILED)
+		goto out_close;
+	shm->hdr = hdr;
+	shm->size = size;
+
+	hdr->version = OSMO_STATS_SHM_VERSION;
+	hdr->hdr_len = sizeof(*hdr);
+	hdr->entry_len = sizeof(struct osmo_stats_shm_entry);
+	hdr->pid = getpid();
+	hdr->size = size;
+	hdr->entries_offs = sizeof(*hdr);
+	hdr->used = hdr->entries_offs;
+
+	osmo_stats_shm_update(shm);
+	/* only now the segment is valid; the update may have remapped it */
+	memcpy(shm->hdr->magic, OSMO_STATS_SHM_MAGIC, sizeof(hdr->magic));
+
+	osmo_timer_setup(&shm->timer, shm_timer_cb, shm);
+	if (interval_ms)
+		shm_timer_cb(shm);
+
+	return shm;
+
+out_close:
+	close(shm->fd);
+	unlink(path);
+out_free:
+	LOGP(DLSTATS, LOGL_ERROR, "cannot create stats segment %s: %s\n", path, strerror(errno));
+	talloc_free(shm);
+	return NULL;
+}
+
+/*! Stop exporting statistics and remove the file.
+ *  \param[in] shm stats segment to close */
+void osmo_stats_shm_close(struct osmo_stats_shm *shm)
+{
+	if (!shm)
+		return;
+
+	osmo_timer_del(&shm->timer);
+	munmap(shm->hdr, shm->size);
+	close(shm->fd);
+	unlink(shm->path);
+	talloc_free(shm);
+}
+
+/*! Take a consistent snapshot of a stats segment; for use by readers.
+ *  \param[in] segment start of the segment as mapped by the reader
+ *  \param[in] segment_len length of the reader's mapping
+ *  \param[out] buf buffer to copy the segment to
+ *  \param[in] buf_len size of \a buf
+ *  \returns number of bytes copied; -EINVAL if \a segment is not a valid
+ *  stats segment; -ERANGE if the segment grew beyond \a segment_len and
+ *  needs to be mapped again; -ENOSPC if \a buf is too small; -EAGAIN if
+ *  no consistent copy could be taken */
+int osmo_stats_shm_snapshot(const void *segment, size_t segment_len, void *buf, size_t buf_len)
+{
+	const struct osmo_stats_shm_hdr *hdr = segment;
+	unsigned int tries;
+	uint64_t seq, used;
+
+	if (segment_len < sizeof(*hdr) || memcmp(hdr->magic, OSMO_STATS_SHM_MAGIC, sizeof(hdr->magic))
+	    || hdr->version != OSMO_STATS_SHM_VERSION)
+		return -EINVAL;
+
+	for (tries = 0; tries < 1000; tries++) {
+		seq = __atomic_load_n(&hdr->seq, __ATOMIC_ACQUIRE);
+		if (seq & 1)
+			continue;
+
+		used = __atomic_load_n(&hdr->used, __ATOMIC_RELAXED);
+		if (used > segment_len)
+			return -ERANGE;
+		if (used > buf_len)
+			return -ENOSPC;
+		memcpy(buf, segment, used);
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&hdr->seq, __ATOMIC_RELAXED) == seq)
+			return used;
+	}
+
+	return -EAGAIN;
+}
+
+#endif /* !EMBEDDED */
+
+/*! @} */
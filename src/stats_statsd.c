@@ -30,6 +30,7 @@
 
 #include <osmocom/core/stats.h>
 
+#include <stdio.h>
 #include <string.h>
 #include <stdint.h>
 #include <errno.h>
@@ -38,6 +39,7 @@
 #include <osmocom/core/logging.h>
 #include <osmocom/core/rate_ctr.h>
 #include <osmocom/core/stat_item.h>
+#include <osmocom/core/stat_hist.h>
 #include <osmocom/core/msgb.h>
 #include <osmocom/core/stats.h>
 
@@ -48,6 +50,10 @@ static int osmo_stats_reporter_statsd_send_counter(struct osmo_stats_reporter *s
 static int osmo_stats_reporter_statsd_send_item(struct osmo_stats_reporter *srep,
 	const struct osmo_stat_item_group *statg,
 	const struct osmo_stat_item_desc *desc, int64_t value);
+static int osmo_stats_reporter_statsd_send_hist(struct osmo_stats_reporter *srep,
+	const struct osmo_stat_hist_group *histg,
+	const struct osmo_stat_hist_desc *desc,
+	const struct osmo_stat_hist_summary *sum);
 
 /*! Create a stats_reporter reporting to statsd.  This creates a stats_reporter
  *  instance which reports the related statistics data to statsd.
@@ -64,6 +70,7 @@ struct osmo_stats_reporter *osmo_stats_reporter_create_statsd(const char *name)
 	srep->close = osmo_stats_reporter_udp_close;
 	srep->send_counter = osmo_stats_reporter_statsd_send_counter;
 	srep->send_item = osmo_stats_reporter_statsd_send_item;
+	srep->send_hist = osmo_stats_reporter_statsd_send_hist;
 
 	return srep;
 }
@@ -188,6 +195,40 @@ static int osmo_stats_reporter_statsd_send_item(struct osmo_stats_reporter *srep
 			desc->name, value, "g");
 	}
 }
+
+/* Histograms are sent as one counter of the number of values and one
+ * gauge per percentile, e.g. "bts.0.rtt.p99:230|g" */
+static int osmo_stats_reporter_statsd_send_hist(struct osmo_stats_reporter *srep,
+	const struct osmo_stat_hist_group *histg,
+	const struct osmo_stat_hist_desc *desc,
+	const struct osmo_stat_hist_summary *sum)
+{
+	const struct {
+		const char *suffix;
+		int64_t value;
+		const char *unit;
+	} fields[] = {
+		{ "count", sum->count, "c" },
+		{ "p50", sum->p50, "g" },
+		{ "p90", sum->p90, "g" },
+		{ "p99", sum->p99, "g" },
+		{ "p999", sum->p999, "g" },
+		{ "max", sum->max, "g" },
+	};
+	char name[256];
+	unsigned int i;
+	int rc;
+
+	for (i = 0; i < ARRAY_SIZE(fields); i++) {
+		snprintf(name, sizeof(name), "%s.%s", desc->name, fields[i].suffix);
+		rc = osmo_stats_reporter_statsd_send(srep, histg->desc->group_name_prefix, histg->idx,
+						     name, fields[i].value, fields[i].unit);
+		if (rc < 0)
+			return rc;
+	}
+
+	return 0;
+}
 #endif /* !EMBEDDED */
 
 /* @} */
@@ -123,6 +123,17 @@ int buffer_empty(struct buffer *b)
 	return (b->head == NULL);
 }
 
+/* Return the number of bytes waiting to be flushed. */
+size_t buffer_len(struct buffer *b)
+{
+	struct buffer_data *data;
+	size_t len = 0;
+
+	for (data = b->head; data; data = data->next)
+		len += data->cp - data->sp;
+	return len;
+}
+
 /* Clear and free all allocated data. */
 void buffer_reset(struct buffer *b)
 {
@@ -45,7 +45,11 @@ Boston, MA  02110-1301, USA. */
 #include <osmocom/vty/vty.h>
 #include <osmocom/vty/command.h>
 
+#include <osmocom/core/hash.h>
+#include <osmocom/core/logging.h>
+#include <osmocom/core/logging_internal.h>
 #include <osmocom/core/talloc.h>
+#include <osmocom/core/timer.h>
 #include <osmocom/core/utils.h>
 
 #ifndef MAXPATHLEN
@@ -166,6 +170,7 @@ static const char *node_name_from_prompt(const char *prompt, char *name_buf, siz
 }
 
 static void install_basic_node_commands(int node);
+static void cmd_node_index_rebuild(struct cmd_node *cnode);
 
 /*! Install top node of command vector, without adding basic node commands. */
 static void install_node_bare(struct cmd_node *node, int (*func) (struct vty *))
@@ -228,6 +233,8 @@ void sort_node(void)
 					      vector_active(descvec),
 					      sizeof(void *), cmp_desc);
 				}
+
+			cmd_node_index_rebuild(cnode);
 		}
 }
 
@@ -309,6 +316,54 @@ int cmd_make_strvec2(const char *string, char **indent, vector *strvec_p)
 	return CMD_SUCCESS;
 }
 
+/* Split a line of a config file like cmd_make_strvec2() with indent, but
+ * without allocating anything: the indent and the words are copied to buf,
+ * which must hold twice the length of line plus two bytes.  The words are
+ * set into vline, which is emptied first.  *indent is set to the indent
+ * characters in buf.  Leave vline empty for blank and comment lines. */
+static int config_line_split(const char *line, char *buf, vector vline, const char **indent)
+{
+	const char *cp = line;
+	char *dst = buf;
+
+	vline->active = 0;
+	*indent = "";
+
+	/* Skip white spaces, only simple spaces and tabs are allowed to indent */
+	while (isspace((int)*cp)) {
+		if (*cp != ' ' && *cp != '\t') {
+			/* Ignore blank lines, they appear as leading whitespace with line breaks. */
+			if (*cp == '\n' || *cp == '\r') {
+				cp++;
+				line = cp;
+				continue;
+			}
+			return CMD_ERR_INVALID_INDENT;
+		}
+		cp++;
+	}
+
+	memcpy(dst, line, cp - line);
+	dst[cp - line] = '\0';
+	*indent = dst;
+	dst += cp - line + 1;
+
+	if (*cp == '\0' || *cp == '!' || *cp == '#')
+		return CMD_SUCCESS;
+
+	while (*cp != '\0') {
+		vector_set_index(vline, vector_active(vline), dst);
+		while (*cp != '\0' && !isspace((int)*cp))
+			*dst++ = *cp++;
+		*dst++ = '\0';
+
+		while (isspace((int)*cp))
+			cp++;
+	}
+
+	return CMD_SUCCESS;
+}
+
 /*! Breaking up string into each command piece. I assume given
    character is separated by a space character. Return value is a
    vector which includes char ** data element. */
@@ -838,6 +893,163 @@ static int check_element_exists(struct cmd_node *cnode, const char *cmdstring)
 	return 0;
 }
 
+/* Index of the commands of a node by the first word of their command
+ * string.  Every word of an input line is matched against all commands left
+ * after the previous words; with the index, the first word only needs to be
+ * matched against commands it may abbreviate and against those starting with
+ * a variable, option or the like.  Commands not in that set would not match
+ * the first word and are filtered out by cmd_filter() anyway. */
+struct cmd_node_index {
+	/* number of slots of the node's cmd_vector covered by the index */
+	unsigned int num_slots;
+	/* keywords a command may start with, sorted by word and slot */
+	struct cmd_keyword {
+		const char *word;
+		unsigned int slot;
+	} *keywords;
+	unsigned int num_keywords;
+	/* slots of commands not starting with a keyword */
+	unsigned int *others;
+	unsigned int num_others;
+	/* candidates for recently seen first words, by hash of the word */
+	struct cmd_candidates {
+		char *word;
+		unsigned int *slots;
+		unsigned int num_slots;
+	} cache[16];
+};
+
+/* struct cmd_node_index by node type */
+static vector cmd_node_indexes;
+
+static int cmp_keyword(const struct cmd_keyword *a, const char *word, unsigned int slot)
+{
+	int rc = strcmp(a->word, word);
+
+	if (rc)
+		return rc;
+	return a->slot < slot ? -1 : a->slot > slot;
+}
+
+/* First position in the keywords of idx not sorting before word, slot */
+static unsigned int cmd_keyword_lower_bound(const struct cmd_node_index *idx, const char *word,
+					    unsigned int slot)
+{
+	unsigned int lo = 0, hi = idx->num_keywords;
+
+	while (lo < hi) {
+		unsigned int mid = lo + (hi - lo) / 2;
+		if (cmp_keyword(&idx->keywords[mid], word, slot) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/* Add the command in slot of the cmd_vector of a node to the node's index.
+ * If the index cannot cover the whole cmd_vector, it is not used. */
+static void cmd_node_index_add(struct cmd_node_index *idx, unsigned int slot,
+			       struct cmd_element *cmd)
+{
+	vector descvec;
+	struct desc *desc;
+	unsigned int i, pos;
+
+	for (i = 0; i < ARRAY_SIZE(idx->cache); i++) {
+		talloc_free(idx->cache[i].word);
+		talloc_free(idx->cache[i].slots);
+		idx->cache[i].word = NULL;
+		idx->cache[i].slots = NULL;
+	}
+
+	if (idx->num_slots != slot)
+		goto incomplete;
+
+	/* an empty command never matches a word */
+	if (!cmd || !vector_active(cmd->strvec))
+		goto out;
+
+	descvec = vector_slot(cmd->strvec, 0);
+	for (i = 0; i < vector_active(descvec); i++) {
+		desc = vector_slot(descvec, i);
+		if (desc && (CMD_OPTION(desc->cmd) || CMD_VARARG(desc->cmd) || CMD_VARIABLE(desc->cmd)))
+			break;
+	}
+
+	if (i < vector_active(descvec)) {
+		unsigned int *others;
+
+		others = talloc_realloc(idx, idx->others, unsigned int, idx->num_others + 1);
+		if (!others)
+			goto incomplete;
+		others[idx->num_others++] = slot;
+		idx->others = others;
+		goto out;
+	}
+
+	for (i = 0; i < vector_active(descvec); i++) {
+		struct cmd_keyword *keywords;
+
+		if (!(desc = vector_slot(descvec, i)))
+			continue;
+		keywords = talloc_realloc(idx, idx->keywords, struct cmd_keyword,
+					  idx->num_keywords + 1);
+		if (!keywords)
+			goto incomplete;
+		idx->keywords = keywords;
+		pos = cmd_keyword_lower_bound(idx, desc->cmd, slot);
+		memmove(&keywords[pos + 1], &keywords[pos],
+			(idx->num_keywords - pos) * sizeof(*keywords));
+		keywords[pos].word = desc->cmd;
+		keywords[pos].slot = slot;
+		idx->num_keywords++;
+	}
+
+out:
+	idx->num_slots = slot + 1;
+	return;
+incomplete:
+	idx->num_slots = UINT_MAX;
+}
+
+/* Get the index of the commands of a node, allocating it if needed */
+static struct cmd_node_index *cmd_node_index_get(int ntype)
+{
+	struct cmd_node_index *idx;
+
+	if (!cmd_node_indexes) {
+		cmd_node_indexes = vector_init(VECTOR_MIN_SIZE);
+		if (!cmd_node_indexes)
+			return NULL;
+	}
+
+	idx = vector_lookup_ensure(cmd_node_indexes, ntype);
+	if (!idx) {
+		idx = talloc_zero(tall_vty_cmd_ctx, struct cmd_node_index);
+		if (!idx)
+			return NULL;
+		vector_set_index(cmd_node_indexes, ntype, idx);
+	}
+	return idx;
+}
+
+/* Rebuild the index of the commands of a node after reordering them */
+static void cmd_node_index_rebuild(struct cmd_node *cnode)
+{
+	struct cmd_node_index *idx = cmd_node_index_get(cnode->node);
+	unsigned int i;
+
+	if (!idx)
+		return;
+
+	idx->num_slots = 0;
+	idx->num_keywords = 0;
+	idx->num_others = 0;
+	for (i = 0; i < vector_active(cnode->cmd_vector); i++)
+		cmd_node_index_add(idx, i, vector_slot(cnode->cmd_vector, i));
+}
+
 /*! Install a command into a node
  *  \param[in] ntype Node Type
  *  \param[cmd] element to be installed
@@ -845,6 +1057,8 @@ static int check_element_exists(struct cmd_node *cnode, const char *cmdstring)
 void install_element(int ntype, struct cmd_element *cmd)
 {
 	struct cmd_node *cnode;
+	struct cmd_node_index *idx;
+	unsigned int slot;
 
 	cnode = vector_slot(cmdvec, ntype);
 
@@ -853,10 +1067,13 @@ void install_element(int ntype, struct cmd_element *cmd)
 	 * node so far */
 	OSMO_ASSERT(!check_element_exists(cnode, cmd->string));
 
-	vector_set(cnode->cmd_vector, cmd);
+	slot = vector_set(cnode->cmd_vector, cmd);
 
 	cmd->strvec = cmd_make_descvec(cmd->string, cmd->doc);
 	cmd->cmdsize = cmd_cmdsize(cmd->strvec);
+
+	if ((idx = cmd_node_index_get(ntype)))
+		cmd_node_index_add(idx, slot, cmd);
 }
 
 /* Install a command into VIEW and ENABLE node */
@@ -2290,6 +2507,84 @@ int vty_go_parent(struct vty *vty)
 	return vty->node;
 }
 
+static int cmp_slot(const void *p, const void *q)
+{
+	unsigned int a = *(const unsigned int *)p;
+	unsigned int b = *(const unsigned int *)q;
+
+	return a < b ? -1 : a > b;
+}
+
+/* Get the sorted slots of the commands in the index which may match word */
+static struct cmd_candidates *cmd_node_index_lookup(struct cmd_node_index *idx, const char *word)
+{
+	struct cmd_candidates *c;
+	unsigned int lo, hi, i, n;
+	unsigned int *slots;
+	size_t len;
+
+	c = &idx->cache[osmo_fnv1a(word) % ARRAY_SIZE(idx->cache)];
+	if (c->word && !strcmp(c->word, word))
+		return c;
+
+	/* all keywords starting with word */
+	len = strlen(word);
+	lo = cmd_keyword_lower_bound(idx, word, 0);
+	for (hi = lo; hi < idx->num_keywords; hi++) {
+		if (strncmp(idx->keywords[hi].word, word, len))
+			break;
+	}
+
+	n = hi - lo + idx->num_others;
+	slots = talloc_array(idx, unsigned int, n ? : 1);
+	if (!slots)
+		return NULL;
+	for (i = lo; i < hi; i++)
+		slots[i - lo] = idx->keywords[i].slot;
+	memcpy(&slots[hi - lo], idx->others, idx->num_others * sizeof(*slots));
+	qsort(slots, n, sizeof(*slots), cmp_slot);
+
+	/* a command may start with several keywords, e.g. "(a|b)" */
+	for (i = 0, hi = 0; i < n; i++) {
+		if (!hi || slots[i] != slots[hi - 1])
+			slots[hi++] = slots[i];
+	}
+
+	talloc_free(c->word);
+	talloc_free(c->slots);
+	c->word = talloc_strdup(idx, word);
+	c->slots = slots;
+	c->num_slots = hi;
+	return c;
+}
+
+/* Copy the commands of a node which may match the first word of vline, in
+ * the order of the node's cmd_vector.  Like vector_copy() of the whole
+ * cmd_vector, this is to be filtered by cmd_filter() for every word. */
+static vector cmd_node_candidates(vector vline, int ntype)
+{
+	vector cmd_vector = cmd_node_vector(cmdvec, ntype);
+	struct cmd_node_index *idx = NULL;
+	struct cmd_candidates *c;
+	const char *word;
+	unsigned int i;
+	vector v;
+
+	if (cmd_node_indexes)
+		idx = vector_lookup(cmd_node_indexes, ntype);
+	if (!idx || idx->num_slots != vector_active(cmd_vector)
+	    || !vector_active(vline) || !(word = vector_slot(vline, 0))
+	    || !(c = cmd_node_index_lookup(idx, word)))
+		return vector_copy(cmd_vector);
+
+	v = vector_init(c->num_slots);
+	if (!v)
+		return vector_copy(cmd_vector);
+	for (i = 0; i < c->num_slots; i++)
+		vector_set_index(v, i, vector_slot(cmd_vector, c->slots[i]));
+	return v;
+}
+
 /* Execute command by argument vline vector. */
 static int
 cmd_execute_command_real(vector vline, struct vty *vty,
@@ -2311,8 +2606,8 @@ cmd_execute_command_real(vector vline, struct vty *vty,
 	   argv[] generation */
 	void *cmd_deopt_ctx = NULL;
 
-	/* Make copy of command elements. */
-	cmd_vector = vector_copy(cmd_node_vector(cmdvec, vty->node));
+	/* Make copy of the command elements which may match the first word. */
+	cmd_vector = cmd_node_candidates(vline, vty->node);
 
 	for (index = 0; index < vector_active(vline); index++) {
 		if ((command = vector_slot(vline, index))) {
@@ -2523,8 +2818,8 @@ cmd_execute_command_strict(vector vline, struct vty *vty,
 	enum match_type match = 0;
 	char *command;
 
-	/* Make copy of command element */
-	cmd_vector = vector_copy(cmd_node_vector(cmdvec, vty->node));
+	/* Make copy of the command elements which may match the first word. */
+	cmd_vector = cmd_node_candidates(vline, vty->node);
 
 	for (index = 0; index < vector_active(vline); index++)
 		if ((command = vector_slot(vline, index))) {
@@ -2648,27 +2943,34 @@ int config_from_file(struct vty *vty, FILE * fp)
 {
 	int ret;
 	vector vline;
-	char *indent;
+	const char *indent;
+	char *buf;
 	int cmp;
 	struct vty_parent_node this_node;
 	struct vty_parent_node *parent;
+	unsigned int num_lines = 0, num_cmds = 0;
+	struct timespec start, end;
+
+	osmo_clock_gettime(CLOCK_MONOTONIC, &start);
+
+	/* The words of each line go to the same buffer and vector */
+	buf = talloc_size(tall_vty_cmd_ctx, 2 * VTY_BUFSIZ + 2);
+	vline = vector_init(VECTOR_MIN_SIZE);
+	if (!buf || !vline) {
+		ret = CMD_WARNING;
+		goto out;
+	}
 
 	while (fgets(vty->buf, VTY_BUFSIZ, fp)) {
-		indent = NULL;
-		vline = NULL;
-		ret = cmd_make_strvec2(vty->buf, &indent, &vline);
+		num_lines++;
+		ret = config_line_split(vty->buf, buf, vline, &indent);
 
 		if (ret != CMD_SUCCESS)
 			goto return_invalid_indent;
 
 		/* In case of comment or empty line */
-		if (vline == NULL) {
-			if (indent) {
-				talloc_free(indent);
-				indent = NULL;
-			}
+		if (!vector_active(vline))
 			continue;
-		}
 
 		/* We have a nonempty line. */
 		if (!vty->indent) {
@@ -2728,15 +3030,10 @@ int config_from_file(struct vty *vty, FILE * fp)
 
 		parent = vty_parent(vty);
 		ret = cmd_execute_command_strict(vline, vty, NULL);
-		cmd_free_strvec(vline);
+		num_cmds++;
 
-		if (ret != CMD_SUCCESS && ret != CMD_ERR_NOTHING_TODO) {
-			if (indent) {
-				talloc_free(indent);
-				indent = NULL;
-			}
-			return ret;
-		}
+		if (ret != CMD_SUCCESS && ret != CMD_ERR_NOTHING_TODO)
+			goto out;
 
 		/* If we have stepped down into a child node, push a parent frame.
 		 * The causality is such: we don't expect every single node entry implementation to push
@@ -2754,26 +3051,28 @@ int config_from_file(struct vty *vty, FILE * fp)
 			 * will choose. */
 			vty->indent = NULL;
 		}
-
-		if (indent) {
-			talloc_free(indent);
-			indent = NULL;
-		}
 	}
 	/* Make sure we call go_parent_cb for all remaining indent levels at the end of file */
 	while (vty_parent(vty))
 		vty_go_parent(vty);
 
-	return CMD_SUCCESS;
+	ret = CMD_SUCCESS;
+	goto out;
 
 return_invalid_indent:
+	ret = CMD_ERR_INVALID_INDENT;
+out:
+	osmo_clock_gettime(CLOCK_MONOTONIC, &end);
+	timespecsub(&end, &start, &end);
+	/* programs may read their config file before log_init() */
+	if (osmo_log_info)
+		LOGP(DLGLOBAL, LOGL_INFO, "Read %u config lines, executed %u commands in %ld.%06ld s\n",
+		     num_lines, num_cmds, (long)end.tv_sec, end.tv_nsec / 1000);
+
 	if (vline)
-		cmd_free_strvec(vline);
-	if (indent) {
-		talloc_free(indent);
-		indent = NULL;
-	}
-	return CMD_ERR_INVALID_INDENT;
+		vector_free(vline);
+	talloc_free(buf);
+	return ret;
 }
 
 /* Configration from terminal */
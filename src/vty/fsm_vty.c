@@ -34,6 +34,7 @@
 #include <osmocom/core/fsm.h>
 #include <osmocom/core/logging.h>
 #include <osmocom/core/linuxlist.h>
+#include <osmocom/core/talloc.h>
 
 /*! \file fsm_vty.c
  *  Osmocom FSM introspection via VTY.
@@ -142,19 +143,44 @@ DEFUN(show_fsm, show_fsm_cmd,
 	return CMD_SUCCESS;
 }
 
+/* Position of "show fsm-instances all" */
+struct fsm_inst_stream {
+	struct osmo_fsm_inst_cursor cur;
+};
+
+static int fsm_inst_stream_free(struct fsm_inst_stream *st)
+{
+	osmo_fsm_inst_cursor_stop(&st->cur);
+	return 0;
+}
+
+static int fsm_inst_stream_cb(struct vty *vty, void *data)
+{
+	struct fsm_inst_stream *st = data;
+	struct osmo_fsm_inst *fsmi;
+
+	while (vty_out_stream_more(vty)) {
+		fsmi = osmo_fsm_inst_cursor_next(&st->cur);
+		if (!fsmi)
+			return 0;
+		vty_out_fsm_inst(vty, fsmi);
+	}
+	return 1;
+}
+
 DEFUN(show_fsm_insts, show_fsm_insts_cmd,
 	"show fsm-instances all",
 	SH_FSMI_STR
 	"Display a list of all FSM instances of all finite state machine")
 {
-	struct osmo_fsm *fsm;
-
-	llist_for_each_entry(fsm, &osmo_g_fsms, list) {
-		struct osmo_fsm_inst *fsmi;
-		llist_for_each_entry(fsmi, &fsm->instances, list)
-			vty_out_fsm_inst(vty, fsmi);
-	}
+	struct fsm_inst_stream *st = talloc_zero(vty, struct fsm_inst_stream);
 
+	if (!st)
+		return CMD_WARNING;
+	osmo_fsm_inst_cursor_start(&st->cur);
+	talloc_set_destructor(st, fsm_inst_stream_free);
+	if (vty_out_stream(vty, fsm_inst_stream_cb, st) < 0)
+		return CMD_WARNING;
 	return CMD_SUCCESS;
 }
 
@@ -22,6 +22,7 @@
  *
  */
 
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -35,8 +36,10 @@
 #include <osmocom/vty/misc.h>
 
 #include <osmocom/core/stats.h>
+#include <osmocom/core/talloc.h>
 #include <osmocom/core/counter.h>
 #include <osmocom/core/rate_ctr.h>
+#include <osmocom/core/stat_hist.h>
 
 #define CFG_STATS_STR "Configure stats sub-system\n"
 #define CFG_REPORTER_STR "Configure a stats reporter\n"
@@ -154,6 +157,24 @@ DEFUN(cfg_stats_reporter_remote_port, cfg_stats_reporter_remote_port_cmd,
 		argv[0], "remote port");
 }
 
+DEFUN(cfg_stats_reporter_local_port, cfg_stats_reporter_local_port_cmd,
+	"local-port <1-65535>",
+	"Set the port on which to accept connections\n"
+	"Local port number\n")
+{
+	return set_srep_parameter_int(vty, osmo_stats_reporter_set_local_port,
+		argv[0], "local port");
+}
+
+DEFUN(cfg_no_stats_reporter_local_port, cfg_no_stats_reporter_local_port_cmd,
+	"no local-port",
+	NO_STR
+	"Set the port on which to accept connections\n")
+{
+	return set_srep_parameter_int(vty, osmo_stats_reporter_set_local_port,
+		"0", "local port");
+}
+
 DEFUN(cfg_stats_reporter_mtu, cfg_stats_reporter_mtu_cmd,
 	"mtu <100-65535>",
 	"Set the maximum packet size\n"
@@ -352,6 +373,47 @@ DEFUN(cfg_no_stats_reporter_log, cfg_no_stats_reporter_log_cmd,
 	return CMD_SUCCESS;
 }
 
+DEFUN(cfg_stats_reporter_prometheus, cfg_stats_reporter_prometheus_cmd,
+	"stats reporter prometheus",
+	CFG_STATS_STR CFG_REPORTER_STR "Serve OpenMetrics to Prometheus via HTTP\n")
+{
+	struct osmo_stats_reporter *srep;
+
+	srep = osmo_stats_reporter_find(OSMO_STATS_REPORTER_PROMETHEUS, NULL);
+	if (!srep) {
+		srep = osmo_stats_reporter_create_prometheus(NULL);
+		if (!srep) {
+			vty_out(vty, "%% Unable to create prometheus reporter%s",
+				VTY_NEWLINE);
+			return CMD_WARNING;
+		}
+		srep->max_class = OSMO_STATS_CLASS_GLOBAL;
+	}
+
+	vty->index = srep;
+	vty->node = CFG_STATS_NODE;
+
+	return CMD_SUCCESS;
+}
+
+DEFUN(cfg_no_stats_reporter_prometheus, cfg_no_stats_reporter_prometheus_cmd,
+	"no stats reporter prometheus",
+	NO_STR CFG_STATS_STR CFG_REPORTER_STR "Serve OpenMetrics to Prometheus via HTTP\n")
+{
+	struct osmo_stats_reporter *srep;
+
+	srep = osmo_stats_reporter_find(OSMO_STATS_REPORTER_PROMETHEUS, NULL);
+	if (!srep) {
+		vty_out(vty, "%% No prometheus reporter active%s",
+			VTY_NEWLINE);
+		return CMD_WARNING;
+	}
+
+	osmo_stats_reporter_free(srep);
+
+	return CMD_SUCCESS;
+}
+
 DEFUN(cfg_stats_interval, cfg_stats_interval_cmd,
 	"stats interval <0-65535>",
 	CFG_STATS_STR "Set the reporting interval\n"
@@ -369,6 +431,23 @@ DEFUN(cfg_stats_interval, cfg_stats_interval_cmd,
 	return CMD_SUCCESS;
 }
 
+DEFUN(cfg_stats_batch_size, cfg_stats_batch_size_cmd,
+	"stats batch-size <0-65535>",
+	CFG_STATS_STR "Spread each report across several main loop iterations\n"
+	"Number of changed groups to report per iteration (0 reports all at once)\n")
+{
+	int rc;
+	unsigned int batch_size = atoi(argv[0]);
+	rc = osmo_stats_set_batch_size(batch_size);
+	if (rc < 0) {
+		vty_out(vty, "%% Unable to set batch size: %s%s",
+			strerror(-rc), VTY_NEWLINE);
+		return CMD_WARNING;
+	}
+
+	return CMD_SUCCESS;
+}
+
 DEFUN(show_stats,
       show_stats_cmd,
       "show stats",
@@ -560,12 +639,44 @@ static int rate_ctr_group_handler(struct rate_ctr_group *ctrg, void *sctx_)
 	return 0;
 }
 
+/* Position of "show rate-counters" in the list of counter groups */
+struct rate_ctr_stream {
+	struct rate_ctr_group_cursor cur;
+};
+
+static int rate_ctr_stream_free(struct rate_ctr_stream *st)
+{
+	rate_ctr_group_cursor_stop(&st->cur);
+	return 0;
+}
+
+static int rate_ctr_stream_cb(struct vty *vty, void *data)
+{
+	struct rate_ctr_stream *st = data;
+	struct rate_ctr_group *ctrg;
+
+	while (vty_out_stream_more(vty)) {
+		ctrg = rate_ctr_group_cursor_next(&st->cur);
+		if (!ctrg)
+			return 0;
+		rate_ctr_group_handler(ctrg, vty);
+	}
+	return 1;
+}
+
 DEFUN(show_rate_counters,
       show_rate_counters_cmd,
       "show rate-counters",
       SHOW_STR "Show all rate counters\n")
 {
-	rate_ctr_for_each_group(rate_ctr_group_handler, vty);
+	struct rate_ctr_stream *st = talloc_zero(vty, struct rate_ctr_stream);
+
+	if (!st)
+		return CMD_WARNING;
+	rate_ctr_group_cursor_start(&st->cur);
+	talloc_set_destructor(st, rate_ctr_stream_free);
+	if (vty_out_stream(vty, rate_ctr_stream_cb, st) < 0)
+		return CMD_WARNING;
 	return CMD_SUCCESS;
 }
 
@@ -590,6 +701,12 @@ static int reset_osmo_stat_item_group_handler(struct osmo_stat_item_group *statg
         return 0;
 }
 
+static int reset_osmo_stat_hist_group_handler(struct osmo_stat_hist_group *histg, void *sctx_)
+{
+        osmo_stat_hist_group_reset(histg);
+        return 0;
+}
+
 DEFUN(stats_reset,
       stats_reset_cmd,
       "stats reset",
@@ -597,6 +714,7 @@ DEFUN(stats_reset,
 {
         rate_ctr_for_each_group(reset_rate_ctr_group_handler, NULL);
         osmo_stat_item_for_each_group(reset_osmo_stat_item_group_handler, NULL);
+        osmo_stat_hist_for_each_group(reset_osmo_stat_hist_group_handler, NULL);
 	return CMD_SUCCESS;
 }
 
@@ -612,6 +730,9 @@ static int config_write_stats_reporter(struct vty *vty, struct osmo_stats_report
 	case OSMO_STATS_REPORTER_LOG:
 		vty_out(vty, "stats reporter log%s", VTY_NEWLINE);
 		break;
+	case OSMO_STATS_REPORTER_PROMETHEUS:
+		vty_out(vty, "stats reporter prometheus%s", VTY_NEWLINE);
+		break;
 	}
 
 	vty_out(vty, "  disable%s", VTY_NEWLINE);
@@ -626,6 +747,9 @@ static int config_write_stats_reporter(struct vty *vty, struct osmo_stats_report
 		if (srep->bind_addr_str)
 			vty_out(vty, "  local-ip %s%s",
 				srep->bind_addr_str, VTY_NEWLINE);
+		if (srep->bind_port)
+			vty_out(vty, "  local-port %d%s",
+				srep->bind_port, VTY_NEWLINE);
 		if (srep->mtu)
 			vty_out(vty, "  mtu %d%s",
 				srep->mtu, VTY_NEWLINE);
@@ -661,8 +785,12 @@ static int config_write_stats(struct vty *vty)
 	config_write_stats_reporter(vty, srep);
 	srep = osmo_stats_reporter_find(OSMO_STATS_REPORTER_LOG, NULL);
 	config_write_stats_reporter(vty, srep);
+	srep = osmo_stats_reporter_find(OSMO_STATS_REPORTER_PROMETHEUS, NULL);
+	config_write_stats_reporter(vty, srep);
 
 	vty_out(vty, "stats interval %d%s", osmo_stats_config->interval, VTY_NEWLINE);
+	if (osmo_stats_config->batch_size)
+		vty_out(vty, "stats batch-size %u%s", osmo_stats_config->batch_size, VTY_NEWLINE);
 
 	return 1;
 }
@@ -680,7 +808,10 @@ void osmo_stats_vty_add_cmds()
 	install_element(CONFIG_NODE, &cfg_no_stats_reporter_statsd_cmd);
 	install_element(CONFIG_NODE, &cfg_stats_reporter_log_cmd);
 	install_element(CONFIG_NODE, &cfg_no_stats_reporter_log_cmd);
+	install_element(CONFIG_NODE, &cfg_stats_reporter_prometheus_cmd);
+	install_element(CONFIG_NODE, &cfg_no_stats_reporter_prometheus_cmd);
 	install_element(CONFIG_NODE, &cfg_stats_interval_cmd);
+	install_element(CONFIG_NODE, &cfg_stats_batch_size_cmd);
 
 	install_node(&cfg_stats_node, config_write_stats);
 
@@ -688,6 +819,8 @@ void osmo_stats_vty_add_cmds()
 	install_element(CFG_STATS_NODE, &cfg_no_stats_reporter_local_ip_cmd);
 	install_element(CFG_STATS_NODE, &cfg_stats_reporter_remote_ip_cmd);
 	install_element(CFG_STATS_NODE, &cfg_stats_reporter_remote_port_cmd);
+	install_element(CFG_STATS_NODE, &cfg_stats_reporter_local_port_cmd);
+	install_element(CFG_STATS_NODE, &cfg_no_stats_reporter_local_port_cmd);
 	install_element(CFG_STATS_NODE, &cfg_stats_reporter_mtu_cmd);
 	install_element(CFG_STATS_NODE, &cfg_no_stats_reporter_mtu_cmd);
 	install_element(CFG_STATS_NODE, &cfg_stats_reporter_prefix_cmd);
@@ -160,8 +160,11 @@ static int client_data(struct osmo_fd *fd, unsigned int what)
 
 	if (what & OSMO_FD_WRITE) {
 		rc = buffer_flush_all(conn->vty->obuf, fd->fd);
-		if (rc == BUFFER_EMPTY)
+		if (rc == BUFFER_EMPTY) {
 			conn->fd.when &= ~OSMO_FD_WRITE;
+			/* produce more output of a streaming command, if any */
+			vty_out_stream_resume(conn->vty);
+		}
 	}
 
 	return rc;
@@ -35,6 +35,7 @@
 #include <osmocom/core/timer.h>
 #include <osmocom/core/rate_ctr.h>
 #include <osmocom/core/stat_item.h>
+#include <osmocom/core/stat_hist.h>
 #include <osmocom/core/utils.h>
 #include <osmocom/core/counter.h>
 
@@ -297,6 +298,61 @@ static int osmo_stat_item_group_handler(struct osmo_stat_item_group *statg, void
 	return 0;
 }
 
+static int osmo_stat_hist_handler(
+	struct osmo_stat_hist_group *histg, struct osmo_stat_hist *hist, void *vctx_)
+{
+	struct vty_out_context *vctx = vctx_;
+	struct vty *vty = vctx->vty;
+	struct osmo_stat_hist_summary sum;
+	const char *unit = hist->desc->unit ? hist->desc->unit : "";
+
+	osmo_stat_hist_get_summary(hist, &sum);
+
+	vty_out(vty, " %s%s: %8" PRIu64 " (min %" PRIu32 " p50 %" PRIu32 " p90 %" PRIu32
+		" p99 %" PRIu32 " p99.9 %" PRIu32 " max %" PRIu32 ") %s%s",
+		vctx->prefix, hist->desc->description, sum.count,
+		sum.min, sum.p50, sum.p90, sum.p99, sum.p999, sum.max,
+		unit, VTY_NEWLINE);
+
+	return 0;
+}
+
+/*! print a stat histogram group to given VTY
+ *  \param[in] vty The VTY to which it should be printed
+ *  \param[in] prefix Any additional log prefix ahead of each line
+ *  \param[in] histg Histogram group to be printed
+ */
+void vty_out_stat_hist_group(struct vty *vty, const char *prefix,
+			     struct osmo_stat_hist_group *histg)
+{
+	struct vty_out_context vctx = {vty, prefix};
+
+	vty_out(vty, "%s%s:%s", prefix, histg->desc->group_description,
+		VTY_NEWLINE);
+	osmo_stat_hist_for_each_hist(histg, osmo_stat_hist_handler, &vctx);
+}
+
+static int osmo_stat_hist_group_handler(struct osmo_stat_hist_group *histg, void *vctx_)
+{
+	struct vty_out_context *vctx = vctx_;
+	struct vty *vty = vctx->vty;
+
+	if (histg->desc->class_id > vctx->max_level)
+		return 0;
+
+	if (histg->idx)
+		vty_out(vty, "%s%s (%d):%s", vctx->prefix,
+			histg->desc->group_description, histg->idx,
+			VTY_NEWLINE);
+	else
+		vty_out(vty, "%s%s:%s", vctx->prefix,
+			histg->desc->group_description, VTY_NEWLINE);
+
+	osmo_stat_hist_for_each_hist(histg, osmo_stat_hist_handler, vctx);
+
+	return 0;
+}
+
 /*! @} */
 
 /*! \addtogroup vty
@@ -328,6 +384,7 @@ void vty_out_statistics_partial(struct vty *vty, const char *prefix,
 	osmo_counters_for_each(handle_counter, &vctx);
 	rate_ctr_for_each_group(rate_ctr_group_handler, &vctx);
 	osmo_stat_item_for_each_group(osmo_stat_item_group_handler, &vctx);
+	osmo_stat_hist_for_each_group(osmo_stat_hist_group_handler, &vctx);
 }
 
 void vty_out_statistics_full(struct vty *vty, const char *prefix)
@@ -332,6 +332,106 @@ int vty_out_newline(struct vty *vty)
 	return 0;
 }
 
+/* Amount of pending output up to which more output of a streamed command
+ * is produced before waiting for the socket to drain */
+#define VTY_OUT_STREAM_CHUNK	16384
+
+/* State of a command producing its output piecewise */
+struct vty_out_stream {
+	vty_out_stream_cb_t cb;
+	void *data;
+};
+
+static void vty_prompt(struct vty *vty);
+
+static void vty_out_stream_end(struct vty *vty)
+{
+	talloc_free(vty->stream);
+	vty->stream = NULL;
+}
+
+/* Produce output of the streamed command until VTY_OUT_STREAM_CHUNK bytes
+ * are pending.  Returns true if the command is done. */
+static bool vty_out_stream_fill(struct vty *vty)
+{
+	struct vty_out_stream *stream = vty->stream;
+
+	while (buffer_len(vty->obuf) < VTY_OUT_STREAM_CHUNK) {
+		if (stream->cb(vty, stream->data) <= 0) {
+			vty_out_stream_end(vty);
+			return true;
+		}
+	}
+	return false;
+}
+
+/*! Produce the output of a command piecewise.
+ *  \param[in] vty VTY to which to print
+ *  \param[in] cb call-back producing the next part of the output
+ *  \param[in] data talloc-allocated state passed to \a cb, or NULL; it
+ *  is freed once the output is complete or the VTY is closed
+ *  \returns 0 on success; negative on error
+ *
+ *  Commands with possibly huge output call this instead of printing all
+ *  of it at once, and return CMD_SUCCESS.  On a VTY_TERM VTY, \a cb is
+ *  called while less than a few KiB of output are pending, and again
+ *  whenever the pending output was written to the socket, which is
+ *  signalled by \ref vty_out_stream_resume; in between, the event loop
+ *  handles other work.  The prompt is printed after \a cb returned 0.
+ *  Ctrl-C aborts the output, any other input received meanwhile is
+ *  discarded.  Using \ref vty_out_stream_more, \a cb can print as much
+ *  as fits before being called again.  On other VTYs, \a cb is called
+ *  until it returns 0 right away. */
+int vty_out_stream(struct vty *vty, vty_out_stream_cb_t cb, void *data)
+{
+	struct vty_out_stream *stream;
+	int rc;
+
+	if (vty->stream) {
+		talloc_free(data);
+		return -EBUSY;
+	}
+
+	if (vty->type != VTY_TERM) {
+		while ((rc = cb(vty, data)) > 0);
+		talloc_free(data);
+		return rc < 0 ? rc : 0;
+	}
+
+	stream = talloc_zero(vty, struct vty_out_stream);
+	if (!stream) {
+		talloc_free(data);
+		return -ENOMEM;
+	}
+	stream->cb = cb;
+	stream->data = talloc_steal(stream, data);
+	vty->stream = stream;
+
+	/* if already done, the prompt is printed after the command returned */
+	vty_out_stream_fill(vty);
+	return 0;
+}
+
+/*! Check whether a call-back passed to \ref vty_out_stream may print more
+ *  output before returning.
+ *  \param[in] vty VTY to which the call-back prints
+ *  \returns true if more output fits */
+bool vty_out_stream_more(struct vty *vty)
+{
+	return !vty->stream || buffer_len(vty->obuf) < VTY_OUT_STREAM_CHUNK;
+}
+
+/*! Continue the output of a command passed to \ref vty_out_stream.
+ *  \param[in] vty VTY whose pending output was written to its socket
+ *
+ *  This is called by the telnet interface, or by whoever else writes the
+ *  output of a VTY_TERM VTY to its socket. */
+void vty_out_stream_resume(struct vty *vty)
+{
+	if (vty->stream && vty_out_stream_fill(vty))
+		vty_prompt(vty);
+}
+
 /*! return the current index of a given VTY */
 void *vty_current_index(struct vty *vty)
 {
@@ -709,7 +809,8 @@ static int vty_execute(struct vty *vty)
 	vty->cp = vty->length = 0;
 	vty_clear_buf(vty);
 
-	if (vty->status != VTY_CLOSE)
+	/* a command streaming its output prints the prompt when done */
+	if (vty->status != VTY_CLOSE && !vty->stream)
 		vty_prompt(vty);
 
 	return ret;
@@ -1321,6 +1422,17 @@ int vty_read(struct vty *vty)
 			continue;
 		}
 
+		/* While a command is streaming its output, only Ctrl-C is handled */
+		if (vty->stream) {
+			if (buf[i] == CONTROL('C')) {
+				vty_out_stream_end(vty);
+				buffer_reset(vty->obuf);
+				vty_out(vty, "%s", VTY_NEWLINE);
+				vty_prompt(vty);
+			}
+			continue;
+		}
+
 		if (vty->status == VTY_MORE) {
 			switch (buf[i]) {
 			case CONTROL('C'):
@@ -0,0 +1,294 @@
+/* compare the unpacked/packed/soft bit conversions against plain loops */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include <osmocom/core/utils.h>
+#include <osmocom/core/bits.h>
+#include <osmocom/core/simd_internal.h>
+
+/* The reference implementations are the bit by bit loops of bits.c, as
+ * they were before the conversions got vectorized. */
+
+static int ref_ubit2pbit(pbit_t *out, const ubit_t *in, unsigned int num_bits)
+{
+	unsigned int i;
+	uint8_t curbyte = 0;
+	pbit_t *outptr = out;
+
+	for (i = 0; i < num_bits; i++) {
+		uint8_t bitnum = 7 - (i % 8);
+
+		curbyte |= (in[i] << bitnum);
+
+		if (i % 8 == 7) {
+			*outptr++ = curbyte;
+			curbyte = 0;
+		}
+	}
+	if (i % 8)
+		*outptr++ = curbyte;
+
+	return outptr - out;
+}
+
+static int ref_pbit2ubit(ubit_t *out, const pbit_t *in, unsigned int num_bits)
+{
+	unsigned int i, b;
+	ubit_t *cur = out;
+	ubit_t *limit = out + num_bits;
+
+	for (i = 0; i < (num_bits / 8) + 1; i++) {
+		for (b = 0; b < 8; b++) {
+			*cur++ = (in[i] >> (7 - b)) & 1;
+			if (cur >= limit)
+				return cur - out;
+		}
+	}
+	return cur - out;
+}
+
+static void ref_ubit2sbit(sbit_t *out, const ubit_t *in, unsigned int num_bits)
+{
+	unsigned int i;
+	for (i = 0; i < num_bits; i++)
+		out[i] = in[i] ? -127 : 127;
+}
+
+static void ref_sbit2ubit(ubit_t *out, const sbit_t *in, unsigned int num_bits)
+{
+	unsigned int i;
+	for (i = 0; i < num_bits; i++)
+		out[i] = in[i] < 0;
+}
+
+static int ref_ubit2pbit_ext(pbit_t *out, unsigned int out_ofs,
+			     const ubit_t *in, unsigned int in_ofs,
+			     unsigned int num_bits, int lsb_mode)
+{
+	unsigned int i, op, bn;
+	for (i = 0; i < num_bits; i++) {
+		op = out_ofs + i;
+		bn = lsb_mode ? (op & 7) : (7 - (op & 7));
+		if (in[in_ofs + i])
+			out[op >> 3] |= 1 << bn;
+		else
+			out[op >> 3] &= ~(1 << bn);
+	}
+	return ((out_ofs + num_bits - 1) >> 3) + 1;
+}
+
+static int ref_pbit2ubit_ext(ubit_t *out, unsigned int out_ofs,
+			     const pbit_t *in, unsigned int in_ofs,
+			     unsigned int num_bits, int lsb_mode)
+{
+	unsigned int i, ip, bn;
+	for (i = 0; i < num_bits; i++) {
+		ip = in_ofs + i;
+		bn = lsb_mode ? (ip & 7) : (7 - (ip & 7));
+		out[out_ofs + i] = !!(in[ip >> 3] & (1 << bn));
+	}
+	return out_ofs + num_bits;
+}
+
+#define NUM_CASES	2000
+#define MAX_BITS	400
+#define MAX_OFS		40
+/* room for offset and bits, and for detecting writes past the end */
+#define BUF_LEN		(MAX_OFS + MAX_BITS + 64)
+
+static uint8_t in[BUF_LEN], out[BUF_LEN], ref_out[BUF_LEN];
+
+static void fill_random(uint8_t *buf, unsigned int len)
+{
+	unsigned int i;
+	for (i = 0; i < len; i++)
+		buf[i] = rand();
+}
+
+/* Random unpacked bits.  If any_value, up to three of them are neither
+ * 0 nor 1, so that the vector steps before and after them run, too. */
+static void fill_ubits(uint8_t *buf, unsigned int len, bool any_value)
+{
+	unsigned int i, n;
+
+	for (i = 0; i < len; i++)
+		buf[i] = rand() & 1;
+	if (!any_value)
+		return;
+	for (n = rand() % 4; n; n--)
+		buf[rand() % len] = 2 + rand() % 254;
+}
+
+/* the same random garbage in both output buffers */
+static void prepare_out(void)
+{
+	fill_random(out, sizeof(out));
+	memcpy(ref_out, out, sizeof(out));
+}
+
+static void check(const char *name, unsigned int num_bits, unsigned int in_ofs,
+		  unsigned int out_ofs, int rc, int ref_rc)
+{
+	if (rc == ref_rc && !memcmp(out, ref_out, sizeof(out)))
+		return;
+	printf("%s: mismatch for num_bits=%u in_ofs=%u out_ofs=%u: rc=%d, expected %d\n",
+	       name, num_bits, in_ofs, out_ofs, rc, ref_rc);
+	printf("  got:      %s\n", osmo_hexdump_nospc(out, sizeof(out)));
+	printf("  expected: %s\n", osmo_hexdump_nospc(ref_out, sizeof(ref_out)));
+	exit(1);
+}
+
+static void test_ubit2pbit(bool any_value)
+{
+	unsigned int n, num_bits;
+	int rc, ref_rc;
+
+	for (n = 0; n < NUM_CASES; n++) {
+		num_bits = rand() % (MAX_BITS + 1);
+		fill_ubits(in, sizeof(in), any_value);
+		prepare_out();
+		rc = osmo_ubit2pbit(out, in, num_bits);
+		ref_rc = ref_ubit2pbit(ref_out, in, num_bits);
+		check(__func__, num_bits, 0, 0, rc, ref_rc);
+	}
+	printf("%s(%s): %u random cases match\n", __func__, any_value ? "any values" : "0 and 1", n);
+}
+
+static void test_pbit2ubit(void)
+{
+	unsigned int n, num_bits;
+	int rc, ref_rc;
+
+	for (n = 0; n < NUM_CASES; n++) {
+		num_bits = rand() % (MAX_BITS + 1);
+		fill_random(in, sizeof(in));
+		prepare_out();
+		rc = osmo_pbit2ubit(out, in, num_bits);
+		ref_rc = ref_pbit2ubit(ref_out, in, num_bits);
+		check(__func__, num_bits, 0, 0, rc, ref_rc);
+	}
+	printf("%s: %u random cases match\n", __func__, n);
+}
+
+static void test_ubit2sbit(bool any_value)
+{
+	unsigned int n, num_bits;
+
+	for (n = 0; n < NUM_CASES; n++) {
+		num_bits = rand() % (MAX_BITS + 1);
+		fill_ubits(in, sizeof(in), any_value);
+		prepare_out();
+		osmo_ubit2sbit((sbit_t *) out, in, num_bits);
+		ref_ubit2sbit((sbit_t *) ref_out, in, num_bits);
+		check(__func__, num_bits, 0, 0, 0, 0);
+	}
+	printf("%s(%s): %u random cases match\n", __func__, any_value ? "any values" : "0 and 1", n);
+}
+
+static void test_sbit2ubit(void)
+{
+	unsigned int n, num_bits;
+
+	for (n = 0; n < NUM_CASES; n++) {
+		num_bits = rand() % (MAX_BITS + 1);
+		fill_random(in, sizeof(in));
+		prepare_out();
+		osmo_sbit2ubit(out, (const sbit_t *) in, num_bits);
+		ref_sbit2ubit(ref_out, (const sbit_t *) in, num_bits);
+		check(__func__, num_bits, 0, 0, 0, 0);
+	}
+	printf("%s: %u random cases match\n", __func__, n);
+}
+
+static void test_ubit2pbit_ext(bool any_value, int lsb_mode)
+{
+	unsigned int n, num_bits, in_ofs, out_ofs;
+	int rc, ref_rc;
+
+	for (n = 0; n < NUM_CASES; n++) {
+		num_bits = rand() % (MAX_BITS + 1);
+		in_ofs = rand() % (MAX_OFS + 1);
+		out_ofs = rand() % (MAX_OFS + 1);
+		fill_ubits(in, sizeof(in), any_value);
+		prepare_out();
+		rc = osmo_ubit2pbit_ext(out, out_ofs, in, in_ofs, num_bits, lsb_mode);
+		ref_rc = ref_ubit2pbit_ext(ref_out, out_ofs, in, in_ofs, num_bits, lsb_mode);
+		check(__func__, num_bits, in_ofs, out_ofs, rc, ref_rc);
+	}
+	printf("%s(%s, %s): %u random cases match\n", __func__, any_value ? "any values" : "0 and 1",
+	       lsb_mode ? "LSB first" : "MSB first", n);
+}
+
+static void test_pbit2ubit_ext(int lsb_mode)
+{
+	unsigned int n, num_bits, in_ofs, out_ofs;
+	int rc, ref_rc;
+
+	for (n = 0; n < NUM_CASES; n++) {
+		num_bits = rand() % (MAX_BITS + 1);
+		in_ofs = rand() % (MAX_OFS + 1);
+		out_ofs = rand() % (MAX_OFS + 1);
+		fill_random(in, sizeof(in));
+		prepare_out();
+		rc = osmo_pbit2ubit_ext(out, out_ofs, in, in_ofs, num_bits, lsb_mode);
+		ref_rc = ref_pbit2ubit_ext(ref_out, out_ofs, in, in_ofs, num_bits, lsb_mode);
+		check(__func__, num_bits, in_ofs, out_ofs, rc, ref_rc);
+	}
+	printf("%s(%s): %u random cases match\n", __func__, lsb_mode ? "LSB first" : "MSB first", n);
+}
+
+/* Run the tests without the AVX2 kernels, or with them if the CPU
+ * supports them; the SSE2 code is not used on such CPUs else */
+static void use_no_avx2(int no_avx2)
+{
+#ifdef HAVE_AVX2
+	osmo_bits_avx2_enable(!no_avx2);
+#endif
+	printf("Using the %s code\n", no_avx2 ? "non-AVX2" : "default");
+}
+
+int main(int argc, char **argv)
+{
+	int no_avx2;
+
+	for (no_avx2 = 0; no_avx2 <= 1; no_avx2++) {
+		srand(0);
+		use_no_avx2(no_avx2);
+		test_ubit2pbit(false);
+		test_ubit2pbit(true);
+		test_pbit2ubit();
+		test_ubit2sbit(false);
+		test_ubit2sbit(true);
+		test_sbit2ubit();
+		test_ubit2pbit_ext(false, 0);
+		test_ubit2pbit_ext(false, 1);
+		test_ubit2pbit_ext(true, 0);
+		test_ubit2pbit_ext(true, 1);
+		test_pbit2ubit_ext(0);
+		test_pbit2ubit_ext(1);
+	}
+
+	return 0;
+}
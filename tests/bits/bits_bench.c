@@ -0,0 +1,120 @@
+/*
+ * Throughput benchmark for the conversions between unpacked, packed and
+ * soft bits, for the sizes of a burst and of a coded block.  Not part of
+ * the test suite, as the results depend on the machine; run manually:
+ *
+ *   ./tests/bits/bits_bench [num_iter]
+ */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <osmocom/core/bits.h>
+#include <osmocom/core/utils.h>
+
+static unsigned long num_iter = 1000000;
+
+static ubit_t ubits[1024];
+static sbit_t sbits[1024];
+static pbit_t pbits[1024 / 8 + 1];
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char *label, unsigned int num_bits, double elapsed)
+{
+	printf("%-18s %4u bits: %7.1f ns/call, %.2f ns/bit\n", label, num_bits,
+	       elapsed * 1e9 / num_iter, elapsed * 1e9 / num_iter / num_bits);
+}
+
+static void bench_size(unsigned int num_bits)
+{
+	unsigned long i;
+	double start;
+
+	start = now();
+	for (i = 0; i < num_iter; i++)
+		osmo_ubit2pbit(pbits, ubits, num_bits);
+	report("ubit2pbit", num_bits, now() - start);
+
+	start = now();
+	for (i = 0; i < num_iter; i++)
+		osmo_pbit2ubit(ubits, pbits, num_bits);
+	report("pbit2ubit", num_bits, now() - start);
+
+	start = now();
+	for (i = 0; i < num_iter; i++)
+		osmo_ubit2sbit(sbits, ubits, num_bits);
+	report("ubit2sbit", num_bits, now() - start);
+
+	start = now();
+	for (i = 0; i < num_iter; i++)
+		osmo_sbit2ubit(ubits, sbits, num_bits);
+	report("sbit2ubit", num_bits, now() - start);
+
+	/* at an offset into the packed bits, as for the header and data of
+	 * a block */
+	start = now();
+	for (i = 0; i < num_iter; i++)
+		osmo_ubit2pbit_ext(pbits, 3, ubits, 0, num_bits - 8, 0);
+	report("ubit2pbit_ext", num_bits - 8, now() - start);
+
+	start = now();
+	for (i = 0; i < num_iter; i++)
+		osmo_pbit2ubit_ext(ubits, 0, pbits, 3, num_bits - 8, 0);
+	report("pbit2ubit_ext", num_bits - 8, now() - start);
+
+	start = now();
+	for (i = 0; i < num_iter; i++)
+		osmo_ubit2pbit_ext(pbits, 0, ubits, 0, num_bits, 1);
+	report("ubit2pbit_ext lsb", num_bits, now() - start);
+
+	start = now();
+	for (i = 0; i < num_iter; i++)
+		osmo_pbit2ubit_ext(ubits, 0, pbits, 0, num_bits, 1);
+	report("pbit2ubit_ext lsb", num_bits, now() - start);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int i;
+
+	if (argc > 1)
+		num_iter = strtoul(argv[1], NULL, 10);
+	if (num_iter < 1)
+		num_iter = 1;
+
+	srandom(0);
+	for (i = 0; i < ARRAY_SIZE(ubits); i++)
+		ubits[i] = random() & 1;
+	osmo_ubit2sbit(sbits, ubits, ARRAY_SIZE(ubits));
+
+	/* a normal burst, a coded xCCH block and the bits of 8-PSK bursts */
+	bench_size(116);
+	bench_size(456);
+	bench_size(1024);
+
+	return 0;
+}
@@ -0,0 +1,199 @@
+/*
+ * Throughput benchmark for the bit vector field accessors, alone and as
+ * used by the System Information rest octet encoders.  Not part of the
+ * test suite, as the results depend on the machine; run manually:
+ *
+ *   ./tests/bitvec/bitvec_bench [num_iter]
+ */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <osmocom/core/bitvec.h>
+#include <osmocom/core/utils.h>
+#include <osmocom/gsm/sysinfo.h>
+#include <osmocom/gsm/gsm48_rest_octets.h>
+
+static unsigned long num_iter = 1000000;
+
+static uint8_t data[64];
+static struct bitvec bv = { .data = data, .data_len = sizeof(data) };
+
+static struct osmo_gsm48_si_ro_info si3, si4;
+static struct osmo_gsm48_si6_ro_info si6;
+static struct osmo_gsm48_si13_info si13;
+
+static uint16_t earfcn_arfcn[8];
+static uint8_t earfcn_meas_bw[8];
+static struct osmo_earfcn_si2q earfcn = {
+	.arfcn = earfcn_arfcn,
+	.meas_bw = earfcn_meas_bw,
+	.length = ARRAY_SIZE(earfcn_arfcn),
+	.thresh_hi = 5,
+	.thresh_lo = 3,
+	.thresh_lo_valid = true,
+	.prio = 2,
+	.prio_valid = true,
+	.qrxlm = 10,
+	.qrxlm_valid = true,
+};
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Fields of the sizes found in RLC/MAC headers and rest octets */
+static const unsigned int field_len[] = { 1, 3, 5, 6, 1, 2, 7, 11, 1, 4, 16, 6, 8, 3, 12, 2 };
+
+static void write_fields(void)
+{
+	unsigned int i, idx = 3;
+
+	for (i = 0; i < ARRAY_SIZE(field_len); i++)
+		bitvec_write_field(&bv, &idx, i * 0x9e3779b9, field_len[i]);
+}
+
+static void read_fields(void)
+{
+	unsigned int i, idx = 3;
+
+	for (i = 0; i < ARRAY_SIZE(field_len); i++)
+		bitvec_read_field(&bv, &idx, field_len[i]);
+}
+
+static void set_uint_padding(void)
+{
+	unsigned int i;
+
+	bv.cur_bit = 0;
+	for (i = 0; i < ARRAY_SIZE(field_len); i++)
+		bitvec_set_uint(&bv, i * 0x9e3779b9, field_len[i]);
+	bitvec_spare_padding(&bv, 8 * 23 - 1);
+}
+
+/* Copy 20 bytes in and out at an offset of 3 bits */
+static void bytes_unaligned(void)
+{
+	uint8_t buf[20];
+
+	bv.cur_bit = 3;
+	bitvec_get_bytes(&bv, buf, sizeof(buf));
+	bv.cur_bit = 3;
+	bitvec_set_bytes(&bv, buf, sizeof(buf));
+}
+
+static void si2quater(void)
+{
+	size_t u_offset = 0, e_offset = 0;
+
+	osmo_gsm48_rest_octets_si2quater_encode(data, 0, 0, NULL, &u_offset, 0, NULL,
+						&earfcn, &e_offset);
+}
+
+static void si3_ro(void)
+{
+	osmo_gsm48_rest_octets_si3_encode(data, &si3);
+}
+
+static void si4_ro(void)
+{
+	osmo_gsm48_rest_octets_si4_encode(data, &si4, 23 - 10);
+}
+
+static void si6_ro(void)
+{
+	osmo_gsm48_rest_octets_si6_encode(data, &si6);
+}
+
+static void si13_ro(void)
+{
+	osmo_gsm48_rest_octets_si13_encode(data, &si13);
+}
+
+static const struct {
+	const char *name;
+	void (*func)(void);
+} benchmarks[] = {
+	{ "write_field", write_fields },
+	{ "read_field", read_fields },
+	{ "set_uint+padding", set_uint_padding },
+	{ "bytes unaligned", bytes_unaligned },
+	{ "si2quater", si2quater },
+	{ "si3", si3_ro },
+	{ "si4", si4_ro },
+	{ "si6", si6_ro },
+	{ "si13", si13_ro },
+};
+
+int main(int argc, char **argv)
+{
+	unsigned long i;
+	unsigned int j;
+	double start, elapsed;
+
+	if (argc > 1)
+		num_iter = strtoul(argv[1], NULL, 10);
+	if (num_iter < 1)
+		num_iter = 1;
+
+	osmo_earfcn_init(&earfcn);
+	for (j = 0; j < 4; j++)
+		osmo_earfcn_add(&earfcn, 1000 + 100 * j, j);
+
+	si3.selection_params.present = 1;
+	si3.selection_params.cell_resel_off = 10;
+	si3.power_offset.present = 1;
+	si3.scheduling.present = 1;
+	si3.gprs_ind.present = 1;
+	si3.gprs_ind.ra_colour = 5;
+	si3.si2quater_indicator = true;
+	si4 = si3;
+	si4.lsa_params.present = 1;
+	si4.lsa_params.mcc = 262;
+	si4.lsa_params.mnc = 42;
+	si4.cell_id = 0x1234;
+
+	si6.pch_nch_info.present = true;
+	si6.vbs_vgcs_options.present = true;
+	si6.dtm_support.present = true;
+	si6.dtm_support.rac = 0x42;
+	si6.gprs_ms_txpwr_max_ccch.present = true;
+
+	si13.bcch_change_mark = 3;
+	si13.rac = 0x42;
+	si13.spgc_ccch_sup = 1;
+
+	for (j = 0; j < ARRAY_SIZE(benchmarks); j++) {
+		start = now();
+		for (i = 0; i < num_iter; i++)
+			benchmarks[j].func();
+		elapsed = now() - start;
+
+		printf("%-16s %lu calls in %.3f s: %.1f ns/call\n",
+		       benchmarks[j].name, num_iter, elapsed, elapsed * 1e9 / num_iter);
+	}
+
+	return 0;
+}
@@ -261,6 +261,95 @@ static void test_bitvec_read_field(void)
 	_bitvec_read_field(8 * 8, 16); /* 16 bits past */
 }
 
+static uint64_t get_bits_ref(const struct bitvec *bv, unsigned int pos, unsigned int len)
+{
+	uint64_t val = 0;
+	unsigned int i;
+
+	for (i = 0; i < len; i++)
+		val = (val << 1) | bitvec_get_bit_pos(bv, pos + i);
+
+	return val;
+}
+
+static void set_bits_ref(struct bitvec *bv, unsigned int pos, uint64_t val,
+			 unsigned int len, bool use_lh)
+{
+	unsigned int i;
+	int bit;
+
+	for (i = 0; i < len; i++) {
+		bit = (val >> (len - i - 1)) & 1;
+		bitvec_set_bit_pos(bv, pos + i, use_lh ? (bit ? H : L) : bit);
+	}
+}
+
+/* Compare the field and byte accessors with bit by bit access, at all
+ * positions and lengths inside the vector */
+static void test_fields(void)
+{
+	const enum bit_value fills[] = { ZERO, ONE, L, H };
+	uint8_t d[20], ref_d[20], bytes[21];
+	struct bitvec bv = { .data = d, .data_len = sizeof(d) };
+	struct bitvec ref = { .data = ref_d, .data_len = sizeof(ref_d) };
+	unsigned int pos, len, i, idx, errors = 0;
+	uint64_t val;
+
+	printf("test field access\n");
+
+	for (pos = 0; pos <= 8 * sizeof(d); pos++) {
+		for (len = 0; len <= 64 && pos + len <= 8 * sizeof(d); len++) {
+			for (i = 0; i < sizeof(d); i++)
+				d[i] = ref_d[i] = random();
+			val = ((uint64_t) random() << 40) ^ ((uint64_t) random() << 20) ^ random();
+
+			idx = pos;
+			if (bitvec_read_field(&bv, &idx, len) != get_bits_ref(&ref, pos, len) ||
+			    idx != pos + len || bv.cur_bit != pos + len)
+				errors++;
+
+			bv.cur_bit = pos;
+			if (len <= 32 && (bitvec_get_uint(&bv, len) != (int) get_bits_ref(&ref, pos, len) ||
+					  bv.cur_bit != pos + len))
+				errors++;
+
+			bv.cur_bit = pos;
+			bitvec_set_u64(&bv, val, len, len & 1);
+			set_bits_ref(&ref, pos, val, len, len & 1);
+			if (memcmp(d, ref_d, sizeof(d)) || bv.cur_bit != pos + len)
+				errors++;
+
+			bv.cur_bit = pos;
+			bitvec_fill(&bv, len, fills[val % 4]);
+			set_bits_ref(&ref, pos, (fills[val % 4] == ONE || fills[val % 4] == H) ? ~0ULL : 0,
+				     len, fills[val % 4] == L || fills[val % 4] == H);
+			if (memcmp(d, ref_d, sizeof(d)) || bv.cur_bit != pos + len)
+				errors++;
+		}
+
+		for (len = 0; pos / 8 + len + (pos % 8 ? 1 : 0) <= sizeof(d); len++) {
+			for (i = 0; i < sizeof(d); i++)
+				d[i] = ref_d[i] = bytes[i] = random();
+
+			bv.cur_bit = pos;
+			bitvec_get_bytes(&bv, bytes, len);
+			for (i = 0; i < len; i++) {
+				if (bytes[i] != get_bits_ref(&ref, pos + 8 * i, 8))
+					errors++;
+			}
+
+			bv.cur_bit = pos;
+			bitvec_set_bytes(&bv, bytes + 1, len);
+			for (i = 0; i < len; i++)
+				set_bits_ref(&ref, pos + 8 * i, bytes[i + 1], 8, false);
+			if (memcmp(d, ref_d, sizeof(d)) || bv.cur_bit != pos + 8 * len)
+				errors++;
+		}
+	}
+
+	printf("%u errors\n", errors);
+}
+
 int main(int argc, char **argv)
 {
 	struct bitvec bv;
@@ -373,6 +462,9 @@ int main(int argc, char **argv)
 	printf("\ntest bitvec_read_field():\n");
 	test_bitvec_read_field();
 
+	printf("\n");
+	test_fields();
+
 	printf("\nbitvec ok.\n");
 	return 0;
 }
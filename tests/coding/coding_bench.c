@@ -0,0 +1,551 @@
+/*
+ * End-to-end throughput benchmark of the channel encoders and decoders of
+ * gsm0503_coding.h, from L2 payload to bursts and back, with each of the
+ * SIMD backends of the Viterbi decoder this CPU supports.  Inputs are
+ * generated from a fixed seed, so runs on different machines or builds
+ * process the same blocks.  Not part of the test suite, as the results
+ * depend on the machine; run manually:
+ *
+ *   ./tests/coding/coding_bench [num_blocks]
+ *
+ * One CSV line is printed per backend, channel and direction:
+ *
+ *   backend,channel,op,blocks,seconds,blocks_per_s,ns_per_block,cycles_per_block
+ *
+ * where cycles are TSC ticks on x86 and left empty elsewhere.
+ */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#include <osmocom/core/bits.h>
+#include <osmocom/core/conv.h>
+#include <osmocom/core/simd_internal.h>
+#include <osmocom/core/crcgen.h>
+#include <osmocom/core/utils.h>
+#include <osmocom/gprs/gprs_rlc.h>
+#include <osmocom/gprs/protocol/gsm_04_60.h>
+#include <osmocom/gsm/gsm0503.h>
+#include <osmocom/coding/gsm0503_amr_dtx.h>
+#include <osmocom/coding/gsm0503_coding.h>
+#include <osmocom/coding/gsm0503_interleaving.h>
+#include <osmocom/coding/gsm0503_mapping.h>
+#include <osmocom/coding/gsm0503_parity.h>
+#include <osmocom/coding/gsm0503_tables.h>
+
+#define SEED		0x0503
+/* Distinct blocks cycled through, so that the branch predictors can't
+ * learn a single block */
+#define POOL_SIZE	16
+/* Large enough for eight GMSK or four 8-PSK bursts */
+#define BURSTS_MAX	(8 * 348)
+/* Large enough for an MCS-9 block */
+#define L2_MAX		160
+
+static unsigned long num_blocks = 2000;
+
+struct bench;
+
+typedef int (*encode_func_t)(const struct bench *b, ubit_t *bursts, const uint8_t *l2);
+typedef int (*decode_func_t)(const struct bench *b, uint8_t *l2, const sbit_t *bursts);
+
+struct bench {
+	const char *name;
+	/* L2 payload length in bytes */
+	int len;
+	/* coding scheme, codec mode or other channel specific parameter */
+	int param;
+	encode_func_t encode;
+	decode_func_t decode;
+	/* encoder producing the input of the decoder, if not the same as
+	 * the encoder benchmarked: used for the EGPRS uplink */
+	encode_func_t encode_rx;
+	/* makes a random payload acceptable to the encoder */
+	void (*fixup)(const struct bench *b, uint8_t *l2);
+};
+
+static uint8_t payload[POOL_SIZE][L2_MAX];
+static sbit_t rx_bursts[POOL_SIZE][BURSTS_MAX];
+static ubit_t tx_bursts[BURSTS_MAX];
+static uint8_t l2_out[L2_MAX];
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t ticks(void)
+{
+#ifdef HAVE_TSC
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static int xcch_enc(const struct bench *b, ubit_t *bursts, const uint8_t *l2)
+{
+	return gsm0503_xcch_encode(bursts, l2);
+}
+
+static int xcch_dec(const struct bench *b, uint8_t *l2, const sbit_t *bursts)
+{
+	int n_errors, n_bits_total;
+
+	return gsm0503_xcch_decode(l2, bursts, &n_errors, &n_bits_total);
+}
+
+static int pdtch_enc(const struct bench *b, ubit_t *bursts, const uint8_t *l2)
+{
+	return gsm0503_pdtch_encode(bursts, l2, b->len);
+}
+
+static int pdtch_dec(const struct bench *b, uint8_t *l2, const sbit_t *bursts)
+{
+	int n_errors, n_bits_total;
+	uint8_t usf;
+
+	return gsm0503_pdtch_decode(l2, bursts, &usf, &n_errors, &n_bits_total);
+}
+
+/* Coding and puncturing scheme of the header, for puncturing scheme P1 of
+ * all blocks of the given MCS */
+static uint8_t egprs_cps_bits(int type, int mcs)
+{
+	struct egprs_cps cps;
+	unsigned int bits;
+
+	for (bits = 0; bits < 32; bits++) {
+		if (egprs_get_cps(&cps, type, bits) < 0 || cps.mcs != mcs)
+			continue;
+		if (cps.p[0] != EGPRS_CPS_P1)
+			continue;
+		if (mcs >= EGPRS_MCS7 && cps.p[1] != EGPRS_CPS_P1)
+			continue;
+		return bits;
+	}
+
+	fprintf(stderr, "no CPS for MCS-%d\n", mcs);
+	exit(1);
+}
+
+static int egprs_hdr_type(int mcs)
+{
+	if (mcs <= EGPRS_MCS4)
+		return EGPRS_HDR_TYPE3;
+	if (mcs <= EGPRS_MCS6)
+		return EGPRS_HDR_TYPE2;
+	return EGPRS_HDR_TYPE1;
+}
+
+/* The downlink encoder takes the MCS from the block length and the
+ * puncturing scheme from the header */
+static void egprs_dl_fixup(const struct bench *b, uint8_t *l2)
+{
+	int type = egprs_hdr_type(b->param);
+	uint8_t bits = egprs_cps_bits(type, b->param);
+
+	switch (type) {
+	case EGPRS_HDR_TYPE1:
+		((struct gprs_rlc_dl_header_egprs_1 *) l2)->cps = bits;
+		break;
+	case EGPRS_HDR_TYPE2:
+		((struct gprs_rlc_dl_header_egprs_2 *) l2)->cps = bits;
+		break;
+	case EGPRS_HDR_TYPE3:
+		((struct gprs_rlc_dl_header_egprs_3 *) l2)->cps = bits;
+		break;
+	}
+}
+
+static int egprs_enc(const struct bench *b, ubit_t *bursts, const uint8_t *l2)
+{
+	return gsm0503_pdtch_egprs_encode(bursts, l2, b->len);
+}
+
+static int egprs_dec(const struct bench *b, uint8_t *l2, const sbit_t *bursts)
+{
+	uint16_t nbits = b->param <= EGPRS_MCS4 ?
+		GSM0503_GPRS_BURSTS_NBITS : GSM0503_EGPRS_BURSTS_NBITS;
+	int n_errors, n_bits_total;
+
+	return gsm0503_pdtch_egprs_decode(l2, bursts, nbits, NULL, &n_errors, &n_bits_total);
+}
+
+/* Uplink codes, as in gsm0503_mcs_ul_codes[] */
+static const struct {
+	const struct osmo_conv_code *hdr_conv;
+	const uint8_t *hdr_punc;
+	const struct osmo_conv_code *data_conv;
+	const uint8_t *data_punc;
+} egprs_ul_codes[] = {
+	[EGPRS_MCS1] = { &gsm0503_mcs1_ul_hdr, gsm0503_puncture_mcs1_ul_hdr,
+			 &gsm0503_mcs1, gsm0503_puncture_mcs1_p1 },
+	[EGPRS_MCS2] = { &gsm0503_mcs1_ul_hdr, gsm0503_puncture_mcs1_ul_hdr,
+			 &gsm0503_mcs2, gsm0503_puncture_mcs2_p1 },
+	[EGPRS_MCS3] = { &gsm0503_mcs1_ul_hdr, gsm0503_puncture_mcs1_ul_hdr,
+			 &gsm0503_mcs3, gsm0503_puncture_mcs3_p1 },
+	[EGPRS_MCS4] = { &gsm0503_mcs1_ul_hdr, gsm0503_puncture_mcs1_ul_hdr,
+			 &gsm0503_mcs4, gsm0503_puncture_mcs4_p1 },
+	[EGPRS_MCS5] = { &gsm0503_mcs5_ul_hdr, NULL,
+			 &gsm0503_mcs5, gsm0503_puncture_mcs5_p1 },
+	[EGPRS_MCS6] = { &gsm0503_mcs5_ul_hdr, NULL,
+			 &gsm0503_mcs6, gsm0503_puncture_mcs6_p1 },
+	[EGPRS_MCS7] = { &gsm0503_mcs7_ul_hdr, gsm0503_puncture_mcs7_ul_hdr,
+			 &gsm0503_mcs7, gsm0503_puncture_mcs7_p1 },
+	[EGPRS_MCS8] = { &gsm0503_mcs7_ul_hdr, gsm0503_puncture_mcs7_ul_hdr,
+			 &gsm0503_mcs8, gsm0503_puncture_mcs8_p1 },
+	[EGPRS_MCS9] = { &gsm0503_mcs7_ul_hdr, gsm0503_puncture_mcs7_ul_hdr,
+			 &gsm0503_mcs9, gsm0503_puncture_mcs9_p1 },
+};
+
+/* Convolutional coding and puncturing of n bits, with CRC bits already
+ * appended to u; the unpunctured bits to *out, returns their number */
+static int egprs_ul_code(ubit_t *out, const ubit_t *u,
+	const struct osmo_conv_code *conv, const uint8_t *punc)
+{
+	ubit_t C[2048];
+	int i, j, n;
+
+	n = osmo_conv_encode(conv, u, C);
+	for (i = 0, j = 0; i < n; i++) {
+		if (!punc || !punc[i])
+			out[j++] = C[i];
+	}
+
+	return j;
+}
+
+/* There is no uplink encoder in the library: code the block like an MS
+ * would, with puncturing scheme P1, as gsm0503_pdtch_egprs_decode()
+ * expects it */
+static int egprs_ul_enc(const struct bench *b, ubit_t *bursts, const uint8_t *l2)
+{
+	int mcs = b->param, type = egprs_hdr_type(mcs);
+	const struct osmo_conv_code *hdr_conv = egprs_ul_codes[mcs].hdr_conv;
+	const struct osmo_conv_code *data_conv = egprs_ul_codes[mcs].data_conv;
+	int hdr_len = hdr_conv->len - 8, data_len = data_conv->len - 12;
+	uint8_t hdr[8] = { 0 };
+	ubit_t upp[64], u[700];
+	ubit_t hc[160] = { 0 }, dc[1248], hi[160], di[1248], iB[456];
+	uint8_t bits = egprs_cps_bits(type, mcs);
+	int i, blk, n;
+
+	memcpy(hdr, l2, OSMO_BYTES_FOR_BITS(hdr_len));
+	switch (type) {
+	case EGPRS_HDR_TYPE1:
+		((struct gprs_rlc_ul_header_egprs_1 *) hdr)->cps = bits;
+		break;
+	case EGPRS_HDR_TYPE2:
+		((struct gprs_rlc_ul_header_egprs_2 *) hdr)->cps_hi = bits & 3;
+		((struct gprs_rlc_ul_header_egprs_2 *) hdr)->cps_lo = bits >> 2;
+		break;
+	case EGPRS_HDR_TYPE3:
+		((struct gprs_rlc_ul_header_egprs_3 *) hdr)->cps_hi = bits & 3;
+		((struct gprs_rlc_ul_header_egprs_3 *) hdr)->cps_lo = bits >> 2;
+		break;
+	}
+
+	osmo_pbit2ubit_ext(upp, 0, hdr, 0, hdr_len, 1);
+	osmo_crc8gen_set_bits(&gsm0503_mcs_crc8_hdr, upp, hdr_len, upp + hdr_len);
+	egprs_ul_code(hc, upp, hdr_conv, egprs_ul_codes[mcs].hdr_punc);
+
+	/* MCS-7,8,9 carry two blocks of data */
+	for (blk = 0, n = 0; blk < (mcs >= EGPRS_MCS7 ? 2 : 1); blk++) {
+		osmo_pbit2ubit_ext(u, 0, l2, hdr_len + blk * data_len, data_len, 1);
+		osmo_crc16gen_set_bits(&gsm0503_mcs_crc12, u, data_len, u + data_len);
+		n += egprs_ul_code(dc + n, u, data_conv, egprs_ul_codes[mcs].data_punc);
+	}
+
+	switch (type) {
+	case EGPRS_HDR_TYPE3:
+		gsm0503_mcs1_ul_interleave(hc, dc, iB);
+		for (i = 0; i < 4; i++)
+			gsm0503_xcch_burst_map(&iB[i * 114], &bursts[i * 116], NULL, NULL);
+		return GSM0503_GPRS_BURSTS_NBITS;
+	case EGPRS_HDR_TYPE2:
+		gsm0503_mcs5_ul_interleave(hc, dc, hi, di);
+		for (i = 0; i < 4; i++)
+			gsm0503_mcs5_ul_burst_map(di, &bursts[i * 348], hi, i);
+		break;
+	case EGPRS_HDR_TYPE1:
+		if (mcs == EGPRS_MCS7)
+			gsm0503_mcs7_ul_interleave(hc, dc, dc + 612, hi, di);
+		else
+			gsm0503_mcs8_ul_interleave(hc, dc, dc + 612, hi, di);
+		for (i = 0; i < 4; i++)
+			gsm0503_mcs7_ul_burst_map(di, &bursts[i * 348], hi, i);
+		break;
+	}
+
+	for (i = 0; i < 4; i++)
+		gsm0503_mcs5_burst_swap((sbit_t *) &bursts[i * 348]);
+
+	return GSM0503_EGPRS_BURSTS_NBITS;
+}
+
+static int tch_fr_enc(const struct bench *b, ubit_t *bursts, const uint8_t *l2)
+{
+	return gsm0503_tch_fr_encode(bursts, l2, b->len, 1);
+}
+
+static int tch_fr_dec(const struct bench *b, uint8_t *l2, const sbit_t *bursts)
+{
+	int n_errors, n_bits_total;
+
+	return gsm0503_tch_fr_decode(l2, bursts, 1, b->param, &n_errors, &n_bits_total);
+}
+
+static int tch_hr_enc(const struct bench *b, ubit_t *bursts, const uint8_t *l2)
+{
+	return gsm0503_tch_hr_encode(bursts, l2, b->len);
+}
+
+static int tch_hr_dec(const struct bench *b, uint8_t *l2, const sbit_t *bursts)
+{
+	int n_errors, n_bits_total;
+
+	return gsm0503_tch_hr_decode(l2, bursts, 0, &n_errors, &n_bits_total);
+}
+
+static int tch_afs_enc(const struct bench *b, ubit_t *bursts, const uint8_t *l2)
+{
+	uint8_t codec[1] = { b->param };
+
+	return gsm0503_tch_afs_encode(bursts, l2, b->len, 0, codec, 1, 0, 0);
+}
+
+static int tch_afs_dec(const struct bench *b, uint8_t *l2, const sbit_t *bursts)
+{
+	uint8_t codec[1] = { b->param };
+	uint8_t ft = 0, cmr = 0;
+	int n_errors, n_bits_total;
+
+	return gsm0503_tch_afs_decode(l2, bursts, 0, codec, 1, &ft, &cmr,
+		&n_errors, &n_bits_total);
+}
+
+/* With DTX frame detection, as done by a BTS on the uplink */
+static int tch_afs_dtx_dec(const struct bench *b, uint8_t *l2, const sbit_t *bursts)
+{
+	uint8_t codec[1] = { b->param };
+	uint8_t ft = 0, cmr = 0, dtx = AMR_OTHER;
+	int n_errors, n_bits_total;
+
+	return gsm0503_tch_afs_decode_dtx(l2, bursts, 0, codec, 1, &ft, &cmr,
+		&n_errors, &n_bits_total, &dtx);
+}
+
+static int tch_ahs_enc(const struct bench *b, ubit_t *bursts, const uint8_t *l2)
+{
+	uint8_t codec[1] = { b->param };
+
+	return gsm0503_tch_ahs_encode(bursts, l2, b->len, 0, codec, 1, 0, 0);
+}
+
+static int tch_ahs_dec(const struct bench *b, uint8_t *l2, const sbit_t *bursts)
+{
+	uint8_t codec[1] = { b->param };
+	uint8_t ft = 0, cmr = 0;
+	int n_errors, n_bits_total;
+
+	return gsm0503_tch_ahs_decode(l2, bursts, 0, 0, codec, 1, &ft, &cmr,
+		&n_errors, &n_bits_total);
+}
+
+static int tch_ahs_dtx_dec(const struct bench *b, uint8_t *l2, const sbit_t *bursts)
+{
+	uint8_t codec[1] = { b->param };
+	uint8_t ft = 0, cmr = 0, dtx = AMR_OTHER;
+	int n_errors, n_bits_total;
+
+	return gsm0503_tch_ahs_decode_dtx(l2, bursts, 0, 0, codec, 1, &ft, &cmr,
+		&n_errors, &n_bits_total, &dtx);
+}
+
+/* param: 11 bit RA */
+static int rach_enc(const struct bench *b, ubit_t *bursts, const uint8_t *l2)
+{
+	uint16_t ra = b->param ? osmo_load16le(l2) & 0x7ff : l2[0];
+
+	return gsm0503_rach_ext_encode(bursts, ra, 0x3f, b->param);
+}
+
+static int rach_dec(const struct bench *b, uint8_t *l2, const sbit_t *bursts)
+{
+	uint16_t ra;
+
+	if (!b->param)
+		return gsm0503_rach_decode_ber(l2, bursts, 0x3f, NULL, NULL);
+
+	return gsm0503_rach_ext_decode_ber(&ra, bursts, 0x3f, NULL, NULL);
+}
+
+static int sch_enc(const struct bench *b, ubit_t *bursts, const uint8_t *l2)
+{
+	return gsm0503_sch_encode(bursts, l2);
+}
+
+static int sch_dec(const struct bench *b, uint8_t *l2, const sbit_t *bursts)
+{
+	return gsm0503_sch_decode(l2, bursts);
+}
+
+#define EGPRS(mcs, len) \
+	{ "pdtch_mcs" #mcs, len, EGPRS_MCS##mcs, egprs_enc, egprs_dec, egprs_ul_enc, egprs_dl_fixup }
+#define AFS(name, len, mode) \
+	{ "tch_afs_" name, len, mode, tch_afs_enc, tch_afs_dec }
+#define AHS(name, len, mode) \
+	{ "tch_ahs_" name, len, mode, tch_ahs_enc, tch_ahs_dec }
+
+static const struct bench benchmarks[] = {
+	{ "xcch", 23, 0, xcch_enc, xcch_dec },
+	{ "pdtch_cs1", 23, 1, pdtch_enc, pdtch_dec },
+	{ "pdtch_cs2", 34, 2, pdtch_enc, pdtch_dec },
+	{ "pdtch_cs3", 40, 3, pdtch_enc, pdtch_dec },
+	{ "pdtch_cs4", 54, 4, pdtch_enc, pdtch_dec },
+	EGPRS(1, 27),
+	EGPRS(2, 33),
+	EGPRS(3, 42),
+	EGPRS(4, 49),
+	EGPRS(5, 60),
+	EGPRS(6, 78),
+	EGPRS(7, 118),
+	EGPRS(8, 142),
+	EGPRS(9, 154),
+	{ "tch_fr", 33, 0, tch_fr_enc, tch_fr_dec },
+	{ "tch_efr", 31, 1, tch_fr_enc, tch_fr_dec },
+	{ "tch_hr", 15, 0, tch_hr_enc, tch_hr_dec },
+	AFS("12_2", 31, 7),
+	AFS("10_2", 26, 6),
+	AFS("7_95", 20, 5),
+	AFS("7_4", 19, 4),
+	AFS("6_7", 17, 3),
+	AFS("5_9", 15, 2),
+	AFS("5_15", 13, 1),
+	AFS("4_75", 12, 0),
+	AHS("7_95", 20, 5),
+	AHS("7_4", 19, 4),
+	AHS("6_7", 17, 3),
+	AHS("5_9", 15, 2),
+	AHS("5_15", 13, 1),
+	AHS("4_75", 12, 0),
+	{ "tch_afs_12_2_dtx", 31, 7, tch_afs_enc, tch_afs_dtx_dec },
+	{ "tch_afs_4_75_dtx", 12, 0, tch_afs_enc, tch_afs_dtx_dec },
+	{ "tch_ahs_7_95_dtx", 20, 5, tch_ahs_enc, tch_ahs_dtx_dec },
+	{ "tch_ahs_4_75_dtx", 12, 0, tch_ahs_enc, tch_ahs_dtx_dec },
+	{ "rach", 1, 0, rach_enc, rach_dec },
+	{ "rach_11bit", 2, 1, rach_enc, rach_dec },
+	{ "sch", 4, 0, sch_enc, sch_dec },
+};
+
+static void report(const char *backend, const char *channel, const char *op,
+		   double elapsed, uint64_t cycles)
+{
+	printf("%s,%s,%s,%lu,%.6f,%.0f,%.1f,", backend, channel, op, num_blocks,
+	       elapsed, num_blocks / elapsed, elapsed * 1e9 / num_blocks);
+#ifdef HAVE_TSC
+	printf("%.0f", (double) cycles / num_blocks);
+#endif
+	printf("\n");
+}
+
+/* Generate the pool of blocks, check that they make it through the
+ * decoder and time both directions */
+static void bench_run(const char *backend, const struct bench *b)
+{
+	encode_func_t encode_rx = b->encode_rx ? : b->encode;
+	unsigned long i;
+	unsigned int j, k;
+	uint64_t start_ticks;
+	double start;
+	int rc;
+
+	for (j = 0; j < POOL_SIZE; j++) {
+		for (k = 0; k < L2_MAX; k++)
+			payload[j][k] = random();
+		if (b->fixup)
+			b->fixup(b, payload[j]);
+
+		rc = b->encode(b, tx_bursts, payload[j]);
+		if (rc < 0) {
+			fprintf(stderr, "%s: encoding failed: %d\n", b->name, rc);
+			exit(1);
+		}
+
+		memset(tx_bursts, 0, sizeof(tx_bursts));
+		encode_rx(b, tx_bursts, payload[j]);
+		osmo_ubit2sbit(rx_bursts[j], tx_bursts, BURSTS_MAX);
+
+		rc = b->decode(b, l2_out, rx_bursts[j]);
+		if (rc < 0) {
+			fprintf(stderr, "%s: decoding failed: %d\n", b->name, rc);
+			exit(1);
+		}
+	}
+
+	start = now();
+	start_ticks = ticks();
+	for (i = 0; i < num_blocks; i++)
+		b->encode(b, tx_bursts, payload[i % POOL_SIZE]);
+	report(backend, b->name, "encode", now() - start, ticks() - start_ticks);
+
+	start = now();
+	start_ticks = ticks();
+	for (i = 0; i < num_blocks; i++)
+		b->decode(b, l2_out, rx_bursts[i % POOL_SIZE]);
+	report(backend, b->name, "decode", now() - start, ticks() - start_ticks);
+}
+
+int main(int argc, char **argv)
+{
+	enum osmo_conv_simd simd;
+	unsigned int j;
+
+	if (argc > 1)
+		num_blocks = strtoul(argv[1], NULL, 10);
+	if (num_blocks < 1)
+		num_blocks = 1;
+
+	printf("backend,channel,op,blocks,seconds,blocks_per_s,ns_per_block,cycles_per_block\n");
+
+	for (simd = OSMO_CONV_SIMD_GEN; simd <= OSMO_CONV_SIMD_NEON; simd++) {
+		/* skip the backends this CPU doesn't support */
+		osmo_conv_simd_limit(simd);
+		if (osmo_conv_simd_get() != simd)
+			continue;
+
+		/* the same blocks for every backend */
+		srandom(SEED);
+		for (j = 0; j < ARRAY_SIZE(benchmarks); j++)
+			bench_run(osmo_conv_simd_name(simd), &benchmarks[j]);
+	}
+
+	return 0;
+}
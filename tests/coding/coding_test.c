@@ -29,6 +29,7 @@
 #include <osmocom/core/utils.h>
 
 #include <osmocom/coding/gsm0503_coding.h>
+#include <osmocom/coding/gsm0503_tables.h>
 
 #define DUMP_U_AT(b, x, u) do {						\
 		printf("%s %02x  %02x  ", osmo_ubit_dump(b + x, 57), b[57 + x], b[58 + x]); \
@@ -493,6 +494,167 @@ uint8_t test_speech_fr[33];
 uint8_t test_speech_efr[31];
 uint8_t test_speech_hr[15];
 
+#define BATCH_LEN 21
+
+/* Decode the same blocks with the batch decoders and one by one, and compare
+ * the results.  The blocks use different coding schemes and have errors at
+ * different places; every third block is too damaged to be decoded. */
+static void test_batch(void)
+{
+	ubit_t bursts_u[116 * 8];
+	sbit_t bursts_s[BATCH_LEN][116 * 8];
+	const sbit_t *bursts[BATCH_LEN];
+	uint8_t result[BATCH_LEN][54], result1[54];
+	uint8_t *results[BATCH_LEN];
+	uint8_t usf[BATCH_LEN], usf1;
+	int n_errors[BATCH_LEN], n_bits_total[BATCH_LEN], rc[BATCH_LEN];
+	int n_errors1, n_bits_total1, rc1;
+	const int pdtch_len[] = { 23, 34, 40, 54 };
+	int i, ok;
+
+	for (i = 0; i < BATCH_LEN; i++) {
+		bursts[i] = bursts_s[i];
+		results[i] = result[i];
+	}
+
+	/* xCCH */
+	for (i = 0; i < BATCH_LEN; i++) {
+		gsm0503_xcch_encode(bursts_u, test_l2[i % ARRAY_SIZE(test_l2)]);
+		osmo_ubit2sbit(bursts_s[i], bursts_u, 116 * 4);
+		memset(bursts_s[i] + 5 * i, 0, i % 3 ? 30 : 300);
+	}
+
+	/* the spare bits of the last octet aren't written */
+	memset(result, 0, sizeof(result));
+	ok = gsm0503_xcch_decode_batch(BATCH_LEN, results, bursts,
+		n_errors, n_bits_total, rc);
+	printf("xcch_decode_batch: %d of %d blocks decoded\n", ok, BATCH_LEN);
+
+	for (i = 0; i < BATCH_LEN; i++) {
+		memset(result1, 0, sizeof(result1));
+		rc1 = gsm0503_xcch_decode(result1, bursts[i], &n_errors1, &n_bits_total1);
+		OSMO_ASSERT(rc[i] == rc1);
+		OSMO_ASSERT(n_errors[i] == n_errors1);
+		OSMO_ASSERT(n_bits_total[i] == n_bits_total1);
+		OSMO_ASSERT(rc1 < 0 || !memcmp(result[i], result1, 23));
+	}
+
+	/* PDTCH, all coding schemes */
+	for (i = 0; i < BATCH_LEN; i++) {
+		gsm0503_pdtch_encode(bursts_u, test_macblock[i % 2].l2, pdtch_len[i % 4]);
+		osmo_ubit2sbit(bursts_s[i], bursts_u, 116 * 4);
+		memset(bursts_s[i] + 5 * i, 0, i % 3 ? 10 : 300);
+	}
+
+	memset(result, 0, sizeof(result));
+	ok = gsm0503_pdtch_decode_batch(BATCH_LEN, results, bursts, usf,
+		n_errors, n_bits_total, rc);
+	printf("pdtch_decode_batch: %d of %d blocks decoded\n", ok, BATCH_LEN);
+
+	for (i = 0; i < BATCH_LEN; i++) {
+		memset(result1, 0, sizeof(result1));
+		rc1 = gsm0503_pdtch_decode(result1, bursts[i], &usf1, &n_errors1, &n_bits_total1);
+		OSMO_ASSERT(rc[i] == rc1);
+		OSMO_ASSERT(n_errors[i] == n_errors1);
+		OSMO_ASSERT(n_bits_total[i] == n_bits_total1);
+		OSMO_ASSERT(rc1 < 0 || !memcmp(result[i], result1, rc1));
+		OSMO_ASSERT(rc1 < 0 || pdtch_len[i % 4] == 23 || usf[i] == usf1);
+	}
+
+	/* TCH/FS, some blocks stolen for FACCH */
+	for (i = 0; i < BATCH_LEN; i++) {
+		if (i % 4 == 1)
+			gsm0503_tch_fr_encode(bursts_u, test_l2[i % ARRAY_SIZE(test_l2)], 23, 1);
+		else
+			gsm0503_tch_fr_encode(bursts_u, test_speech_fr, sizeof(test_speech_fr), 1);
+		osmo_ubit2sbit(bursts_s[i], bursts_u, 116 * 8);
+		memset(bursts_s[i] + 5 * i, 0, i % 3 ? 20 : 600);
+	}
+
+	memset(result, 0, sizeof(result));
+	ok = gsm0503_tch_fr_decode_batch(BATCH_LEN, results, bursts, 1, 0,
+		n_errors, n_bits_total, rc);
+	printf("tch_fr_decode_batch: %d of %d blocks decoded\n", ok, BATCH_LEN);
+
+	for (i = 0; i < BATCH_LEN; i++) {
+		memset(result1, 0, sizeof(result1));
+		rc1 = gsm0503_tch_fr_decode(result1, bursts[i], 1, 0, &n_errors1, &n_bits_total1);
+		OSMO_ASSERT(rc[i] == rc1);
+		OSMO_ASSERT(n_errors[i] == n_errors1);
+		OSMO_ASSERT(n_bits_total[i] == n_bits_total1);
+		OSMO_ASSERT(rc1 < 0 || !memcmp(result[i], result1, rc1));
+	}
+
+	printf("\n");
+}
+
+/* position of interleaved bit j of burst b in the 116 bits of a burst
+ * with the two stealing bits in the middle */
+static unsigned int burst_pos(unsigned int b, unsigned int j)
+{
+	return b * 116 + (j < 57 ? j : j + 2);
+}
+
+static void check_table(const char *name, const uint16_t *table, const unsigned int *exp, unsigned int len)
+{
+	unsigned int k;
+
+	for (k = 0; k < len; k++) {
+		if (table[k] != exp[k]) {
+			printf("%s[%u] is %u, expected %u\n", name, k, table[k], exp[k]);
+			OSMO_ASSERT(0);
+		}
+	}
+	printf("%s: %u entries match\n", name, len);
+}
+
+/* recompute the interleaving tables from the formulas of 3GPP TS 45.003 */
+static void test_interleave_tables(void)
+{
+	unsigned int exp[1224], k;
+
+	printf("\n%s\n", __func__);
+
+	for (k = 0; k < 456; k++)
+		exp[k] = (k % 4) * 114 + 2 * (49 * k % 57) + (k % 8) / 4;
+	check_table("gsm0503_interleave_xcch", gsm0503_interleave_xcch, exp, 456);
+	for (k = 0; k < 456; k++)
+		exp[k] = burst_pos(k % 4, 2 * (49 * k % 57) + (k % 8) / 4);
+	check_table("gsm0503_interleave_xcch_burst", gsm0503_interleave_xcch_burst, exp, 456);
+
+	for (k = 0; k < 456; k++)
+		exp[k] = (k % 8) * 114 + 2 * (49 * k % 57) + (k % 8) / 4;
+	check_table("gsm0503_interleave_tch_fr", gsm0503_interleave_tch_fr, exp, 456);
+	for (k = 0; k < 456; k++)
+		exp[k] = burst_pos(k % 8, 2 * (49 * k % 57) + (k % 8) / 4);
+	check_table("gsm0503_interleave_tch_fr_burst", gsm0503_interleave_tch_fr_burst, exp, 456);
+
+	for (k = 0; k < 136; k++)
+		exp[k] = 34 * (k % 4) + 2 * (11 * k % 17) + (k % 8) / 4;
+	check_table("gsm0503_interleave_mcs5_ul_hdr", gsm0503_interleave_mcs5_ul_hdr, exp, 136);
+
+	for (k = 0; k < 100; k++)
+		exp[k] = 25 * (k % 4) + (17 * k % 25);
+	check_table("gsm0503_interleave_mcs5_dl_hdr", gsm0503_interleave_mcs5_dl_hdr, exp, 100);
+
+	for (k = 0; k < 124; k++)
+		exp[k] = 31 * (k % 4) + (17 * k % 31);
+	check_table("gsm0503_interleave_mcs7_dl_hdr", gsm0503_interleave_mcs7_dl_hdr, exp, 124);
+
+	for (k = 0; k < 160; k++)
+		exp[k] = 40 * (k % 4) + 2 * (13 * (k / 8) % 20) + (k % 8) / 4;
+	check_table("gsm0503_interleave_mcs7_ul_hdr", gsm0503_interleave_mcs7_ul_hdr, exp, 160);
+
+	for (k = 0; k < 1224; k++)
+		exp[k] = 306 * (k % 4) + 3 * (44 * k % 102 + (k / 4) % 2) + (k + 2 - k / 408) % 3;
+	check_table("gsm0503_interleave_mcs7", gsm0503_interleave_mcs7, exp, 1224);
+
+	for (k = 0; k < 1224; k++)
+		exp[k] = 306 * (2 * (k / 612) + k % 2) + 3 * (74 * k % 102 + (k / 2) % 2)
+			 + (k + 2 - k / 204) % 3;
+	check_table("gsm0503_interleave_mcs8", gsm0503_interleave_mcs8, exp, 1224);
+}
+
 int main(int argc, char **argv)
 {
 	int i, len_l2, len_mb;
@@ -554,6 +716,10 @@ int main(int argc, char **argv)
 		}
 	}
 
+	test_batch();
+
+	test_interleave_tables();
+
 	printf("Success\n");
 
 	return 0;
@@ -0,0 +1,264 @@
+/*
+ * Throughput benchmark for burst mapping and interleaving of every channel
+ * type: bursts to coded bits (unmap + deinterleave) on receive and coded
+ * bits to bursts (interleave + map) on transmit, as done by the decoders
+ * and encoders in gsm0503_coding.c.  Not part of the test suite, as the
+ * results depend on the machine; run manually:
+ *
+ *   ./tests/coding/interleave_bench [num_blocks]
+ */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <osmocom/core/bits.h>
+#include <osmocom/core/utils.h>
+#include <osmocom/coding/gsm0503_mapping.h>
+#include <osmocom/coding/gsm0503_interleaving.h>
+#include <osmocom/coding/gsm0503_tables.h>
+
+static unsigned long num_blocks = 1000000;
+
+/* Large enough for eight GMSK or four 8-PSK bursts */
+static sbit_t bursts[8 * 348];
+static sbit_t cB[1224 + 1224], hc[160], up[36];
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void xcch_rx(void)
+{
+	sbit_t iB[456];
+	int i;
+
+	for (i = 0; i < 4; i++)
+		gsm0503_xcch_burst_unmap(&iB[i * 114], &bursts[i * 116], NULL, NULL);
+	gsm0503_xcch_deinterleave(cB, iB);
+}
+
+/* What the xCCH and PDTCH decoders do: unmap and deinterleave at once */
+static void xcch_rx_fused(void)
+{
+	int k;
+
+	for (k = 0; k < 456; k++)
+		cB[k] = bursts[gsm0503_interleave_xcch_burst[k]];
+}
+
+static void xcch_tx(void)
+{
+	ubit_t iB[456];
+	int i;
+
+	gsm0503_xcch_interleave((ubit_t *) cB, iB);
+	for (i = 0; i < 4; i++)
+		gsm0503_xcch_burst_map(&iB[i * 114], (ubit_t *) &bursts[i * 116], NULL, NULL);
+}
+
+static void tch_fr_rx(void)
+{
+	sbit_t iB[912], h;
+	int i;
+
+	for (i = 0; i < 8; i++)
+		gsm0503_tch_burst_unmap(&iB[i * 114], &bursts[i * 116], &h, i >> 2);
+	gsm0503_tch_fr_deinterleave(cB, iB);
+}
+
+/* What the TCH/FS, TCH/EFS and TCH/AFS decoders do */
+static void tch_fr_rx_fused(void)
+{
+	int k;
+
+	for (k = 0; k < 456; k++)
+		cB[k] = bursts[gsm0503_interleave_tch_fr_burst[k]];
+}
+
+static void tch_fr_tx(void)
+{
+	ubit_t iB[912];
+	int i;
+
+	gsm0503_tch_fr_interleave((ubit_t *) cB, iB);
+	for (i = 0; i < 8; i++)
+		gsm0503_tch_burst_map(&iB[i * 114], (ubit_t *) &bursts[i * 116], NULL, i >> 2);
+}
+
+static void tch_hr_rx(void)
+{
+	sbit_t iB[912];
+	int i;
+
+	for (i = 0; i < 4; i++)
+		gsm0503_tch_burst_unmap(&iB[i * 114], &bursts[i * 116], NULL, i >> 1);
+	gsm0503_tch_hr_deinterleave(cB, iB);
+}
+
+static void tch_hr_tx(void)
+{
+	ubit_t iB[912];
+	int i;
+
+	gsm0503_tch_hr_interleave((ubit_t *) cB, iB);
+	for (i = 0; i < 4; i++)
+		gsm0503_tch_burst_map(&iB[i * 114], (ubit_t *) &bursts[i * 116], NULL, i >> 1);
+}
+
+static void mcs1_rx(void)
+{
+	sbit_t iB[456];
+	int i;
+
+	for (i = 0; i < 4; i++)
+		gsm0503_xcch_burst_unmap(&iB[i * 114], &bursts[i * 116], NULL, NULL);
+	gsm0503_mcs1_ul_deinterleave(hc, cB, iB);
+}
+
+static void mcs1_tx(void)
+{
+	ubit_t iB[456];
+	int i;
+
+	gsm0503_mcs1_dl_interleave((ubit_t *) up, (ubit_t *) hc, (ubit_t *) cB, iB);
+	for (i = 0; i < 4; i++)
+		gsm0503_xcch_burst_map(&iB[i * 114], (ubit_t *) &bursts[i * 116], NULL, NULL);
+}
+
+static void mcs5_rx(void)
+{
+	sbit_t hi[136], di[1248];
+	int i;
+
+	for (i = 0; i < 4; i++)
+		gsm0503_mcs5_ul_burst_unmap(di, &bursts[i * 348], hi, i);
+	gsm0503_mcs5_ul_deinterleave(hc, cB, hi, di);
+}
+
+static void mcs5_tx(void)
+{
+	ubit_t hi[100], di[1248];
+	int i;
+
+	gsm0503_mcs5_dl_interleave((ubit_t *) hc, (ubit_t *) cB, hi, di);
+	for (i = 0; i < 4; i++)
+		gsm0503_mcs5_dl_burst_map(di, (ubit_t *) &bursts[i * 348], hi, (ubit_t *) up, i);
+}
+
+static void mcs7_rx(void)
+{
+	sbit_t hi[160], di[1224];
+	int i;
+
+	for (i = 0; i < 4; i++)
+		gsm0503_mcs7_ul_burst_unmap(di, &bursts[i * 348], hi, i);
+	gsm0503_mcs7_ul_deinterleave(hc, cB, cB + 612, hi, di);
+}
+
+static void mcs7_tx(void)
+{
+	ubit_t hi[124], di[1224];
+	int i;
+
+	gsm0503_mcs7_dl_interleave((ubit_t *) hc, (ubit_t *) cB, (ubit_t *) cB + 612, hi, di);
+	for (i = 0; i < 4; i++)
+		gsm0503_mcs7_dl_burst_map(di, (ubit_t *) &bursts[i * 348], hi, (ubit_t *) up, i);
+}
+
+static void mcs8_rx(void)
+{
+	sbit_t hi[160], di[1224];
+	int i;
+
+	for (i = 0; i < 4; i++)
+		gsm0503_mcs7_ul_burst_unmap(di, &bursts[i * 348], hi, i);
+	gsm0503_mcs8_ul_deinterleave(hc, cB, cB + 612, hi, di);
+}
+
+static void mcs8_tx(void)
+{
+	ubit_t hi[124], di[1224];
+	int i;
+
+	gsm0503_mcs8_dl_interleave((ubit_t *) hc, (ubit_t *) cB, (ubit_t *) cB + 612, hi, di);
+	for (i = 0; i < 4; i++)
+		gsm0503_mcs7_dl_burst_map(di, (ubit_t *) &bursts[i * 348], hi, (ubit_t *) up, i);
+}
+
+static const struct {
+	const char *name;
+	void (*func)(void);
+} benchmarks[] = {
+	{ "xcch rx", xcch_rx },
+	{ "xcch rx fused", xcch_rx_fused },
+	{ "xcch tx", xcch_tx },
+	{ "tch_fr rx", tch_fr_rx },
+	{ "tch_fr rx fused", tch_fr_rx_fused },
+	{ "tch_fr tx", tch_fr_tx },
+	{ "tch_hr rx", tch_hr_rx },
+	{ "tch_hr tx", tch_hr_tx },
+	{ "mcs1-4 rx", mcs1_rx },
+	{ "mcs1-4 tx", mcs1_tx },
+	{ "mcs5-6 rx", mcs5_rx },
+	{ "mcs5-6 tx", mcs5_tx },
+	{ "mcs7 rx", mcs7_rx },
+	{ "mcs7 tx", mcs7_tx },
+	{ "mcs8-9 rx", mcs8_rx },
+	{ "mcs8-9 tx", mcs8_tx },
+};
+
+int main(int argc, char **argv)
+{
+	unsigned long i;
+	unsigned int j;
+	double start, elapsed;
+
+	if (argc > 1)
+		num_blocks = strtoul(argv[1], NULL, 10);
+	if (num_blocks < 1)
+		num_blocks = 1;
+
+	srandom(0);
+	for (i = 0; i < ARRAY_SIZE(bursts); i++)
+		bursts[i] = random() & 1;
+	for (i = 0; i < ARRAY_SIZE(cB); i++)
+		cB[i] = random() & 1;
+	for (i = 0; i < ARRAY_SIZE(hc); i++)
+		hc[i] = random() & 1;
+	for (i = 0; i < ARRAY_SIZE(up); i++)
+		up[i] = random() & 1;
+
+	for (j = 0; j < ARRAY_SIZE(benchmarks); j++) {
+		start = now();
+		for (i = 0; i < num_blocks; i++)
+			benchmarks[j].func();
+		elapsed = now() - start;
+
+		printf("%-16s %lu blocks in %.3f s: %.1f ns/block\n",
+		       benchmarks[j].name, num_blocks, elapsed, elapsed * 1e9 / num_blocks);
+	}
+
+	return 0;
+}
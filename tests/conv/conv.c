@@ -17,6 +17,114 @@ static void fill_random(ubit_t *b, int n)
 		b[i] = random() & 1;
 }
 
+#define BATCH_LEN	37
+
+/* Soft bits of a random encoded sequence, with some of them weakened or
+ * flipped, so that the decoder has to correct errors */
+static void fill_noisy(const struct conv_test_vector *test, sbit_t *bs)
+{
+	ubit_t bu0[MAX_LEN_BITS], bu1[MAX_LEN_BITS];
+	int i, r;
+
+	fill_random(bu0, test->in_len);
+	osmo_conv_encode(test->code, bu0, bu1);
+	osmo_ubit2sbit(bs, bu1, test->out_len);
+
+	for (i = 0; i < test->out_len; i++) {
+		r = random() % 16;
+		if (r == 0)
+			bs[i] = -bs[i] / 4;
+		else if (r < 4)
+			bs[i] = bs[i] * r / 8;
+	}
+}
+
+static int check_batch(const struct conv_test_vector *test)
+{
+	sbit_t *bs[BATCH_LEN];
+	ubit_t *bu[BATCH_LEN];
+	ubit_t bu1[MAX_LEN_BITS];
+	int i, rc = 0;
+
+	for (i = 0; i < BATCH_LEN; i++) {
+		bs[i] = malloc(sizeof(sbit_t) * MAX_LEN_BITS);
+		bu[i] = malloc(sizeof(ubit_t) * MAX_LEN_BITS);
+		fill_noisy(test, bs[i]);
+	}
+
+	/* a single, a partial and several full batches */
+	if (osmo_conv_decode_batch(test->code, (const sbit_t **) bs, bu, 1) < 0 ||
+	    osmo_conv_decode_batch(test->code, (const sbit_t **) bs + 1, bu + 1, 5) < 0 ||
+	    osmo_conv_decode_batch(test->code, (const sbit_t **) bs + 6, bu + 6, BATCH_LEN - 6) < 0)
+		rc = -1;
+
+	for (i = 0; i < BATCH_LEN && !rc; i++) {
+		osmo_conv_decode(test->code, bs[i], bu1);
+		if (memcmp(bu[i], bu1, test->in_len))
+			rc = -1;
+	}
+
+	for (i = 0; i < BATCH_LEN; i++) {
+		free(bs[i]);
+		free(bu[i]);
+	}
+
+	return rc;
+}
+
+/* Bit errors of the input: soft bits without the sign of re-encoding the
+ * decoded bits, zero ones included */
+static int count_ber(const struct conv_test_vector *test,
+	const sbit_t *bs, const ubit_t *bu)
+{
+	ubit_t bu1[MAX_LEN_BITS];
+	int i, n_errors = 0;
+
+	osmo_conv_encode(test->code, bu, bu1);
+	for (i = 0; i < test->out_len; i++) {
+		if (bu1[i] ? bs[i] >= 0 : bs[i] <= 0)
+			n_errors++;
+	}
+
+	return n_errors;
+}
+
+static int check_ber(const struct conv_test_vector *test)
+{
+	sbit_t *bs[BATCH_LEN];
+	ubit_t *bu[BATCH_LEN];
+	ubit_t bu1[MAX_LEN_BITS];
+	int n_errors[BATCH_LEN], n_bits_total[BATCH_LEN];
+	int i, n_err, n_bits, rc = 0;
+
+	for (i = 0; i < BATCH_LEN; i++) {
+		bs[i] = malloc(sizeof(sbit_t) * MAX_LEN_BITS);
+		bu[i] = malloc(sizeof(ubit_t) * MAX_LEN_BITS);
+		fill_noisy(test, bs[i]);
+		/* some erased soft bits, too */
+		bs[i][i % test->out_len] = 0;
+	}
+
+	if (osmo_conv_decode_batch_ber(test->code, (const sbit_t **) bs, bu, BATCH_LEN,
+				       n_errors, n_bits_total) < 0)
+		rc = -1;
+
+	for (i = 0; i < BATCH_LEN && !rc; i++) {
+		osmo_conv_decode_ber(test->code, bs[i], bu1, &n_err, &n_bits);
+		if (memcmp(bu[i], bu1, test->in_len) ||
+		    n_err != count_ber(test, bs[i], bu1) || n_errors[i] != n_err ||
+		    n_bits != test->out_len || n_bits_total[i] != n_bits)
+			rc = -1;
+	}
+
+	for (i = 0; i < BATCH_LEN; i++) {
+		free(bs[i]);
+		free(bu[i]);
+	}
+
+	return rc;
+}
+
 int do_check(const struct conv_test_vector *test)
 {
 	ubit_t *bu0, *bu1;
@@ -132,6 +240,28 @@ int do_check(const struct conv_test_vector *test)
 		printf("OK\n");
 	}
 
+	/* Check batch decoding of noisy vectors against single decoding */
+	printf("[..] Batch decoding : ");
+
+	if (check_batch(test) < 0) {
+		printf("ERROR !\n");
+		fprintf(stderr, "[!] Failed batch decoding: Results don't match\n");
+		return -1;
+	}
+
+	printf("OK\n");
+
+	/* Check the bit errors counted while decoding */
+	printf("[..] Bit error count : ");
+
+	if (check_ber(test) < 0) {
+		printf("ERROR !\n");
+		fprintf(stderr, "[!] Failed bit error count: Results don't match\n");
+		return -1;
+	}
+
+	printf("OK\n");
+
 	/* Spacing */
 	printf("\n");
 
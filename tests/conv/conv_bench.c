@@ -0,0 +1,181 @@
+/*
+ * Throughput benchmark for decoding many codewords of the same code, as in
+ * a BTS receiving on all timeslots of several carriers: one by one versus
+ * in batches, without and with counting bit errors.  Not part of the test suite, as the results depend on the
+ * machine; run manually:
+ *
+ *   ./tests/conv/conv_bench [num_blocks [batch_len]]
+ */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <osmocom/core/bits.h>
+#include <osmocom/core/conv.h>
+#include <osmocom/core/utils.h>
+#include <osmocom/gsm/gsm0503.h>
+#include <osmocom/coding/gsm0503_coding.h>
+
+#define MAX_BATCH	64
+
+static unsigned long num_blocks = 200000;
+static unsigned int batch_len = 16;
+
+/* one block of soft bits per entry of a batch, reused for all batches */
+static sbit_t *input[MAX_BATCH];
+static ubit_t *output[MAX_BATCH];
+static uint8_t *l2_data[MAX_BATCH];
+static int n_errors[MAX_BATCH], n_bits_total[MAX_BATCH], rc[MAX_BATCH];
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char *label, double elapsed)
+{
+	printf("%-24s %lu blocks in %.3f s: %.0f blocks/s, %.2f us/block\n",
+	       label, num_blocks, elapsed, num_blocks / elapsed, elapsed * 1e6 / num_blocks);
+}
+
+/* Encode random data and add some noise */
+static void fill_noisy(const struct osmo_conv_code *code, sbit_t *bs)
+{
+	ubit_t bu0[1024], bu1[1024];
+	int i, len;
+
+	for (i = 0; i < code->len; i++)
+		bu0[i] = random() & 1;
+	len = osmo_conv_encode(code, bu0, bu1);
+	osmo_ubit2sbit(bs, bu1, len);
+
+	for (i = 0; i < len; i++) {
+		if (random() % 16 == 0)
+			bs[i] = -bs[i] / 4;
+	}
+}
+
+static void bench_code(const char *name, const struct osmo_conv_code *code)
+{
+	char label[64];
+	unsigned long i;
+	unsigned int j;
+	double start;
+
+	for (j = 0; j < batch_len; j++)
+		fill_noisy(code, input[j]);
+
+	start = now();
+	for (i = 0; i < num_blocks; i++)
+		osmo_conv_decode(code, input[i % batch_len], output[i % batch_len]);
+	snprintf(label, sizeof(label), "%s single:", name);
+	report(label, now() - start);
+
+	start = now();
+	for (i = 0; i < num_blocks; i += batch_len)
+		osmo_conv_decode_batch(code, (const sbit_t **) input, output, batch_len);
+	snprintf(label, sizeof(label), "%s batch:", name);
+	report(label, now() - start);
+
+	start = now();
+	for (i = 0; i < num_blocks; i++) {
+		j = i % batch_len;
+		osmo_conv_decode_ber(code, input[j], output[j], &n_errors[j], &n_bits_total[j]);
+	}
+	snprintf(label, sizeof(label), "%s single+ber:", name);
+	report(label, now() - start);
+
+	start = now();
+	for (i = 0; i < num_blocks; i += batch_len)
+		osmo_conv_decode_batch_ber(code, (const sbit_t **) input, output, batch_len,
+					   n_errors, n_bits_total);
+	snprintf(label, sizeof(label), "%s batch+ber:", name);
+	report(label, now() - start);
+}
+
+static void bench_xcch(void)
+{
+	uint8_t l2[23];
+	ubit_t bursts_u[116 * 4];
+	unsigned long i;
+	unsigned int j;
+	double start;
+
+	for (j = 0; j < batch_len; j++) {
+		for (i = 0; i < sizeof(l2); i++)
+			l2[i] = random();
+		gsm0503_xcch_encode(bursts_u, l2);
+		osmo_ubit2sbit(input[j], bursts_u, sizeof(bursts_u));
+		memset(input[j] + 7 * j, 0, 20);
+	}
+
+	start = now();
+	for (i = 0; i < num_blocks; i++) {
+		j = i % batch_len;
+		gsm0503_xcch_decode(l2_data[j], input[j], &n_errors[j], &n_bits_total[j]);
+	}
+	report("gsm0503_xcch single:", now() - start);
+
+	start = now();
+	for (i = 0; i < num_blocks; i += batch_len)
+		gsm0503_xcch_decode_batch(batch_len, l2_data, (const sbit_t **) input,
+					  n_errors, n_bits_total, rc);
+	report("gsm0503_xcch batch:", now() - start);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int j;
+
+	if (argc > 1)
+		num_blocks = strtoul(argv[1], NULL, 10);
+	if (argc > 2)
+		batch_len = atoi(argv[2]);
+	if (batch_len < 1 || batch_len > MAX_BATCH)
+		batch_len = 16;
+
+	for (j = 0; j < batch_len; j++) {
+		input[j] = malloc(1024 * sizeof(sbit_t));
+		output[j] = malloc(1024);
+		l2_data[j] = malloc(64);
+		OSMO_ASSERT(input[j] && output[j] && l2_data[j]);
+	}
+
+	srandom(0);
+
+	bench_code("xcch", &gsm0503_xcch);
+	bench_code("tch_fr", &gsm0503_tch_fr);
+	bench_code("cs3", &gsm0503_cs3_np);
+	bench_code("tch_afs_7_95", &gsm0503_tch_afs_7_95);
+	bench_code("tch_afs_4_75", &gsm0503_tch_afs_4_75);
+	bench_xcch();
+
+	for (j = 0; j < batch_len; j++) {
+		free(input[j]);
+		free(output[j]);
+		free(l2_data[j]);
+	}
+
+	return 0;
+}
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <osmocom/core/conv.h>
 #include <osmocom/gsm/gsm0503.h>
@@ -165,10 +166,91 @@ const struct osmo_conv_code conv_lte_pbch = {
 	.next_state  = conv_lte_pbch_next_state,
 };
 
+/**
+ * Rate 1/7, K=7
+ * Non recursive code, tail-biting, non-punctured
+ */
+static const uint8_t conv_rate7_k7_next_output[][2] = {
+	{   0, 127 }, {  60,  67 }, { 106,  21 }, {  86,  41 },
+	{ 109,  18 }, {  81,  46 }, {   7, 120 }, {  59,  68 },
+	{  30,  97 }, {  34,  93 }, { 116,  11 }, {  72,  55 },
+	{ 115,  12 }, {  79,  48 }, {  25, 102 }, {  37,  90 },
+	{  70,  57 }, { 122,   5 }, {  44,  83 }, {  16, 111 },
+	{  43,  84 }, {  23, 104 }, {  65,  62 }, { 125,   2 },
+	{  88,  39 }, { 100,  27 }, {  50,  77 }, {  14, 113 },
+	{  53,  74 }, {   9, 118 }, {  95,  32 }, {  99,  28 },
+	{ 127,   0 }, {  67,  60 }, {  21, 106 }, {  41,  86 },
+	{  18, 109 }, {  46,  81 }, { 120,   7 }, {  68,  59 },
+	{  97,  30 }, {  93,  34 }, {  11, 116 }, {  55,  72 },
+	{  12, 115 }, {  48,  79 }, { 102,  25 }, {  90,  37 },
+	{  57,  70 }, {   5, 122 }, {  83,  44 }, { 111,  16 },
+	{  84,  43 }, { 104,  23 }, {  62,  65 }, {   2, 125 },
+	{  39,  88 }, {  27, 100 }, {  77,  50 }, { 113,  14 },
+	{  74,  53 }, { 118,   9 }, {  32,  95 }, {  28,  99 },
+};
+
+static const struct osmo_conv_code conv_rate7_k7 = {
+	.N = 7,
+	.K = 7,
+	.len = 60,
+	.term = CONV_TERM_TAIL_BITING,
+	.next_output = conv_rate7_k7_next_output,
+	.next_state  = conv_lte_pbch_next_state,
+};
+
+/**
+ * Rate 1/6, K=5
+ * Non recursive code, flushed, non-punctured
+ */
+static const uint8_t conv_rate6_k5_next_output[][2] = {
+	{   0,  63 }, {  27,  36 }, {  14,  49 }, {  21,  42 },
+	{  50,  13 }, {  41,  22 }, {  60,   3 }, {  39,  24 },
+	{  63,   0 }, {  36,  27 }, {  49,  14 }, {  42,  21 },
+	{  13,  50 }, {  22,  41 }, {   3,  60 }, {  24,  39 },
+};
+
 /* ------------------------------------------------------------------------ */
 /* Main                                                                     */
 /* ------------------------------------------------------------------------ */
 
+/* Decode the pre computed vector with a preallocated decoder, several times */
+static int check_acc_decoder(const struct conv_test_vector *test)
+{
+	struct osmo_conv_acc_decoder *dec;
+	ubit_t bu[MAX_LEN_BITS];
+	sbit_t bs[MAX_LEN_BITS];
+	pbit_t bp[MAX_LEN_BYTES];
+	int i, j, rc = 0;
+
+	dec = osmo_conv_acc_decoder_alloc(test->code);
+	if (!dec) {
+		printf("[+] %s: no accelerated decoder\n", test->name);
+		return 0;
+	}
+
+	osmo_pbit2ubit(bu, test->vec_out, test->out_len);
+	for (i = 0; i < test->out_len; i++)
+		bs[i] = bu[i] ? -127 : 127;
+
+	for (j = 0; j < 3; j++) {
+		memset(bu, 0xff, sizeof(bu));
+		if (osmo_conv_acc_decoder_decode(dec, bs, bu) != 0) {
+			rc = -1;
+			break;
+		}
+		memset(bp, 0, sizeof(bp));
+		osmo_ubit2pbit(bp, bu, test->in_len);
+		if (memcmp(bp, test->vec_in, (test->in_len + 7) / 8)) {
+			rc = -1;
+			break;
+		}
+	}
+
+	printf("[+] %s: decoder reused 3 times: %s\n", test->name, rc ? "FAILED" : "OK");
+	osmo_conv_acc_decoder_free(dec);
+	return rc;
+}
+
 int main(int argc, char *argv[])
 {
 	const struct conv_test_vector *test;
@@ -184,6 +266,16 @@ int main(int argc, char *argv[])
 		.next_state  = gsm0503_xcch.next_state,
 	};
 
+	/* Rate 1/6 code, shares the state transitions of the xCCH code */
+	const struct osmo_conv_code conv_rate6_k5 = {
+		.N = 6,
+		.K = 5,
+		.len = 100,
+		.term = CONV_TERM_FLUSH,
+		.next_output = conv_rate6_k5_next_output,
+		.next_state  = gsm0503_xcch.next_state,
+	};
+
 	const struct conv_test_vector tests[] = {
 		{
 			.name = "GSM xCCH (non-recursive, flushed, not punctured)",
@@ -268,6 +360,24 @@ int main(int argc, char *argv[])
 						 0x61, 0x15, 0xaa, 0x4d, 0x94, 0xed, 0xb3, 0x3a,
 						 0x5d, 0x1b, 0x09, 0xc2, 0x99, 0x01, 0xec, 0x68 },
 		},
+		{
+			.name = "Rate 1/6 K=5 (non-recursive, flushed, not punctured)",
+			.code = &conv_rate6_k5,
+			.in_len  = 100,
+			.out_len = 624,
+			.has_vec = 0,
+			.vec_in  = { },
+			.vec_out = { },
+		},
+		{
+			.name = "Rate 1/7 K=7 (non-recursive, tail-biting, not punctured)",
+			.code = &conv_rate7_k7,
+			.in_len  = 60,
+			.out_len = 420,
+			.has_vec = 0,
+			.vec_in  = { },
+			.vec_out = { },
+		},
 		{ /* end */ },
 	};
 
@@ -277,5 +387,14 @@ int main(int argc, char *argv[])
 			return rc;
 	}
 
+	printf("\n");
+	for (test = tests; test->name; test++) {
+		if (!test->has_vec)
+			continue;
+		rc = check_acc_decoder(test);
+		if (rc)
+			return rc;
+	}
+
 	return 0;
 }
@@ -0,0 +1,201 @@
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include "config.h"
+
+#include <osmocom/core/bits.h>
+#include <osmocom/core/crcgen.h>
+#include <osmocom/core/utils.h>
+#include <osmocom/core/simd_internal.h>
+
+#define MAX_LEN	1000
+
+/* Bit by bit, as the CRC is defined */
+static uint64_t crc_ref(int bits, uint64_t poly, uint64_t init, uint64_t remainder,
+			const ubit_t *in, int len)
+{
+	uint64_t mask = (bits == 64) ? ~(uint64_t) 0 : ((uint64_t) 1 << bits) - 1;
+	uint64_t crc = init;
+	int i;
+
+	for (i = 0; i < len; i++) {
+		crc ^= (uint64_t) (in[i] & 1) << (bits - 1);
+		if (crc & ((uint64_t) 1 << (bits - 1)))
+			crc = (crc << 1) ^ poly;
+		else
+			crc <<= 1;
+		crc &= mask;
+	}
+
+	return crc ^ remainder;
+}
+
+/* Run the tests on the generic code only, or on the PCLMULQDQ kernel if
+ * the CPU supports it; the generic code is not used on such CPUs else */
+static void use_generic(int generic)
+{
+#ifdef HAVE_PCLMUL
+	osmo_crc_clmul_enable(!generic);
+#endif
+	printf("Using the %s code\n", generic ? "generic" : "default");
+}
+
+static void check_val(const char *name, uint64_t val, uint64_t exp)
+{
+	if (val != exp)
+		printf("%s: got 0x%" PRIx64 ", expected 0x%" PRIx64 "\n", name, val, exp);
+}
+
+/* The check values of the catalogue of CRC algorithms: the CRC of the
+ * ASCII string "123456789" */
+static void test_check_values(void)
+{
+	const struct osmo_crc8gen_code crc8 = { 8, 0x07, 0x00, 0x00 };
+	const struct osmo_crc16gen_code crc16 = { 16, 0x1021, 0xffff, 0x0000 };
+	const struct osmo_crc32gen_code crc32 = { 32, 0x04c11db7, 0xffffffff, 0xffffffff };
+	const struct osmo_crc64gen_code crc64 = { 64, 0x42f0e1eba9ea3693ULL, ~0ULL, ~0ULL };
+	const uint8_t str[] = "123456789";
+	ubit_t in[72];
+
+	printf("Testing check values\n");
+
+	osmo_pbit2ubit(in, str, 72);
+	check_val("CRC-8", osmo_crc8gen_compute_bits(&crc8, in, 72), 0xf4);
+	check_val("CRC-16/CCITT-FALSE", osmo_crc16gen_compute_bits(&crc16, in, 72), 0x29b1);
+	check_val("CRC-32/BZIP2", osmo_crc32gen_compute_bits(&crc32, in, 72), 0xfc891918);
+	check_val("CRC-64/WE", osmo_crc64gen_compute_bits(&crc64, in, 72), 0x62ec59e3f1a4f00aULL);
+
+	check_val("CRC-8 packed", osmo_crc8gen_compute_pbits(&crc8, str, 72), 0xf4);
+	check_val("CRC-16/CCITT-FALSE packed", osmo_crc16gen_compute_pbits(&crc16, str, 72), 0x29b1);
+	check_val("CRC-32/BZIP2 packed", osmo_crc32gen_compute_pbits(&crc32, str, 72), 0xfc891918);
+	check_val("CRC-64/WE packed", osmo_crc64gen_compute_pbits(&crc64, str, 72), 0x62ec59e3f1a4f00aULL);
+}
+
+static const struct {
+	int bits;
+	uint64_t poly, init, remainder;
+} codes[] = {
+	/* as in gsm0503_parity.c */
+	{ 3, 0x3, 0x0, 0x7 },
+	{ 6, 0x2f, 0x0, 0x3f },
+	{ 8, 0x49, 0x0, 0xff },
+	{ 10, 0x175, 0x0, 0x3ff },
+	{ 12, 0xd31, 0x0, 0xfff },
+	{ 14, 0x202d, 0x0, 0x0 },
+	{ 16, 0x1021, 0x0, 0xffff },
+	{ 40, 0x0004820009ULL, 0x0, 0xffffffffffULL },
+	/* odd sizes and all bits set */
+	{ 1, 0x1, 0x1, 0x0 },
+	{ 7, 0x09, 0x7f, 0x0 },
+	{ 24, 0x864cfb, 0xb704ce, 0x0 },
+	{ 32, 0x04c11db7, 0xffffffff, 0xffffffff },
+	{ 63, 0x7fffffffffffffffULL, 0x1234567890abcdefULL, 0x0 },
+	{ 64, 0x42f0e1eba9ea3693ULL, ~0ULL, ~0ULL },
+};
+
+/* Compare with the reference for all lengths from 0 to MAX_LEN, also at
+ * unaligned addresses, with the generator of the smallest fitting size.
+ * The packed bits variant gets the same bits, packed. */
+static void test_random(void)
+{
+	static ubit_t buf[MAX_LEN + 16], bits1[MAX_LEN];
+	static pbit_t pbuf[MAX_LEN / 8 + 1 + 16];
+	ubit_t crc_bits[64];
+	uint64_t exp, val, pval;
+	unsigned int i;
+	int len, errors, j;
+
+	printf("Testing random input\n");
+
+	for (i = 0; i < ARRAY_SIZE(codes); i++) {
+		errors = 0;
+
+		for (len = 0; len <= MAX_LEN; len++) {
+			const ubit_t *in = &buf[len % 16];
+			int bits = codes[i].bits;
+
+			const pbit_t *pin = &pbuf[len % 16];
+
+			/* not only 0 and 1, only the LSB counts */
+			for (j = 0; j < len + 16; j++)
+				buf[j] = random() & 3;
+			for (j = 0; j < len; j++)
+				bits1[j] = in[j] & 1;
+			osmo_ubit2pbit(&pbuf[len % 16], bits1, len);
+
+			exp = crc_ref(bits, codes[i].poly, codes[i].init, codes[i].remainder, in, len);
+
+			if (bits <= 8) {
+				const struct osmo_crc8gen_code code = { bits, codes[i].poly, codes[i].init, codes[i].remainder };
+				val = osmo_crc8gen_compute_bits(&code, in, len);
+				pval = osmo_crc8gen_compute_pbits(&code, pin, len);
+				osmo_crc8gen_set_bits(&code, in, len, crc_bits);
+				if (osmo_crc8gen_check_bits(&code, in, len, crc_bits))
+					errors++;
+			} else if (bits <= 16) {
+				const struct osmo_crc16gen_code code = { bits, codes[i].poly, codes[i].init, codes[i].remainder };
+				val = osmo_crc16gen_compute_bits(&code, in, len);
+				pval = osmo_crc16gen_compute_pbits(&code, pin, len);
+				osmo_crc16gen_set_bits(&code, in, len, crc_bits);
+				if (osmo_crc16gen_check_bits(&code, in, len, crc_bits))
+					errors++;
+			} else if (bits <= 32) {
+				const struct osmo_crc32gen_code code = { bits, codes[i].poly, codes[i].init, codes[i].remainder };
+				val = osmo_crc32gen_compute_bits(&code, in, len);
+				pval = osmo_crc32gen_compute_pbits(&code, pin, len);
+				osmo_crc32gen_set_bits(&code, in, len, crc_bits);
+				if (osmo_crc32gen_check_bits(&code, in, len, crc_bits))
+					errors++;
+			} else {
+				const struct osmo_crc64gen_code code = { bits, codes[i].poly, codes[i].init, codes[i].remainder };
+				val = osmo_crc64gen_compute_bits(&code, in, len);
+				pval = osmo_crc64gen_compute_pbits(&code, pin, len);
+				osmo_crc64gen_set_bits(&code, in, len, crc_bits);
+				if (osmo_crc64gen_check_bits(&code, in, len, crc_bits))
+					errors++;
+			}
+
+			if (val != exp || pval != exp) {
+				if (!errors)
+					printf("CRC-%d poly 0x%" PRIx64 " len %d: got 0x%" PRIx64 " (packed 0x%" PRIx64
+					       "), expected 0x%" PRIx64 "\n", bits, codes[i].poly, len, val, pval, exp);
+				errors++;
+			}
+		}
+
+		printf("CRC-%d poly 0x%" PRIx64 ": %s\n", codes[i].bits, codes[i].poly,
+		       errors ? "FAILED" : "OK");
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int generic;
+
+	for (generic = 0; generic <= 1; generic++) {
+		srandom(0);
+		use_generic(generic);
+		test_check_values();
+		test_random();
+	}
+
+	return 0;
+}
@@ -9,6 +9,7 @@
 #include <osmocom/core/logging.h>
 #include <osmocom/core/msgb.h>
 #include <osmocom/core/application.h>
+#include <osmocom/core/stat_hist.h>
 #include <osmocom/gsm/protocol/ipaccess.h>
 #include <osmocom/ctrl/control_if.h>
 
@@ -31,7 +32,7 @@ struct msgb *msgb_from_string(const char *str)
 	char *str_msg;
 	size_t len = strlen(str) + 1;
 
-	struct msgb *msg = msgb_alloc(1024, str);
+	struct msgb *msg = msgb_alloc(len + 1024, str);
 
 	iph = (void*)msgb_put(msg, sizeof(*iph));
 	iph->proto = IPAC_PROTO_OSMO;
@@ -329,6 +330,62 @@ static const struct one_test test_messages_list[] = {
 			.reply = "some error message",
 		},
 	},
+	{ "GET_BULK 1 variable other.*",
+		{
+			.type = CTRL_TYPE_GET_BULK,
+			.id = "1",
+			.variable = "variable other.*",
+		},
+		"GET_BULK_REPLY 1 last\n!variable Command not found\n!other.* Command not found\n",
+	},
+	{ "GET_BULK 1 *\n",
+		{
+			.type = CTRL_TYPE_GET_BULK,
+			.id = "1",
+			.variable = "*",
+		},
+		"GET_BULK_REPLY 1 last\n!* Command not found\n",
+	},
+	{ "GET_BULK 1 var\tiable",
+		{
+			.type = CTRL_TYPE_ERROR,
+			.id = "1",
+			.reply = "GET_BULK variable contains invalid characters",
+		},
+		"ERROR 1 GET_BULK variable contains invalid characters",
+	},
+	{ "GET_BULK 1 variable *.other",
+		{
+			.type = CTRL_TYPE_ERROR,
+			.id = "1",
+			.reply = "GET_BULK variable contains invalid characters",
+		},
+		"ERROR 1 GET_BULK variable contains invalid characters",
+	},
+	{ "GET_BULK 1  ",
+		{
+			.type = CTRL_TYPE_ERROR,
+			.id = "1",
+			.reply = "GET_BULK incomplete",
+		},
+		"ERROR 1 GET_BULK incomplete",
+	},
+	{ "GET_BULK 1 variable\nvalue",
+		{
+			.type = CTRL_TYPE_ERROR,
+			.id = "1",
+			.reply = "GET_BULK with trailing characters",
+		},
+		"ERROR 1 GET_BULK with trailing characters",
+	},
+	{ "GET_BULK_REPLY 1 last\nvariable 42\n",
+		{
+			.type = CTRL_TYPE_GET_BULK_REPLY,
+			.id = "1",
+			.variable = "last",
+			.reply = "variable 42\n",
+		},
+	},
 };
 
 static void test_messages()
@@ -449,6 +506,231 @@ static void test_deferred_cmd()
 	printf("success\n");
 }
 
+static int bulk_num_gets;
+
+CTRL_CMD_DEFINE_RO(bulk_a, "bulk-a");
+static int get_bulk_a(struct ctrl_cmd *cmd, void *data)
+{
+	bulk_num_gets++;
+	cmd->reply = talloc_asprintf(cmd, "%d", 42);
+	return CTRL_CMD_REPLY;
+}
+
+CTRL_CMD_DEFINE_RO(bulk_multiline, "bulk multi line");
+static int get_bulk_multiline(struct ctrl_cmd *cmd, void *data)
+{
+	bulk_num_gets++;
+	cmd->reply = "one\\two\nthree";
+	return CTRL_CMD_REPLY;
+}
+
+CTRL_CMD_DEFINE_RO(bulk_fail, "bulk fail");
+static int get_bulk_fail(struct ctrl_cmd *cmd, void *data)
+{
+	bulk_num_gets++;
+	cmd->reply = "Failure";
+	return CTRL_CMD_ERROR;
+}
+
+/* not listed when expanding a '*' */
+CTRL_CMD_DEFINE_WO_NOVRF(bulk_wo, "bulk wo");
+static int set_bulk_wo(struct ctrl_cmd *cmd, void *data)
+{
+	cmd->reply = "OK";
+	return CTRL_CMD_REPLY;
+}
+
+/* send a GET_BULK and print all replies */
+static void bulk_test(struct ctrl_handle *ctrl, struct ctrl_connection *ccon, const char *req)
+{
+	struct msgb *msg = msgb_from_string(req);
+	int num_msgs = 0;
+
+	printf("request: '%.60s'\n", osmo_escape_str(req, -1));
+	bulk_num_gets = 0;
+	OSMO_ASSERT(ctrl_handle_msg(ctrl, ccon, msg) == 0);
+	msgb_free(msg);
+
+	while ((msg = msgb_dequeue(&ccon->write_queue.msg_queue))) {
+		ccon->write_queue.current_length--;
+		num_msgs++;
+		msgb_put_u8(msg, 0);
+		if (msgb_l2len(msg) < 200)
+			printf("replied: '%s'\n", osmo_escape_str((char *)msgb_l2(msg), -1));
+		else
+			printf("replied: %u bytes: '%s'\n", msgb_l2len(msg),
+			       osmo_escape_str((char *)msgb_l2(msg), 30));
+		msgb_free(msg);
+	}
+	printf("%d GETs, %d reply messages\n", bulk_num_gets, num_msgs);
+}
+
+static void test_bulk_get()
+{
+	struct ctrl_handle *ctrl;
+	struct ctrl_connection *ccon;
+	struct ctrl_cmd *cmd;
+	char *req;
+	int i;
+	int ctx_size_was;
+
+	printf("\n%s\n", __func__);
+	ctrl = ctrl_handle_alloc2(ctx, NULL, NULL, 0);
+	ccon = talloc_zero(ctx, struct ctrl_connection);
+	INIT_LLIST_HEAD(&ccon->def_cmds);
+	osmo_wqueue_init(&ccon->write_queue, 100);
+
+	ctrl_cmd_install(CTRL_NODE_ROOT, &cmd_bulk_a);
+	ctrl_cmd_install(CTRL_NODE_ROOT, &cmd_bulk_multiline);
+	ctrl_cmd_install(CTRL_NODE_ROOT, &cmd_bulk_fail);
+	ctrl_cmd_install(CTRL_NODE_ROOT, &cmd_bulk_wo);
+
+	ctx_size_was = talloc_total_size(ctx);
+
+	bulk_test(ctrl, ccon, "GET_BULK 1 bulk-a bulk.fail  bulk.multi.line bulk.none bulk.wo");
+	bulk_test(ctrl, ccon, "GET_BULK 2 bulk.*");
+	bulk_test(ctrl, ccon, "GET_BULK 3 bulk.multi.*");
+	bulk_test(ctrl, ccon, "GET_BULK 4 *");
+
+	/* a reply not fitting into one message is split */
+	req = talloc_strdup(ctx, "GET_BULK 5");
+	for (i = 0; i < 600; i++)
+		req = talloc_strdup_append(req, " bulk.multi.line");
+	bulk_test(ctrl, ccon, req);
+	talloc_free(req);
+
+	if (talloc_total_size(ctx) != ctx_size_was) {
+		printf("mem leak!\n");
+		talloc_report_full(ctx, stdout);
+		OSMO_ASSERT(false);
+	}
+
+	/* without a connection, the reply is collected in the command */
+	cmd = ctrl_cmd_exec_from_string(ctrl, "GET_BULK 6 bulk-a bulk.*");
+	OSMO_ASSERT(cmd);
+	printf("exec: %s %s %s '%s'\n", get_value_string(ctrl_type_vals, cmd->type), cmd->id,
+	       cmd->variable, osmo_escape_str(cmd->reply, -1));
+	talloc_free(cmd);
+
+	talloc_free(ccon);
+	talloc_free(ctrl);
+	printf("success\n");
+}
+
+/* each of the commands replies with its index in match_cmds */
+#define MATCH_GET(n) \
+static int get_match_##n(struct ctrl_cmd *cmd, void *data) \
+{ \
+	cmd->reply = talloc_asprintf(cmd, "%d", n); \
+	return CTRL_CMD_REPLY; \
+}
+MATCH_GET(0) MATCH_GET(1) MATCH_GET(2) MATCH_GET(3)
+MATCH_GET(4) MATCH_GET(5) MATCH_GET(6) MATCH_GET(7)
+
+static struct ctrl_cmd_element match_cmds[] = {
+	{ .name = "match x y", .get = get_match_0 },
+	{ .name = "match x", .get = get_match_1 },
+	{ .name = "match * z", .get = get_match_2 },
+	{ .name = "match", .get = get_match_3 },
+	{ .name = "match x y *", .get = get_match_4 },
+	{ .name = "other *", .get = get_match_5 },
+	{ .name = "other", .get = get_match_6 },
+	{ .name = "match q z", .get = get_match_7 },
+};
+
+static void test_cmd_match()
+{
+	static const char * const vars[] = {
+		"match", "match.x", "match.x.y", "match.x.y.z", "match.x.q",
+		"match.q", "match.q.z", "match.q.z.z", "match.y", "other",
+		"other.x", "othe", "none",
+	};
+	struct ctrl_handle *ctrl;
+	struct ctrl_cmd *cmd;
+	char *req;
+	int i;
+
+	printf("\n%s\n", __func__);
+	ctrl = ctrl_handle_alloc2(ctx, NULL, NULL, 0);
+	for (i = 0; i < ARRAY_SIZE(match_cmds); i++)
+		ctrl_cmd_install(CTRL_NODE_ROOT, &match_cmds[i]);
+
+	/* the first installed command matching a prefix of the variable wins */
+	for (i = 0; i < ARRAY_SIZE(vars); i++) {
+		req = talloc_asprintf(ctx, "GET %d %s", i, vars[i]);
+		cmd = ctrl_cmd_exec_from_string(ctrl, req);
+		OSMO_ASSERT(cmd);
+		printf("%s -> %s %s\n", vars[i], get_value_string(ctrl_type_vals, cmd->type), cmd->reply);
+		talloc_free(cmd);
+		talloc_free(req);
+	}
+
+	talloc_free(ctrl);
+	printf("success\n");
+}
+
+static const struct osmo_stat_hist_desc hist_desc[] = {
+	{ "rtt", "Round trip time", "us" },
+	{ "unused", "Never recorded", "us" },
+};
+
+static const struct osmo_stat_hist_group_desc histg_desc = {
+	.group_name_prefix = "ctrl-hist",
+	.group_description = "CTRL test histograms",
+	.num_hists = ARRAY_SIZE(hist_desc),
+	.hist_desc = hist_desc,
+};
+
+static void test_stat_hist()
+{
+	static const char * const vars[] = {
+		"stat_hist.count.ctrl-hist.0.rtt",
+		"stat_hist.min.ctrl-hist.0.rtt",
+		"stat_hist.max.ctrl-hist.0.rtt",
+		"stat_hist.p50.ctrl-hist.0.rtt",
+		"stat_hist.p90.ctrl-hist.0.rtt",
+		"stat_hist.p99.ctrl-hist.0.rtt",
+		"stat_hist.p999.ctrl-hist.0.rtt",
+		"stat_hist.count.ctrl-hist.0",
+		"stat_hist.p50.ctrl-hist.0",
+		"stat_hist.count.ctrl-hist.0.none",
+		"stat_hist.count.ctrl-hist.1.rtt",
+		"stat_hist.avg.ctrl-hist.0.rtt",
+		"stat_hist.count.ctrl-hist",
+	};
+	struct osmo_stat_hist_group *histg;
+	struct ctrl_handle *ctrl;
+	struct ctrl_cmd *cmd;
+	char *req;
+	int i;
+
+	printf("\n%s\n", __func__);
+	ctrl = ctrl_handle_alloc2(ctx, NULL, NULL, 0);
+	histg = osmo_stat_hist_group_alloc(ctx, &histg_desc, 0);
+	OSMO_ASSERT(histg);
+	for (i = 1; i <= 100; i++)
+		osmo_stat_hist_record2(histg, 0, i);
+
+	for (i = 0; i < ARRAY_SIZE(vars); i++) {
+		req = talloc_asprintf(ctx, "GET %d %s", i, vars[i]);
+		cmd = ctrl_cmd_exec_from_string(ctrl, req);
+		OSMO_ASSERT(cmd);
+		printf("%s -> %s %s\n", vars[i], get_value_string(ctrl_type_vals, cmd->type), cmd->reply);
+		talloc_free(cmd);
+		talloc_free(req);
+	}
+
+	/* histograms are read-only */
+	cmd = ctrl_cmd_exec_from_string(ctrl, "SET 42 stat_hist.count.ctrl-hist.0.rtt 1");
+	OSMO_ASSERT(cmd);
+	printf("SET -> %s %s\n", get_value_string(ctrl_type_vals, cmd->type), cmd->reply);
+	talloc_free(cmd);
+
+	osmo_stat_hist_group_free(histg);
+	talloc_free(ctrl);
+	printf("success\n");
+}
+
 static struct log_info_cat test_categories[] = {
 };
 
@@ -472,12 +754,20 @@ int main(int argc, char **argv)
 	check_type(CTRL_TYPE_SET_REPLY);
 	check_type(CTRL_TYPE_TRAP);
 	check_type(CTRL_TYPE_ERROR);
+	check_type(CTRL_TYPE_GET_BULK);
+	check_type(CTRL_TYPE_GET_BULK_REPLY);
 	check_type(64);
 
 	test_messages();
 
 	test_deferred_cmd();
 
+	test_bulk_get();
+
+	test_cmd_match();
+
+	test_stat_hist();
+
 	/* Expecting root ctx + msgb root ctx + 5 logging elements */
 	if (talloc_total_blocks(ctx) != 7) {
 		talloc_report_full(ctx, stdout);
@@ -112,6 +112,28 @@ void test_gsm0503_detect_ahs_dtx_frame(char *string)
 	       n_errors, n_bits_total);
 }
 
+/* Flip every 23rd bit, 20 bits in total: still detected if less than 1/8
+ * of the checked bits are wrong */
+void test_gsm0503_detect_dtx_frame_errors(char *string)
+{
+	ubit_t ubits[512];
+	uint8_t dtx_frame_type;
+	int n_errors;
+	int n_bits_total;
+	unsigned int i;
+
+	string_to_ubit(ubits, string);
+	for (i = 0; i < 456; i += 23)
+		ubits[i] ^= 1;
+
+	dtx_frame_type = gsm0503_detect_afs_dtx_frame(&n_errors, &n_bits_total, ubits);
+	printf(" ==> FR: %s, n_errors=%i, n_bits_total=%i\n", gsm0503_amr_dtx_frame_name(dtx_frame_type),
+	       n_errors, n_bits_total);
+	dtx_frame_type = gsm0503_detect_ahs_dtx_frame(&n_errors, &n_bits_total, ubits);
+	printf(" ==> HR: %s, n_errors=%i, n_bits_total=%i\n", gsm0503_amr_dtx_frame_name(dtx_frame_type),
+	       n_errors, n_bits_total);
+}
+
 int main(int argc, char **argv)
 {
 	printf("FR AMR DTX FRAMES:\n");
@@ -125,6 +147,16 @@ int main(int argc, char **argv)
 	test_gsm0503_detect_ahs_dtx_frame(sample_ahs_onset_frame);
 	test_gsm0503_detect_ahs_dtx_frame(sample_sid_first_inh_frame);
 	test_gsm0503_detect_ahs_dtx_frame(sample_sid_update_inh_frame);
+	printf("AMR DTX FRAMES WITH BIT ERRORS:\n");
+	test_gsm0503_detect_dtx_frame_errors(sample_afs_sid_frame);
+	test_gsm0503_detect_dtx_frame_errors(sample_afs_sid_update_frame);
+	test_gsm0503_detect_dtx_frame_errors(sample_afs_onset_frame);
+	test_gsm0503_detect_dtx_frame_errors(sample_ahs_sid_update_frame);
+	test_gsm0503_detect_dtx_frame_errors(sample_ahs_sid_first_p1_frame);
+	test_gsm0503_detect_dtx_frame_errors(sample_ahs_sid_first_p2_frame);
+	test_gsm0503_detect_dtx_frame_errors(sample_ahs_onset_frame);
+	test_gsm0503_detect_dtx_frame_errors(sample_sid_first_inh_frame);
+	test_gsm0503_detect_dtx_frame_errors(sample_sid_update_inh_frame);
 
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,175 @@
+/*
+ * Call setup rate benchmark for FSM instances: allocate an instance per
+ * call, look it up by id, run it through a few states and terminate it,
+ * with a number of calls alive at any time.  Not part of the test suite,
+ * as the results depend on the machine; run manually:
+ *
+ *   ./tests/fsm/fsm_bench [num_calls [num_active]]
+ */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <osmocom/core/fsm.h>
+#include <osmocom/core/logging.h>
+#include <osmocom/core/talloc.h>
+#include <osmocom/core/utils.h>
+
+static unsigned long num_calls = 1000000;
+static unsigned int num_active = 1000;
+
+#define S(x)	(1 << (x))
+
+enum call_state {
+	ST_SETUP,
+	ST_ALERTING,
+	ST_ACTIVE,
+};
+
+enum call_event {
+	EV_ALERT,
+	EV_CONNECT,
+};
+
+static const struct value_string call_event_names[] = {
+	{ EV_ALERT, "ALERT" },
+	{ EV_CONNECT, "CONNECT" },
+	{ 0, NULL }
+};
+
+static void call_fsm_setup(struct osmo_fsm_inst *fi, uint32_t event, void *data)
+{
+	osmo_fsm_inst_state_chg(fi, ST_ALERTING, 0, 0);
+}
+
+static void call_fsm_alerting(struct osmo_fsm_inst *fi, uint32_t event, void *data)
+{
+	osmo_fsm_inst_state_chg(fi, ST_ACTIVE, 0, 0);
+}
+
+static void call_fsm_active(struct osmo_fsm_inst *fi, uint32_t event, void *data)
+{
+}
+
+static const struct osmo_fsm_state call_fsm_states[] = {
+	[ST_SETUP] = {
+		.name = "SETUP",
+		.in_event_mask = S(EV_ALERT),
+		.out_state_mask = S(ST_ALERTING),
+		.action = call_fsm_setup,
+	},
+	[ST_ALERTING] = {
+		.name = "ALERTING",
+		.in_event_mask = S(EV_CONNECT),
+		.out_state_mask = S(ST_ACTIVE),
+		.action = call_fsm_alerting,
+	},
+	[ST_ACTIVE] = {
+		.name = "ACTIVE",
+		.action = call_fsm_active,
+	},
+};
+
+static struct osmo_fsm call_fsm = {
+	.name = "call",
+	.states = call_fsm_states,
+	.num_states = ARRAY_SIZE(call_fsm_states),
+	.log_subsys = DLGLOBAL,
+	.event_names = call_event_names,
+};
+
+static const struct log_info_cat log_categories[] = {
+};
+
+static const struct log_info log_info = {
+	.cat = log_categories,
+	.num_cat = ARRAY_SIZE(log_categories),
+};
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void bench_calls(const char *label)
+{
+	struct osmo_fsm_inst **active;
+	struct osmo_fsm_inst *fi;
+	char id[32];
+	unsigned long i;
+	unsigned int slot;
+	double start, elapsed;
+
+	active = talloc_zero_array(NULL, struct osmo_fsm_inst *, num_active);
+	OSMO_ASSERT(active);
+
+	start = now();
+	for (i = 0; i < num_calls; i++) {
+		slot = i % num_active;
+		if (active[slot])
+			osmo_fsm_inst_term(active[slot], OSMO_FSM_TERM_REGULAR, NULL);
+
+		fi = osmo_fsm_inst_alloc(&call_fsm, NULL, NULL, LOGL_DEBUG, NULL);
+		OSMO_ASSERT(fi);
+		/* the id is usually only known after the instance was allocated */
+		OSMO_ASSERT(osmo_fsm_inst_update_id_f(fi, "call%lu", i) == 0);
+		active[slot] = fi;
+
+		snprintf(id, sizeof(id), "call%lu", i);
+		OSMO_ASSERT(osmo_fsm_inst_find_by_id(&call_fsm, id) == fi);
+		osmo_fsm_inst_dispatch(fi, EV_ALERT, NULL);
+		osmo_fsm_inst_dispatch(fi, EV_CONNECT, NULL);
+	}
+	elapsed = now() - start;
+
+	for (slot = 0; slot < num_active; slot++) {
+		if (active[slot])
+			osmo_fsm_inst_term(active[slot], OSMO_FSM_TERM_REGULAR, NULL);
+	}
+	talloc_free(active);
+
+	printf("%s: %lu calls, %u active, in %.3f s: %.0f calls/s, %.1f ns/call\n",
+	       label, num_calls, num_active, elapsed, num_calls / elapsed, elapsed * 1e9 / num_calls);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 1)
+		num_calls = strtoul(argv[1], NULL, 10);
+	if (argc > 2)
+		num_active = atoi(argv[2]);
+	if (num_active < 1)
+		num_active = 1;
+
+	/* no log targets: measure the FSM, not the logging */
+	log_init(&log_info, NULL);
+	OSMO_ASSERT(osmo_fsm_register(&call_fsm) == 0);
+
+	bench_calls("talloc");
+
+	OSMO_ASSERT(osmo_fsm_set_inst_pool(&call_fsm, num_active) == 0);
+	bench_calls("pool");
+
+	osmo_fsm_unregister(&call_fsm);
+	return 0;
+}
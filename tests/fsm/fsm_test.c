@@ -399,6 +399,215 @@ static const struct log_info log_info = {
 	.num_cat = ARRAY_SIZE(default_categories),
 };
 
+static void test_find_many()
+{
+	struct osmo_fsm_inst *fi[16];
+	struct osmo_fsm_inst *dup;
+	char id[32];
+	int i;
+
+	fprintf(stderr, "\n--- %s()\n", __func__);
+
+	for (i = 0; i < ARRAY_SIZE(fi); i++) {
+		fi[i] = osmo_fsm_inst_alloc(&fsm, g_ctx, NULL, LOGL_DEBUG, NULL);
+		OSMO_ASSERT(fi[i]);
+		OSMO_ASSERT(osmo_fsm_inst_update_id_f(fi[i], "inst%d", i) == 0);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(fi); i++) {
+		snprintf(id, sizeof(id), "inst%d", i);
+		OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, id) == fi[i]);
+		snprintf(id, sizeof(id), "Test_FSM(inst%d)", i);
+		OSMO_ASSERT(osmo_fsm_inst_find_by_name(&fsm, id) == fi[i]);
+	}
+	fprintf(stderr, "found %zu instances by id and name\n", ARRAY_SIZE(fi));
+
+	/* the old id and name are gone after a change of id */
+	OSMO_ASSERT(osmo_fsm_inst_update_id(fi[0], "renamed") == 0);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, "inst0") == NULL);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_name(&fsm, "Test_FSM(inst0)") == NULL);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, "renamed") == fi[0]);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_name(&fsm, "Test_FSM(renamed)") == fi[0]);
+
+	/* instances without id are not found by id */
+	OSMO_ASSERT(osmo_fsm_inst_update_id(fi[1], NULL) == 0);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, "inst1") == NULL);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_name(&fsm, "Test_FSM") == fi[1]);
+
+	/* of several instances with the same id, the newest one is found */
+	dup = osmo_fsm_inst_alloc(&fsm, g_ctx, NULL, LOGL_DEBUG, "inst2");
+	OSMO_ASSERT(dup);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, "inst2") == dup);
+	osmo_fsm_inst_free(dup);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, "inst2") == fi[2]);
+
+	/* freed instances are not found */
+	for (i = 0; i < ARRAY_SIZE(fi); i++)
+		osmo_fsm_inst_free(fi[i]);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, "renamed") == NULL);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, "inst42") == NULL);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_name(&fsm, "Test_FSM(inst42)") == NULL);
+	fprintf(stderr, "freed instances are gone\n");
+
+	fprintf(stderr, "\n--- %s() done\n\n", __func__);
+}
+
+static void test_find_grow(struct log_target *target)
+{
+	struct osmo_fsm_inst *fi[5000];
+	struct osmo_fsm_inst *first, *newest;
+	unsigned int loglevel = target->loglevel;
+	char id[32];
+	int i;
+
+	fprintf(stderr, "\n--- %s()\n", __func__);
+
+	/* thousands of allocations would flood the log */
+	log_set_log_level(target, LOGL_FATAL);
+
+	first = osmo_fsm_inst_alloc(&fsm, g_ctx, NULL, LOGL_DEBUG, "dup");
+	newest = osmo_fsm_inst_alloc(&fsm, g_ctx, NULL, LOGL_DEBUG, "dup");
+	OSMO_ASSERT(first && newest);
+
+	/* the hash tables grow several times */
+	for (i = 0; i < ARRAY_SIZE(fi); i++) {
+		snprintf(id, sizeof(id), "inst%d", i);
+		fi[i] = osmo_fsm_inst_alloc(&fsm, g_ctx, NULL, LOGL_DEBUG, id);
+		OSMO_ASSERT(fi[i]);
+	}
+	for (i = 0; i < ARRAY_SIZE(fi); i++) {
+		snprintf(id, sizeof(id), "inst%d", i);
+		OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, id) == fi[i]);
+		snprintf(id, sizeof(id), "Test_FSM(inst%d)", i);
+		OSMO_ASSERT(osmo_fsm_inst_find_by_name(&fsm, id) == fi[i]);
+	}
+	OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, "dup") == newest);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_name(&fsm, "Test_FSM(dup)") == newest);
+
+	/* and shrink again */
+	for (i = 0; i < ARRAY_SIZE(fi) - 10; i++)
+		osmo_fsm_inst_free(fi[i]);
+	for (; i < ARRAY_SIZE(fi); i++) {
+		snprintf(id, sizeof(id), "inst%d", i);
+		OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, id) == fi[i]);
+		osmo_fsm_inst_free(fi[i]);
+	}
+	OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, "inst0") == NULL);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, "dup") == newest);
+	osmo_fsm_inst_free(newest);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, "dup") == first);
+	osmo_fsm_inst_free(first);
+
+	log_set_log_level(target, loglevel);
+	fprintf(stderr, "found %zu instances while the tables grew and shrank\n", ARRAY_SIZE(fi));
+
+	fprintf(stderr, "\n--- %s() done\n\n", __func__);
+}
+
+static void test_inst_cursor(struct log_target *target)
+{
+	struct osmo_fsm fsm_b = fsm;
+	struct osmo_fsm_inst *a[5], *b[2], *fi;
+	struct osmo_fsm_inst_cursor cur;
+	unsigned int loglevel = target->loglevel;
+	char id[32];
+	int i;
+
+	fprintf(stderr, "\n--- %s()\n", __func__);
+
+	log_set_log_level(target, LOGL_FATAL);
+	fsm_b.name = "Cursor_FSM";
+	OSMO_ASSERT(osmo_fsm_register(&fsm_b) == 0);
+
+	/* new instances are added at the list head: the walk sees a3 .. a0, b1, b0 */
+	for (i = 0; i < 4; i++) {
+		snprintf(id, sizeof(id), "a%d", i);
+		a[i] = osmo_fsm_inst_alloc(&fsm, g_ctx, NULL, LOGL_DEBUG, id);
+		OSMO_ASSERT(a[i]);
+	}
+	for (i = 0; i < ARRAY_SIZE(b); i++) {
+		snprintf(id, sizeof(id), "b%d", i);
+		b[i] = osmo_fsm_inst_alloc(&fsm_b, g_ctx, NULL, LOGL_DEBUG, id);
+		OSMO_ASSERT(b[i]);
+	}
+
+	osmo_fsm_inst_cursor_start(&cur);
+	fi = osmo_fsm_inst_cursor_next(&cur);
+	fprintf(stderr, "%s\n", fi->name);
+	/* free the instance returned next, and the one returned already; an
+	 * instance allocated before the cursor position is not returned */
+	osmo_fsm_inst_free(a[2]);
+	osmo_fsm_inst_free(a[3]);
+	a[4] = osmo_fsm_inst_alloc(&fsm, g_ctx, NULL, LOGL_DEBUG, "a4");
+	OSMO_ASSERT(a[4]);
+	while ((fi = osmo_fsm_inst_cursor_next(&cur)))
+		fprintf(stderr, "%s\n", fi->name);
+	osmo_fsm_inst_cursor_stop(&cur);
+
+	/* a cursor in the instances of an unregistered FSM moves on */
+	fprintf(stderr, "unregister the FSM of the cursor:\n");
+	osmo_fsm_inst_cursor_start(&cur);
+	while ((fi = osmo_fsm_inst_cursor_next(&cur))) {
+		fprintf(stderr, "%s\n", fi->name);
+		if (fi->fsm == &fsm_b)
+			break;
+	}
+	for (i = 0; i < ARRAY_SIZE(b); i++)
+		osmo_fsm_inst_free(b[i]);
+	osmo_fsm_unregister(&fsm_b);
+	OSMO_ASSERT(!osmo_fsm_inst_cursor_next(&cur));
+	osmo_fsm_inst_cursor_stop(&cur);
+
+	osmo_fsm_inst_free(a[0]);
+	osmo_fsm_inst_free(a[1]);
+	osmo_fsm_inst_free(a[4]);
+	log_set_log_level(target, loglevel);
+
+	fprintf(stderr, "\n--- %s() done\n\n", __func__);
+}
+
+static void test_inst_pool()
+{
+	struct osmo_fsm unregistered = { .name = "Unregistered_FSM" };
+	struct osmo_fsm_inst *fi, *fi2;
+	const char *long_id = "a_rather_long_id_that_does_not_fit_into_the_inline_buffer";
+
+	fprintf(stderr, "\n--- %s()\n", __func__);
+
+	OSMO_ASSERT(osmo_fsm_set_inst_pool(&unregistered, 1) == -ENOENT);
+	OSMO_ASSERT(osmo_fsm_set_inst_pool(&fsm, 1) == 0);
+
+	/* a released instance is handed out again, without its children */
+	fi = osmo_fsm_inst_alloc(&fsm, g_ctx, NULL, LOGL_DEBUG, "first");
+	OSMO_ASSERT(fi);
+	OSMO_ASSERT(talloc_zero(fi, int));
+	OSMO_ASSERT(osmo_fsm_inst_update_id(fi, long_id) == 0);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, long_id) == fi);
+	osmo_fsm_inst_free(fi);
+
+	fi2 = osmo_fsm_inst_alloc(&fsm, g_ctx, NULL, LOGL_DEBUG, "second");
+	OSMO_ASSERT(fi2 == fi);
+	OSMO_ASSERT(talloc_total_blocks(fi2) == 1);
+	OSMO_ASSERT(fi2->state == 0 && !fi2->proc.terminating);
+	OSMO_ASSERT(!strcmp(osmo_fsm_inst_name(fi2), "Test_FSM(second)"));
+	OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, long_id) == NULL);
+	OSMO_ASSERT(osmo_fsm_inst_find_by_id(&fsm, "second") == fi2);
+	fprintf(stderr, "released instance was reused\n");
+
+	/* the pool keeps at most one instance */
+	fi = osmo_fsm_inst_alloc(&fsm, g_ctx, NULL, LOGL_DEBUG, "third");
+	OSMO_ASSERT(fi && fi != fi2);
+	osmo_fsm_inst_free(fi2);
+	osmo_fsm_inst_free(fi);
+
+	OSMO_ASSERT(osmo_fsm_set_inst_pool(&fsm, 0) == 0);
+	fi = osmo_fsm_inst_alloc(&fsm, g_ctx, NULL, LOGL_DEBUG, "fourth");
+	OSMO_ASSERT(fi);
+	osmo_fsm_inst_free(fi);
+
+	fprintf(stderr, "\n--- %s() done\n\n", __func__);
+}
+
 int main(int argc, char **argv)
 {
 	struct log_target *stderr_target;
@@ -432,7 +641,12 @@ int main(int argc, char **argv)
 	test_id_api();
 	test_state_chg_keep_timer();
 	test_state_chg_T();
+	test_find_many();
+	test_find_grow(stderr_target);
+	test_inst_cursor(stderr_target);
+	test_inst_pool();
 
 	osmo_fsm_unregister(&fsm);
+	OSMO_ASSERT(osmo_fsm_find_by_name(fsm.name) == NULL);
 	exit(0);
 }
@@ -0,0 +1,188 @@
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <osmocom/core/select.h>
+#include <osmocom/core/talloc.h>
+#include <osmocom/core/utils.h>
+
+#define NUM_POSTERS	3
+#define NUM_TASKS	1000
+
+static struct osmo_loop *main_loop;
+static unsigned int executed;
+static uintptr_t next_seq[NUM_POSTERS];
+
+static void count_task(void *data)
+{
+	uintptr_t val = (uintptr_t)data;
+	unsigned int id = val >> 16;
+	uintptr_t seq = val & 0xffff;
+
+	OSMO_ASSERT(id < NUM_POSTERS);
+	/* closures of one poster are executed in order */
+	OSMO_ASSERT(seq == next_seq[id]);
+	next_seq[id]++;
+	executed++;
+}
+
+static void *poster_thread(void *arg)
+{
+	uintptr_t id = (uintptr_t)arg;
+	uintptr_t i;
+
+	for (i = 0; i < NUM_TASKS; i++) {
+		while (osmo_loop_post(main_loop, count_task, (void *)((id << 16) | i)) == -ENOSPC)
+			sched_yield();
+	}
+	return NULL;
+}
+
+static void test_post_from_threads(void)
+{
+	pthread_t threads[NUM_POSTERS];
+	uintptr_t i;
+
+	printf("Testing osmo_loop_post() from %d threads\n", NUM_POSTERS);
+
+	for (i = 0; i < NUM_POSTERS; i++)
+		OSMO_ASSERT(pthread_create(&threads[i], NULL, poster_thread, (void *)i) == 0);
+
+	while (executed < NUM_POSTERS * NUM_TASKS)
+		osmo_select_main(0);
+
+	for (i = 0; i < NUM_POSTERS; i++)
+		pthread_join(threads[i], NULL);
+
+	printf("executed %u closures in order\n", executed);
+}
+
+static void self_task(void *data)
+{
+	unsigned int *depth = data;
+
+	printf("self_task depth=%u\n", *depth);
+	if (++(*depth) < 3)
+		OSMO_ASSERT(osmo_loop_post(osmo_loop_self(), self_task, depth) == 0);
+}
+
+static void test_post_to_self(void)
+{
+	unsigned int depth = 0;
+
+	printf("Testing closures posted from a closure run in the next iteration\n");
+
+	OSMO_ASSERT(osmo_loop_post(osmo_loop_self(), self_task, &depth) == 0);
+	OSMO_ASSERT(osmo_loop_run_tasks() == 1);
+	OSMO_ASSERT(osmo_loop_run_tasks() == 1);
+	OSMO_ASSERT(osmo_loop_run_tasks() == 1);
+	OSMO_ASSERT(osmo_loop_run_tasks() == 0);
+}
+
+/* a worker thread with its own select loop, computing on behalf of the main thread */
+struct job {
+	unsigned int in;
+	unsigned int out;
+};
+
+static struct osmo_loop *worker_loop;
+static int worker_quit;
+static unsigned int jobs_done;
+
+static void job_done(void *data)
+{
+	struct job *job = data;
+	printf("job %u -> %u\n", job->in, job->out);
+	jobs_done++;
+}
+
+static void job_run(void *data)
+{
+	struct job *job = data;
+	job->out = job->in * job->in;
+	OSMO_ASSERT(osmo_loop_post(main_loop, job_done, job) == 0);
+}
+
+static void worker_stop(void *data)
+{
+	worker_quit = 1;
+}
+
+static void *worker_thread(void *arg)
+{
+	OSMO_ASSERT(osmo_ctx_init("worker") == 0);
+	osmo_select_init();
+	OSMO_ASSERT(osmo_loop_init(OTC_GLOBAL, 16) == 0);
+	__atomic_store_n(&worker_loop, osmo_loop_self(), __ATOMIC_RELEASE);
+
+	while (!worker_quit)
+		osmo_select_main(0);
+
+	osmo_loop_exit();
+	talloc_free(osmo_ctx);
+	return NULL;
+}
+
+static void test_worker_roundtrip(void)
+{
+	struct job jobs[4];
+	pthread_t thread;
+	unsigned int i;
+
+	printf("Testing round-trip to a worker thread's select loop\n");
+
+	OSMO_ASSERT(pthread_create(&thread, NULL, worker_thread, NULL) == 0);
+	while (!__atomic_load_n(&worker_loop, __ATOMIC_ACQUIRE))
+		sched_yield();
+
+	for (i = 0; i < ARRAY_SIZE(jobs); i++) {
+		jobs[i].in = i + 2;
+		OSMO_ASSERT(osmo_loop_post(worker_loop, job_run, &jobs[i]) == 0);
+	}
+
+	while (jobs_done < ARRAY_SIZE(jobs))
+		osmo_select_main(0);
+
+	OSMO_ASSERT(osmo_loop_post(worker_loop, worker_stop, NULL) == 0);
+	pthread_join(thread, NULL);
+}
+
+int main(int argc, char **argv)
+{
+	OSMO_ASSERT(osmo_loop_self() == NULL);
+	OSMO_ASSERT(osmo_loop_run_tasks() == 0);
+	OSMO_ASSERT(osmo_loop_init(OTC_GLOBAL, 64) == 0);
+	OSMO_ASSERT(osmo_loop_init(OTC_GLOBAL, 64) == -EALREADY);
+	main_loop = osmo_loop_self();
+	OSMO_ASSERT(main_loop);
+
+	test_post_from_threads();
+	test_post_to_self();
+	test_worker_roundtrip();
+
+	osmo_loop_exit();
+	OSMO_ASSERT(osmo_loop_self() == NULL);
+
+	printf("Done\n");
+	return 0;
+}
@@ -0,0 +1,202 @@
+/* tests for the interval rates of rate counters */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <osmocom/core/logging.h>
+#include <osmocom/core/utils.h>
+#include <osmocom/core/rate_ctr.h>
+#include <osmocom/core/timer.h>
+
+static const struct rate_ctr_desc ctr_description[] = {
+	{ "ctr:a", "The A counter value" },
+};
+
+static const struct rate_ctr_group_desc ctrg_desc = {
+	.group_name_prefix = "rate-ctr-test",
+	.group_description = "Rate counter test",
+	.num_ctr = ARRAY_SIZE(ctr_description),
+	.ctr_desc = ctr_description,
+};
+
+static void print_intv(unsigned int secs, const struct rate_ctr *ctr)
+{
+	printf("t=%us: cur=%"PRIu64" per_sec=%"PRIu64" per_min=%"PRIu64"\n", secs, ctr->current,
+	       ctr->intv[RATE_CTR_INTV_SEC].rate, ctr->intv[RATE_CTR_INTV_MIN].rate);
+}
+
+/* One second passes, during which the counter is incremented by inc */
+static void second_passes(struct rate_ctr *ctr, unsigned int inc)
+{
+	rate_ctr_add(ctr, inc);
+	osmo_gettimeofday_override_add(1, 0);
+	osmo_timers_prepare();
+	osmo_timers_update();
+}
+
+/* A busy counter, incremented every second, but read only every few
+ * seconds (like by a stats reporter with a longer interval, or a periodic
+ * CTRL GET), must show its average rate, never zero */
+static void test_sparse_reads(void)
+{
+	struct rate_ctr_group *ctrg;
+	struct rate_ctr *ctr;
+	unsigned int t = 0, i;
+
+	printf("Start test: %s\n", __func__);
+
+	ctrg = rate_ctr_group_alloc(NULL, &ctrg_desc, 0);
+	OSMO_ASSERT(ctrg);
+	ctr = &ctrg->ctr[0];
+
+	/* 10 per second, read every 5 seconds */
+	for (i = 0; i < 3; i++) {
+		for (; t < (i + 1) * 5; t++)
+			second_passes(ctr, 10);
+		rate_ctr_group_aggregate(ctrg);
+		print_intv(t, ctr);
+	}
+
+	/* 10 per second, read only every few minutes, on a minute boundary:
+	 * per_min is 600 */
+	for (i = 0; i < 2; i++) {
+		unsigned int end = (t / 60 + 3) * 60;
+		for (; t < end; t++)
+			second_passes(ctr, 10);
+		rate_ctr_group_aggregate(ctrg);
+		print_intv(t, ctr);
+	}
+
+	/* a single increment, read 7 seconds later: a rate of at least 1 */
+	second_passes(ctr, 1);
+	for (i = 1; i < 7; i++)
+		second_passes(ctr, 0);
+	t += 7;
+	rate_ctr_group_aggregate(ctrg);
+	print_intv(t, ctr);
+
+	/* idle since: all rates drop to 0 */
+	for (i = 0; i < 200; i++)
+		second_passes(ctr, 0);
+	t += 200;
+	rate_ctr_group_aggregate(ctrg);
+	print_intv(t, ctr);
+
+	rate_ctr_group_free(ctrg);
+
+	printf("End test: %s\n", __func__);
+}
+
+static void test_cursor(void)
+{
+	struct rate_ctr_group_cursor cur, cur2;
+	struct rate_ctr_group *ctrg[4], *grp;
+	unsigned int i;
+
+	printf("Start test: %s\n", __func__);
+
+	for (i = 0; i < ARRAY_SIZE(ctrg); i++) {
+		ctrg[i] = rate_ctr_group_alloc(NULL, &ctrg_desc, i);
+		OSMO_ASSERT(ctrg[i]);
+	}
+
+	/* new groups are added at the list head: the walk sees 3, 2, 1, 0 */
+	rate_ctr_group_cursor_start(&cur);
+	rate_ctr_group_cursor_start(&cur2);
+	grp = rate_ctr_group_cursor_next(&cur);
+	printf("group %u\n", grp->idx);
+
+	/* free the group returned next, and one already returned */
+	rate_ctr_group_free(ctrg[2]);
+	rate_ctr_group_free(ctrg[3]);
+	/* groups allocated meanwhile are not returned */
+	ctrg[2] = rate_ctr_group_alloc(NULL, &ctrg_desc, 4);
+	OSMO_ASSERT(ctrg[2]);
+
+	while ((grp = rate_ctr_group_cursor_next(&cur)))
+		printf("group %u\n", grp->idx);
+	OSMO_ASSERT(!rate_ctr_group_cursor_next(&cur));
+	rate_ctr_group_cursor_stop(&cur);
+
+	/* a cursor which had not moved yet skips its freed first group */
+	printf("second cursor:\n");
+	while ((grp = rate_ctr_group_cursor_next(&cur2)))
+		printf("group %u\n", grp->idx);
+	rate_ctr_group_cursor_stop(&cur2);
+
+	for (i = 0; i < 3; i++)
+		rate_ctr_group_free(ctrg[i]);
+
+	printf("End test: %s\n", __func__);
+}
+
+/* the groups stay found while the hash table of groups grows and shrinks */
+static void test_lookup_grow(void)
+{
+	enum { NUM_GROUPS = 3000 };
+	static struct rate_ctr_group *ctrg[NUM_GROUPS];
+	unsigned int i;
+
+	printf("Start test: %s\n", __func__);
+
+	for (i = 0; i < NUM_GROUPS; i++) {
+		ctrg[i] = rate_ctr_group_alloc(NULL, &ctrg_desc, i);
+		OSMO_ASSERT(ctrg[i]);
+	}
+	for (i = 0; i < NUM_GROUPS; i++) {
+		OSMO_ASSERT(rate_ctr_get_group_by_name_idx(ctrg_desc.group_name_prefix, i) == ctrg[i]);
+		OSMO_ASSERT(rate_ctr_get_by_name(ctrg[i], "ctr:a") == &ctrg[i]->ctr[0]);
+		OSMO_ASSERT(!rate_ctr_get_by_name(ctrg[i], "ctr:b"));
+	}
+	printf("%u groups found\n", i);
+
+	/* free all but every 16th group, so that the table shrinks again */
+	for (i = 0; i < NUM_GROUPS; i++) {
+		if (i % 16 == 0)
+			continue;
+		rate_ctr_group_free(ctrg[i]);
+		ctrg[i] = NULL;
+	}
+	for (i = 0; i < NUM_GROUPS; i++)
+		OSMO_ASSERT(rate_ctr_get_group_by_name_idx(ctrg_desc.group_name_prefix, i) == ctrg[i]);
+	printf("remaining groups found\n");
+
+	for (i = 0; i < NUM_GROUPS; i += 16)
+		rate_ctr_group_free(ctrg[i]);
+	OSMO_ASSERT(!rate_ctr_get_group_by_name_idx(ctrg_desc.group_name_prefix, 0));
+
+	printf("End test: %s\n", __func__);
+}
+
+int main(int argc, char **argv)
+{
+	static const struct log_info log_info = {};
+	log_init(&log_info, NULL);
+
+	osmo_gettimeofday_override_time = (struct timeval){ .tv_sec = 123 };
+	osmo_gettimeofday_override = true;
+	rate_ctr_init(NULL);
+
+	test_sparse_reads();
+	test_cursor();
+	test_lookup_grow();
+
+	return 0;
+}
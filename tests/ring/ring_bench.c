@@ -0,0 +1,177 @@
+/*
+ * Throughput benchmark for the lock-free ring buffers and inter-thread
+ * msgb queues.  Not part of the test suite, as the results depend on the
+ * machine; run manually:
+ *
+ *   ./tests/ring/ring_bench [num_items]
+ */
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <osmocom/core/ring.h>
+#include <osmocom/core/it_msgq.h>
+#include <osmocom/core/msgb.h>
+#include <osmocom/core/select.h>
+#include <osmocom/core/utils.h>
+
+#define MAX_PRODUCERS	8
+
+static unsigned long num_items = 10000000;
+
+struct producer {
+	pthread_t thread;
+	struct osmo_ring *ring;
+	struct osmo_it_msgq *q;
+	unsigned long count;
+};
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *ring_producer(void *arg)
+{
+	struct producer *p = arg;
+	unsigned long i;
+
+	for (i = 1; i <= p->count; i++) {
+		while (osmo_ring_enqueue_ptr(p->ring, (void *)i) == -ENOSPC)
+			sched_yield();
+	}
+	return NULL;
+}
+
+static void bench_ring(enum osmo_ring_type type, unsigned int num_producers)
+{
+	struct producer prod[MAX_PRODUCERS];
+	struct osmo_ring *ring;
+	unsigned long received = 0, total;
+	unsigned int i;
+	double start, elapsed;
+
+	ring = osmo_ring_alloc(NULL, type, 4096, sizeof(void *));
+	OSMO_ASSERT(ring);
+	total = (num_items / num_producers) * num_producers;
+
+	start = now();
+	for (i = 0; i < num_producers; i++) {
+		prod[i].ring = ring;
+		prod[i].count = num_items / num_producers;
+		OSMO_ASSERT(pthread_create(&prod[i].thread, NULL, ring_producer, &prod[i]) == 0);
+	}
+	while (received < total) {
+		if (osmo_ring_dequeue_ptr(ring))
+			received++;
+		else
+			sched_yield();
+	}
+	elapsed = now() - start;
+
+	for (i = 0; i < num_producers; i++)
+		pthread_join(prod[i].thread, NULL);
+
+	printf("ring %s %u producer(s): %lu elements in %.3f s: %.2f Mops/s, %.1f ns/op\n",
+	       type == OSMO_RING_SPSC ? "SPSC" : "MPSC", num_producers, total, elapsed,
+	       total / elapsed / 1e6, elapsed * 1e9 / total);
+
+	osmo_ring_free(ring);
+}
+
+static unsigned long msgq_received;
+
+static void *msgq_producer(void *arg)
+{
+	struct producer *p = arg;
+	struct msgb *msg;
+	unsigned long i;
+
+	for (i = 0; i < p->count; i++) {
+		msg = msgb_alloc_c(NULL, 64, "ring_bench");
+		OSMO_ASSERT(msg);
+		while (osmo_it_msgq_enqueue(p->q, msg) == -ENOSPC)
+			sched_yield();
+	}
+	return NULL;
+}
+
+static void msgq_read_cb(struct osmo_it_msgq *q, struct msgb *msg)
+{
+	msgq_received++;
+	msgb_free(msg);
+}
+
+static void bench_it_msgq(unsigned int num_producers)
+{
+	struct producer prod[MAX_PRODUCERS];
+	struct osmo_it_msgq *q;
+	unsigned long total;
+	unsigned int i;
+	double start, elapsed;
+
+	q = osmo_it_msgq_alloc(NULL, "bench", num_producers > 1 ? OSMO_RING_MPSC : OSMO_RING_SPSC,
+			       4096, msgq_read_cb, NULL);
+	OSMO_ASSERT(q);
+	msgq_received = 0;
+	total = (num_items / 10 / num_producers) * num_producers;
+
+	start = now();
+	for (i = 0; i < num_producers; i++) {
+		prod[i].q = q;
+		prod[i].count = num_items / 10 / num_producers;
+		OSMO_ASSERT(pthread_create(&prod[i].thread, NULL, msgq_producer, &prod[i]) == 0);
+	}
+	while (msgq_received < total)
+		osmo_select_main(0);
+	elapsed = now() - start;
+
+	for (i = 0; i < num_producers; i++)
+		pthread_join(prod[i].thread, NULL);
+
+	printf("it_msgq %u producer(s): %lu msgbs in %.3f s: %.2f Mmsgb/s (incl. msgb alloc/free)\n",
+	       num_producers, total, elapsed, total / elapsed / 1e6);
+
+	osmo_it_msgq_destroy(q);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 1)
+		num_items = strtoul(argv[1], NULL, 10);
+	if (num_items < MAX_PRODUCERS * 10)
+		num_items = MAX_PRODUCERS * 10;
+
+	bench_ring(OSMO_RING_SPSC, 1);
+	bench_ring(OSMO_RING_MPSC, 1);
+	bench_ring(OSMO_RING_MPSC, 2);
+	bench_ring(OSMO_RING_MPSC, 4);
+	bench_it_msgq(1);
+	bench_it_msgq(4);
+
+	return 0;
+}
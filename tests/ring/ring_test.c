@@ -0,0 +1,273 @@
+/*
+ * (C) 2026 by agent <agent@local>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <osmocom/core/ring.h>
+#include <osmocom/core/it_msgq.h>
+#include <osmocom/core/msgb.h>
+#include <osmocom/core/select.h>
+#include <osmocom/core/talloc.h>
+#include <osmocom/core/utils.h>
+
+static const char *ring_type_name(enum osmo_ring_type type)
+{
+	return type == OSMO_RING_SPSC ? "SPSC" : "MPSC";
+}
+
+static void test_ring_basic(enum osmo_ring_type type)
+{
+	struct osmo_ring *ring;
+	uint32_t val;
+	unsigned int i, round;
+
+	printf("Testing basic %s ring operations\n", ring_type_name(type));
+
+	OSMO_ASSERT(osmo_ring_alloc(NULL, type, 0, sizeof(val)) == NULL);
+
+	ring = osmo_ring_alloc(NULL, type, 5, sizeof(val));
+	OSMO_ASSERT(ring);
+	printf("size=%u elem_size=%zu\n", osmo_ring_size(ring), osmo_ring_elem_size(ring));
+	OSMO_ASSERT(osmo_ring_get_type(ring) == type);
+
+	OSMO_ASSERT(!osmo_ring_dequeue(ring, &val));
+
+	for (i = 0; i < osmo_ring_size(ring); i++) {
+		val = 100 + i;
+		OSMO_ASSERT(osmo_ring_enqueue(ring, &val) == 0);
+	}
+	printf("count=%u\n", osmo_ring_count(ring));
+	val = 42;
+	printf("enqueue into full ring: %d\n", osmo_ring_enqueue(ring, &val));
+
+	for (i = 0; i < osmo_ring_size(ring); i++) {
+		OSMO_ASSERT(osmo_ring_dequeue(ring, &val));
+		printf("%u ", val);
+	}
+	printf("\n");
+	OSMO_ASSERT(!osmo_ring_dequeue(ring, &val));
+	OSMO_ASSERT(osmo_ring_count(ring) == 0);
+
+	/* wrap around many times with a partially filled ring */
+	for (round = 0; round < 1000; round++) {
+		for (i = 0; i < 3; i++) {
+			val = round * 3 + i;
+			OSMO_ASSERT(osmo_ring_enqueue(ring, &val) == 0);
+		}
+		for (i = 0; i < 3; i++) {
+			OSMO_ASSERT(osmo_ring_dequeue(ring, &val));
+			OSMO_ASSERT(val == round * 3 + i);
+		}
+	}
+	OSMO_ASSERT(osmo_ring_count(ring) == 0);
+	printf("wrap-around ok\n");
+
+	osmo_ring_free(ring);
+}
+
+/* a ring of one requested element must still tell full from empty */
+static void test_ring_one_elem(enum osmo_ring_type type)
+{
+	struct osmo_ring *ring;
+	uint32_t val;
+	unsigned int i, round;
+
+	printf("Testing %s ring of one element\n", ring_type_name(type));
+
+	ring = osmo_ring_alloc(NULL, type, 1, sizeof(val));
+	OSMO_ASSERT(ring);
+	printf("size=%u\n", osmo_ring_size(ring));
+
+	for (round = 0; round < 10; round++) {
+		for (i = 0; i < osmo_ring_size(ring); i++) {
+			val = round * 10 + i;
+			OSMO_ASSERT(osmo_ring_enqueue(ring, &val) == 0);
+		}
+		OSMO_ASSERT(osmo_ring_enqueue(ring, &val) == -ENOSPC);
+		OSMO_ASSERT(osmo_ring_count(ring) == osmo_ring_size(ring));
+		for (i = 0; i < osmo_ring_size(ring); i++) {
+			OSMO_ASSERT(osmo_ring_dequeue(ring, &val));
+			OSMO_ASSERT(val == round * 10 + i);
+		}
+		OSMO_ASSERT(!osmo_ring_dequeue(ring, &val));
+	}
+	printf("full and empty ok\n");
+
+	osmo_ring_free(ring);
+}
+
+#define NUM_ITEMS	200000
+#define MAX_PRODUCERS	4
+
+struct producer {
+	pthread_t thread;
+	struct osmo_ring *ring;
+	uint32_t id;
+};
+
+static void *ring_producer(void *arg)
+{
+	struct producer *p = arg;
+	uint32_t i, val;
+
+	for (i = 0; i < NUM_ITEMS; i++) {
+		val = (p->id << 24) | i;
+		while (osmo_ring_enqueue(p->ring, &val) == -ENOSPC)
+			sched_yield();
+	}
+	return NULL;
+}
+
+static void test_ring_threads(enum osmo_ring_type type, unsigned int num_producers)
+{
+	struct producer prod[MAX_PRODUCERS];
+	uint32_t next[MAX_PRODUCERS] = { 0 };
+	struct osmo_ring *ring;
+	unsigned int i, received = 0;
+	uint32_t val;
+
+	printf("Testing %s ring with %u producer thread(s)\n", ring_type_name(type), num_producers);
+
+	ring = osmo_ring_alloc(NULL, type, 256, sizeof(val));
+	OSMO_ASSERT(ring);
+
+	for (i = 0; i < num_producers; i++) {
+		prod[i].ring = ring;
+		prod[i].id = i;
+		OSMO_ASSERT(pthread_create(&prod[i].thread, NULL, ring_producer, &prod[i]) == 0);
+	}
+
+	while (received < num_producers * NUM_ITEMS) {
+		uint32_t id, seq;
+		if (!osmo_ring_dequeue(ring, &val)) {
+			sched_yield();
+			continue;
+		}
+		id = val >> 24;
+		seq = val & 0xffffff;
+		OSMO_ASSERT(id < num_producers);
+		/* elements of one producer must arrive in order */
+		OSMO_ASSERT(seq == next[id]);
+		next[id]++;
+		received++;
+	}
+
+	for (i = 0; i < num_producers; i++)
+		pthread_join(prod[i].thread, NULL);
+
+	OSMO_ASSERT(!osmo_ring_dequeue(ring, &val));
+	printf("received %u elements in order\n", received);
+
+	osmo_ring_free(ring);
+}
+
+#define NUM_MSGS	1000
+
+static unsigned int msgq_received;
+static uint32_t msgq_next[MAX_PRODUCERS];
+
+struct msgq_producer {
+	pthread_t thread;
+	struct osmo_it_msgq *q;
+	uint32_t id;
+};
+
+static void *msgq_producer(void *arg)
+{
+	struct msgq_producer *p = arg;
+	struct msgb *msg;
+	uint32_t i;
+
+	for (i = 0; i < NUM_MSGS; i++) {
+		msg = msgb_alloc_c(NULL, 64, "it_msgq_test");
+		OSMO_ASSERT(msg);
+		msgb_put_u32(msg, p->id);
+		msgb_put_u32(msg, i);
+		while (osmo_it_msgq_enqueue(p->q, msg) == -ENOSPC)
+			sched_yield();
+	}
+	return NULL;
+}
+
+static void msgq_read_cb(struct osmo_it_msgq *q, struct msgb *msg)
+{
+	uint32_t id = osmo_load32be(msgb_data(msg));
+	uint32_t seq = osmo_load32be(msgb_data(msg) + 4);
+
+	OSMO_ASSERT(q->data == &msgq_received);
+	OSMO_ASSERT(id < MAX_PRODUCERS);
+	OSMO_ASSERT(seq == msgq_next[id]);
+	msgq_next[id]++;
+	msgq_received++;
+	msgb_free(msg);
+}
+
+static void test_it_msgq(unsigned int batch_max)
+{
+	struct msgq_producer prod[2];
+	struct osmo_it_msgq *q;
+	unsigned int i;
+
+	printf("Testing it_msgq with batch_max=%u\n", batch_max);
+
+	msgq_received = 0;
+	memset(msgq_next, 0, sizeof(msgq_next));
+
+	q = osmo_it_msgq_alloc(NULL, "test", OSMO_RING_MPSC, 64, msgq_read_cb, &msgq_received);
+	OSMO_ASSERT(q);
+	q->batch_max = batch_max;
+
+	for (i = 0; i < ARRAY_SIZE(prod); i++) {
+		prod[i].q = q;
+		prod[i].id = i;
+		OSMO_ASSERT(pthread_create(&prod[i].thread, NULL, msgq_producer, &prod[i]) == 0);
+	}
+
+	while (msgq_received < ARRAY_SIZE(prod) * NUM_MSGS)
+		osmo_select_main(0);
+
+	for (i = 0; i < ARRAY_SIZE(prod); i++)
+		pthread_join(prod[i].thread, NULL);
+
+	printf("received %u msgbs in order\n", msgq_received);
+
+	/* msgbs left in the queue are free'd on destroy */
+	OSMO_ASSERT(osmo_it_msgq_enqueue(q, msgb_alloc_c(NULL, 64, "left-over")) == 0);
+	osmo_it_msgq_destroy(q);
+}
+
+int main(int argc, char **argv)
+{
+	test_ring_basic(OSMO_RING_SPSC);
+	test_ring_basic(OSMO_RING_MPSC);
+	test_ring_one_elem(OSMO_RING_SPSC);
+	test_ring_one_elem(OSMO_RING_MPSC);
+	test_ring_threads(OSMO_RING_SPSC, 1);
+	test_ring_threads(OSMO_RING_MPSC, 1);
+	test_ring_threads(OSMO_RING_MPSC, MAX_PRODUCERS);
+	test_it_msgq(0);
+	test_it_msgq(16);
+
+	printf("Done\n");
+	return 0;
+}
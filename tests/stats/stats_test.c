@@ -27,9 +27,22 @@
 #include <osmocom/core/stat_item.h>
 #include <osmocom/core/rate_ctr.h>
 #include <osmocom/core/stats.h>
+#include <osmocom/core/stat_hist.h>
+#include <osmocom/core/stats_shm.h>
+#include <osmocom/core/timer.h>
+#include <osmocom/core/select.h>
 
+#include <errno.h>
 #include <stdio.h>
 #include <inttypes.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 
 enum test_ctr {
 	TEST_A_CTR,
@@ -49,6 +62,15 @@ static const struct rate_ctr_group_desc ctrg_desc = {
 	.class_id = OSMO_STATS_CLASS_SUBSCRIBER,
 };
 
+/* its metric names collide with those of ctrg_desc */
+static const struct rate_ctr_group_desc ctrg_desc_collide = {
+	.group_name_prefix = "ctr_test_one",
+	.group_description = "Counter test number 1 with _",
+	.num_ctr = ARRAY_SIZE(ctr_description),
+	.ctr_desc = ctr_description,
+	.class_id = OSMO_STATS_CLASS_SUBSCRIBER,
+};
+
 static const struct rate_ctr_desc ctr_description_dot[] = {
 	[TEST_A_CTR] = { "ctr.a", "The A counter value with ."},
 	[TEST_B_CTR] = { "ctr.b", "The B counter value with ."},
@@ -295,6 +317,23 @@ static int stats_reporter_test_send_item(struct osmo_stats_reporter *srep,
 	return 0;
 }
 
+static int stats_reporter_test_send_hist(struct osmo_stats_reporter *srep,
+	const struct osmo_stat_hist_group *histg,
+	const struct osmo_stat_hist_desc *desc,
+	const struct osmo_stat_hist_summary *sum)
+{
+	printf("  %s: hist p=%s g=%s i=%u n=%s c=%"PRIu64" min=%"PRIu32" p50=%"PRIu32
+	       " p90=%"PRIu32" p99=%"PRIu32" max=%"PRIu32" u=%s\n",
+		srep->name,
+		srep->name_prefix ? srep->name_prefix : "",
+		histg->desc->group_name_prefix, histg->idx,
+		desc->name, sum->count, sum->min, sum->p50, sum->p90, sum->p99, sum->max,
+		desc->unit ? desc->unit : "");
+
+	send_count += 1;
+	return 0;
+}
+
 static int stats_reporter_test_open(struct osmo_stats_reporter *srep)
 {
 	printf("  %s: open\n", srep->name);
@@ -318,6 +357,7 @@ static struct osmo_stats_reporter *stats_reporter_create_test(const char *name)
 	srep->close = stats_reporter_test_close;
 	srep->send_counter = stats_reporter_test_send_counter;
 	srep->send_item = stats_reporter_test_send_item;
+	srep->send_hist = stats_reporter_test_send_hist;
 
 	return srep;
 }
@@ -490,6 +530,606 @@ static void test_reporting()
 	printf("End test: %s\n", __func__);
 }
 
+#define SHARD_THREADS	4
+#define SHARD_INCS	100000
+
+static void *shard_inc_thread(void *arg)
+{
+	struct rate_ctr_group *ctrg = arg;
+	unsigned int i;
+
+	for (i = 0; i < SHARD_INCS; i++) {
+		rate_ctr_inc2(ctrg, TEST_A_CTR);
+		rate_ctr_add2(ctrg, TEST_B_CTR, 3);
+	}
+	rate_ctr_add2(ctrg, TEST_B_CTR, -SHARD_INCS);
+	return NULL;
+}
+
+static void test_stats_dirty(void)
+{
+	struct osmo_stats_reporter *srep;
+	struct rate_ctr_group *ctrg[3];
+	struct osmo_stat_item_group *statg;
+	unsigned int i;
+
+	printf("Start test: %s\n", __func__);
+
+	for (i = 0; i < ARRAY_SIZE(ctrg); i++) {
+		ctrg[i] = rate_ctr_group_alloc(NULL, &ctrg_desc, 11 + i);
+		OSMO_ASSERT(ctrg[i]);
+	}
+	statg = osmo_stat_item_group_alloc(NULL, &statg_desc, 14);
+	OSMO_ASSERT(statg);
+
+	srep = stats_reporter_create_test("test-dirty");
+	OSMO_ASSERT(osmo_stats_reporter_set_max_class(srep, OSMO_STATS_CLASS_SUBSCRIBER) == 0);
+	OSMO_ASSERT(osmo_stats_reporter_enable(srep) == 0);
+
+	/* the first report flushes everything, which includes left-overs of other tests */
+	send_count = 0;
+	osmo_stats_report();
+	printf("flush: send_count=%d\n", send_count > 0);
+
+	printf("nothing changed:\n");
+	send_count = 0;
+	osmo_stats_report();
+	OSMO_ASSERT(send_count == 0);
+
+	printf("two of three groups changed:\n");
+	rate_ctr_add(&ctrg[2]->ctr[TEST_A_CTR], 3);
+	rate_ctr_inc2(ctrg[0], TEST_B_CTR);
+	osmo_stat_item_set(statg->items[TEST_A_ITEM], 9);
+	osmo_stats_report();
+
+	printf("one group per main loop iteration:\n");
+	OSMO_ASSERT(osmo_stats_set_batch_size(1) == 0);
+	rate_ctr_inc2(ctrg[1], TEST_A_CTR);
+	rate_ctr_inc2(ctrg[2], TEST_A_CTR);
+	rate_ctr_inc2(ctrg[0], TEST_A_CTR);
+	osmo_stat_item_set(statg->items[TEST_B_ITEM], 10);
+	osmo_stats_report();
+	for (i = 0; i < 3; i++) {
+		printf(" iteration %u:\n", i + 1);
+		/* a change during the pass is reported by this or the next pass */
+		if (i == 0)
+			rate_ctr_inc2(ctrg[1], TEST_B_CTR);
+		osmo_timers_prepare();
+		osmo_timers_update();
+	}
+	printf("next report:\n");
+	osmo_stats_report();
+	OSMO_ASSERT(osmo_stats_set_batch_size(0) == 0);
+
+	/* a freed group is forgotten even if it changed */
+	rate_ctr_inc2(ctrg[1], TEST_A_CTR);
+	rate_ctr_group_free(ctrg[1]);
+	printf("after free:\n");
+	osmo_stats_report();
+
+	osmo_stats_reporter_free(srep);
+	rate_ctr_group_free(ctrg[0]);
+	rate_ctr_group_free(ctrg[2]);
+	osmo_stat_item_group_free(statg);
+
+	printf("End test: %s\n", __func__);
+}
+
+/* a value set while a batched pass runs is reported exactly once */
+static void test_stats_batch_item_once(void)
+{
+	struct osmo_stats_reporter *srep;
+	struct osmo_stat_item_group *statg[2];
+	unsigned int i;
+
+	printf("Start test: %s\n", __func__);
+
+	for (i = 0; i < ARRAY_SIZE(statg); i++) {
+		statg[i] = osmo_stat_item_group_alloc(NULL, &statg_desc, 21 + i);
+		OSMO_ASSERT(statg[i]);
+	}
+
+	srep = stats_reporter_create_test("test-once");
+	OSMO_ASSERT(osmo_stats_reporter_set_max_class(srep, OSMO_STATS_CLASS_SUBSCRIBER) == 0);
+	OSMO_ASSERT(osmo_stats_reporter_enable(srep) == 0);
+
+	/* flush everything, including left-overs of other tests */
+	osmo_stats_report();
+
+	OSMO_ASSERT(osmo_stats_set_batch_size(1) == 0);
+	osmo_stat_item_set(statg[0]->items[TEST_A_ITEM], 1);
+	osmo_stat_item_set(statg[1]->items[TEST_A_ITEM], 2);
+	printf("first pass, iteration 1:\n");
+	send_count = 0;
+	osmo_stats_report();
+	OSMO_ASSERT(send_count == 1);
+
+	/* one group already visited, the other one still pending */
+	osmo_stat_item_set(statg[0]->items[TEST_B_ITEM], 4711);
+	osmo_stat_item_set(statg[1]->items[TEST_B_ITEM], 4712);
+
+	printf("first pass, iteration 2:\n");
+	send_count = 0;
+	osmo_timers_prepare();
+	osmo_timers_update();
+	OSMO_ASSERT(send_count == 1);
+
+	printf("second pass:\n");
+	send_count = 0;
+	osmo_stats_report();
+	osmo_timers_prepare();
+	osmo_timers_update();
+	OSMO_ASSERT(send_count == 2);
+
+	printf("third pass:\n");
+	send_count = 0;
+	osmo_stats_report();
+	osmo_timers_prepare();
+	osmo_timers_update();
+	OSMO_ASSERT(send_count == 0);
+	OSMO_ASSERT(osmo_stats_set_batch_size(0) == 0);
+
+	osmo_stats_reporter_free(srep);
+	for (i = 0; i < ARRAY_SIZE(statg); i++)
+		osmo_stat_item_group_free(statg[i]);
+
+	printf("End test: %s\n", __func__);
+}
+
+static void test_rate_ctr_shards(void)
+{
+	pthread_t threads[SHARD_THREADS + 1];
+	struct rate_ctr_group *ctrg;
+	unsigned int i;
+
+	printf("Start test: %s\n", __func__);
+
+	ctrg = rate_ctr_group_alloc(NULL, &ctrg_desc, 3);
+	OSMO_ASSERT(ctrg);
+	OSMO_ASSERT(rate_ctr_group_enable_shards(ctrg, 0) == -EINVAL);
+	OSMO_ASSERT(rate_ctr_group_enable_shards(ctrg, SHARD_THREADS) == 0);
+	OSMO_ASSERT(rate_ctr_group_enable_shards(ctrg, SHARD_THREADS) == -EALREADY);
+
+	/* one thread more than shards, so that two threads share a shard */
+	for (i = 0; i < ARRAY_SIZE(threads); i++)
+		OSMO_ASSERT(pthread_create(&threads[i], NULL, shard_inc_thread, ctrg) == 0);
+	for (i = 0; i < ARRAY_SIZE(threads); i++)
+		pthread_join(threads[i], NULL);
+
+	/* nothing folded into the counters yet */
+	printf("before aggregation: a=%"PRIu64" b=%"PRIu64"\n",
+	       ctrg->ctr[TEST_A_CTR].current, ctrg->ctr[TEST_B_CTR].current);
+	rate_ctr_group_aggregate(ctrg);
+	printf("after aggregation: a=%"PRIu64" b=%"PRIu64"\n",
+	       ctrg->ctr[TEST_A_CTR].current, ctrg->ctr[TEST_B_CTR].current);
+
+	/* increments from the owning thread work the same way */
+	rate_ctr_inc2(ctrg, TEST_A_CTR);
+	rate_ctr_group_aggregate(ctrg);
+	rate_ctr_group_aggregate(ctrg);
+	printf("after local increment: a=%"PRIu64"\n", ctrg->ctr[TEST_A_CTR].current);
+
+	rate_ctr_inc2(ctrg, TEST_A_CTR);
+	rate_ctr_group_reset(ctrg);
+	printf("after reset: a=%"PRIu64" b=%"PRIu64"\n",
+	       ctrg->ctr[TEST_A_CTR].current, ctrg->ctr[TEST_B_CTR].current);
+
+	rate_ctr_group_free(ctrg);
+
+	printf("End test: %s\n", __func__);
+}
+
+static const struct osmo_stat_hist_desc hist_description[] = {
+	{ "rtt", "Round trip time", "us" },
+	{ "size", "Message size", "B" },
+};
+
+static const struct osmo_stat_hist_group_desc histg_desc = {
+	.group_name_prefix = "hist-test",
+	.group_description = "Histogram test",
+	.class_id = OSMO_STATS_CLASS_GLOBAL,
+	.num_hists = ARRAY_SIZE(hist_description),
+	.hist_desc = hist_description,
+};
+
+static void print_summary(const char *label, const struct osmo_stat_hist_summary *sum)
+{
+	printf("%s: count=%"PRIu64" min=%"PRIu32" p50=%"PRIu32" p90=%"PRIu32" p99=%"PRIu32
+	       " p999=%"PRIu32" max=%"PRIu32"\n", label, sum->count, sum->min, sum->p50, sum->p90,
+	       sum->p99, sum->p999, sum->max);
+}
+
+static void test_stat_hist(void)
+{
+	static const uint32_t bucket_test_values[] = {
+		0, 1, 7, 8, 15, 16, 17, 31, 32, 1000, 1023, 1024, 0x7fffffff, 0x80000000, UINT32_MAX
+	};
+	struct osmo_stat_hist_group *histg;
+	struct osmo_stat_hist_summary sum;
+	struct osmo_stats_reporter *srep;
+	struct osmo_stat_hist *rtt;
+	unsigned int i, prev_bucket = 0;
+	uint32_t v;
+
+	printf("Start test: %s\n", __func__);
+
+	for (i = 0; i < ARRAY_SIZE(bucket_test_values); i++) {
+		unsigned int b = osmo_stat_hist_bucket(bucket_test_values[i]);
+		printf("value %"PRIu32" -> bucket %u (max %"PRIu32")\n", bucket_test_values[i], b,
+		       osmo_stat_hist_bucket_max(b));
+	}
+
+	/* buckets are contiguous and each value lies within its bucket */
+	for (v = 0; v < 100000; v++) {
+		unsigned int b = osmo_stat_hist_bucket(v);
+		OSMO_ASSERT(b == prev_bucket || b == prev_bucket + 1);
+		OSMO_ASSERT(v <= osmo_stat_hist_bucket_max(b));
+		OSMO_ASSERT(b == 0 || v > osmo_stat_hist_bucket_max(b - 1));
+		/* relative error of at most 1/8 */
+		OSMO_ASSERT(osmo_stat_hist_bucket_max(b) - v <= v / 8);
+		prev_bucket = b;
+	}
+	OSMO_ASSERT(osmo_stat_hist_bucket(UINT32_MAX) == OSMO_STAT_HIST_NUM_BUCKETS - 1);
+
+	histg = osmo_stat_hist_group_alloc(NULL, &histg_desc, 0);
+	OSMO_ASSERT(histg);
+	OSMO_ASSERT(osmo_stat_hist_get_group_by_name_idx("hist-test", 0) == histg);
+	rtt = &histg->hist[0];
+	OSMO_ASSERT(osmo_stat_hist_get_by_name(histg, "rtt") == rtt);
+
+	osmo_stat_hist_get_summary(rtt, &sum);
+	print_summary("empty", &sum);
+
+	/* 1..1000 */
+	for (v = 1; v <= 1000; v++)
+		osmo_stat_hist_record2(histg, 0, v);
+	osmo_stat_hist_get_summary(rtt, &sum);
+	print_summary("1..1000", &sum);
+	printf("sum=%"PRIu64" p0=%"PRIu32" p100=%"PRIu32"\n", rtt->sum,
+	       osmo_stat_hist_get_percentile(rtt, 0), osmo_stat_hist_get_percentile(rtt, 100));
+
+	/* reporters see the values of the last interval only */
+	srep = stats_reporter_create_test("test-hist");
+	OSMO_ASSERT(srep);
+	osmo_stats_reporter_set_max_class(srep, OSMO_STATS_CLASS_GLOBAL);
+	osmo_stats_reporter_enable(srep);
+	printf("report:\n");
+	osmo_stats_report();
+	printf("report (no new values):\n");
+	osmo_stats_report();
+	for (i = 0; i < 10; i++)
+		osmo_stat_hist_record(rtt, 5000);
+	printf("report (10 new values):\n");
+	osmo_stats_report();
+
+	osmo_stat_hist_group_reset(histg);
+	osmo_stat_hist_get_summary(rtt, &sum);
+	print_summary("after reset", &sum);
+	osmo_stat_hist_record(rtt, 3);
+	printf("report (after reset):\n");
+	osmo_stats_report();
+
+	osmo_stats_reporter_free(srep);
+	osmo_stat_hist_group_free(histg);
+	OSMO_ASSERT(osmo_stat_hist_get_group_by_name_idx("hist-test", 0) == NULL);
+
+	printf("End test: %s\n", __func__);
+}
+
+#define SHM_PATH "stats_shm_test.seg"
+
+static void print_shm_snapshot(const void *seg, size_t seg_len)
+{
+	const struct osmo_stats_shm_hdr *hdr;
+	const struct osmo_stats_shm_entry *entries;
+	static uint8_t buf[1024 * 1024];
+	unsigned int i;
+	int rc;
+
+	rc = osmo_stats_shm_snapshot(seg, seg_len, buf, sizeof(buf));
+	if (rc < 0) {
+		printf("snapshot: %s\n", strerror(-rc));
+		return;
+	}
+	hdr = (const struct osmo_stats_shm_hdr *)buf;
+	entries = osmo_stats_shm_entries(hdr);
+	printf("snapshot: generation=%"PRIu64" seq even=%d\n", hdr->generation, !(hdr->seq & 1));
+	for (i = 0; i < hdr->num_entries; i++) {
+		const char *name = osmo_stats_shm_entry_name(hdr, &entries[i]);
+		/* only print our own groups, others may be left over by earlier tests */
+		if (strncmp(name, "ctr-test", 8) && strncmp(name, "test.one", 8) && strncmp(name, "hist-test", 9))
+			continue;
+		printf("  type=%u idx=%u %s=%"PRId64"\n", entries[i].type, entries[i].group_idx,
+		       name, entries[i].value);
+	}
+}
+
+static void test_stats_shm(void)
+{
+	struct osmo_stats_shm *shm;
+	struct rate_ctr_group *ctrg, *ctrg2;
+	struct osmo_stat_item_group *statg;
+	struct osmo_stat_hist_group *histg;
+	struct stat st;
+	void *seg;
+	size_t seg_len;
+	int fd;
+
+	printf("Start test: %s\n", __func__);
+
+	ctrg = rate_ctr_group_alloc(NULL, &ctrg_desc, 5);
+	statg = osmo_stat_item_group_alloc(NULL, &statg_desc, 6);
+	histg = osmo_stat_hist_group_alloc(NULL, &histg_desc, 7);
+	OSMO_ASSERT(ctrg && statg && histg);
+	rate_ctr_add(&ctrg->ctr[TEST_A_CTR], 42);
+	osmo_stat_item_set(statg->items[TEST_B_ITEM], -3);
+	osmo_stat_hist_record(&histg->hist[0], 100);
+
+	/* start with a tiny segment to test growing it */
+	shm = osmo_stats_shm_open(NULL, SHM_PATH, 1, 0);
+	OSMO_ASSERT(shm);
+
+	fd = open(SHM_PATH, O_RDONLY);
+	OSMO_ASSERT(fd >= 0);
+	OSMO_ASSERT(fstat(fd, &st) == 0);
+	seg_len = st.st_size;
+	seg = mmap(NULL, seg_len, PROT_READ, MAP_SHARED, fd, 0);
+	OSMO_ASSERT(seg != MAP_FAILED);
+	print_shm_snapshot(seg, seg_len);
+
+	/* values are only updated by the writer */
+	rate_ctr_add(&ctrg->ctr[TEST_A_CTR], 1);
+	rate_ctr_add(&ctrg->ctr[TEST_B_CTR], 7);
+	print_shm_snapshot(seg, seg_len);
+	OSMO_ASSERT(osmo_stats_shm_update(shm) == 0);
+	print_shm_snapshot(seg, seg_len);
+
+	/* adding and removing groups changes the layout */
+	ctrg2 = rate_ctr_group_alloc(NULL, &ctrg_desc, 8);
+	osmo_stat_item_group_free(statg);
+	osmo_stat_hist_group_free(histg);
+	OSMO_ASSERT(osmo_stats_shm_update(shm) == 0);
+	print_shm_snapshot(seg, seg_len);
+	rate_ctr_group_free(ctrg2);
+	OSMO_ASSERT(osmo_stats_shm_update(shm) == 0);
+	print_shm_snapshot(seg, seg_len);
+
+	/* a reader whose mapping is too small needs to map the segment again */
+	printf("small mapping: %s\n",
+	       strerror(-osmo_stats_shm_snapshot(seg, sizeof(struct osmo_stats_shm_hdr), NULL, 0)));
+	printf("small buffer: %s\n", strerror(-osmo_stats_shm_snapshot(seg, seg_len, NULL, 0)));
+
+	osmo_stats_shm_close(shm);
+	OSMO_ASSERT(access(SHM_PATH, F_OK) < 0);
+	munmap(seg, seg_len);
+	close(fd);
+	rate_ctr_group_free(ctrg);
+
+	printf("End test: %s\n", __func__);
+}
+
+/* send an HTTP request to the reporter and print the interesting lines of the response */
+static void prometheus_scrape(const struct sockaddr_in *addr, const char *req)
+{
+	static char buf[256 * 1024];
+	size_t len = 0;
+	char *line, *saveptr;
+	int fd, rc, i;
+
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	OSMO_ASSERT(fd >= 0);
+	OSMO_ASSERT(connect(fd, (const struct sockaddr *)addr, sizeof(*addr)) == 0);
+	OSMO_ASSERT(send(fd, req, strlen(req), 0) == strlen(req));
+
+	for (i = 0; i < 1000; i++) {
+		osmo_select_main(1);
+		rc = recv(fd, buf + len, sizeof(buf) - 1 - len, MSG_DONTWAIT);
+		if (rc == 0)
+			break;
+		if (rc > 0)
+			len += rc;
+	}
+	close(fd);
+	buf[len] = '\0';
+
+	for (line = strtok_r(buf, "\r\n", &saveptr); line; line = strtok_r(NULL, "\r\n", &saveptr)) {
+		if (strncmp(line, "HTTP/", 5) == 0 || strncmp(line, "Content-Type:", 13) == 0
+		    || strstr(line, "idx=\"5\"") || strstr(line, "idx=\"6\"") || strstr(line, "idx=\"7\"")
+		    || strstr(line, " ctr_test_one_ctr") || strstr(line, " test_one_item")
+		    || strcmp(line, "# EOF") == 0)
+			printf("  %s\n", line);
+	}
+}
+
+static void test_stats_prometheus(void)
+{
+	struct osmo_stats_reporter *srep;
+	struct rate_ctr_group *ctrg, *ctrg_collide;
+	struct osmo_stat_item_group *statg;
+	struct sockaddr_in addr;
+	socklen_t addr_len = sizeof(addr);
+
+	printf("Start test: %s\n", __func__);
+
+	ctrg = rate_ctr_group_alloc(NULL, &ctrg_desc, 5);
+	statg = osmo_stat_item_group_alloc(NULL, &statg_desc, 6);
+	OSMO_ASSERT(ctrg && statg);
+	rate_ctr_add(&ctrg->ctr[TEST_A_CTR], 42);
+	osmo_stat_item_set(statg->items[TEST_B_ITEM], 23);
+
+	srep = osmo_stats_reporter_create_prometheus("test-prom");
+	OSMO_ASSERT(osmo_stats_reporter_set_local_addr(srep, "127.0.0.1") == 0);
+	OSMO_ASSERT(osmo_stats_reporter_set_max_class(srep, OSMO_STATS_CLASS_SUBSCRIBER) == 0);
+	OSMO_ASSERT(osmo_stats_reporter_enable(srep) == 0);
+	OSMO_ASSERT(getsockname(srep->fd, (struct sockaddr *)&addr, &addr_len) == 0);
+
+	printf("scrape /metrics:\n");
+	prometheus_scrape(&addr, "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+
+	/* values are rendered at the time of the scrape */
+	rate_ctr_inc(&ctrg->ctr[TEST_B_CTR]);
+	printf("scrape /metrics?x=y:\n");
+	prometheus_scrape(&addr, "GET /metrics?x=y HTTP/1.0\r\n\r\n");
+
+	printf("scrape /foo:\n");
+	prometheus_scrape(&addr, "GET /foo HTTP/1.0\r\n\r\n");
+
+	/* each metric family appears once, even if names collide */
+	ctrg_collide = rate_ctr_group_alloc(NULL, &ctrg_desc_collide, 7);
+	OSMO_ASSERT(ctrg_collide);
+	rate_ctr_add(&ctrg_collide->ctr[TEST_A_CTR], 7);
+	printf("scrape /metrics with colliding names:\n");
+	prometheus_scrape(&addr, "GET /metrics HTTP/1.0\r\n\r\n");
+	rate_ctr_group_free(ctrg_collide);
+
+	osmo_stats_reporter_free(srep);
+	rate_ctr_group_free(ctrg);
+	osmo_stat_item_group_free(statg);
+
+	printf("End test: %s\n", __func__);
+}
+
+static void print_intv(const char *label, const struct rate_ctr *ctr)
+{
+	printf("%s: cur=%"PRIu64" sec=%"PRIu64" min=%"PRIu64" hour=%"PRIu64"\n", label, ctr->current,
+	       ctr->intv[RATE_CTR_INTV_SEC].rate, ctr->intv[RATE_CTR_INTV_MIN].rate,
+	       ctr->intv[RATE_CTR_INTV_HOUR].rate);
+}
+
+static void fake_time_passes(unsigned int secs)
+{
+	while (secs--) {
+		osmo_gettimeofday_override_add(1, 0);
+		osmo_timers_prepare();
+		osmo_timers_update();
+	}
+}
+
+static void test_rate_ctr_intv(void)
+{
+	struct rate_ctr_group *ctrg;
+	struct rate_ctr *ctr;
+
+	printf("Start test: %s\n", __func__);
+
+	osmo_gettimeofday_override_time = (struct timeval){ .tv_sec = 123 };
+	osmo_gettimeofday_override = true;
+	rate_ctr_init(NULL);
+
+	ctrg = rate_ctr_group_alloc(NULL, &ctrg_desc, 4);
+	OSMO_ASSERT(ctrg);
+	ctr = &ctrg->ctr[TEST_A_CTR];
+
+	rate_ctr_add(ctr, 5);
+	fake_time_passes(1);
+	rate_ctr_group_aggregate(ctrg);
+	print_intv("after 1s", ctr);
+
+	/* reading twice within the same second changes nothing */
+	rate_ctr_group_aggregate(ctrg);
+	print_intv("same second", ctr);
+
+	rate_ctr_add(ctr, 7);
+	fake_time_passes(1);
+	rate_ctr_group_aggregate(ctrg);
+	print_intv("after 2s", ctr);
+
+	/* an idle second */
+	fake_time_passes(1);
+	rate_ctr_group_aggregate(ctrg);
+	print_intv("after 3s", ctr);
+
+	/* not read for a while: the minute expires while nobody looks */
+	rate_ctr_add(ctr, 100);
+	fake_time_passes(60);
+	rate_ctr_group_aggregate(ctrg);
+	print_intv("after 63s", ctr);
+
+	rate_ctr_add(ctr, 1);
+	fake_time_passes(2 * 60);
+	rate_ctr_group_aggregate(ctrg);
+	print_intv("after 183s", ctr);
+
+	fake_time_passes(60 * 60);
+	rate_ctr_group_aggregate(ctrg);
+	print_intv("after 3783s", ctr);
+
+	rate_ctr_group_free(ctrg);
+	osmo_gettimeofday_override = false;
+
+	printf("End test: %s\n", __func__);
+}
+
+static void test_group_lookup(void)
+{
+	struct rate_ctr_group *ctrg[300], *ctrg_dup;
+	struct osmo_stat_item_group *statg[300];
+	void *ctx = talloc_named_const(NULL, 1, "lookup test context");
+	int i;
+
+	printf("Start test: %s\n", __func__);
+
+	for (i = 0; i < ARRAY_SIZE(ctrg); i++) {
+		ctrg[i] = rate_ctr_group_alloc(ctx, &ctrg_desc, i);
+		OSMO_ASSERT(ctrg[i] && ctrg[i]->idx == i);
+		statg[i] = osmo_stat_item_group_alloc(ctx, &statg_desc, i);
+		OSMO_ASSERT(statg[i]);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(ctrg); i++) {
+		OSMO_ASSERT(rate_ctr_get_group_by_name_idx("ctr-test:one", i) == ctrg[i]);
+		OSMO_ASSERT(rate_ctr_get_by_name(ctrg[i], "ctr:a") == &ctrg[i]->ctr[TEST_A_CTR]);
+		OSMO_ASSERT(rate_ctr_get_by_name(ctrg[i], "ctr:b") == &ctrg[i]->ctr[TEST_B_CTR]);
+		OSMO_ASSERT(rate_ctr_get_by_name(ctrg[i], "ctr:c") == NULL);
+		OSMO_ASSERT(osmo_stat_item_get_group_by_name_idx("test.one", i) == statg[i]);
+		OSMO_ASSERT(osmo_stat_item_get_by_name(statg[i], "item.b") == statg[i]->items[TEST_B_ITEM]);
+	}
+	OSMO_ASSERT(rate_ctr_get_group_by_name_idx("ctr-test:one", ARRAY_SIZE(ctrg)) == NULL);
+	OSMO_ASSERT(rate_ctr_get_group_by_name_idx("ctr-test:two", 0) == NULL);
+	OSMO_ASSERT(osmo_stat_item_get_group_by_name_idx("test.one", ARRAY_SIZE(statg)) == NULL);
+
+	/* groups with a mangled description get a copy of it */
+	ctrg_dup = rate_ctr_group_alloc(ctx, &ctrg_desc_dot, 0);
+	OSMO_ASSERT(ctrg_dup);
+	OSMO_ASSERT(rate_ctr_get_group_by_name_idx("ctr-test:one_dot", 0) == ctrg_dup);
+	OSMO_ASSERT(rate_ctr_get_by_name(ctrg_dup, "ctr:b") == &ctrg_dup->ctr[TEST_B_CTR]);
+	rate_ctr_group_free(ctrg_dup);
+	OSMO_ASSERT(rate_ctr_get_group_by_name_idx("ctr-test:one_dot", 0) == NULL);
+
+	/* a duplicate index is replaced by one above all used indexes, even
+	 * after the group with the highest index was freed */
+	rate_ctr_group_free(ctrg[ARRAY_SIZE(ctrg) - 1]);
+	ctrg_dup = rate_ctr_group_alloc(ctx, &ctrg_desc, 5);
+	OSMO_ASSERT(ctrg_dup && ctrg_dup->idx >= ARRAY_SIZE(ctrg) - 1);
+	OSMO_ASSERT(rate_ctr_get_group_by_name_idx("ctr-test:one", ctrg_dup->idx) == ctrg_dup);
+	OSMO_ASSERT(rate_ctr_get_group_by_name_idx("ctr-test:one", 5) == ctrg[5]);
+	rate_ctr_group_free(ctrg_dup);
+
+	/* changing the index moves the group in the lookup */
+	rate_ctr_group_upd_idx(ctrg[7], 1000);
+	OSMO_ASSERT(rate_ctr_get_group_by_name_idx("ctr-test:one", 7) == NULL);
+	OSMO_ASSERT(rate_ctr_get_group_by_name_idx("ctr-test:one", 1000) == ctrg[7]);
+	osmo_stat_item_group_udp_idx(statg[7], 1000);
+	OSMO_ASSERT(osmo_stat_item_get_group_by_name_idx("test.one", 7) == NULL);
+	OSMO_ASSERT(osmo_stat_item_get_group_by_name_idx("test.one", 1000) == statg[7]);
+
+	for (i = 0; i < ARRAY_SIZE(ctrg) - 1; i++)
+		rate_ctr_group_free(ctrg[i]);
+	for (i = 0; i < ARRAY_SIZE(statg); i++)
+		osmo_stat_item_group_free(statg[i]);
+	OSMO_ASSERT(rate_ctr_get_group_by_name_idx("ctr-test:one", 1000) == NULL);
+	OSMO_ASSERT(osmo_stat_item_get_group_by_name_idx("test.one", 0) == NULL);
+
+	/* once all groups are gone, indexes start from zero again */
+	ctrg_dup = rate_ctr_group_alloc(ctx, &ctrg_desc, 0);
+	OSMO_ASSERT(ctrg_dup && ctrg_dup->idx == 0);
+	rate_ctr_group_free(ctrg_dup);
+
+	talloc_free(ctx);
+
+	printf("End test: %s\n", __func__);
+}
+
 int main(int argc, char **argv)
 {
 	static const struct log_info log_info = {};
@@ -499,5 +1139,13 @@ int main(int argc, char **argv)
 
 	stat_test();
 	test_reporting();
+	test_stats_dirty();
+	test_stats_batch_item_once();
+	test_rate_ctr_shards();
+	test_rate_ctr_intv();
+	test_stat_hist();
+	test_stats_shm();
+	test_stats_prometheus();
+	test_group_lookup();
 	return 0;
 }
@@ -23,6 +23,7 @@
 #include <string.h>
 #include <errno.h>
 #include <limits.h>
+#include <unistd.h>
 
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -281,6 +282,23 @@ static void test_stats_vty(void)
 	OSMO_ASSERT(do_vty_command(vty, "exit") == CMD_SUCCESS);
 	OSMO_ASSERT(vty->node == CONFIG_NODE);
 
+	/* Create prometheus reporter */
+	srep = osmo_stats_reporter_find(OSMO_STATS_REPORTER_PROMETHEUS, NULL);
+	OSMO_ASSERT(srep == NULL);
+	OSMO_ASSERT(do_vty_command(vty, "stats reporter prometheus") == CMD_SUCCESS);
+	OSMO_ASSERT(vty->node == CFG_STATS_NODE);
+	srep = osmo_stats_reporter_find(OSMO_STATS_REPORTER_PROMETHEUS, NULL);
+	OSMO_ASSERT(srep != NULL);
+	OSMO_ASSERT(srep->type == OSMO_STATS_REPORTER_PROMETHEUS);
+	check_srep_vty_config(vty, srep);
+	OSMO_ASSERT(do_vty_command(vty, "no local-port") == CMD_SUCCESS);
+	OSMO_ASSERT(srep->bind_port == 0);
+	OSMO_ASSERT(do_vty_command(vty, "local-port 9342") == CMD_SUCCESS);
+	OSMO_ASSERT(srep->bind_port == 9342);
+	OSMO_ASSERT(do_vty_command(vty, "local-port 0") == CMD_ERR_NO_MATCH);
+	OSMO_ASSERT(do_vty_command(vty, "exit") == CMD_SUCCESS);
+	OSMO_ASSERT(vty->node == CONFIG_NODE);
+
 	/* Destroy log reporter */
 	OSMO_ASSERT(osmo_stats_reporter_find(OSMO_STATS_REPORTER_LOG, NULL));
 	OSMO_ASSERT(do_vty_command(vty, "no stats reporter log") == CMD_SUCCESS);
@@ -291,6 +309,11 @@ static void test_stats_vty(void)
 	OSMO_ASSERT(do_vty_command(vty, "no stats reporter statsd") == CMD_SUCCESS);
 	OSMO_ASSERT(!osmo_stats_reporter_find(OSMO_STATS_REPORTER_STATSD, NULL));
 
+	/* Destroy prometheus reporter */
+	OSMO_ASSERT(osmo_stats_reporter_find(OSMO_STATS_REPORTER_PROMETHEUS, NULL));
+	OSMO_ASSERT(do_vty_command(vty, "no stats reporter prometheus") == CMD_SUCCESS);
+	OSMO_ASSERT(!osmo_stats_reporter_find(OSMO_STATS_REPORTER_PROMETHEUS, NULL));
+
 	destroy_test_vty(&test, vty);
 }
 
@@ -452,8 +475,78 @@ DEFUN(cfg_numeric_range, cfg_numeric_range_cmd,
 	return CMD_SUCCESS;
 }
 
+DEFUN(cfg_first_word_choice, cfg_first_word_choice_cmd,
+	"(alpha|beta) first-word",
+	"testing the first word\n" "testing the first word\n" "testing the first word\n")
+{
+	printf("Called: '(alpha|beta) first-word' (%s)\n", argv[0]);
+	return CMD_SUCCESS;
+}
+
+DEFUN(cfg_first_word_prefix, cfg_first_word_prefix_cmd,
+	"alpha-two",
+	"testing the first word\n")
+{
+	printf("Called: 'alpha-two'\n");
+	return CMD_SUCCESS;
+}
+
+DEFUN(cfg_first_word_ip, cfg_first_word_ip_cmd,
+	"A.B.C.D first-word",
+	"testing the first word\n" "testing the first word\n")
+{
+	printf("Called: 'A.B.C.D first-word' (%s)\n", argv[0]);
+	return CMD_SUCCESS;
+}
+
+struct stream_test {
+	int remaining;
+	int calls;
+};
+
+static int stream_test_cb(struct vty *vty, void *data)
+{
+	struct stream_test *st = data;
+
+	st->calls++;
+	while (st->remaining && vty_out_stream_more(vty))
+		vty_out(vty, "line %d%s", st->remaining--, VTY_NEWLINE);
+	if (!st->remaining)
+		printf("streamed all lines in %d call(s)\n", st->calls);
+	return st->remaining;
+}
+
+DEFUN(cfg_stream_test, cfg_stream_test_cmd,
+	"stream-test <0-100000>",
+	"testing streamed output\n" "number of lines\n")
+{
+	struct stream_test *st = talloc_zero(vty, struct stream_test);
+
+	st->remaining = atoi(argv[0]);
+	OSMO_ASSERT(vty_out_stream(vty, stream_test_cb, st) == 0);
+	return CMD_SUCCESS;
+}
+
+/* More distinct first words than the VTY first-word cache holds */
+#define NUM_WORD_CMDS 20
+static char word_cmd_str[NUM_WORD_CMDS][32];
+static struct cmd_element word_cmds[NUM_WORD_CMDS];
+static int word_cmd_calls[NUM_WORD_CMDS];
+
+static int cfg_word(struct cmd_element *self, struct vty *vty, int argc, const char *argv[])
+{
+	int i = self - word_cmds;
+
+	/* the marker names the command each config line was meant for */
+	OSMO_ASSERT(argc == 1 && atoi(argv[0]) == i);
+	word_cmd_calls[i]++;
+	return CMD_SUCCESS;
+}
+
 void test_vty_add_cmds()
 {
+	int i;
+
 	install_element(CONFIG_NODE, &cfg_ret_warning_cmd);
 	install_element(CONFIG_NODE, &cfg_ret_success_cmd);
 
@@ -477,6 +570,35 @@ void test_vty_add_cmds()
 	install_element_ve(&cfg_ambiguous_str_2_cmd);
 
 	install_element_ve(&cfg_numeric_range_cmd);
+
+	install_element_ve(&cfg_first_word_choice_cmd);
+	install_element_ve(&cfg_first_word_prefix_cmd);
+	install_element_ve(&cfg_first_word_ip_cmd);
+
+	install_element_ve(&cfg_stream_test_cmd);
+
+	for (i = 0; i < NUM_WORD_CMDS; i++) {
+		snprintf(word_cmd_str[i], sizeof(word_cmd_str[i]), "word%02d MARKER", i);
+		word_cmds[i] = (struct cmd_element){
+			.string = word_cmd_str[i],
+			.func = cfg_word,
+			.doc = "Word command for VTY testing purposes\n"
+			       "string to mark the line for test debugging\n",
+		};
+		install_element(CONFIG_NODE, &word_cmds[i]);
+	}
+}
+
+static void test_config_repeated_first_words(void)
+{
+	int i;
+
+	printf("reading config with repeated first words\n");
+	memset(word_cmd_calls, 0, sizeof(word_cmd_calls));
+	test_exit_by_indent("ok_repeated_first_words.cfg", 0);
+	for (i = 0; i < NUM_WORD_CMDS; i++)
+		OSMO_ASSERT(word_cmd_calls[i] == 3);
+	printf("all word commands called 3 times\n");
 }
 
 void test_is_cmd_ambiguous()
@@ -513,6 +635,68 @@ void test_numeric_range()
 	destroy_test_vty(&test, vty);
 }
 
+void test_first_word()
+{
+	struct vty *vty;
+	struct vty_test test;
+
+	printf("Going to test the first word of commands\n");
+	vty = create_test_vty(&test);
+
+	OSMO_ASSERT(do_vty_command(vty, "alpha first-word") == CMD_SUCCESS);
+	OSMO_ASSERT(do_vty_command(vty, "b first-word") == CMD_SUCCESS);
+	OSMO_ASSERT(do_vty_command(vty, "alpha-t") == CMD_SUCCESS);
+	OSMO_ASSERT(do_vty_command(vty, "al first-word") == CMD_ERR_AMBIGUOUS);
+	OSMO_ASSERT(do_vty_command(vty, "alpha") == CMD_ERR_INCOMPLETE);
+	OSMO_ASSERT(do_vty_command(vty, "10.0.0.1 first-word") == CMD_SUCCESS);
+	OSMO_ASSERT(do_vty_command(vty, "gamma") == CMD_ERR_NO_MATCH);
+	OSMO_ASSERT(do_vty_command(vty, "numeric-range 1") == CMD_SUCCESS);
+
+	destroy_test_vty(&test, vty);
+}
+
+void test_out_stream()
+{
+	struct vty *vty;
+	struct vty_test test;
+	const char ctrl_c = 0x03;
+
+	printf("Going to test streamed output\n");
+	vty = create_test_vty(&test);
+	buffer_reset(vty->obuf);
+	/* each line printed raises a VTY_WRITE event, don't log thousands */
+	osmo_signal_unregister_handler(SS_L_VTY, vty_event_cb, NULL);
+
+	/* output fitting into one chunk is produced right away */
+	OSMO_ASSERT(do_vty_command(vty, "stream-test 0") == CMD_SUCCESS);
+	OSMO_ASSERT(do_vty_command(vty, "stream-test 20") == CMD_SUCCESS);
+	OSMO_ASSERT(!vty->stream);
+	buffer_reset(vty->obuf);
+
+	/* one chunk, the rest after the output was written */
+	OSMO_ASSERT(do_vty_command(vty, "stream-test 2000") == CMD_SUCCESS);
+	OSMO_ASSERT(vty->stream);
+	printf("pending after first chunk: %zu\n", buffer_len(vty->obuf));
+	buffer_reset(vty->obuf);
+	vty_out_stream_resume(vty);
+	OSMO_ASSERT(!vty->stream);
+	printf("pending after resume: %zu\n", buffer_len(vty->obuf));
+	buffer_reset(vty->obuf);
+
+	/* Ctrl-C aborts the output after the second chunk */
+	OSMO_ASSERT(do_vty_command(vty, "stream-test 4000") == CMD_SUCCESS);
+	buffer_reset(vty->obuf);
+	vty_out_stream_resume(vty);
+	OSMO_ASSERT(vty->stream);
+	OSMO_ASSERT(write(test.sock[1], &ctrl_c, 1) == 1);
+	OSMO_ASSERT(vty_read(vty) == 0);
+	OSMO_ASSERT(!vty->stream);
+	printf("pending after Ctrl-C: %zu\n", buffer_len(vty->obuf));
+
+	osmo_signal_register_handler(SS_L_VTY, vty_event_cb, NULL);
+	destroy_test_vty(&test, vty);
+}
+
 /* Application specific attributes */
 enum vty_test_attr {
 	VTY_TEST_ATTR_FOO = 0,
@@ -553,6 +737,8 @@ int main(int argc, char **argv)
 
 	/* Fake logging. */
 	osmo_init_logging2(ctx, &log_info);
+	/* the Prometheus reporter logs the ephemeral port it binds to */
+	log_set_category_filter(osmo_stderr_target, DLSTATS, 0, LOGL_NOTICE);
 
 	/* Init stats */
 	osmo_stats_init(stats_ctx);
@@ -581,11 +767,16 @@ int main(int argc, char **argv)
 	test_exit_by_indent("ok_empty_parent.cfg", 0);
 	test_exit_by_indent("fail_cmd_ret_warning.cfg", -EINVAL);
 	test_exit_by_indent("ok_deprecated_logging.cfg", 0);
+	test_config_repeated_first_words();
 
 	test_is_cmd_ambiguous();
 
 	test_numeric_range();
 
+	test_first_word();
+
+	test_out_stream();
+
 	/* Leak check */
 	OSMO_ASSERT(talloc_total_blocks(stats_ctx) == 1);
 